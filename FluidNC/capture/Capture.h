@@ -8,6 +8,8 @@
 #include <thread>
 #include <atomic>
 #include <mutex>
+#include <condition_variable>
+#include <algorithm>
 
 // Capture here defines everything that we want to know. Specifically, we want to capture per ID:
 // 1. Timings. *When* did something happen?
@@ -28,6 +30,139 @@ class Capture {
     mutable std::mutex        events_mutex_;
     std::atomic<uint32_t>     currentTime { 0 };
 
+    // Virtual time mode.  Nothing sleeps; instead, time is a microsecond
+    // counter that only moves forward when something waits for it.  While
+    // the step timer is running it owns the clock, advancing it by exactly
+    // one step period per step interrupt, and tasks that wait are released
+    // when the step timer reaches their wake time.  When no motion is in
+    // progress, a wait simply moves the clock forward, so idle time costs
+    // nothing.  currentTime follows the microsecond clock in milliseconds.
+    //
+    // The step timer runs in lock-step with the tasks.  When a tick releases
+    // tasks, the step timer holds the clock until each of them has run and
+    // waited again, as the protocol task does after prepping segments, so the
+    // tasks see the same step interrupts between their waits as in real time.
+    // The task that starts the step timer is held for in the same way, since
+    // it is usually still prepping segments.
+    // A task that keeps running instead of waiting, like the protocol task
+    // when the planner is full, is given up on after a real-time grace.  The
+    // grace must outlast a task that is merely slow to be scheduled on a
+    // loaded host, or the clock runs ahead of it.
+    struct Waiter {
+        uint64_t target;
+        bool     released = false;  // Set when the clock reaches target
+        uint64_t run      = 0;      // Set if the step timer holds the clock for the released task
+    };
+    struct Run {
+        uint64_t id;
+        bool     running;  // The released task has been scheduled
+    };
+
+    std::atomic<bool>       virtualTime { false };
+    std::atomic<bool>       stepperClock { false };
+    std::atomic<uint64_t>   virtualMicros { 0 };
+    std::atomic<uint64_t>   nextWake { UINT64_MAX };  // Earliest wake time of the waiters
+    std::mutex              clock_mutex_;
+    std::condition_variable clock_cv_;
+    std::vector<Waiter*>    waiters;  // Tasks waiting for the clock
+    std::vector<Run>        awake;    // Released tasks that the step timer is waiting for
+    uint64_t                lastRun = 0;
+
+    static inline thread_local uint64_t currentRun  = 0;      // The calling task's entry in awake
+    static inline thread_local bool     clockThread = false;  // The calling thread is the step timer
+
+    // How long the step timer waits, in real time, for released tasks to be
+    // scheduled, and then for them to wait again
+    static constexpr auto scheduleTimeout = std::chrono::milliseconds(100);
+    static constexpr auto runGrace        = std::chrono::milliseconds(50);
+
+    void waitVirtual(uint64_t target) {
+        std::unique_lock<std::mutex> lock(clock_mutex_);
+        finishRun();
+        if (virtualMicros.load(std::memory_order_acquire) >= target) {
+            return;
+        }
+        if (!stepperClock.load(std::memory_order_acquire)) {
+            moveClock(target);
+            return;
+        }
+        Waiter waiter { target };
+        waiters.push_back(&waiter);
+        nextWake.store(std::min(nextWake.load(std::memory_order_relaxed), target), std::memory_order_release);
+        while (!waiter.released) {
+            if (!stepperClock.load(std::memory_order_acquire)) {
+                moveClock(target);  // Releases this waiter too
+                break;
+            }
+            // The timeout only guards against a missed notification
+            clock_cv_.wait_for(lock, std::chrono::milliseconds(1));
+        }
+        if (waiter.run) {
+            for (auto& run : awake) {
+                if (run.id == waiter.run) {
+                    run.running = true;
+                    currentRun  = run.id;
+                    clock_cv_.notify_all();
+                }
+            }
+        }
+    }
+
+    // Called with clock_mutex_ held when a task that the step timer released
+    // waits again
+    void finishRun() {
+        if (currentRun) {
+            for (auto it = awake.begin(); it != awake.end(); ++it) {
+                if (it->id == currentRun) {
+                    awake.erase(it);
+                    clock_cv_.notify_all();
+                    break;
+                }
+            }
+            currentRun = 0;
+        }
+    }
+
+    // Moves the virtual clock forward to value, if it is not already past it
+    void setMicros(uint64_t value) {
+        uint64_t now = virtualMicros.load(std::memory_order_relaxed);
+        while (now < value) {
+            if (virtualMicros.compare_exchange_weak(now, value, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+                currentTime.store(uint32_t(value / 1000), std::memory_order_relaxed);
+                return;
+            }
+        }
+    }
+
+    // Called with clock_mutex_ held.  Moves the clock forward to value and
+    // releases the tasks whose wake time it reaches, returning true if any
+    bool moveClock(uint64_t value) {
+        setMicros(value);
+        value         = virtualMicros.load(std::memory_order_acquire);
+        bool     any  = false;
+        uint64_t next = UINT64_MAX;
+        for (auto it = waiters.begin(); it != waiters.end();) {
+            Waiter* waiter = *it;
+            if (waiter->target <= value) {
+                waiter->released = true;
+                if (clockThread) {
+                    waiter->run = ++lastRun;
+                    awake.push_back({ waiter->run, false });
+                }
+                it  = waiters.erase(it);
+                any = true;
+            } else {
+                next = std::min(next, waiter->target);
+                ++it;
+            }
+        }
+        nextWake.store(next, std::memory_order_release);
+        if (any) {
+            clock_cv_.notify_all();
+        }
+        return any;
+    }
+
 public:
     static Capture& instance() {
         static Capture instance;
@@ -79,13 +214,88 @@ public:
 
     uint32_t current() { return currentTime.load(std::memory_order_relaxed); }
 
+    void setVirtualTime(bool on) {
+        virtualMicros.store(uint64_t(currentTime.load()) * 1000);
+        virtualTime = on;
+    }
+    bool isVirtualTime() { return virtualTime.load(std::memory_order_relaxed); }
+
+    uint64_t micros() { return virtualMicros.load(std::memory_order_acquire); }
+
+    // Used by the step timer in virtual time mode.  While the step timer has
+    // the clock, tasks that wait are held until it advances to their wake time.
+    void takeClock(bool on) {
+        {
+            std::lock_guard<std::mutex> lock(clock_mutex_);
+            stepperClock = on;
+            awake.clear();
+            if (on && !clockThread) {
+                // The first tick holds the clock until the starting task waits
+                currentRun = ++lastRun;
+                awake.push_back({ currentRun, true });
+                nextWake.store(0, std::memory_order_release);
+            }
+        }
+        if (!on) {
+            clock_cv_.notify_all();
+        }
+    }
+
+    // Called by the step timer thread, so that the clock is moved by its ticks
+    // in lock-step with the tasks, and spins in step interrupts consume time
+    void setClockThread() { clockThread = true; }
+
+    // Moves the clock to the time of a step timer tick.  If that releases any
+    // tasks, or the task that started the step timer has not waited yet, holds
+    // the clock until they have run up to their next wait.
+    void tick(uint64_t value) {
+        if (value < nextWake.load(std::memory_order_acquire)) {
+            setMicros(value);
+            return;
+        }
+        std::unique_lock<std::mutex> lock(clock_mutex_);
+        if (!moveClock(value) && awake.empty()) {
+            return;
+        }
+        auto scheduled = [this]() {
+            return std::all_of(awake.begin(), awake.end(), [](const Run& run) { return run.running; });
+        };
+        clock_cv_.wait_for(lock, scheduleTimeout, scheduled);
+        clock_cv_.wait_for(lock, runGrace, [this]() { return awake.empty(); });
+        awake.clear();  // Tasks that are still running are not waited for
+    }
+
+    // Moves the clock forward without waiting for the tasks that it releases
+    void advanceTo(uint64_t value) {
+        std::lock_guard<std::mutex> lock(clock_mutex_);
+        moveClock(value);
+    }
+
+    // Waits until the microsecond clock reaches value.  A spin in a step
+    // interrupt, or while no motion is in progress, moves the clock instead.
+    void spinUntil(uint64_t value) {
+        if (clockThread) {
+            advanceTo(value);
+        } else {
+            waitVirtual(value);
+        }
+    }
+
     void wait(uint32_t delay) {
+        if (virtualTime.load(std::memory_order_relaxed)) {
+            waitVirtual(micros() + uint64_t(delay) * 1000);
+            return;
+        }
         // Actually wait in real time (delay is in milliseconds)
         std::this_thread::sleep_for(std::chrono::milliseconds(delay));
         currentTime.fetch_add(delay, std::memory_order_relaxed);
     }
 
     void waitUntil(uint32_t value) {
+        if (virtualTime.load(std::memory_order_relaxed)) {
+            waitVirtual(uint64_t(value) * 1000);
+            return;
+        }
         auto now = currentTime.load(std::memory_order_relaxed);
         while (value > now) {
             uint32_t delay = value - now;
@@ -99,6 +309,9 @@ public:
     void yield() {
         // Yield to other threads with minimal delay
         std::this_thread::yield();
+        if (virtualTime.load(std::memory_order_relaxed)) {
+            return;
+        }
         currentTime.fetch_add(1, std::memory_order_relaxed);
     }
 };
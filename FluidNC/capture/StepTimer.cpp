@@ -5,6 +5,7 @@
 
 #include "Platform.h"
 #include "Driver/step_engine.h"
+#include "Capture.h"
 #include <thread>
 #include <chrono>
 #include <mutex>
@@ -18,12 +19,25 @@ static std::mutex                                         mtx;
 static std::condition_variable                            cv;
 static std::chrono::time_point<std::chrono::steady_clock> _target_time;
 static std::chrono::duration<int64_t, std::micro>         _tick_interval;
+static uint64_t                                           _target_micros;  // Virtual time mode
+static std::thread                                        _timer_thread;
 
 static bool (*timer_isr_callback)(void);
 
 static void timing_loop() {
+    auto& capture = Capture::instance();
+    capture.setClockThread();
     while (_running) {
-        if (_pulsing) {
+        if (_pulsing && capture.isVirtualTime()) {
+            // Advance virtual time by exactly one period instead of sleeping,
+            // so the step sequence and its timing are the same as in real time
+            _target_micros += _tick_interval.count();
+            capture.tick(_target_micros);
+            if (!timer_isr_callback()) {
+                _pulsing = false;
+                capture.takeClock(false);
+            }
+        } else if (_pulsing) {
             _target_time += _tick_interval;
             auto now = std::chrono::steady_clock::now();
             if (_target_time > now) {
@@ -34,30 +48,51 @@ static void timing_loop() {
             }
         } else {
             std::unique_lock<std::mutex> lock(mtx);
-            cv.wait(lock);
+            cv.wait(lock, []() { return _pulsing || !_running; });
         }
     }
 }
 // Call this on shutdown to cleanly stop the timing thread
 void stepTimerShutdown() {
-    _running = false;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        _running = false;
+    }
     cv.notify_one();
+    // Wait for it to stop, so that a later stepTimerInit() cannot start a
+    // second one while the first is still running
+    if (_timer_thread.joinable() && _timer_thread.get_id() != std::this_thread::get_id()) {
+        _timer_thread.join();
+    }
 }
 
 uint32_t stepTimerInit(bool (*callback)(void)) {
     // Note: frequency must be 1000000 (units of microseconds); this implementation uses that frequency
+    if (_timer_thread.joinable()) {
+        stepTimerShutdown();
+    }
     timer_isr_callback = callback;
-    std::thread(timing_loop).detach();
+    _running           = true;
+    _timer_thread      = std::thread(timing_loop);
     return STEPPING_FREQUENCY;
 }
 void stepTimerStart() {
+    auto& capture  = Capture::instance();
     _tick_interval = std::chrono::microseconds(1);
     _target_time   = std::chrono::steady_clock::now();
-    _pulsing       = true;
+    if (capture.isVirtualTime()) {
+        _target_micros = capture.micros();
+        capture.takeClock(true);
+    }
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        _pulsing = true;
+    }
     cv.notify_one();
 }
 void stepTimerStop() {
     _pulsing = false;
+    Capture::instance().takeClock(false);
 }
 
 void stepTimerSetTicks(uint32_t ticks) {
@@ -37,6 +37,9 @@ inline void vTaskPrioritySet(portMUX_TYPE* mux) {
 inline size_t xPortGetFreeHeapSize() {
     return 500000;
 }
+inline size_t xPortGetMinimumEverFreeHeapSize() {
+    return 500000;
+}
 
 #define INC_FREERTOS_H
 #define PRIVILEGED_FUNCTION
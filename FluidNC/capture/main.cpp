@@ -2,6 +2,7 @@ extern "C" void setup();
 extern "C" void loop();
 
 #include "Platform.h"
+#include "Capture.h"
 
 #include <string>
 // Signal handling for SIGINT
@@ -24,10 +25,15 @@ int main(int argc, char** argv) {
     // Parse command line arguments looking for -c flags
     // Concatenate all -c arguments into a single string with newline terminators
     // Usage: ./program -c "G0 X10" -c "M5" or ./program -c '$sd/run=file.nc'
+    // --virtual-time runs on a simulated clock instead of sleeping, so a job
+    // runs as fast as the host allows with the same step output.
     for (int i = 1; i < argc; i++) {
         if (std::string(argv[i]) == "-") {
             continue_after_cmds = true;
         }
+        if (std::string(argv[i]) == "--virtual-time") {
+            Capture::instance().setVirtualTime(true);
+        }
         if (std::string(argv[i]) == "-c" && i + 1 < argc) {
             command_line_cmds += argv[++i];
             command_line_cmds += '\n';
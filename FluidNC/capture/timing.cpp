@@ -1,4 +1,5 @@
 #include "Driver/delay_usecs.h"
+#include "Capture.h"
 
 static int counter = 0;
 uint32_t   ticks_per_us;
@@ -20,9 +21,23 @@ int32_t usToEndTicks(int32_t us) {
 }
 
 void spinUntil(int32_t endTicks) {
+    auto& capture = Capture::instance();
+    if (capture.isVirtualTime()) {
+        // Spinning consumes time, so the spin lasts until the clock reaches its end
+        int32_t remaining = endTicks - getCpuTicks();
+        if (remaining > 0) {
+            capture.spinUntil(capture.micros() + remaining);
+        }
+        return;
+    }
     while ((getCpuTicks() - endTicks) < 0) {}
 }
 
+// In virtual time mode, CPU ticks are microseconds of virtual time
 int32_t getCpuTicks() {
+    auto& capture = Capture::instance();
+    if (capture.isVirtualTime()) {
+        return int32_t(capture.micros());
+    }
     return ++counter;
 }
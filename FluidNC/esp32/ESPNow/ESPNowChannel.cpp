@@ -1014,7 +1014,7 @@ void ESPNowChannel::poll() {
 
 int ESPNowChannel::available() {
     drainRxBuffer();
-    return _queue.size();
+    return queued_bytes();
 }
 
 Error ESPNowChannel::pollLine(char* line) {
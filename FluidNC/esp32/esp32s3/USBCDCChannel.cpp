@@ -207,11 +207,9 @@ size_t USBCDCChannel::timedReadBytes(char* buffer, size_t length, TickType_t tim
     // It is likely that _queue will be empty because timedReadBytes() is only
     // used in situations where the UART is not receiving GCode commands
     // and Grbl realtime characters.
-    while (remlen && _queue.size()) {
-        *buffer++ = _queue.front();
-        _queue.pop();
-        --remlen;
-    }
+    size_t queued = pop_queued_bytes(reinterpret_cast<uint8_t*>(buffer), remlen);
+    buffer += queued;
+    remlen -= queued;
 
     // The Arduino framework does not expose a timed read function
     // for USBCDC so we have to do the timeout the hard way
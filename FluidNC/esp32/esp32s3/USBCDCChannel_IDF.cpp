@@ -268,11 +268,9 @@ void USBCDCChannel::flushRx() {
 size_t USBCDCChannel::timedReadBytes(char* buffer, size_t length, TickType_t timeout) {
     // First, drain anything from the queue
     size_t remlen = length;
-    while (remlen && _queue.size()) {
-        *buffer++ = _queue.front();
-        _queue.pop();
-        --remlen;
-    }
+    size_t queued = pop_queued_bytes(reinterpret_cast<uint8_t*>(buffer), remlen);
+    buffer += queued;
+    remlen -= queued;
 
     if (remlen < length) {
         return length - remlen;
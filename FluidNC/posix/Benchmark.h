@@ -0,0 +1,35 @@
+// Copyright (c) 2026 - FluidNC Contributors
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#pragma once
+
+// Helpers for the $Bench/ commands, which time FluidNC hot paths on the
+// posix build so that throughput regressions show up before firmware is
+// flashed onto a machine.  Run them from the command line with, e.g.
+//   fluidnc -c '$Bench/File=/job.nc'
+
+#include "Channel.h"
+
+#include <chrono>
+#include <cstdint>
+
+namespace Benchmark {
+    class Timer {
+        std::chrono::steady_clock::time_point _start;
+
+    public:
+        Timer() : _start(std::chrono::steady_clock::now()) {}
+
+        void   restart() { _start = std::chrono::steady_clock::now(); }
+        double seconds() const { return std::chrono::duration<double>(std::chrono::steady_clock::now() - _start).count(); }
+    };
+
+    // Reports a count of units processed in the elapsed time, and the rate
+    void report(Channel& out, const char* name, uint64_t count, const char* units, double seconds);
+
+    // Reports the cost of one operation in nanoseconds
+    void report_cost(Channel& out, const char* name, uint64_t count, double seconds);
+
+    // Number of operator new calls so far, from all threads
+    uint64_t allocations();
+}
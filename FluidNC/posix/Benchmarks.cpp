@@ -0,0 +1,896 @@
+// Copyright (c) 2026 - FluidNC Contributors
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#include "Benchmark.h"
+
+#include "Module.h"
+#include "Settings.h"
+#include "InputFile.h"
+#include "Error.h"
+#include "Planner.h"
+#include "GCode.h"
+#include "Report.h"
+#include "SettingsDefinitions.h"
+#include "Stepper.h"
+#include "Stepping.h"
+#include "Driver/step_engine.h"
+#include "Machine/MachineConfig.h"
+#include "Configuration/GCodeParam.h"
+#include "Configuration/ItemIndex.h"
+#include "Expression.h"
+#include "Parameters.h"
+
+#include <atomic>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+// The host build counts heap allocations so that benchmarks can report them.
+// Every operator new in the program comes through here.
+static std::atomic<uint64_t> allocation_count;
+
+void* operator new(size_t size) {
+    ++allocation_count;
+    if (void* p = malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+void operator delete(void* p) noexcept {
+    free(p);
+}
+void operator delete[](void* p) noexcept {
+    free(p);
+}
+void operator delete(void* p, size_t) noexcept {
+    free(p);
+}
+void operator delete[](void* p, size_t) noexcept {
+    free(p);
+}
+
+namespace Benchmark {
+    uint64_t allocations() { return allocation_count; }
+
+    void report(Channel& out, const char* name, uint64_t count, const char* units, double seconds) {
+        double rate = seconds > 0 ? count / seconds : 0;
+        log_stream(out, name << ": " << count << " " << units << " in " << seconds << " s, " << rate << " " << units << "/s");
+    }
+
+    void report_cost(Channel& out, const char* name, uint64_t count, double seconds) {
+        double ns = count ? seconds * 1e9 / count : 0;
+        log_stream(out, name << ": " << ns << " ns each over " << count << " iterations");
+    }
+
+    // $Bench/File=/path streams a GCode file through InputFile::pollLine(),
+    // the same way that a running job reads it, without executing the lines.
+    static Error bench_file(const char* value, AuthenticationLevel auth_level, Channel& out) {
+        if (!value || !*value) {
+            log_string(out, "Missing file name!");
+            return Error::InvalidValue;
+        }
+        std::string path(value);
+        if (path[0] != '/') {
+            path = "/" + path;
+        }
+
+        InputFile* file;
+        try {
+            file = new InputFile(SD, path.c_str());
+        } catch (const ErrorException& ex) {
+            log_error_to(out, ex.what());
+            return ex.error();
+        } catch (std::filesystem::filesystem_error const& ex) {
+            log_error_to(out, ex.what());
+            return Error::FsFailedOpenFile;
+        }
+
+        char     line[Channel::maxLine];
+        uint64_t lines = 0;
+        uint64_t bytes = file->size();
+        Error    err;
+
+        Timer timer;
+        while ((err = file->pollLine(line)) == Error::Ok) {
+            ++lines;
+        }
+        double seconds = timer.seconds();
+        delete file;
+
+        if (err != Error::Eof) {
+            log_error_to(out, "Read failed: " << errorString(err));
+            return err;
+        }
+        report(out, "File lines", lines, "lines", seconds);
+        report(out, "File bytes", bytes, "bytes", seconds);
+        return Error::Ok;
+    }
+
+    // Time to traverse a planner block, from its entry speed to the given exit speed,
+    // using the same trapezoid that the segment generator traces.
+    static float block_minutes(plan_block_t* block, float exit_speed_sqr) {
+        float nominal     = plan_compute_profile_nominal_speed(block);
+        float entry       = sqrtf(block->entry_speed_sqr);
+        float exit        = sqrtf(exit_speed_sqr);
+        float accel       = block->acceleration;
+        float inv_2_accel = 0.5f / accel;
+        float accel_mm    = inv_2_accel * (nominal * nominal - block->entry_speed_sqr);
+        float decel_mm    = inv_2_accel * (nominal * nominal - exit_speed_sqr);
+        if (accel_mm + decel_mm <= block->millimeters) {
+            return (nominal - entry) / accel + (nominal - exit) / accel + (block->millimeters - accel_mm - decel_mm) / nominal;
+        }
+        float peak = sqrtf(accel * block->millimeters + 0.5f * (block->entry_speed_sqr + exit_speed_sqr));
+        return (peak - entry) / accel + (peak - exit) / accel;
+    }
+
+    // Plans a reference 3D surfacing program - a raster over a tessellated
+    // surface - and returns the machine time that the planned velocity profiles
+    // would take.  Blocks are retired as soon as the buffer fills, as if the
+    // steppers were keeping up.
+    static double plan_surfacing(plan_line_data_t& pl_data, uint64_t& blocks) {
+        const float size = 50.0f, stepover = 1.0f, step = 1.0f;
+
+        float origin[MAX_N_AXIS];
+        plan_get_planner_mpos(origin);
+        float target[MAX_N_AXIS];
+        copyAxes(target, origin);
+
+        double minutes = 0;
+        auto   retire  = [&]() {
+            plan_block_t* block = plan_get_current_block();
+            minutes += block_minutes(block, plan_get_exec_block_exit_speed_sqr());
+            plan_discard_current_block();
+        };
+
+        bool forward = true;
+        for (float y = 0.0f; y <= size; y += stepover) {
+            for (float i = 0.0f; i <= size; i += step) {
+                float x        = forward ? i : size - i;
+                target[X_AXIS] = origin[X_AXIS] + x;
+                target[Y_AXIS] = origin[Y_AXIS] + y;
+                target[Z_AXIS] = origin[Z_AXIS] + 3.0f * sinf(x / 4.0f) * cosf(y / 9.0f);
+                while (plan_check_full_buffer()) {
+                    retire();
+                }
+                if (plan_buffer_line(target, &pl_data)) {
+                    ++blocks;
+                }
+            }
+            forward = !forward;
+        }
+        while (plan_get_current_block()) {
+            retire();
+        }
+        return minutes * 60.0;
+    }
+
+    // $Bench/Blend compares the planned execution time of a surfacing program
+    // in the G61, G61.1 and G64 path control modes, setting up the motions the
+    // way the g-code parser does.  The machine does not move.
+    static Error bench_blend(const char* value, AuthenticationLevel auth_level, Channel& out) {
+        if (plan_get_current_block()) {
+            return Error::IdleError;
+        }
+
+        struct {
+            const char* name;
+            ControlMode control;
+        } modes[] = {
+            { "G61", ControlMode::ExactPath },
+            { "G61.1", ControlMode::ExactStop },
+            { "G64", ControlMode::Continuous },
+        };
+
+        for (auto& mode : modes) {
+            plan_line_data_t pl_data = {};
+            pl_data.feed_rate        = 5000.0f;
+            pl_data.is_jog           = true;  // Skips the homing check; the blocks never reach the steppers
+            pl_data.motion.exactStop = mode.control == ControlMode::ExactStop;
+
+            uint64_t blocks = 0;
+            Timer    timer;
+            double   machine_seconds = plan_surfacing(pl_data, blocks);
+            double   seconds         = timer.seconds();
+
+            plan_reset();
+            plan_sync_position();
+
+            log_stream(out, mode.name << ": machine time " << machine_seconds << " s");
+            report_cost(out, "  Planning", blocks, seconds);
+        }
+        return Error::Ok;
+    }
+
+    // $Bench/Planner measures the cost of plan_buffer_line() at several planner
+    // buffer depths, planning a circle made of short segments at a high feed rate,
+    // and reports the machine time of the resulting plan.  The machine does not move.
+    static Error bench_planner(const char* value, AuthenticationLevel auth_level, Channel& out) {
+        if (plan_get_current_block()) {
+            return Error::IdleError;
+        }
+        const int   depths[]   = { 16, 64, 256, 1024, 4000 };
+        const int   segments   = 20000;
+        const float radius     = 20.0f;
+        const int   saved_size = config->_planner_blocks;
+
+        plan_line_data_t pl_data = {};
+        pl_data.feed_rate        = 20000.0f;
+        pl_data.is_jog           = true;  // Skips the homing check; the blocks never reach the steppers
+
+        for (int depth : depths) {
+            config->_planner_blocks = depth;
+            plan_init();
+            plan_reset();
+            plan_sync_position();
+            if (config->_planner_blocks != depth) {
+                break;  // Could not allocate the buffer
+            }
+
+            float origin[MAX_N_AXIS];
+            plan_get_planner_mpos(origin);
+            float target[MAX_N_AXIS];
+            copyAxes(target, origin);
+
+            double minutes = 0;
+            Timer  timer;
+            for (int i = 1; i <= segments; i++) {
+                float angle    = i * 0.1f / radius;  // 0.1 mm segments
+                target[X_AXIS] = origin[X_AXIS] + radius * (cosf(angle) - 1.0f);
+                target[Y_AXIS] = origin[Y_AXIS] + radius * sinf(angle);
+                while (plan_check_full_buffer()) {
+                    plan_block_t* block = plan_get_current_block();
+                    minutes += block_minutes(block, plan_get_exec_block_exit_speed_sqr());
+                    plan_discard_current_block();
+                }
+                plan_buffer_line(target, &pl_data);
+            }
+            double seconds = timer.seconds();
+            while (plan_block_t* block = plan_get_current_block()) {
+                minutes += block_minutes(block, plan_get_exec_block_exit_speed_sqr());
+                plan_discard_current_block();
+            }
+
+            log_stream(out, "Planner blocks " << depth << ": machine time " << minutes * 60.0 << " s");
+            report_cost(out, "  plan_buffer_line", segments, seconds);
+        }
+
+        config->_planner_blocks = saved_size;
+        plan_init();
+        plan_reset();
+        plan_sync_position();
+        return Error::Ok;
+    }
+
+    // A step engine that does nothing, so the stepper ISR can be driven
+    // directly at full speed without touching the step timer or the pins.
+    static uint32_t null_init(uint32_t dir_delay_us, uint32_t pulse_delay_us, uint32_t& frequency, bool (*fn)(void)) {
+        return pulse_delay_us;
+    }
+    static uint32_t null_init_step_pin(pinnum_t pin, bool inverted) {
+        return pin;
+    }
+    static void null_set_pin(pinnum_t pin, bool level) {}
+    static void null_action() {}
+    static bool null_start_unstep() {
+        return false;
+    }
+    static uint32_t null_max_pulses_per_sec() {
+        return 1000000;
+    }
+    static void null_set_timer_ticks(uint32_t ticks) {}
+
+    // clang-format off
+    static step_engine_t null_engine = {
+        "Null",
+        null_init,
+        null_init_step_pin,
+        null_set_pin,
+        null_action,
+        null_action,
+        null_set_pin,
+        null_action,
+        null_start_unstep,
+        null_action,
+        null_max_pulses_per_sec,
+        null_set_timer_ticks,
+        null_action,
+        null_action,
+        NULL
+    };
+    // clang-format on
+
+    // Reference programs for the pipeline benchmark
+    using Corpus = std::vector<std::string>;
+
+    static void add_line(Corpus& corpus, const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+    static void add_line(Corpus& corpus, const char* fmt, ...) {
+        char    line[Channel::maxLine];
+        va_list args;
+        va_start(args, fmt);
+        vsnprintf(line, sizeof(line), fmt, args);
+        va_end(args);
+        corpus.emplace_back(line);
+    }
+
+    // Raster finishing pass over a tessellated 3D surface
+    static Corpus surfacing_corpus() {
+        Corpus corpus;
+        add_line(corpus, "G21G90G94G17F3000");
+        bool forward = true;
+        for (int y = 0; y <= 50; y++) {
+            for (int i = 0; i <= 50; i++) {
+                int x = forward ? i : 50 - i;
+                add_line(corpus, "G1X%dY%dZ%.3f", x, y, 3.0f * sinf(x / 4.0f) * cosf(y / 9.0f));
+            }
+            forward = !forward;
+        }
+        return corpus;
+    }
+
+    // Grayscale laser image, one short move per pixel with its own power
+    static Corpus laser_corpus() {
+        Corpus corpus;
+        add_line(corpus, "G21G90G94G17F6000S0");
+        for (int row = 0; row < 100; row++) {
+            float y = row * 0.2f;
+            add_line(corpus, "G0X0Y%.1f", y);
+            for (int px = 1; px <= 200; px++) {
+                int power = int(500 + 499 * sinf(px / 7.0f) * cosf(row / 5.0f));
+                add_line(corpus, "G1X%.1fS%d", px * 0.2f, power);
+            }
+        }
+        return corpus;
+    }
+
+    // Chains of semicircles, alternating direction, with a helical lead-in on each row
+    static Corpus arcs_corpus() {
+        Corpus corpus;
+        add_line(corpus, "G21G90G94G17F2000");
+        for (int row = 0; row < 50; row++) {
+            int y = row * 10;
+            add_line(corpus, "G0X0Y%dZ1", y);
+            add_line(corpus, "G2X0Y%dZ0I2J0", y);
+            for (int i = 0; i < 10; i++) {
+                add_line(corpus, "%sX%dY%dI2.5J0", i & 1 ? "G3" : "G2", (i + 1) * 5, y);
+            }
+        }
+        return corpus;
+    }
+
+    // The moves and parameter arithmetic of a grid probing macro.  The probe
+    // moves are plain feeds because the host build has no probe input.
+    static Corpus probing_corpus() {
+        Corpus corpus;
+        add_line(corpus, "G21G90G94G17");
+        add_line(corpus, "#<pitch>=5");
+        add_line(corpus, "#<retract>=3");
+        add_line(corpus, "#<feed>=300");
+        add_line(corpus, "#<count>=0");
+        for (int j = 0; j < 10; j++) {
+            for (int i = 0; i < 10; i++) {
+                int col = j & 1 ? 9 - i : i;
+                add_line(corpus, "G90G0X[#<pitch>*%d]Y[#<pitch>*%d]", col, j);
+                add_line(corpus, "G91G1Z[0-#<retract>]F[#<feed>]");
+                add_line(corpus, "G1Z[#<retract>*0.5]F[#<feed>*2]");
+                add_line(corpus, "G1Z[0-#<retract>*0.5]F[#<feed>/4]");
+                add_line(corpus, "#<count>=[#<count>+1]");
+                add_line(corpus, "G0Z[#<retract>]");
+            }
+        }
+        add_line(corpus, "G90");
+        return corpus;
+    }
+
+    // Runs the segment generator and the stepper ISR, as the main loop and the
+    // step timer would, until the planner has room for reserve blocks or the
+    // motion is finished.
+    static void run_steppers(plan_index_t reserve, uint64_t& isr_calls) {
+        Stepper::prep_buffer();
+        Stepper::wake_up();
+        while (plan_get_block_buffer_available() < reserve && Stepper::pulse_func()) {
+            ++isr_calls;
+            Stepper::prep_buffer();
+        }
+    }
+
+    // Executes a program through the whole motion pipeline - parser, motion
+    // control, planner, segment generator and stepper ISR - and reports the throughput.
+    static Error run_pipeline(Channel& out, const char* name, const Corpus& corpus) {
+        // Leave room in the planner for the longest arc, so that motion control never
+        // waits for the steppers; they only run here, between lines.  The arcs in the
+        // reference programs need fewer than 128 blocks.
+        const plan_index_t reserve = plan_index_t(config->_planner_blocks / 2);
+
+        parser_state_t saved_gc = gc_state;
+        steps_t        saved_steps[MAX_N_AXIS];
+        auto           n_axis = Axes::_numberAxis;
+        for (axis_t axis = X_AXIS; axis < n_axis; axis++) {
+            saved_steps[axis] = Machine::Stepping::getSteps(axis);
+        }
+
+        Stepper::reset_stats();
+        uint64_t blocks    = 0;
+        uint64_t isr_calls = 0;
+        uint64_t allocs    = allocations();
+        Error    err       = Error::Ok;
+
+        Timer timer;
+        for (auto& line : corpus) {
+            plan_index_t available = plan_get_block_buffer_available();
+            err                    = gc_execute_line(line.c_str());
+            if (err != Error::Ok) {
+                log_error_to(out, name << " failed at " << line << ": " << errorString(err));
+                break;
+            }
+            blocks += available - plan_get_block_buffer_available();
+            run_steppers(reserve, isr_calls);
+        }
+        run_steppers(plan_index_t(~0), isr_calls);
+        double seconds = timer.seconds();
+        allocs         = allocations() - allocs;
+
+        Stepper::reset();
+        plan_reset();
+        for (axis_t axis = X_AXIS; axis < n_axis; axis++) {
+            Machine::Stepping::setSteps(axis, saved_steps[axis]);
+        }
+        gc_state = saved_gc;
+        gc_sync_position();
+        plan_sync_position();
+
+        if (err != Error::Ok) {
+            return err;
+        }
+        uint64_t lines = corpus.size();
+        log_stream(out, name << ":");
+        report(out, "  Lines", lines, "lines", seconds);
+        report(out, "  Blocks", blocks, "blocks", seconds);
+        report(out, "  Segments", Stepper::stats.prep_segments, "segments", seconds);
+        report(out, "  ISR", isr_calls, "calls", seconds);
+        log_stream(out, "  Allocations: " << allocs << " total, " << float(allocs) / lines << " per line");
+        return Error::Ok;
+    }
+
+    // $Bench/Pipeline[=/path] runs reference programs - 3D surfacing, a laser
+    // raster, arcs and a probing macro - or the given file through the real
+    // parser, planner and segment generator, with the stepper ISR driving a
+    // null step engine instead of the step timer.  The machine does not move,
+    // and the motion statistics ($SM) are reset.
+    static Error bench_pipeline(const char* value, AuthenticationLevel auth_level, Channel& out) {
+        if (plan_get_current_block()) {
+            return Error::IdleError;
+        }
+
+        std::vector<std::pair<std::string, Corpus>> corpora;
+        if (value && *value) {
+            std::string path(value);
+            if (path[0] != '/') {
+                path = "/" + path;
+            }
+            Corpus corpus;
+            try {
+                InputFile file(SD, path.c_str());
+                char      line[Channel::maxLine];
+                while (file.pollLine(line) == Error::Ok) {
+                    corpus.emplace_back(line);
+                }
+            } catch (const ErrorException& ex) {
+                log_error_to(out, ex.what());
+                return ex.error();
+            } catch (std::filesystem::filesystem_error const& ex) {
+                log_error_to(out, ex.what());
+                return Error::FsFailedOpenFile;
+            }
+            corpora.emplace_back(path, std::move(corpus));
+        } else {
+            corpora.emplace_back("Surfacing", surfacing_corpus());
+            corpora.emplace_back("Laser raster", laser_corpus());
+            corpora.emplace_back("Arcs", arcs_corpus());
+            corpora.emplace_back("Probing macro", probing_corpus());
+        }
+
+        // A long arc can produce more blocks than a small planner holds
+        const int saved_size = config->_planner_blocks;
+        if (saved_size < 256) {
+            config->_planner_blocks = 256;
+            plan_init();
+            plan_reset();
+            plan_sync_position();
+        }
+        auto saved_engine          = Machine::Stepping::_engine;
+        Machine::Stepping::_engine = &null_engine;
+
+        Error err = Error::Ok;
+        for (auto& corpus : corpora) {
+            if ((err = run_pipeline(out, corpus.first.c_str(), corpus.second)) != Error::Ok) {
+                break;
+            }
+        }
+
+        Machine::Stepping::_engine = saved_engine;
+        if (config->_planner_blocks != saved_size) {
+            config->_planner_blocks = saved_size;
+            plan_init();
+            plan_reset();
+            plan_sync_position();
+        }
+        return err;
+    }
+
+    // Executes every line of a program in check mode, passes times over, and
+    // returns the elapsed time, or a negative number if a line fails.
+    static double run_check_mode(Channel& out, const char* name, const Corpus& corpus, int passes) {
+        parser_state_t saved_gc = gc_state;
+        Timer          timer;
+        for (int pass = 0; pass < passes; pass++) {
+            for (auto& line : corpus) {
+                Error err = gc_execute_line(line.c_str());
+                if (err != Error::Ok) {
+                    log_error_to(out, name << " failed: " << errorString(err));
+                    gc_state = saved_gc;
+                    return -1;
+                }
+            }
+        }
+        double seconds = timer.seconds();
+        gc_state       = saved_gc;
+        return seconds;
+    }
+
+    // $Bench/Binary[=passes] encodes the reference programs as binary GCode
+    // lines (see GCodeBinary.h) and compares their size, and the time to
+    // execute them in check mode - parsing and checking every line without
+    // planning any motion - with the text.
+    static Error bench_binary(const char* value, AuthenticationLevel auth_level, Channel& out) {
+        int passes = 10;
+        if (value && *value) {
+            char* end;
+            passes = strtol(value, &end, 10);
+            if (*end || passes <= 0) {
+                log_string(out, "Invalid count");
+                return Error::InvalidValue;
+            }
+        }
+        if (!state_is(State::Idle)) {
+            return Error::IdleError;
+        }
+
+        std::vector<std::pair<const char*, Corpus>> corpora;
+        corpora.emplace_back("Surfacing", surfacing_corpus());
+        corpora.emplace_back("Laser raster", laser_corpus());
+        corpora.emplace_back("Arcs", arcs_corpus());
+        corpora.emplace_back("Probing macro", probing_corpus());
+
+        set_state(State::CheckMode);
+        Error err = Error::Ok;
+        for (auto& [name, text] : corpora) {
+            Corpus binary;
+            size_t text_bytes = 0, binary_bytes = 0, converted = 0;
+            for (auto& line : text) {
+                char   encoded[128];
+                size_t length = GCodeBinary::encode(line.c_str(), encoded, sizeof(encoded));
+                if (length) {
+                    binary.emplace_back(encoded, length);
+                    ++converted;
+                } else {
+                    binary.push_back(line);
+                }
+                text_bytes += line.length() + 1;
+                binary_bytes += binary.back().length() + 1;
+            }
+
+            double text_seconds   = run_check_mode(out, name, text, passes);
+            double binary_seconds = run_check_mode(out, name, binary, passes);
+            if (text_seconds < 0 || binary_seconds < 0) {
+                err = Error::GcodeUnsupportedCommand;
+                break;
+            }
+            uint64_t lines = uint64_t(text.size()) * passes;
+            log_stream(out,
+                       name << ": " << text.size() << " lines, " << converted << " binary, " << text_bytes << " bytes as text, "
+                            << binary_bytes << " as binary (" << 100.0f * (text_bytes - binary_bytes) / text_bytes << "% smaller)");
+            report_cost(out, "  Text line", lines, text_seconds);
+            report_cost(out, "  Binary line", lines, binary_seconds);
+        }
+        set_state(State::Idle);
+        return err;
+    }
+
+    // Collects characters into a heap string, the way LogStream used to
+    class StringSink : public Print {
+    public:
+        std::string* _line = new std::string();
+        ~StringSink() { delete _line; }
+        size_t write(uint8_t c) override {
+            *_line += (char)c;
+            return 1;
+        }
+    };
+
+    static std::string stream_axis_values(const float* axis_value) {
+        std::string msg;
+        auto        n_axis = Axes::_numberAxis;
+        for (axis_t axis = X_AXIS; axis < n_axis; axis++) {
+            float value = axis_value[axis];
+            int   decimals;
+            if (is_linear(axis) && config->_reportInches) {
+                value /= MM_PER_INCH;
+                decimals = 4;
+            } else {
+                decimals = 3;
+            }
+            msg += formatFloat(value, decimals);
+            if (axis < (n_axis - 1)) {
+                msg += ",";
+            }
+        }
+        return msg;
+    }
+
+    // The status report as it was formatted before format_realtime_status(),
+    // with LogStream-style streaming, for comparison
+    static void stream_realtime_status(Channel& channel) {
+        static Counter ovr_counter = 0, wco_counter = 0;
+
+        StringSink msg;
+        msg << "<" << state_name();
+        float* print_position = get_mpos();
+        if (bits_are_true(status_mask->get(), RtStatus::Position)) {
+            msg << "|MPos:";
+        } else {
+            msg << "|WPos:";
+            mpos_to_wpos(print_position);
+        }
+        msg << stream_axis_values(print_position).c_str();
+        if (bits_are_true(status_mask->get(), RtStatus::Buffer)) {
+            msg << "|Bf:" << plan_get_block_buffer_available() << "," << channel.rx_buffer_available();
+        }
+        float rate = Stepper::get_realtime_rate();
+        if (config->_reportInches) {
+            rate /= MM_PER_INCH;
+        }
+        msg << "|FS:" << setprecision(0) << rate << "," << sys.spindle_speed();
+        if (report_pin_string.length()) {
+            msg << "|Pn:" << report_pin_string;
+        }
+        if (wco_counter > 0) {
+            wco_counter--;
+        } else {
+            wco_counter = REPORT_WCO_REFRESH_IDLE_COUNT - 1;
+            if (ovr_counter == 0) {
+                ovr_counter = 1;
+            }
+            msg << "|WCO:" << stream_axis_values(get_wco()).c_str();
+        }
+        if (ovr_counter > 0) {
+            ovr_counter--;
+        } else {
+            ovr_counter = REPORT_OVR_REFRESH_IDLE_COUNT - 1;
+            msg << "|Ov:" << int(sys.f_override()) << "," << int(sys.r_override()) << "," << int(sys.spindle_speed_ovr());
+        }
+        msg << ">";
+    }
+
+    // $Bench/Status[=count] compares the cost of formatting a realtime status
+    // report the old way, by streaming into a heap string, with
+    // format_realtime_status().  Reports are formatted but not sent.
+    static Error bench_status(const char* value, AuthenticationLevel auth_level, Channel& out) {
+        int count = 100000;
+        if (value && *value) {
+            char* end;
+            count = strtol(value, &end, 10);
+            if (*end || count <= 0) {
+                log_string(out, "Invalid count");
+                return Error::InvalidValue;
+            }
+        }
+
+        uint64_t allocs = allocations();
+        Timer    timer;
+        for (int i = 0; i < count; i++) {
+            stream_realtime_status(out);
+        }
+        double seconds = timer.seconds();
+        report_cost(out, "Streamed status report", count, seconds);
+        log_stream(out, "  Allocations per report: " << float(allocations() - allocs) / count);
+
+        char   report[400];
+        size_t length = 0;
+        allocs        = allocations();
+        timer.restart();
+        for (int i = 0; i < count; i++) {
+            length = format_realtime_status(out, report, sizeof(report));
+        }
+        seconds = timer.seconds();
+        report_cost(out, "Formatted status report", count, seconds);
+        log_stream(out, "  Allocations per report: " << float(allocations() - allocs) / count);
+        log_string(out, std::string(report, length));
+        return Error::Ok;
+    }
+
+    // $Bench/ConfigItem[=count] compares reading and writing config items
+    // the way #</path> parameters in macros do, by walking the config tree
+    // with GCodeParam, with the lookups in ItemIndex.
+    static Error bench_config_item(const char* value, AuthenticationLevel auth_level, Channel& out) {
+        int count = 100000;
+        if (value && *value) {
+            char* end;
+            count = strtol(value, &end, 10);
+            if (*end || count <= 0) {
+                log_string(out, "Invalid count");
+                return Error::InvalidValue;
+            }
+        }
+
+        const std::string paths[] = {
+            "/axes/x/max_rate_mm_per_min",
+            "/axes/y/acceleration_mm_per_sec2",
+            "/axes/z/homing/seek_mm_per_min",
+            "/arc_tolerance_mm",
+        };
+        const int n_paths = sizeof(paths) / sizeof(paths[0]);
+
+        for (auto& path : paths) {
+            float walked = 0, indexed = 0;
+            try {
+                Configuration::GCodeParam gci(path.c_str(), walked, true);
+                config->group(gci);
+            } catch (...) {}
+            Configuration::ItemIndex::get(path, indexed);
+            if (walked != indexed) {
+                log_stream(out, "ItemIndex and GCodeParam values differ for " << path);
+            }
+        }
+
+        uint64_t allocs = allocations();
+        Timer    timer;
+        for (int i = 0; i < count; i++) {
+            float result;
+            try {
+                Configuration::GCodeParam gci(paths[i % n_paths].c_str(), result, true);
+                config->group(gci);
+            } catch (...) {}
+        }
+        double seconds = timer.seconds();
+        report_cost(out, "GCodeParam get", count, seconds);
+        log_stream(out, "  Allocations per get: " << float(allocations() - allocs) / count);
+
+        Configuration::ItemIndex::invalidate();
+        timer.restart();
+        size_t items = Configuration::ItemIndex::size();
+        seconds      = timer.seconds();
+        log_stream(out, "Index build: " << items << " items in " << seconds * 1e6 << " us");
+
+        allocs = allocations();
+        timer.restart();
+        for (int i = 0; i < count; i++) {
+            float result;
+            Configuration::ItemIndex::get(paths[i % n_paths], result);
+        }
+        seconds = timer.seconds();
+        report_cost(out, "ItemIndex get", count, seconds);
+        log_stream(out, "  Allocations per get: " << float(allocations() - allocs) / count);
+
+        // Write back the value that is already there, so the config is unchanged
+        float rate = 0;
+        Configuration::ItemIndex::get(paths[0], rate);
+        timer.restart();
+        for (int i = 0; i < count; i++) {
+            Configuration::GCodeParam gci(paths[0].c_str(), rate, false);
+            config->group(gci);
+        }
+        seconds = timer.seconds();
+        report_cost(out, "GCodeParam set", count, seconds);
+
+        timer.restart();
+        for (int i = 0; i < count; i++) {
+            Configuration::ItemIndex::set(paths[0], rate);
+        }
+        seconds = timer.seconds();
+        report_cost(out, "ItemIndex set", count, seconds);
+        return Error::Ok;
+    }
+
+    // $Bench/Expression[=count] compares evaluating NGC expressions from
+    // their text, as expression() does, with compiling them once and
+    // evaluating the CompiledExpression, as loop bodies in jobs do.
+    static Error bench_expression(const char* value, AuthenticationLevel auth_level, Channel& out) {
+        int count = 100000;
+        if (value && *value) {
+            char* end;
+            count = strtol(value, &end, 10);
+            if (*end || count <= 0) {
+                log_string(out, "Invalid count");
+                return Error::InvalidValue;
+            }
+        }
+
+        set_numbered_param(1, 3.0f);
+        set_numbered_param(2, 12.5f);
+        set_named_param("_bench_depth", -0.25f);
+
+        const char* expressions[] = {
+            "[#1*2+1]",
+            "[[#<_bench_depth>-0.1]*[2+3]]",
+            "[SIN[30]*#2+COS[60]*#1-SQRT[16]/4]",
+            "[#1LT10AND#2GT[100/8-1]]",
+        };
+        const int n_expressions = sizeof(expressions) / sizeof(expressions[0]);
+
+        CompiledExpression compiled[n_expressions];
+        for (int i = 0; i < n_expressions; i++) {
+            size_t pos = 0;
+            float  text_value, compiled_value;
+            if (!compiled[i].compile(expressions[i], pos) || compiled[i].evaluate(compiled_value) != Error::Ok) {
+                log_stream(out, "Cannot compile " << expressions[i]);
+                return Error::ExpressionSyntaxError;
+            }
+            pos = 0;
+            if (expression(expressions[i], pos, text_value) != Error::Ok || text_value != compiled_value) {
+                log_stream(out, "Compiled value differs for " << expressions[i]);
+            }
+            log_stream(out, expressions[i] << ": " << compiled[i].size() << " instructions");
+        }
+
+        float    sum    = 0;
+        uint64_t allocs = allocations();
+        Timer    timer;
+        for (int i = 0; i < count; i++) {
+            size_t pos = 0;
+            float  result;
+            expression(expressions[i % n_expressions], pos, result);
+            sum += result;
+        }
+        double seconds = timer.seconds();
+        report_cost(out, "Text expression", count, seconds);
+        log_stream(out, "  Allocations per expression: " << float(allocations() - allocs) / count);
+
+        allocs = allocations();
+        timer.restart();
+        for (int i = 0; i < count; i++) {
+            float result;
+            compiled[i % n_expressions].evaluate(result);
+            sum -= result;
+        }
+        seconds = timer.seconds();
+        report_cost(out, "Compiled expression", count, seconds);
+        log_stream(out, "  Allocations per expression: " << float(allocations() - allocs) / count);
+
+        timer.restart();
+        for (int i = 0; i < count; i++) {
+            size_t             pos = 0;
+            CompiledExpression expr;
+            expr.compile(expressions[i % n_expressions], pos);
+        }
+        seconds = timer.seconds();
+        report_cost(out, "Compile", count, seconds);
+
+        log_stream(out, "Checksum: " << sum);
+        return Error::Ok;
+    }
+
+    class BenchmarkModule : public Module {
+    public:
+        explicit BenchmarkModule(const char* name) : Module(name) {}
+
+        void init() override {
+            new UserCommand(NULL, "Bench/File", bench_file, notIdleOrAlarm);
+            new UserCommand(NULL, "Bench/Blend", bench_blend, notIdleOrAlarm);
+            new UserCommand(NULL, "Bench/Planner", bench_planner, notIdleOrAlarm);
+            new UserCommand(NULL, "Bench/Pipeline", bench_pipeline, notIdleOrAlarm);
+            new UserCommand(NULL, "Bench/Binary", bench_binary, notIdleOrAlarm);
+            new UserCommand(NULL, "Bench/Status", bench_status, anyState);
+            new UserCommand(NULL, "Bench/ConfigItem", bench_config_item, notIdleOrAlarm);
+            new UserCommand(NULL, "Bench/Expression", bench_expression, anyState);
+        }
+    };
+
+    ModuleFactory::InstanceBuilder<BenchmarkModule> benchmark_module __attribute__((init_priority(110))) ("benchmarks", true);
+}
@@ -238,7 +238,7 @@ public:
         return false;
     }
     Error pollLine(char* line) override {
-        if (line && _queue.empty() && _exit_after_cmds) {
+        if (line && !queued_bytes() && _exit_after_cmds) {
             cleanup_threads();
             exit(0);
         }
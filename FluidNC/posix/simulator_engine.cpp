@@ -10,6 +10,7 @@
 #include "freertos/semphr.h"
 #include "freertos/task.h"
 #include "freertos/queue.h"
+#include "Capture.h"
 
 bool simulator_ws_has_client = false;
 
@@ -201,8 +202,16 @@ static void start_timer() {
     _segment_state.duration = 0;
 
     // Call the pulse function until it returns false
+    uint64_t elapsed = 0;
     while (_pulse_func()) {
         _segment_state.duration += _segment_state.ticks;
+        elapsed += _segment_state.ticks;
+    }
+
+    // In virtual time mode, the motion takes as long as its step periods add up to
+    auto& capture = Capture::instance();
+    if (capture.isVirtualTime()) {
+        capture.advanceTo(capture.micros() + elapsed);
     }
 }
 
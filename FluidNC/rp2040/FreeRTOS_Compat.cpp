@@ -21,6 +21,9 @@ static inline void* get_current_sp() {
     return sp;
 }
 
+// Lowest free heap that xPortGetFreeHeapSize() has seen
+static size_t min_free_heap = SIZE_MAX;
+
 // RP2040 has 264KB of SRAM total
 // Starting from SRAM base at 0x20000000, ending at 0x20042000
 extern "C" size_t xPortGetFreeHeapSize() {
@@ -35,12 +38,19 @@ extern "C" size_t xPortGetFreeHeapSize() {
     
     // Calculate free heap: space between heap start and current stack top
     // This represents the available memory for heap before it would collide with the stack
-    if (stack_top > heap_start) {
-        return stack_top - heap_start;
-    }
-    
     // If stack pointer is not above heap, something is wrong; return 0 or a safe value
-    return 0;
+    size_t free_heap = stack_top > heap_start ? stack_top - heap_start : 0;
+    if (free_heap < min_free_heap) {
+        min_free_heap = free_heap;
+    }
+    return free_heap;
+}
+
+// There is no allocator hook, so the low-water mark is only as good as the
+// calls to xPortGetFreeHeapSize()
+extern "C" size_t xPortGetMinimumEverFreeHeapSize() {
+    xPortGetFreeHeapSize();
+    return min_free_heap;
 }
 
 extern "C" bool backtrace_available(void) {
@@ -0,0 +1,69 @@
+// Copyright (c) 2026 - FluidNC Contributors
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#pragma once
+
+// BufferPool is a fixed set of equal-sized buffers that any task can take
+// and give back without locks or heap allocation.  A bit in an atomic mask
+// marks each buffer that is in use, so acquire() and release() are a single
+// compare-and-swap or fetch-and on that mask.  There are at most 32 buffers.
+//
+// acquire() returns nullptr when every buffer is in use; the caller is
+// expected to fall back to something slower, and exhausted() counts how often
+// that happened.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+template <size_t Count, size_t Size>
+class BufferPool {
+    static_assert(Count >= 1 && Count <= 32, "BufferPool holds 1 to 32 buffers");
+
+    static constexpr uint32_t _all = Count == 32 ? ~uint32_t(0) : (uint32_t(1) << Count) - 1;
+
+    char                  _buffers[Count][Size];
+    std::atomic<uint32_t> _in_use { 0 };
+
+    // Statistics
+    std::atomic<uint32_t> _high_water { 0 };
+    std::atomic<uint32_t> _exhausted { 0 };
+
+public:
+    static constexpr size_t count() { return Count; }
+    static constexpr size_t buffer_size() { return Size; }
+
+    char* acquire() {
+        uint32_t used = _in_use.load(std::memory_order_relaxed);
+        uint32_t bit;
+        do {
+            uint32_t available = ~used & _all;
+            if (!available) {
+                _exhausted.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+            }
+            bit = available & (~available + 1);  // Lowest free buffer
+        } while (!_in_use.compare_exchange_weak(used, used | bit, std::memory_order_acquire, std::memory_order_relaxed));
+
+        uint32_t n    = __builtin_popcount(used | bit);
+        uint32_t high = _high_water.load(std::memory_order_relaxed);
+        while (n > high && !_high_water.compare_exchange_weak(high, n, std::memory_order_relaxed)) {}
+
+        return _buffers[__builtin_ctz(bit)];
+    }
+
+    void release(const char* buffer) {
+        size_t index = (buffer - _buffers[0]) / Size;
+        _in_use.fetch_and(~(uint32_t(1) << index), std::memory_order_release);
+    }
+
+    bool owns(const char* p) const { return p >= _buffers[0] && p < _buffers[0] + Count * Size; }
+
+    size_t   in_use() const { return __builtin_popcount(_in_use.load(std::memory_order_relaxed)); }
+    size_t   high_water() const { return _high_water.load(std::memory_order_relaxed); }
+    uint32_t exhausted() const { return _exhausted.load(std::memory_order_relaxed); }
+    void     reset_stats() {
+        _high_water = in_use();
+        _exhausted  = 0;
+    }
+};
@@ -9,9 +9,13 @@
 #include "Limit.h"
 #include "Logging.h"
 #include "Job.h"
+#include "Config.h"
+#include "GCodeBinary.h"
 #include <string_view>
 #include <algorithm>
 
+static_assert(Telemetry::max_frame_size <= MESSAGE_BUFFER_SIZE, "Telemetry frames must fit in message buffers");
+
 namespace {
     constexpr TickType_t message_queue_retry_ticks = 10;
     constexpr uint32_t   message_queue_max_retries = 25;
@@ -100,32 +104,32 @@ void Channel::resume() {
 }
 
 void Channel::flushRx() {
-    _linelen   = 0;
-    _lastWasCR = false;
-    xSemaphoreTake(_queue_mutex, portMAX_DELAY);
-    while (_queue.size()) {
-        _queue.pop();
-    }
-    xSemaphoreGive(_queue_mutex);
+    _flush_requested.store(true, std::memory_order_release);
 }
 
-size_t Channel::queued_bytes() const {
-    xSemaphoreTake(_queue_mutex, portMAX_DELAY);
-    auto size = _queue.size();
-    xSemaphoreGive(_queue_mutex);
-    return size;
+Channel::RxQueue* Channel::rx_queue() {
+    auto queue = rx_queue_if_any();
+    if (queue) {
+        return queue;
+    }
+    auto     fresh    = new RxQueue();
+    RxQueue* expected = nullptr;
+    if (_queue.compare_exchange_strong(expected, fresh, std::memory_order_acq_rel)) {
+        return fresh;
+    }
+    delete fresh;
+    return expected;
 }
 
-bool Channel::try_pop_queued_byte(uint8_t& byte) {
-    xSemaphoreTake(_queue_mutex, portMAX_DELAY);
-    if (_queue.empty()) {
-        xSemaphoreGive(_queue_mutex);
-        return false;
+void Channel::take_flush() {
+    if (_flush_requested.load(std::memory_order_acquire) && _flush_requested.exchange(false)) {
+        _linelen    = 0;
+        _lastWasCR  = false;
+        _binaryLine = false;
+        if (auto queue = rx_queue_if_any()) {
+            queue->clear();
+        }
     }
-    byte = _queue.front();
-    _queue.pop();
-    xSemaphoreGive(_queue_mutex);
-    return true;
 }
 
 bool Channel::lineComplete(char* line, char ch) {
@@ -178,14 +182,17 @@ bool Channel::lineComplete(char* line, char ch) {
     return false;
 }
 
-uint32_t Channel::setReportInterval(uint32_t ms) {
+uint32_t Channel::setReportInterval(uint32_t ms, bool binary) {
     uint32_t actual = ms;
     if (actual) {
-        actual = std::max(actual, uint32_t(50));
+        // Binary frames are cheap enough to send at up to 100 Hz
+        actual = std::max(actual, uint32_t(binary ? 10 : 50));
     }
     _reportInterval = actual;
+    _binaryReports  = binary && actual;
     _nextReportTime = int32_t(xTaskGetTickCount());
     _lastTool       = 255;  // Force GCodeState report
+    _telemetry.reset();
     return actual;
 }
 static bool motionState() {
@@ -212,7 +219,45 @@ void Channel::autoReportGCodeState() {
         _lastFeedRate     = gc_state.feed_rate;
     }
 }
+// Sends a telemetry frame if anything changed since the last one.  Each
+// frame depends on the previous one, so the encoder is not touched unless
+// the frame can be queued, and if it is lost anyway the next one is a keyframe.
+void Channel::autoReportTelemetry() {
+    int32_t now = int32_t(xTaskGetTickCount());
+    if ((now - _nextReportTime) < 0) {
+        return;
+    }
+    _nextReportTime = now + _reportInterval;
+
+    uint8_t* frame = reinterpret_cast<uint8_t*>(message_buffer_acquire());
+    if (!frame) {
+        _telemetry.reset();
+        return;
+    }
+    bool keyframe = (now - _nextKeyframeTime) >= 0;
+    if (keyframe) {
+        _nextKeyframeTime = now + TELEMETRY_KEYFRAME_INTERVAL;
+    }
+
+    Telemetry::Sample sample;
+    sample_telemetry(sample);
+    if (_telemetry.encode(sample, frame, keyframe)) {
+        sendPooledFrame(frame);
+    } else {
+        message_buffer_release(reinterpret_cast<char*>(frame));
+    }
+}
+
 void Channel::autoReport() {
+    if (_binaryReports) {
+        autoReportTelemetry();
+        if (_reportNgc != CoordIndex::End) {
+            report_ngc_coord(_reportNgc, *this);
+            _reportNgc = CoordIndex::End;
+        }
+        autoReportGCodeState();
+        return;
+    }
     if (_reportInterval) {
         const char* stateName = state_name();
         if (_reportOvr || _reportWco || _reportState || _lastPinString != report_pin_string ||
@@ -297,17 +342,40 @@ void Channel::push(uint8_t byte) {
     if (is_realtime_command(byte)) {
         handleRealtimeCharacter(byte);
     } else {
-        xSemaphoreTake(_queue_mutex, portMAX_DELAY);
-        _queue.push(byte);
-        xSemaphoreGive(_queue_mutex);
+        rx_queue()->push(byte);
     }
 }
+
+void Channel::push(const uint8_t* data, size_t length) {
+    // Queue runs of ordinary characters in bulk
+    while (length) {
+        size_t run = 0;
+        while (run < length && !is_realtime_command(data[run])) {
+            ++run;
+        }
+        if (run) {
+            rx_queue()->push(data, run);
+            data += run;
+            length -= run;
+        } else {
+            handleRealtimeCharacter(*data++);
+            --length;
+        }
+    }
+}
+
 static int  _cnt = 10;
 Error       Channel::pollLine(char* line) {
     if (_paused) {
         return Error::Ok;
     }
     handle();
+    take_flush();
+    auto queue = rx_queue_if_any();
+    if (line && queue && queue->full_count() != _reported_overruns) {
+        _reported_overruns = queue->full_count();
+        log_warn(name() << " input overrun, characters were lost");
+    }
     while (1) {
         if (_cnt) {
             --_cnt;
@@ -328,9 +396,11 @@ Error       Channel::pollLine(char* line) {
             continue;
         }
         if (!line) {
-            xSemaphoreTake(_queue_mutex, portMAX_DELAY);
-            _queue.push(ch);
-            xSemaphoreGive(_queue_mutex);
+            queue = rx_queue();
+            queue->push(uint8_t(ch));
+            if (!queue->free_space()) {
+                break;  // Leave the rest in the device until lines are collected
+            }
             continue;
         }
         // Fall through if line is non-null and it is not a realtime character
@@ -339,6 +409,14 @@ Error       Channel::pollLine(char* line) {
             --_cnt;
         }
 
+        if (_binaryLine || (_binaryGCode && ch == GCodeBinary::marker)) {
+            // Binary lines bypass line editing, which would take their bytes as keystrokes
+            _binaryLine = !Channel::lineComplete(line, ch);
+            if (!_binaryLine) {
+                return Error::Ok;
+            }
+            continue;
+        }
         if (lineComplete(line, ch)) {
             return Error::Ok;
         }
@@ -391,6 +469,12 @@ void Channel::print_msg(MsgLevel level, const char* msg) {
     }
 }
 
+void Channel::print_line(MsgLevel level, const char* line, size_t length) {
+    if (_message_level >= level) {
+        write(reinterpret_cast<const uint8_t*>(line), length);
+    }
+}
+
 // This overload is used primarily with fixed string
 // values.  It sends a pointer to the string whose
 // memory does not need to be reclaimed later.
@@ -398,7 +482,7 @@ void Channel::print_msg(MsgLevel level, const char* msg) {
 // with fixed messages.
 void Channel::sendLine(MsgLevel level, const char* line) {
     if (outputTask && try_acquire_log_ref()) {
-        LogMessage msg { this, (void*)line, level, false };
+        LogMessage msg { this, (void*)line, level, LineStorage::Static };
         if (!enqueue_log_message(msg)) {
             release_log_ref();
         }
@@ -419,7 +503,7 @@ void Channel::sendLine(MsgLevel level, const char* line) {
 // is allocated once and freed once.
 void Channel::sendLine(MsgLevel level, const std::string* line) {
     if (outputTask && try_acquire_log_ref()) {
-        LogMessage msg { this, (void*)line, level, true };
+        LogMessage msg { this, (void*)line, level, LineStorage::Heap };
         if (!enqueue_log_message(msg)) {
             release_log_ref();
             delete line;
@@ -432,25 +516,76 @@ void Channel::sendLine(MsgLevel level, const std::string* line) {
     }
 }
 
+// This is used with LogStream, which builds most messages in a
+// buffer from the message pool.  The output task releases the
+// buffer after the message is forwarded to the output channel,
+// so no memory is allocated on the heap.
+void Channel::sendPooledLine(MsgLevel level, char* line) {
+    if (outputTask && try_acquire_log_ref()) {
+        LogMessage msg { this, (void*)line, level, LineStorage::Pooled };
+        if (!enqueue_log_message(msg)) {
+            release_log_ref();
+            message_buffer_release(line);
+        }
+    } else {
+        if (!_closing.load(std::memory_order_acquire)) {
+            print_msg(level, line);
+        }
+        message_buffer_release(line);
+    }
+}
+
+// Telemetry frames are sent often and each one can be replaced by
+// the next, so a frame is dropped rather than waiting for the queue.
+void Channel::sendPooledFrame(uint8_t* frame) {
+    LogMessage msg { this, frame, MsgLevelNone, LineStorage::Frame };
+    if (!outputTask || !try_acquire_log_ref()) {
+        _telemetry.reset();
+        message_buffer_release(reinterpret_cast<char*>(frame));
+        return;
+    }
+    if (!message_queue || !xQueueSend(message_queue, &msg, 0)) {
+        _telemetry.reset();
+        release_log_ref();
+        message_buffer_release(reinterpret_cast<char*>(frame));
+    }
+}
+
+void Channel::print_frame(const uint8_t* frame, size_t length) {
+    write(frame, length);
+}
+
 // This overload is used for many miscellaneous messages
 // where the std::string is allocated in a code block and
-// then extended with various information.  This send_line()
-// copies that string to a newly allocated one and sends that
-// via the std::string* version of send_line().  The original
+// then extended with various information.  The original
 // string is freed by the caller sometime after send_line()
-// returns, while the new string is freed by the output task
-// after the message is forwarded to the output channel.
-// This is the least efficient form, requiring two strings
-// to be allocated and freed, with an intermediate copy.
-// It is used only rarely.
+// returns, so send_line() copies it and sends the copy.
 void Channel::sendLine(MsgLevel level, const std::string& line) {
     if (outputTask) {
-        sendLine(level, new std::string(line));
+        sendLine(level, line.c_str(), line.length());
     } else {
         print_msg(level, line.c_str());
     }
 }
 
+// The copy is in a pooled buffer, or in a newly allocated
+// string if the text is too long or the pool is empty.
+void Channel::sendLine(MsgLevel level, const char* text, size_t length) {
+    if (!outputTask) {
+        print_msg(level, std::string(text, length).c_str());
+        return;
+    }
+    if (length + 2 <= message_buffer_size()) {
+        if (char* buffer = message_buffer_acquire()) {
+            memcpy(buffer, text, length);
+            buffer[length] = '\0';
+            sendPooledLine(level, buffer);
+            return;
+        }
+    }
+    sendLine(level, new std::string(text, length));
+}
+
 bool Channel::is_visible(const std::string& stem, std::string extension, bool isdir) {
     if (stem.length() && stem[0] == '.') {
         // Exclude hidden files and directories
@@ -468,7 +603,7 @@ bool Channel::is_visible(const std::string& stem, std::string extension, bool is
     std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return ::tolower(c); });
 
     // common gcode extensions
-    std::string_view extensions(".g .gc .gco .gcode .nc .ngc .ncc .txt .cnc .tap");
+    std::string_view extensions(".g .gc .gco .gcode .nc .ngc .ncc .txt .cnc .tap .gcb");
     size_t           pos = 0;
     while (extensions.length()) {
         auto             next_pos       = extensions.find_first_of(' ', pos);
@@ -21,6 +21,8 @@
 #include "Types.h"        // MotorMask
 #include "RealtimeCmd.h"  // Cmd
 #include "UTF8.h"
+#include "SPSCQueue.h"
+#include "Telemetry.h"
 
 #include "Pins/PinAttributes.h"
 #include "Machine/EventPin.h"
@@ -29,11 +31,11 @@
 #include <freertos/FreeRTOS.h>  // TickType_T
 #include <freertos/semphr.h>
 #include <atomic>
-#include <queue>
 
 class Channel : public Stream {
 private:
     void pin_event(pinnum_t pinnum, bool active);
+    void autoReportTelemetry();
 
     static constexpr int PinACK = 0xB2;
     static constexpr int PinNAK = 0xB3;
@@ -58,12 +60,38 @@ protected:
     bool        _addCR         = false;
     char        _lastWasCR     = false;
 
-    mutable SemaphoreHandle_t _queue_mutex = xSemaphoreCreateMutex();
-    std::queue<uint8_t> _queue;
+    // Received characters that are waiting to be collected into lines.  The task
+    // that receives them is the only producer and the task that polls for lines
+    // is the only consumer, so the ring needs no lock.  flushRx() can be called
+    // from other tasks, so it only asks the consumer to discard the queue, which
+    // it does before it takes the next character.
+    //
+    // Only channels that receive ahead of line collection need the ring, so it
+    // is allocated by rx_queue() when the first character is queued.  Channels
+    // like files and macros, which are read a line at a time, never have one.
+    using RxQueue = SPSCQueue<uint8_t, CHANNEL_RX_BUFFER_SIZE>;
+    std::atomic<RxQueue*> _queue { nullptr };
+    uint32_t              _reported_overruns = 0;
+    std::atomic<bool>     _flush_requested { false };
+
+    // The ring, allocated if need be.  Either side may be first, so the ring
+    // is published with a compare-exchange and the loser discards its own.
+    RxQueue* rx_queue();
+
+    // The ring if it has been allocated, otherwise nullptr
+    RxQueue* rx_queue_if_any() const { return _queue.load(std::memory_order_acquire); }
+
+    // Consumer side of flushRx()
+    void take_flush();
 
     uint32_t _reportInterval = 0;
     int32_t  _nextReportTime = 0;
 
+    // With binary reports, telemetry frames replace the text status reports
+    bool               _binaryReports = false;
+    Telemetry::Encoder _telemetry;
+    int32_t            _nextKeyframeTime = 0;
+
     gc_modal_t  _lastModal        = modal_defaults;
     uint8_t     _lastTool         = 0;
     float       _lastSpindleSpeed = 0;
@@ -81,6 +109,13 @@ protected:
 
     std::map<int, InputPin*> _pins;
 
+    // In binary GCode mode, lines that start with the binary marker are
+    // collected without line editing.  Realtime characters are still handled,
+    // since the encoding escapes them.  _binaryLine is set while pollLine()
+    // collects such a line.
+    bool _binaryGCode = false;
+    bool _binaryLine  = false;
+
     UTF8 _utf8;
 
     bool _ended   = false;
@@ -97,7 +132,7 @@ public:
     explicit Channel(const std::string& name, bool addCR = false);
     explicit Channel(const char* name, bool addCR = false);
     Channel(const char* name, objnum_t num, bool addCR = false);
-    virtual ~Channel() = default;
+    virtual ~Channel() { delete rx_queue_if_any(); }
 
     int8_t _ackwait = 0;  // 1 - waiting, 0 - ACKed, -1 - NAKed
 
@@ -111,6 +146,15 @@ public:
     virtual void sendLine(MsgLevel level, const std::string* line);
     virtual void sendLine(MsgLevel level, const std::string& line);
 
+    // Sends a copy of text that the caller owns, such as a stack buffer
+    void sendLine(MsgLevel level, const char* text, size_t length);
+
+    // Sends a message in a buffer from the message pool, and releases the buffer
+    virtual void sendPooledLine(MsgLevel level, char* line);
+
+    // Sends a telemetry frame in a buffer from the message pool, and releases the buffer
+    void sendPooledFrame(uint8_t* frame);
+
     size_t _line_number = 0;
 
     std::string _progress;
@@ -119,9 +163,10 @@ public:
     // a reception buffer, even if the system is busy.  Channels that can handle external
     // input via an interrupt or other background mechanism should override it to return
     // the remaining space that mechanism has available.
-    // The queue can handle more than 256 characters but we don't want it to get too
-    // large, so we report a limited size.
-    virtual int rx_buffer_available() { return std::max(0, 256 - int(queued_bytes())); }
+    virtual int rx_buffer_available() {
+        auto queue = rx_queue_if_any();
+        return int(queue ? queue->free_space() : RxQueue::capacity());
+    }
 
     // flushRx() discards any characters that have already been received.  It is used
     // after a reset, so that anything already sent will not be processed.
@@ -170,28 +215,47 @@ public:
 
     virtual void print_msg(MsgLevel level, const char* msg);
 
+    // print_line() sends a line that already ends with a newline in one write, so
+    // channels that send each write as a packet need not collect the pieces.
+    virtual void print_line(MsgLevel level, const char* line, size_t length);
+
     void print_msg(MsgLevel level, const std::string& msg) { print_msg(level, msg.c_str()); }
 
-    uint32_t     setReportInterval(uint32_t ms);
+    // print_frame() sends a binary telemetry frame.  Channels that can carry
+    // binary data alongside text lines say so with binaryReportsOkay().
+    virtual void print_frame(const uint8_t* frame, size_t length);
+    virtual bool binaryReportsOkay() { return false; }
+
+    void setBinaryGCode(bool on) { _binaryGCode = on; }
+    bool getBinaryGCode() { return _binaryGCode; }
+
+    uint32_t     setReportInterval(uint32_t ms, bool binary = false);
     uint32_t     getReportInterval() { return _reportInterval; }
+    bool         getBinaryReports() { return _binaryReports; }
     virtual void autoReport();
     void         autoReportGCodeState();
 
+    // push() queues received characters, acting on realtime characters immediately.
+    // Characters that do not fit in the queue are dropped and reported later.
     void push(uint8_t byte);
-    void push(const uint8_t* data, size_t length) {
-        while (length--) {
-            push(*data++);
-        }
-    }
-    void push(std::string_view data) {
-        for (auto const& c : data) {
-            push((uint8_t)c);
-        }
-    }
+    void push(const uint8_t* data, size_t length);
+    void push(std::string_view data) { push(reinterpret_cast<const uint8_t*>(data.data()), data.length()); }
     void push(const std::string& s) { push(reinterpret_cast<const uint8_t*>(s.c_str()), s.length()); }
 
-    size_t queued_bytes() const;
-    bool   try_pop_queued_byte(uint8_t& byte);
+    size_t queued_bytes() const {
+        auto queue = rx_queue_if_any();
+        return queue ? queue->size() : 0;
+    }
+    bool try_pop_queued_byte(uint8_t& byte) {
+        take_flush();
+        auto queue = rx_queue_if_any();
+        return queue && queue->pop(byte);
+    }
+    size_t pop_queued_bytes(uint8_t* data, size_t length) {
+        take_flush();
+        auto queue = rx_queue_if_any();
+        return queue ? queue->pop(data, length) : 0;
+    }
 
     void end() { _ended = true; }
     void percent() { _percent = true; }
@@ -210,6 +274,20 @@ public:
     size_t lineNumber() { return _line_number; }
     void   setLineNumber(size_t line_number) { _line_number = line_number; }
 
+    // The input polling task can read ahead, so lineNumber() can be past the
+    // line that is executing.  The protocol loop records the number of the
+    // executing line here, so ack() can report errors at the right line.
+    size_t _exec_line_number = 0;
+    size_t execLineNumber() { return _exec_line_number; }
+
+    // pendingError() is non-Ok when a previous ack() has stopped the channel,
+    // so any lines that were read ahead of the failing line must be discarded.
+    virtual Error pendingError() { return Error::Ok; }
+
+    // canReplay() is true if pollLine() would try to read another line, so a
+    // job can substitute a line that it has cached.
+    bool canReplay() { return !_ended && !_percent && pendingError() == Error::Ok; }
+
     virtual void   save() {}
     virtual void   restore() {}
     virtual size_t position() { return 0; }
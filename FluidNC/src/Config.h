@@ -96,6 +96,11 @@ const int REPORT_OVR_REFRESH_IDLE_COUNT = 10;  // (1-255) Must be less than or e
 const int REPORT_WCO_REFRESH_BUSY_COUNT = 30;  // (2-255)
 const int REPORT_WCO_REFRESH_IDLE_COUNT = 10;  // (2-255) Must be less than or equal to the busy count
 
+// Binary telemetry frames ($RB) send only the fields that changed since the previous frame.
+// A complete keyframe is sent at least this often, in milliseconds, so that a client that
+// connects late or misses a frame can resynchronize.
+const int TELEMETRY_KEYFRAME_INTERVAL = 1000;
+
 // The temporal resolution of the acceleration management subsystem. A higher number gives smoother
 // acceleration, particularly noticeable on machines that run at very high feedrates, but may negatively
 // impact performance. The correct value for this parameter is machine dependent, so it's advised to
@@ -162,6 +167,62 @@ const bool FORCE_BUFFER_SYNC_DURING_WCO_CHANGE = true;  // Default enabled. Comm
 // repeatable. If needed, you can disable this behavior by uncommenting the define below.
 const bool ALLOW_FEED_OVERRIDE_DURING_PROBE_CYCLES = false;
 
+// Number of input lines that the polling task can read ahead of the protocol loop.
+// Lines are handed over through a lock-free queue, so a sender or file job that
+// streams many short motion lines is not limited to one line per scheduler tick.
+// Each entry costs about 260 bytes of RAM.  Must be a power of two.
+const int LINE_QUEUE_DEPTH = 8;
+
+// Capacity of the lock-free ring in each channel that holds received characters
+// until the protocol loop collects them into lines.  rx_buffer_available(), and
+// thus the Bf: field of status reports, is the free space in this ring, so
+// character-counting senders must not send more than this ahead.  Must be a
+// power of two.
+const int CHANNEL_RX_BUFFER_SIZE = 1024;
+
+// Outgoing messages - log lines, status reports and command responses - are
+// built in buffers from a fixed pool instead of on the heap, so that frequent
+// reports to several clients do not fragment the heap.  A buffer stays in use
+// until the output task has sent its message, so the pool should be somewhat
+// larger than the output queue.  Longer messages, and messages built while the
+// pool is empty, fall back to the heap; $Stats/Output shows how often.
+const int MESSAGE_POOL_BUFFERS = 20;  // At most 32
+const int MESSAGE_BUFFER_SIZE  = 256;
+
+// Size of the read-ahead buffer that a FileStream opened for reading uses, so that
+// reading a GCode job line by line costs one filesystem call per block instead of
+// one per character.  The buffer is allocated on the first read and released when
+// a nested job closes the file temporarily.
+const int FILE_READ_BUFFER_SIZE = 1024;
+
+// Number of 1 KiB packet buffers that an Xmodem or Ymodem upload uses, so that
+// receiving packets can continue while earlier ones are being written to the
+// file.  More buffers ride out longer filesystem stalls, like SD card block
+// erases; they are allocated only while an upload is running.
+const int XMODEM_WRITE_BUFFERS = 8;
+
+// When HTTP/MotionRate allows file transfers during motion, they read and write
+// the filesystem in pieces of at most this many bytes, so that no single flash
+// operation holds up the support core for long.  The rate is allowed to burst
+// to this many pieces.
+const int HTTP_MOTION_IO_CHUNK = 512;
+const int HTTP_MOTION_IO_BURST = 4;
+
+// Maximum number of lines of a GCode job that are kept in memory while flow
+// control loops (O-word do, while and repeat) are running, so that later
+// iterations execute the loop body without reading and parsing it again.
+// Lines of longer loop bodies are read from the job each time.
+const int LOOP_CACHE_LINES = 128;
+
+// Planner buffers with more blocks than this are allocated in external PSRAM on
+// boards that have it, so that deep look-ahead does not exhaust internal RAM.
+// Smaller buffers stay in internal RAM, which is faster.
+const int PLANNER_INTERNAL_RAM_BLOCKS = 128;
+
+// Number of planner blocks to fall back to when the configured planner_blocks
+// cannot be allocated.
+const int PLANNER_FALLBACK_BLOCKS = 16;
+
 #include "NutsBolts.h"
 
 #include "Assertion.h"
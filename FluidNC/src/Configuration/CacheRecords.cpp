@@ -0,0 +1,82 @@
+// Copyright (c) 2026 - FluidNC Contributors
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#include "CacheRecords.h"
+
+#include <cstring>
+
+namespace Configuration {
+    bool CacheWriter::put_key(CacheRecord type, const char* name, size_t length) {
+        size_t nameLength = strlen(name);
+        if (nameLength > UINT8_MAX || length > UINT16_MAX) {
+            _failed = true;
+            return false;
+        }
+        _records += char(type);
+        _records += char(nameLength);
+        _records.append(name, nameLength);
+        _records += char(length & 0xff);
+        _records += char(length >> 8);
+        return true;
+    }
+
+    void CacheWriter::put_value(CacheRecord type, const char* name, const void* value, size_t length) {
+        if (put_key(type, name, length)) {
+            _records.append(static_cast<const char*>(value), length);
+        }
+    }
+
+    void CacheWriter::put(const char* name, const std::vector<float>& value) {
+        put_value(CacheRecord::Floats, name, value.data(), value.size() * sizeof(float));
+    }
+
+    CacheRecords::CacheRecords(const std::string& records) :
+        _next(reinterpret_cast<const uint8_t*>(records.data())), _end(_next + records.length()) {}
+
+    // Reads the next record, returning false at the end of a section
+    bool CacheRecords::next_record() {
+        if (_next == _end) {
+            throw CacheError("Config cache is truncated");
+        }
+        _type    = CacheRecord(*_next++);
+        _matched = false;
+        if (_type == CacheRecord::EndSection) {
+            return false;
+        }
+        if (_end - _next < 1 || size_t(_end - _next) < size_t(1 + _next[0] + 2)) {
+            throw CacheError("Config cache is truncated");
+        }
+        size_t keyLength = *_next++;
+        _key             = std::string_view(reinterpret_cast<const char*>(_next), keyLength);
+        _next += keyLength;
+        _valueLength = _next[0] | (_next[1] << 8);
+        _next += 2;
+        if (size_t(_end - _next) < _valueLength) {
+            throw CacheError("Config cache is truncated");
+        }
+        _value = _next;
+        _next += _valueLength;
+        return true;
+    }
+
+    bool CacheRecords::is(const char* name, CacheRecord type) {
+        if (_matched || _type != type || _key.length() != strlen(name) || _key.compare(name) != 0) {
+            return false;
+        }
+        _matched = true;
+        return true;
+    }
+
+    void CacheRecords::get(void* value, size_t length) {
+        if (_valueLength != length) {
+            throw CacheError("Config cache item has the wrong size");
+        }
+        memcpy(value, _value, length);
+    }
+
+    uint32_t CacheRecords::get_uint() {
+        uint32_t value;
+        get(&value, sizeof(value));
+        return value;
+    }
+}
@@ -0,0 +1,151 @@
+// Copyright (c) 2026 - FluidNC Contributors
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#pragma once
+
+// The record format of the config cache, see ConfigCache.h.
+//
+// Each record is a type byte, then for all but EndSection the key as a
+// length byte and text, a 2-byte little-endian value length, and the value.
+// The items of a section follow its Section record, up to an EndSection.
+//
+// This file does not depend on the configuration tree, so the format and the
+// way sections are replayed can be tested on the host.
+
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+enum class UartData : uint8_t;
+enum class UartParity : uint8_t;
+enum class UartStop : uint8_t;
+
+namespace Configuration {
+    struct speed_entry_t;
+
+    enum class CacheRecord : uint8_t {
+        EndSection = 0,
+        Section,
+        Int,     // int32_t
+        Uint,    // uint32_t, also for bools, enums and axes
+        Float,   // float
+        String,  // Text, also for pins, macros and step engine names
+        Floats,  // A float array
+        Speeds,  // A speed map, with four 32-bit fields per entry
+        Uart,    // Word length, parity, stop bits
+        IP,      // Four address bytes
+    };
+
+    const uint64_t fnv_basis = 0xcbf29ce484222325ULL;
+
+    inline uint64_t fnv1a(const void* data, size_t length, uint64_t hash = fnv_basis) {
+        auto p = static_cast<const uint8_t*>(data);
+        while (length--) {
+            hash = (hash ^ *p++) * 0x100000001b3ULL;
+        }
+        return hash;
+    }
+
+    // Thrown when the records cannot be replayed, as when they are malformed
+    class CacheError : public std::runtime_error {
+    public:
+        explicit CacheError(const char* what) : std::runtime_error(what) {}
+    };
+
+    // CacheWriter collects records as ParserHandler sets items
+    class CacheWriter {
+        std::string _records;
+        bool        _failed = false;
+
+        bool put_key(CacheRecord type, const char* name, size_t length);
+        void put_value(CacheRecord type, const char* name, const void* value, size_t length);
+
+    public:
+        void begin_section(const char* name) { put_key(CacheRecord::Section, name, 0); }
+        void end_section() { _records += char(CacheRecord::EndSection); }
+
+        void put(const char* name, int32_t value) { put_value(CacheRecord::Int, name, &value, sizeof(value)); }
+        void put(const char* name, uint32_t value) { put_value(CacheRecord::Uint, name, &value, sizeof(value)); }
+        void put(const char* name, float value) { put_value(CacheRecord::Float, name, &value, sizeof(value)); }
+        void put(const char* name, std::string_view value) { put_value(CacheRecord::String, name, value.data(), value.length()); }
+        void put(const char* name, const std::vector<float>& value);
+        void put(const char* name, const uint8_t (&address)[4]) { put_value(CacheRecord::IP, name, address, sizeof(address)); }
+
+        // Defined in ConfigCache.cpp, with the configuration types
+        void put(const char* name, const std::vector<speed_entry_t>& value);
+        void put(const char* name, UartData wordLength, UartParity parity, UartStop stopBits);
+
+        // False if an item was too long to record
+        bool               ok() const { return !_failed; }
+        const std::string& records() const { return _records; }
+    };
+
+    // CacheRecords steps through the records, one section at a time.  An item
+    // takes the current record with is(), which succeeds only once per
+    // record, so a record that no item takes can be detected.
+    class CacheRecords {
+        const uint8_t* _next;
+        const uint8_t* _end;
+
+        // The current record
+        CacheRecord      _type        = CacheRecord::EndSection;
+        std::string_view _key;
+        const uint8_t*   _value       = nullptr;
+        size_t           _valueLength = 0;
+        bool             _matched     = false;
+
+        bool next_record();
+
+    public:
+        explicit CacheRecords(const std::string& records);
+
+        // True, once, if the current record is the item name of the given type
+        bool is(const char* name, CacheRecord type);
+
+        const uint8_t* value() const { return _value; }
+        size_t         length() const { return _valueLength; }
+
+        // Copies the value, which must be exactly length bytes
+        void     get(void* value, size_t length);
+        uint32_t get_uint();
+
+        // If the current record is the section name, calls group() for each
+        // of the section's records and returns true.  The section record may
+        // already have been taken by is(), as when a section is created.
+        // Otherwise, as when a factory re-enters an existing object while
+        // another record is current, it does nothing and returns false.
+        template <typename Group>
+        bool section(const char* name, Group&& group) {
+            if (_type != CacheRecord::Section || _key != name) {
+                return false;
+            }
+            while (next_record()) {
+                group();
+                if (!_matched) {
+                    // Only keys that were used are cached, so the cache must
+                    // have come from a different version of the configuration
+                    throw CacheError("Config cache has an unknown key");
+                }
+            }
+            // The section's own record was used, whatever its last item did
+            _matched = true;
+            return true;
+        }
+
+        // Replays the records, which must be a single top section, by
+        // calling enter() with the top Section record current.  enter() is
+        // expected to take it with section().
+        template <typename Enter>
+        void replay(Enter&& enter) {
+            if (!next_record() || _type != CacheRecord::Section) {
+                throw CacheError("Config cache does not start with a section");
+            }
+            enter();
+            if (!_matched || _next != _end) {
+                throw CacheError("Config cache does not hold just the top section");
+            }
+        }
+    };
+}
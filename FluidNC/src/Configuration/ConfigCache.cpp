@@ -0,0 +1,250 @@
+// Copyright (c) 2026 - FluidNC Contributors
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#include "ConfigCache.h"
+
+#include "Configurable.h"
+#include "FileStream.h"
+#include "Report.h"  // git_info
+#include "System.h"
+#include "Machine/Axes.h"
+
+#include <cstring>
+#include <stdexcept>
+
+namespace Configuration {
+    static const char    cacheMagic[]  = "FNCC";
+    static const uint8_t cacheVersion  = 1;
+    static const size_t  cacheHashSize = 8;
+
+    void CacheWriter::put(const char* name, const std::vector<speedEntry>& value) {
+        if (!put_key(CacheRecord::Speeds, name, value.size() * 4 * sizeof(uint32_t))) {
+            return;
+        }
+        for (auto& entry : value) {
+            uint32_t percent;
+            memcpy(&percent, &entry.percent, sizeof(percent));
+            uint32_t fields[] = { entry.speed, percent, entry.offset, entry.scale };
+            _records.append(reinterpret_cast<const char*>(fields), sizeof(fields));
+        }
+    }
+
+    void CacheWriter::put(const char* name, UartData wordLength, UartParity parity, UartStop stopBits) {
+        uint8_t mode[] = { uint8_t(wordLength), uint8_t(parity), uint8_t(stopBits) };
+        put_value(CacheRecord::Uart, name, mode, sizeof(mode));
+    }
+
+    CacheReader::CacheReader(const std::string& records) : _records(records) {}
+
+    void CacheReader::enterSection(const char* name, Configurable* section) {
+        _path.push_back(name);  // For error handling
+
+        _records.section(name, [&] {
+            try {
+                section->group(*this);
+            } catch (CacheError&) {
+                throw;
+            } catch (std::exception& ex) {
+                log_config_error("Configuration error at "; for (auto it : _path) { ss << '/' << it; } ss << ": " << ex.what());
+            }
+        });
+
+        _path.erase(_path.begin() + (_path.size() - 1));
+    }
+
+    void CacheReader::replay(const char* name, Configurable* root) {
+        _records.replay([&] { enterSection(name, root); });
+    }
+
+    void CacheReader::item(const char* name, bool& value) {
+        if (is(name, CacheRecord::Uint)) {
+            value = _records.get_uint();
+        }
+    }
+
+    void CacheReader::item(const char* name, int32_t& value, const int32_t minValue, const int32_t maxValue) {
+        if (is(name, CacheRecord::Int)) {
+            _records.get(&value, sizeof(value));
+            constrain_with_message(value, minValue, maxValue, name);
+        }
+    }
+
+    void CacheReader::item(const char* name, uint32_t& value, const uint32_t minValue, const uint32_t maxValue) {
+        if (is(name, CacheRecord::Uint)) {
+            value = _records.get_uint();
+            constrain_with_message(value, minValue, maxValue, name);
+        }
+    }
+
+    void CacheReader::item(const char* name, float& value, const float minValue, const float maxValue) {
+        if (is(name, CacheRecord::Float)) {
+            _records.get(&value, sizeof(value));
+            constrain_with_message(value, minValue, maxValue, name);
+        }
+    }
+
+    void CacheReader::item(const char* name, std::vector<speedEntry>& value) {
+        if (is(name, CacheRecord::Speeds)) {
+            const size_t entrySize = 4 * sizeof(uint32_t);
+            if (_records.length() % entrySize) {
+                throw CacheError("Config cache item has the wrong size");
+            }
+            value.resize(_records.length() / entrySize);
+            for (size_t i = 0; i < value.size(); i++) {
+                uint32_t fields[4];
+                memcpy(fields, _records.value() + i * entrySize, entrySize);
+                value[i].speed = fields[0];
+                memcpy(&value[i].percent, &fields[1], sizeof(float));
+                value[i].offset = fields[2];
+                value[i].scale  = fields[3];
+            }
+        }
+    }
+
+    void CacheReader::item(const char* name, std::vector<float>& value) {
+        if (is(name, CacheRecord::Floats)) {
+            if (_records.length() % sizeof(float)) {
+                throw CacheError("Config cache item has the wrong size");
+            }
+            value.resize(_records.length() / sizeof(float));
+            memcpy(value.data(), _records.value(), _records.length());
+        }
+    }
+
+    void CacheReader::item(const char* name, UartData& wordLength, UartParity& parity, UartStop& stopBits) {
+        if (is(name, CacheRecord::Uart)) {
+            uint8_t mode[3];
+            _records.get(mode, sizeof(mode));
+            wordLength = UartData(mode[0]);
+            parity     = UartParity(mode[1]);
+            stopBits   = UartStop(mode[2]);
+        }
+    }
+
+    void CacheReader::item(const char* name, std::string& value, const int minLength, const int maxLength) {
+        if (is(name, CacheRecord::String)) {
+            value.assign(reinterpret_cast<const char*>(_records.value()), _records.length());
+        }
+    }
+
+    void CacheReader::item(const char* name, EventPin& value) {
+        if (is(name, CacheRecord::String)) {
+            auto parsed = Pin::create(std::string_view(reinterpret_cast<const char*>(_records.value()), _records.length()));
+            value.swap(parsed);
+        }
+    }
+
+    void CacheReader::item(const char* name, InputPin& value) {
+        if (is(name, CacheRecord::String)) {
+            auto parsed = Pin::create(std::string_view(reinterpret_cast<const char*>(_records.value()), _records.length()));
+            value.swap(parsed);
+        }
+    }
+
+    void CacheReader::item(const char* name, Pin& value) {
+        if (is(name, CacheRecord::String)) {
+            auto parsed = Pin::create(std::string_view(reinterpret_cast<const char*>(_records.value()), _records.length()));
+            value.swap(parsed);
+        }
+    }
+
+    void CacheReader::item(const char* name, Macro& value) {
+        if (is(name, CacheRecord::String)) {
+            value.set(std::string_view(reinterpret_cast<const char*>(_records.value()), _records.length()));
+        }
+    }
+
+    void CacheReader::item(const char* name, IPAddress& value) {
+        if (is(name, CacheRecord::IP)) {
+            uint8_t address[4];
+            _records.get(address, sizeof(address));
+            value = IPAddress(address[0], address[1], address[2], address[3]);
+        }
+    }
+
+    void CacheReader::item(const char* name, step_engine*& value) {
+        if (is(name, CacheRecord::String)) {
+            std::string_view engineName(reinterpret_cast<const char*>(_records.value()), _records.length());
+            for (auto const engine : step_engines) {
+                if (engineName == engine->name) {
+                    value = engine;
+                    return;
+                }
+            }
+            throw CacheError("Config cache names an unknown step engine");
+        }
+    }
+
+    void CacheReader::item(const char* name, uint32_t& value, const EnumItem* e) {
+        if (is(name, CacheRecord::Uint)) {
+            value = _records.get_uint();
+        }
+    }
+
+    void CacheReader::item(const char* name, axis_t& value) {
+        if (is(name, CacheRecord::Uint)) {
+            value = axis_t(_records.get_uint());
+        }
+    }
+
+    static std::string firmware_version() {
+        std::string version(git_info);
+        if (version.length() > UINT8_MAX) {
+            version.resize(UINT8_MAX);
+        }
+        return version;
+    }
+
+    bool read_cache(const std::string& filename, uint64_t yaml_hash, std::string& records) {
+        try {
+            FileStream file(filename, "rb", LocalFS);
+
+            std::string version = firmware_version();
+            uint8_t     header[sizeof(cacheMagic) - 1 + 1 + 2 * cacheHashSize + 1];
+            if (file.read(header, sizeof(header)) != int(sizeof(header)) || memcmp(header, cacheMagic, sizeof(cacheMagic) - 1) ||
+                header[4] != cacheVersion) {
+                return false;
+            }
+            uint64_t cachedYamlHash, recordsHash;
+            memcpy(&cachedYamlHash, header + 5, cacheHashSize);
+            memcpy(&recordsHash, header + 5 + cacheHashSize, cacheHashSize);
+            if (cachedYamlHash != yaml_hash || header[sizeof(header) - 1] != version.length()) {
+                return false;
+            }
+
+            char cachedVersion[UINT8_MAX];
+            if (file.read(cachedVersion, version.length()) != int(version.length()) ||
+                version.compare(0, version.length(), cachedVersion, version.length())) {
+                return false;
+            }
+
+            size_t length = file.size() - sizeof(header) - version.length();
+            records.resize(length);
+            if (file.read(records.data(), length) != int(length)) {
+                return false;
+            }
+            return fnv1a(records.data(), records.length()) == recordsHash;
+        } catch (...) {
+            return false;
+        }
+    }
+
+    void write_cache(const std::string& filename, uint64_t yaml_hash, const std::string& records) {
+        std::string version     = firmware_version();
+        uint64_t    recordsHash = fnv1a(records.data(), records.length());
+
+        std::string header(cacheMagic, sizeof(cacheMagic) - 1);
+        header += char(cacheVersion);
+        header.append(reinterpret_cast<const char*>(&yaml_hash), cacheHashSize);
+        header.append(reinterpret_cast<const char*>(&recordsHash), cacheHashSize);
+        header += char(version.length());
+        header += version;
+        try {
+            FileStream file(filename, "wb", LocalFS);
+            file.write(reinterpret_cast<const uint8_t*>(header.data()), header.length());
+            file.write(reinterpret_cast<const uint8_t*>(records.data()), records.length());
+        } catch (...) {
+            log_debug("Cannot save the config cache " << filename);
+        }
+    }
+}
@@ -0,0 +1,74 @@
+// Copyright (c) 2026 - FluidNC Contributors
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#pragma once
+
+// The config cache lets the machine configuration be rebuilt at boot without
+// tokenizing the YAML file and converting its values from text.  When a
+// configuration file parses without errors, the items that were set are
+// recorded, with their values already converted, and saved in a binary file
+// next to the YAML file.  On the next boot, if the YAML file has the same
+// hash and the firmware is the same, the records are replayed through the
+// group() methods instead of parsing the YAML.  After-parse and validation
+// run the same either way.
+//
+// Cache file layout:
+//
+//   "FNCC", a version byte, the FNV-1a hash of the YAML file and the hash of
+//   the records (8 bytes each, little-endian), the firmware version as a
+//   length byte and text, then the records
+//
+// The records are described in CacheRecords.h.
+
+#include "CacheRecords.h"
+#include "HandlerBase.h"
+
+#include <string>
+#include <vector>
+
+namespace Configuration {
+    // CacheReader replays records into a configuration tree.  It acts as a
+    // parser, so sections and factory objects are created as they would be
+    // from the YAML.  Records that cannot be replayed throw CacheError.
+    class CacheReader : public HandlerBase {
+        CacheRecords             _records;
+        std::vector<const char*> _path;
+
+        bool is(const char* name, CacheRecord type) { return _records.is(name, type); }
+
+    protected:
+        void        enterSection(const char* name, Configurable* section) override;
+        bool        matchesUninitialized(const char* name) override { return is(name, CacheRecord::Section); }
+        HandlerType handlerType() override { return HandlerType::Parser; }
+
+    public:
+        explicit CacheReader(const std::string& records);
+
+        // Replays the records into root, which must have been created as
+        // the top level section.
+        void replay(const char* name, Configurable* root);
+
+        void item(const char* name, bool& value) override;
+        void item(const char* name, int32_t& value, const int32_t minValue, const int32_t maxValue) override;
+        void item(const char* name, uint32_t& value, const uint32_t minValue, const uint32_t maxValue) override;
+        void item(const char* name, float& value, const float minValue, const float maxValue) override;
+        void item(const char* name, std::vector<speedEntry>& value) override;
+        void item(const char* name, std::vector<float>& value) override;
+        void item(const char* name, UartData& wordLength, UartParity& parity, UartStop& stopBits) override;
+        void item(const char* name, std::string& value, const int minLength, const int maxLength) override;
+        void item(const char* name, EventPin& value) override;
+        void item(const char* name, InputPin& value) override;
+        void item(const char* name, Pin& value) override;
+        void item(const char* name, Macro& value) override;
+        void item(const char* name, IPAddress& value) override;
+        void item(const char* name, step_engine*& value) override;
+        void item(const char* name, uint32_t& value, const EnumItem* e) override;
+        void item(const char* name, axis_t& value) override;
+    };
+
+    // Reads the records from a cache file, returning false if there is no
+    // cache file or it does not match the YAML hash and this firmware.
+    bool read_cache(const std::string& filename, uint64_t yaml_hash, std::string& records);
+
+    void write_cache(const std::string& filename, uint64_t yaml_hash, const std::string& records);
+}
@@ -43,7 +43,10 @@ namespace Configuration {
         virtual void item(const char* name, int32_t& value, const int32_t minValue = 0, const int32_t maxValue = INT32_MAX)     = 0;
         virtual void item(const char* name, uint32_t& value, const uint32_t minValue = 0, uint32_t const maxValue = UINT32_MAX) = 0;
 
-        void item(const char* name, uint8_t& value, const uint8_t minValue = 0, const uint8_t maxValue = UINT8_MAX) {
+        // Handlers that keep a reference to the item, rather than just reading
+        // or writing it during the call, must override this, since the default
+        // passes a temporary to the int32_t overload
+        virtual void item(const char* name, uint8_t& value, const uint8_t minValue = 0, const uint8_t maxValue = UINT8_MAX) {
             int32_t v = int32_t(value);
             item(name, v, int32_t(minValue), int32_t(maxValue));
             value = uint8_t(v);
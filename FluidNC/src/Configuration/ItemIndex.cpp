@@ -0,0 +1,172 @@
+// Copyright (c) 2026 - FluidNC Contributors
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#include "ItemIndex.h"
+
+#include "Machine/MachineConfig.h"  // config
+#include "NutsBolts.h"              // constrain_with_message
+
+#include <cctype>
+
+namespace Configuration {
+    std::unordered_map<std::string_view, ItemIndex::Entry, ItemIndex::NoCaseHash, ItemIndex::NoCaseEqual> ItemIndex::_index;
+    std::deque<std::string>                                                                              ItemIndex::_paths;
+    bool                                                                                                 ItemIndex::_built = false;
+
+    size_t ItemIndex::NoCaseHash::operator()(std::string_view s) const {
+        // FNV-1a on the lower-case characters
+        size_t hash = 2166136261u;
+        for (char c : s) {
+            hash = (hash ^ uint8_t(::tolower(c))) * 16777619u;
+        }
+        return hash;
+    }
+
+    bool ItemIndex::NoCaseEqual::operator()(std::string_view a, std::string_view b) const {
+        return string_util::equal_ignore_case(a, b);
+    }
+
+    void ItemIndex::add(const char* name, Type type, void* value, double minValue, double maxValue) {
+        _paths.emplace_back(_path + name);
+        // The first item with a path wins, as the first one that GCodeParam finds would
+        _index.emplace(_paths.back(), Entry { type, value, minValue, maxValue });
+    }
+
+    void ItemIndex::enterSection(const char* name, Configurable* value) {
+        auto length = _path.length();
+        _path += name;
+        _path += '/';
+        value->group(*this);
+        _path.resize(length);
+    }
+
+    void ItemIndex::build() {
+        _index.clear();
+        _paths.clear();
+        if (config) {
+            ItemIndex builder;
+            try {
+                config->group(builder);
+            } catch (std::exception& ex) {
+                log_debug("Config item index is incomplete: " << ex.what());
+            }
+        }
+        _built = true;
+    }
+
+    void ItemIndex::invalidate() {
+        _index.clear();
+        _paths.clear();
+        _built = false;
+    }
+
+    size_t ItemIndex::size() {
+        if (!_built) {
+            build();
+        }
+        return _index.size();
+    }
+
+    const ItemIndex::Entry* ItemIndex::find(std::string_view path) {
+        if (!_built) {
+            build();
+        }
+        // Remove the leading and trailing '/' if they are present
+        if (path.length() && path.front() == '/') {
+            path.remove_prefix(1);
+        }
+        if (path.length() && path.back() == '/') {
+            path.remove_suffix(1);
+        }
+        auto it = _index.find(path);
+        if (it == _index.end()) {
+            return nullptr;
+        }
+        if (it->second.type == Type::NonNumeric) {
+            log_debug("Non-numeric config item");
+            return nullptr;
+        }
+        return &it->second;
+    }
+
+    bool ItemIndex::get(std::string_view path, float& value) {
+        auto entry = find(path);
+        if (!entry) {
+            return false;
+        }
+        switch (entry->type) {
+            case Type::Bool:
+                value = *static_cast<bool*>(entry->value);
+                break;
+            case Type::Int:
+                value = *static_cast<int32_t*>(entry->value);
+                break;
+            case Type::Uint:
+            case Type::Enum:
+                value = *static_cast<uint32_t*>(entry->value);
+                break;
+            case Type::Uint8:
+                value = *static_cast<uint8_t*>(entry->value);
+                break;
+            case Type::Float:
+                value = *static_cast<float*>(entry->value);
+                break;
+            case Type::Axis:
+                value = float(*static_cast<axis_t*>(entry->value));
+                break;
+            default:
+                return false;
+        }
+        return true;
+    }
+
+    bool ItemIndex::set(std::string_view path, float value) {
+        auto entry = find(path);
+        if (!entry) {
+            return false;
+        }
+        switch (entry->type) {
+            case Type::Bool:
+                *static_cast<bool*>(entry->value) = value;
+                break;
+            case Type::Int:
+                *static_cast<int32_t*>(entry->value) = value;
+                break;
+            case Type::Uint: {
+                if (value < 0) {
+                    log_debug("Negative value for unsigned config item");
+                    return false;
+                }
+                uint32_t& item = *static_cast<uint32_t*>(entry->value);
+                item           = value;
+                constrain_with_message(item, uint32_t(entry->minValue), uint32_t(entry->maxValue));
+                break;
+            }
+            case Type::Uint8: {
+                if (value < 0) {
+                    log_debug("Negative value for unsigned config item");
+                    return false;
+                }
+                uint32_t item = value;
+                constrain_with_message(item, uint32_t(entry->minValue), uint32_t(entry->maxValue));
+                *static_cast<uint8_t*>(entry->value) = item;
+                break;
+            }
+            case Type::Enum:
+                *static_cast<uint32_t*>(entry->value) = value;
+                break;
+            case Type::Float: {
+                float& item = *static_cast<float*>(entry->value);
+                item        = value;
+                constrain_with_message(item, float(entry->minValue), float(entry->maxValue));
+                break;
+            }
+            case Type::Axis:
+                *static_cast<axis_t*>(entry->value) = static_cast<axis_t>(value);
+                break;
+            default:
+                return false;
+        }
+        return true;
+    }
+}
@@ -0,0 +1,107 @@
+// Copyright (c) 2026 - FluidNC Contributors
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#pragma once
+
+// ItemIndex maps the paths of config items, like /axes/x/max_rate_mm_per_min,
+// to the items themselves, so that #</path> parameters in GCode expressions
+// can be read and written without walking the whole config tree with a
+// GCodeParam handler for every reference.  The index is built by walking
+// the tree once, the first time it is needed, and is rebuilt after the
+// configuration is loaded or changed with a $/path=value command, since
+// either can create or delete the objects that hold the items.
+//
+// Reads and writes through the index behave exactly as through GCodeParam:
+// paths are case-insensitive, the leading and trailing '/' are optional,
+// and only numeric items can be used.
+
+#include "HandlerBase.h"
+#include "Configurable.h"
+
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace Configuration {
+    class ItemIndex : public HandlerBase {
+    public:
+        enum class Type : uint8_t { Bool, Int, Uint, Uint8, Float, Enum, Axis, NonNumeric };
+
+        struct Entry {
+            Type   type;
+            void*  value;
+            double minValue;  // A double holds any int32_t, uint32_t or float limit exactly
+            double maxValue;
+        };
+
+        // Get and set a numeric item by path.  They return false if there
+        // is no such item or it is not numeric.
+        static bool get(std::string_view path, float& value);
+        static bool set(std::string_view path, float value);
+
+        // Drops the index, so that the next get() or set() rebuilds it
+        static void invalidate();
+
+        // Number of items in the index, building it if necessary
+        static size_t size();
+
+    private:
+        // Case-insensitive hash and comparison, so lookups need not copy the path
+        struct NoCaseHash {
+            size_t operator()(std::string_view s) const;
+        };
+        struct NoCaseEqual {
+            bool operator()(std::string_view a, std::string_view b) const;
+        };
+
+        // The keys are views of the paths in _paths, which a deque never moves
+        static std::unordered_map<std::string_view, Entry, NoCaseHash, NoCaseEqual> _index;
+        static std::deque<std::string>                                               _paths;
+        static bool                                                                  _built;
+
+        static const Entry* find(std::string_view path);
+        static void         build();
+
+        std::string _path;  // The path of the current section, with a trailing '/'
+
+        ItemIndex() = default;
+
+        void add(const char* name, Type type, void* value, double minValue = 0, double maxValue = 0);
+
+    protected:
+        void        enterSection(const char* name, Configurable* value) override;
+        bool        matchesUninitialized(const char* name) override { return false; }
+        HandlerType handlerType() override { return HandlerType::Runtime; }
+
+    public:
+        void item(const char* name, bool& value) override { add(name, Type::Bool, &value); }
+        void item(const char* name, int32_t& value, const int32_t minValue, const int32_t maxValue) override {
+            add(name, Type::Int, &value, minValue, maxValue);
+        }
+        void item(const char* name, uint32_t& value, const uint32_t minValue, const uint32_t maxValue) override {
+            add(name, Type::Uint, &value, minValue, maxValue);
+        }
+        void item(const char* name, uint8_t& value, const uint8_t minValue, const uint8_t maxValue) override {
+            add(name, Type::Uint8, &value, minValue, maxValue);
+        }
+        void item(const char* name, float& value, const float minValue, const float maxValue) override {
+            add(name, Type::Float, &value, minValue, maxValue);
+        }
+        void item(const char* name, uint32_t& value, const EnumItem* e) override { add(name, Type::Enum, &value); }
+        void item(const char* name, axis_t& value) override { add(name, Type::Axis, &value); }
+
+        void item(const char* name, std::vector<speedEntry>& value) override { add(name, Type::NonNumeric, nullptr); }
+        void item(const char* name, std::vector<float>& value) override { add(name, Type::NonNumeric, nullptr); }
+        void item(const char* name, UartData& wordLength, UartParity& parity, UartStop& stopBits) override {}
+        void item(const char* name, std::string& value, const int minLength, const int maxLength) override {
+            add(name, Type::NonNumeric, nullptr);
+        }
+        void item(const char* name, EventPin& value) override { add(name, Type::NonNumeric, nullptr); }
+        void item(const char* name, InputPin& value) override { add(name, Type::NonNumeric, nullptr); }
+        void item(const char* name, Pin& value) override { add(name, Type::NonNumeric, nullptr); }
+        void item(const char* name, IPAddress& value) override { add(name, Type::NonNumeric, nullptr); }
+        void item(const char* name, step_engine*& value) override { add(name, Type::NonNumeric, nullptr); }
+        void item(const char* name, Macro& value) override { add(name, Type::NonNumeric, nullptr); }
+    };
+}
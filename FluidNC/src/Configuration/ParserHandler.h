@@ -5,6 +5,7 @@
 
 #include "HandlerBase.h"
 #include "Parser.h"
+#include "ConfigCache.h"
 #include "Configurable.h"
 #include "System.h"
 #include "parser_logging.h"
@@ -14,12 +15,23 @@
 namespace Configuration {
     class ParserHandler : public Configuration::HandlerBase {
     private:
-        Configuration::Parser&   _parser;
-        std::vector<const char*> _path;
+        Configuration::Parser&      _parser;
+        std::vector<const char*>    _path;
+        Configuration::CacheWriter* _cache;  // Records the items that are set, if not null
+
+        template <typename... T>
+        void record(const char* name, T... value) {
+            if (_cache) {
+                _cache->put(name, value...);
+            }
+        }
 
     public:
         void enterSection(const char* name, Configuration::Configurable* section) override {
             _path.push_back(name);  // For error handling
+            if (_cache) {
+                _cache->begin_section(name);
+            }
 
             // On entry, the token is for the section that invoked us.
             // We will handle following nodes with indents greater than entryIndent
@@ -72,17 +84,21 @@ namespace Configuration {
             log_parser_verbose("Left section at indent " << entryIndent << " holding " << _parser.key());
 
             _path.erase(_path.begin() + (_path.size() - 1));
+            if (_cache) {
+                _cache->end_section();
+            }
         }
 
         bool matchesUninitialized(const char* name) override { return _parser.is(name); }
 
     public:
-        ParserHandler(Configuration::Parser& parser) : _parser(parser) {}
+        ParserHandler(Configuration::Parser& parser, Configuration::CacheWriter* cache = nullptr) : _parser(parser), _cache(cache) {}
 
         void item(const char* name, int32_t& value, int32_t minValue, int32_t maxValue) override {
             if (_parser.is(name)) {
                 value = _parser.intValue();
                 constrain_with_message(value, minValue, maxValue, name);
+                record(name, value);
             }
         }
 
@@ -90,18 +106,21 @@ namespace Configuration {
             if (_parser.is(name)) {
                 value = _parser.uintValue();
                 constrain_with_message(value, minValue, maxValue, name);
+                record(name, value);
             }
         }
 
         void item(const char* name, step_engine*& value) override {
             if (_parser.is(name)) {
                 value = _parser.stepEngineValue();
+                record(name, std::string_view(value->name));
             }
         }
 
         void item(const char* name, uint32_t& value, const EnumItem* e) override {
             if (_parser.is(name)) {
                 value = _parser.enumValue(e);
+                record(name, value);
             }
         }
 
@@ -112,16 +131,19 @@ namespace Configuration {
                     axis_t axis = Machine::Axes::axisNum(token);
                     if (axis != INVALID_AXIS) {
                         value = axis;
+                        record(name, uint32_t(value));
                         return;
                     }
                 }
                 value = X_AXIS;
+                record(name, uint32_t(value));
             }
         }
 
         void item(const char* name, bool& value) override {
             if (_parser.is(name)) {
                 value = _parser.boolValue();
+                record(name, uint32_t(value));
             }
         }
 
@@ -129,30 +151,35 @@ namespace Configuration {
             if (_parser.is(name)) {
                 value = _parser.floatValue();
                 constrain_with_message(value, minValue, maxValue, name);
+                record(name, value);
             }
         }
 
         void item(const char* name, std::vector<speedEntry>& value) override {
             if (_parser.is(name)) {
                 value = _parser.speedEntryValue();
+                record<const std::vector<speedEntry>&>(name, value);
             }
         }
 
         void item(const char* name, std::vector<float>& value) override {
             if (_parser.is(name)) {
                 value = _parser.floatArray();
+                record<const std::vector<float>&>(name, value);
             }
         }
 
         void item(const char* name, UartData& wordLength, UartParity& parity, UartStop& stopBits) override {
             if (_parser.is(name)) {
                 _parser.uartMode(wordLength, parity, stopBits);
+                record(name, wordLength, parity, stopBits);
             }
         }
 
         void item(const char* name, std::string& value, const int minLength, const int maxLength) override {
             if (_parser.is(name)) {
                 value = _parser.stringValue();
+                record(name, std::string_view(value));
             }
         }
 
@@ -160,6 +187,7 @@ namespace Configuration {
             if (_parser.is(name)) {
                 auto parsed = _parser.pinValue();
                 value.swap(parsed);
+                record(name, string_util::trim(_parser.stringValue()));
             }
         }
 
@@ -167,6 +195,7 @@ namespace Configuration {
             if (_parser.is(name)) {
                 auto parsed = _parser.pinValue();
                 value.swap(parsed);
+                record(name, string_util::trim(_parser.stringValue()));
             }
         }
 
@@ -174,18 +203,24 @@ namespace Configuration {
             if (_parser.is(name)) {
                 auto parsed = _parser.pinValue();
                 value.swap(parsed);
+                record(name, string_util::trim(_parser.stringValue()));
             }
         }
 
         void item(const char* name, Macro& value) override {
             if (_parser.is(name)) {
                 value.set(_parser.stringValue());
+                record(name, _parser.stringValue());
             }
         }
 
         void item(const char* name, IPAddress& value) override {
             if (_parser.is(name)) {
                 value = _parser.ipValue();
+                if (_cache) {
+                    uint8_t address[] = { value[0], value[1], value[2], value[3] };
+                    _cache->put(name, address);
+                }
             }
         }
 
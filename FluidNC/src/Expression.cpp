@@ -680,15 +680,22 @@ Error read_unary(const char* line, size_t& pos, float& value) {
     return execute_unary(value, operation);
 }
 
-/*! \brief Evaluate expression and set result if successful.
+/*! \brief Parses an expression, using operator precedence to decide the order
+of its operations.
+
+The operands object keeps the values of the operands on a stack:
+operands.operand(line, pos, index) reads the operand at line[pos] into
+stack[index], and operands.apply(index, operation) combines stack[index]
+and stack[index + 1] into stack[index].  expression() computes the values
+as they are read, and CompiledExpression records the operations.
 
 \param line pointer to RS274/NGC code (block).
 \param pos offset into line where expression starts.
-\param value pointer to float where result is to be stored.
-\returns #Error::Ok enum value if evaluated without error, appropriate \ref Error enum value if not.
+\param operands the operand stack.
+\returns #Error::Ok enum value if parsed without error, appropriate \ref Error enum value if not.
 */
-Error expression(const char* line, size_t& pos, float& value) {
-    float           values[MAX_STACK];
+template <typename Operands>
+static Error parse_expression(const char* line, size_t& pos, Operands& operands) {
     ngc_binary_op_t operators[MAX_STACK];
     uint_fast8_t    stack_index = 1;
 
@@ -699,14 +706,14 @@ Error expression(const char* line, size_t& pos, float& value) {
 
     Error status;
 
-    if (!read_number(line, pos, values[0]))
+    if (!operands.operand(line, pos, 0))
         return Error::BadNumberFormat;
 
     if ((status = read_operation(line, pos, operators[0])) != Error::Ok)
         return status;
 
     for (; operators[0] != Binary_RightBracket;) {
-        if (!read_number(line, pos, values[stack_index]))
+        if (!operands.operand(line, pos, stack_index))
             return Error::BadNumberFormat;
 
         if ((status = read_operation(line, pos, operators[stack_index])) != Error::Ok)
@@ -716,15 +723,10 @@ Error expression(const char* line, size_t& pos, float& value) {
             stack_index++;
         else {  // precedence of latest operator is <= previous precedence
             for (; precedence(operators[stack_index]) <= precedence(operators[stack_index - 1]);) {
-                if ((status = execute_binary(values[stack_index - 1], operators[stack_index - 1], values[stack_index])) != Error::Ok)
+                if ((status = operands.apply(stack_index - 1, operators[stack_index - 1])) != Error::Ok)
                     return status;
 
                 operators[stack_index - 1] = operators[stack_index];
-                // auto o1 = operators[stack_index - 1];
-                // auto o2 = operators[stack_index - 2];
-                // auto p1 = precedence(o1);
-                // auto p2 = precedence(o1);
-                // if ((stack_index > 1) && p1 <= p2)
                 if ((stack_index > 1) && precedence(operators[stack_index - 1]) <= precedence(operators[stack_index - 2]))
                     stack_index--;
                 else
@@ -733,7 +735,224 @@ Error expression(const char* line, size_t& pos, float& value) {
         }
     }
 
-    value = values[0];
+    return Error::Ok;
+}
+
+// The operand stack for expression(), which computes values as it goes
+struct ExpressionValues {
+    float values[MAX_STACK];
+
+    bool  operand(const char* line, size_t& pos, size_t index) { return read_number(line, pos, values[index]); }
+    Error apply(size_t index, ngc_binary_op_t operation) { return execute_binary(values[index], operation, values[index + 1]); }
+};
+
+/*! \brief Evaluate expression and set result if successful.
+
+\param line pointer to RS274/NGC code (block).
+\param pos offset into line where expression starts.
+\param value pointer to float where result is to be stored.
+\returns #Error::Ok enum value if evaluated without error, appropriate \ref Error enum value if not.
+*/
+Error expression(const char* line, size_t& pos, float& value) {
+    ExpressionValues operands;
+    Error            status = parse_expression(line, pos, operands);
+
+    if (status == Error::Ok)
+        value = operands.values[0];
+
+    return status;
+}
+
+// The operand stack for CompiledExpression, which records the operations
+// instead of doing them.  Operands are compiled as read_number() operands.
+struct ExpressionEmitter {
+    CompiledExpression& compiled;
+
+    bool operand(const char* line, size_t& pos, size_t index) {
+        ++compiled._nesting;
+        bool ok = compiled.number(line, pos);
+        --compiled._nesting;
+        return ok;
+    }
+    Error apply(size_t index, ngc_binary_op_t operation) {
+        return compiled.push(CompiledExpression::Code::Binary, operation) ? Error::Ok : Error::ExpressionSyntaxError;
+    }
+};
+
+void CompiledExpression::clear() {
+    _code.clear();
+    _depth   = 0;
+    _nesting = 0;
+}
+
+bool CompiledExpression::compile(const char* line, size_t& pos) {
+    clear();
+    ExpressionEmitter emitter { *this };
+    if (parse_expression(line, pos, emitter) != Error::Ok) {
+        clear();
+        return false;
+    }
+    return true;
+}
+
+bool CompiledExpression::compile_number(const char* line, size_t& pos) {
+    clear();
+    ExpressionEmitter emitter { *this };
+    if (!emitter.operand(line, pos, 0)) {
+        clear();
+        return false;
+    }
+    return true;
+}
+
+// Compiles an operand, following the grammar of read_number()
+bool CompiledExpression::number(const char* line, size_t& pos) {
+    char c = line[pos];
+
+    if (c == '#') {
+        // Indirect references are resolved when they are read, so they cannot be compiled
+        char next = line[pos + 1];
+        if (next == '#' || next == '[') {
+            return false;
+        }
+        ++pos;
+        param_ref_t param_ref;
+        if (!get_param_ref(line, pos, param_ref)) {
+            return false;
+        }
+        return push(Code::Param, 0, 0, param_ref);
+    }
+
+    if (c == '[') {
+        ExpressionEmitter emitter { *this };
+        return parse_expression(line, pos, emitter) == Error::Ok;
+    }
+
+    char c1 = line[pos + 1];
+    if ((c == '-' || c == '+') && c1 && !isdigit(c1) && c1 != '.') {
+        ++pos;
+        if (!number(line, pos)) {
+            return false;
+        }
+        return c == '+' || push(Code::Negate, 0);
+    }
+
+    if (isalpha(c)) {
+        ngc_unary_op_t operation;
+        if (read_operation_unary(line, pos, operation) != Error::Ok || line[pos] != '[' || operation == Unary_Exists) {
+            return false;
+        }
+        ExpressionEmitter emitter { *this };
+        if (parse_expression(line, pos, emitter) != Error::Ok) {
+            return false;
+        }
+        if (operation == Unary_ATAN) {
+            if (line[pos] != '/' || line[++pos] != '[' || parse_expression(line, pos, emitter) != Error::Ok) {
+                return false;
+            }
+            return push(Code::Atan, 0);
+        }
+        return push(Code::Unary, operation);
+    }
+
+    float value;
+    if (!read_float(line, pos, value)) {
+        return false;
+    }
+    return push(Code::Constant, 0, value);
+}
 
+// Adds an instruction, or if its operands are constant, replaces them with
+// the constant result.  Fails if the stack would be too deep.
+bool CompiledExpression::push(Code code, uint8_t op, float value, param_ref_t param) {
+    Instruction instruction = { code, op, _nesting > 0, value, param };
+
+    size_t n_operands = 0;
+    switch (code) {
+        case Code::Constant:
+        case Code::Param:
+            if (++_depth > max_depth) {
+                return false;
+            }
+            break;
+        case Code::Negate:
+        case Code::Unary:
+            n_operands = 1;
+            break;
+        case Code::Atan:
+        case Code::Binary:
+            n_operands = 2;
+            --_depth;
+            break;
+    }
+
+    if (n_operands && _code.size() >= n_operands) {
+        float operands[2];
+        bool  constant = true;
+        for (size_t i = 0; i < n_operands; i++) {
+            auto& operand = _code[_code.size() - n_operands + i];
+            constant &= operand.code == Code::Constant;
+            operands[i] = operand.value;
+        }
+        // A division by zero is left for evaluate() to report
+        bool divides_by_zero = code == Code::Binary && op == Binary_DividedBy && operands[1] == 0.0f;
+        if (constant && !divides_by_zero && step(instruction, operands + n_operands) == Error::Ok) {
+            _code.resize(_code.size() - n_operands);
+            _code.push_back({ Code::Constant, 0, instruction.nested, operands[0], {} });
+            return true;
+        }
+    }
+    _code.push_back(instruction);
+    return true;
+}
+
+// Does an operation on the values below top
+Error CompiledExpression::step(const Instruction& instruction, float* top) {
+    switch (instruction.code) {
+        case Code::Negate:
+            top[-1] = -top[-1];
+            return Error::Ok;
+        case Code::Unary:
+            return execute_unary(top[-1], ngc_unary_op_t(instruction.op));
+        case Code::Atan:
+            top[-2] = atan2f(top[-2], top[-1]) * DEGRAD; /* value in radians, convert to degrees */
+            return Error::Ok;
+        case Code::Binary:
+            return execute_binary(top[-2], ngc_binary_op_t(instruction.op), top[-1]);
+        default:
+            return Error::ExpressionUnknownOp;
+    }
+}
+
+Error CompiledExpression::evaluate(float& value) const {
+    float  stack[max_depth];
+    float* top = stack;
+
+    for (auto const& instruction : _code) {
+        switch (instruction.code) {
+            case Code::Constant:
+                *top++ = instruction.value;
+                break;
+            case Code::Param:
+                if (!read_param(instruction.param, *top)) {
+                    return Error::BadNumberFormat;
+                }
+                ++top;
+                break;
+            default: {
+                Error status = step(instruction, top);
+                if (status != Error::Ok) {
+                    return instruction.nested ? Error::BadNumberFormat : status;
+                }
+                if (instruction.code == Code::Atan || instruction.code == Code::Binary) {
+                    --top;
+                }
+            }
+        }
+    }
+    if (top == stack) {
+        return Error::BadNumberFormat;
+    }
+    value = stack[0];
     return Error::Ok;
 }
@@ -1,3 +1,67 @@
 #pragma once
+
+#include "Error.h"
+#include "Parameters.h"  // param_ref_t
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
 Error expression(const char* line, size_t& pos, float& value);
 Error read_unary(const char* line, size_t& pos, float& value);
+
+// An expression, or any other value that read_number() accepts, compiled
+// into a postfix program so that it can be evaluated again without parsing
+// the text.  Parameters are read when the program runs, and operations whose
+// operands are all constant are done when it is compiled.  Evaluating gives
+// the same value and errors as reading the text would.
+//
+// Indirect parameter references, like ##1 and #[expr], and EXISTS[] are not
+// compiled, so compiling fails for text that uses them; the caller keeps
+// reading that text with read_number() or expression().
+class CompiledExpression {
+public:
+    // Compiles the value at line[pos] the way read_number() reads it
+    bool compile_number(const char* line, size_t& pos);
+
+    // Compiles the bracketed expression at line[pos] the way expression() reads it
+    bool compile(const char* line, size_t& pos);
+
+    Error evaluate(float& value) const;
+
+    bool   empty() const { return _code.empty(); }
+    bool   constant() const { return _code.size() == 1 && _code[0].code == Code::Constant; }
+    size_t size() const { return _code.size(); }
+    void   clear();
+
+private:
+    friend struct ExpressionEmitter;
+
+    enum class Code : uint8_t {
+        Constant,  // Pushes value
+        Param,     // Pushes the value of param
+        Negate,    // Negates the top value
+        Unary,     // Applies the unary operation op to the top value
+        Atan,      // Replaces the top two values with ATAN[top - 1]/[top]
+        Binary,    // Applies the binary operation op to the top two values
+    };
+    struct Instruction {
+        Code        code;
+        uint8_t     op;
+        bool        nested;  // Errors are reported as BadNumberFormat, as read_number() fails
+        float       value;
+        param_ref_t param;
+    };
+
+    static const size_t max_depth = 32;
+
+    std::vector<Instruction> _code;
+
+    // Compile state
+    size_t _depth   = 0;  // Values on the stack
+    size_t _nesting = 0;  // Depth of read_number() operands
+
+    bool         number(const char* line, size_t& pos);
+    bool         push(Code code, uint8_t op, float value = 0, param_ref_t param = {});
+    static Error step(const Instruction& instruction, float* top);
+};
@@ -7,7 +7,7 @@
 #include "Configuration/JsonGenerator.h"
 #include "InputFile.h"    // InputFile
 #include "Job.h"          // Job::
-#include "xmodem.h"       // xmodemReceive(), xmodemTransmit()
+#include "xmodem.h"       // xmodemReceive(), ymodemReceive(), xmodemTransmit()
 #include "Protocol.h"     // pollingPaused
 #include "string_util.h"  // split_prefix()
 
@@ -554,7 +554,7 @@ static Error copyDir(const Volume& ifs, const std::string_view iDir, const Volum
     return err;
 }
 static Error showLocalFSHashes(const char* parameter, AuthenticationLevel auth_level, Channel& out) {
-    for (const auto& [name, hash] : HashFS::localFsHashes) {
+    for (const auto& [name, hash] : HashFS::hashes()) {
         log_info_to(out, name << ": " << hash);
     }
     return Error::Ok;
@@ -598,6 +598,29 @@ static Error showSDStatus(const char* parameter, AuthenticationLevel auth_level,
     return Error::Ok;
 }
 
+static void log_receive_failure(int len) {
+    switch (len) {
+        case -6:
+            log_info("Reception failed: not enough free space on the target filesystem");
+            break;
+        case -7:
+            log_info("Reception failed: not enough memory");
+            break;
+        case -8:
+            log_info("Reception failed: cannot create the file");
+            break;
+        default:
+            log_info("Reception failed or was canceled");
+            break;
+    }
+}
+
+static void log_transfer_stats(const TransferStats& stats) {
+    uint32_t ms = stats.ms ? stats.ms : 1;
+    log_info("Transfer took " << stats.ms << " ms, " << (stats.bytes * 1000 / ms / 1024) << " KB/s, " << stats.packets << " packets, "
+                              << stats.retries << " retries, " << stats.write_wait_ms << " ms waiting for writes");
+}
+
 static Error xmodem_receive(const char* value, AuthenticationLevel auth_level, Channel& out) {
     if (!value || !*value) {
         value = "uploaded";
@@ -613,15 +636,15 @@ static Error xmodem_receive(const char* value, AuthenticationLevel auth_level, C
     pollingPaused = true;
     bool oldCr    = out.setCr(false);
     delay_ms(1000);
-    int len = xmodemReceive(&out, outfile);
+    TransferStats stats;
+    int           len = xmodemReceive(&out, outfile, stats);
     out.setCr(oldCr);
     pollingPaused = false;
     if (len >= 0) {
         log_info("Received " << len << " bytes to file " << outfile->path());
-    } else if (len == -6) {
-        log_info("Reception failed: not enough free space on the target filesystem");
+        log_transfer_stats(stats);
     } else {
-        log_info("Reception failed or was canceled");
+        log_receive_failure(len);
     }
     std::filesystem::path fname = outfile->fpath();
     delete outfile;
@@ -639,6 +662,37 @@ static Error xmodem_receive(const char* value, AuthenticationLevel auth_level, C
     return len < 0 ? Error::UploadFailed : Error::Ok;
 }
 
+// Ymodem sends the file names, so the parameter is the directory to put them
+// in, by default the top of the local filesystem.  The receive functions
+// delete any partial file and update the file hashes themselves.
+static Error ymodem_receive_files(const char* value, bool streaming, Channel& out) {
+    if (!value) {
+        value = "";
+    }
+    pollingPaused = true;
+    bool oldCr    = out.setCr(false);
+    delay_ms(1000);
+    TransferStats stats;
+    int           len = ymodemReceive(&out, value, streaming, stats);
+    out.setCr(oldCr);
+    pollingPaused = false;
+    if (len >= 0) {
+        log_info("Received " << len << " bytes in " << stats.files << (stats.files == 1 ? " file" : " files"));
+        log_transfer_stats(stats);
+    } else {
+        log_receive_failure(len);
+    }
+    return len < 0 ? Error::UploadFailed : Error::Ok;
+}
+
+static Error ymodem_receive(const char* value, AuthenticationLevel auth_level, Channel& out) {
+    return ymodem_receive_files(value, false, out);
+}
+
+static Error ymodem_receive_streaming(const char* value, AuthenticationLevel auth_level, Channel& out) {
+    return ymodem_receive_files(value, true, out);
+}
+
 static Error xmodem_send(const char* value, AuthenticationLevel auth_level, Channel& out) {
     if (!value || !*value) {
         value = "config.yaml";
@@ -697,6 +751,8 @@ void make_file_commands() {
     new WebCommand("path", WEBCMD, WU, NULL, "Files/ListGCode", listGCodeFiles);
     new UserCommand("XR", "Xmodem/Receive", xmodem_receive, allowConfigStates);
     new UserCommand("XS", "Xmodem/Send", xmodem_send, allowConfigStates);
+    new UserCommand("YR", "Ymodem/Receive", ymodem_receive, allowConfigStates);
+    new UserCommand("YG", "Ymodem/ReceiveG", ymodem_receive_streaming, allowConfigStates);
 
     new WebCommand("RESTART", WEBCMD, WA, NULL, "Bye", restart);
 }
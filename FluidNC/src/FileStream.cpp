@@ -16,9 +16,41 @@ int FileStream::available() {
     return size() - position();
 }
 
+bool FileStream::fill() {
+    if (!_rbuf) {
+        _rbuf = new char[FILE_READ_BUFFER_SIZE];
+    }
+    _rbuf_pos += _rbuf_len;
+    _rbuf_next = 0;
+    _rbuf_len  = fread(_rbuf, 1, FILE_READ_BUFFER_SIZE, _fd);
+    return _rbuf_len != 0;
+}
+
+// Forget the buffered data after the underlying file has been moved to pos
+void FileStream::discard_buffer(size_t pos) {
+    _rbuf_pos  = pos;
+    _rbuf_len  = 0;
+    _rbuf_next = 0;
+}
+
+bool FileStream::read_ahead(const char*& data, size_t& length) {
+    if (_rbuf_next == _rbuf_len && !fill()) {
+        return false;
+    }
+    data   = _rbuf + _rbuf_next;
+    length = _rbuf_len - _rbuf_next;
+    return true;
+}
+
 int FileStream::read() {
-    char   data;
-    size_t res = fread(&data, 1, 1, _fd);
+    if (_buffered) {
+        if (_rbuf_next == _rbuf_len && !fill()) {
+            return -1;
+        }
+        return (uint8_t)_rbuf[_rbuf_next++];
+    }
+    uint8_t data;
+    size_t  res = fread(&data, 1, 1, _fd);
     return res == 1 ? data : -1;
 }
 
@@ -29,7 +61,22 @@ int FileStream::peek() {
 void FileStream::flush() {}
 
 int FileStream::read(char* buffer, size_t length) {
-    return fread(buffer, 1, length, _fd);
+    if (!_buffered) {
+        return fread(buffer, 1, length, _fd);
+    }
+    size_t n = std::min(length, _rbuf_len - _rbuf_next);
+    if (n) {
+        memcpy(buffer, _rbuf + _rbuf_next, n);
+        _rbuf_next += n;
+    }
+    if (n < length) {
+        // The rest of a large read bypasses the buffer
+        discard_buffer(_rbuf_pos + _rbuf_len);
+        size_t res = fread(buffer + n, 1, length - n, _fd);
+        _rbuf_pos += res;
+        n += res;
+    }
+    return n;
 }
 
 size_t FileStream::write(uint8_t c) {
@@ -45,7 +92,7 @@ size_t FileStream::size() {
 }
 
 size_t FileStream::position() {
-    return ftell(_fd);
+    return _buffered ? _rbuf_pos + _rbuf_next : ftell(_fd);
 }
 
 void FileStream::setup(const char* mode) {
@@ -55,7 +102,8 @@ void FileStream::setup(const char* mode) {
         bool opening = strcmp(mode, "w");
         throw ErrorException(opening ? Error::FsFailedOpenFile : Error::FsFailedCreateFile);
     }
-    _size = stdfs::file_size(_fpath);
+    _size     = stdfs::file_size(_fpath);
+    _buffered = strchr(mode, 'r') && !strchr(mode, '+');
 }
 
 FileStream::FileStream(const char* filename, const char* mode, const Volume& fs) : Channel(filename), _fpath(filename, fs), _mode(mode) {
@@ -68,19 +116,28 @@ FileStream::FileStream(FluidPath fpath, const char* mode) : Channel("file"), _mo
 }
 
 void FileStream::set_position(size_t pos) {
+    // Flowcontrol loops usually jump back to a position that is still buffered
+    if (_buffered && pos >= _rbuf_pos && pos <= _rbuf_pos + _rbuf_len) {
+        _rbuf_next = pos - _rbuf_pos;
+        return;
+    }
     fseek(_fd, pos, SEEK_SET);
+    discard_buffer(pos);
 }
 
 void FileStream::save() {
     _saved_position = position();
     fclose(_fd);
     _fd = nullptr;
+    delete[] _rbuf;
+    _rbuf = nullptr;
 }
 
 void FileStream::restore() {
     _fd = fopen(_fpath.string().c_str(), _mode);
     if (_fd) {
         fseek(_fd, _saved_position, SEEK_SET);
+        discard_buffer(_saved_position);
     } else {
         // XXX need to unwind the job stack somehow
     }
@@ -90,4 +147,5 @@ FileStream::~FileStream() {
     if (_fd) {
         fclose(_fd);
     }
+    delete[] _rbuf;
 }
@@ -29,7 +29,26 @@ class FileStream : public Channel {
     long        _saved_position;  // Used when the
     const char* _mode;
 
+    // Files that are opened for reading only are read through a block buffer.
+    // _rbuf_pos is the file offset of _rbuf[0]; the unread data is from
+    // _rbuf_next up to _rbuf_len.  The underlying file is always positioned
+    // at _rbuf_pos + _rbuf_len.
+    bool   _buffered  = false;
+    char*  _rbuf      = nullptr;
+    size_t _rbuf_pos  = 0;
+    size_t _rbuf_len  = 0;
+    size_t _rbuf_next = 0;
+
     void setup(const char* mode);
+    bool fill();
+    void discard_buffer(size_t pos);
+
+protected:
+    // read_ahead() exposes the unread part of the read buffer, refilling it if
+    // necessary, so that subclasses can scan it in place.  It returns false at
+    // end of file.  consume() marks length bytes of it as read.
+    bool read_ahead(const char*& data, size_t& length);
+    void consume(size_t length) { _rbuf_next += length; }
 
 public:
     FileStream() = delete;
@@ -11,6 +11,7 @@
 #include "Expression.h"
 #include "Parameters.h"
 #include "Job.h"
+#include <algorithm>
 #include <stack>
 
 #ifndef NGC_STACK_DEPTH
@@ -46,6 +47,9 @@ typedef struct {
     bool        skip;
     bool        handled;
     bool        brk;
+    bool        cached;  // The loop body is being kept in the job's line cache
+
+    CompiledExpression condition;  // The while condition of a loop, once it has been compiled
 } ngc_stack_entry_t;
 
 std::stack<ngc_stack_entry_t> context;
@@ -82,14 +86,42 @@ static Error read_command(const char* line, size_t& pos, ngc_cmd_t& operation) {
 }
 
 static Error stack_push(uint32_t o_label, ngc_cmd_t operation, bool skip) {
-    ngc_stack_entry_t ent = { o_label, operation, Job::source(), 0, 0, "", 0, skip, false, false };
+    ngc_stack_entry_t ent = { o_label, operation, Job::source(), 0, 0, "", 0, skip, false, false, false };
     context.push(ent);
     return Error::Ok;
 }
+// Records the loop start position and lets the job cache the loop body
+static void start_loop() {
+    auto& top       = context.top();
+    top.file_pos    = top.file->position();
+    top.line_number = top.file->lineNumber();
+    top.cached      = true;
+    top.file->begin_loop();
+}
+// Evaluates the while condition of a loop at line[pos], compiling it the
+// first time so that later iterations need not parse it.  pos is advanced
+// only when the text is parsed.
+static Error loop_condition(ngc_stack_entry_t& loop, const char* line, size_t& pos, float& value) {
+    if (loop.condition.empty()) {
+        size_t end = pos;
+        if (!loop.condition.compile(line, end)) {
+            return expression(line, pos, value);
+        }
+    }
+    return loop.condition.evaluate(value);
+}
 static bool stack_pull(void) {
     if (context.empty()) {
         return false;
     }
+    auto& top = context.top();
+    if (top.cached) {
+        // The job might have ended, e.g. on a reset
+        auto& jobs = Job::jobs_stack();
+        if (std::find(jobs.begin(), jobs.end(), top.file) != jobs.end()) {
+            top.file->end_loop();
+        }
+    }
     context.pop();
     return true;
 }
@@ -108,6 +140,16 @@ void flowcontrol_init(void) {
     }
 }
 
+// Forgets every open flow control block after a reset, without touching the
+// jobs.  Lines of a loop body may still be queued, and the polling task may be
+// changing the job stack, so loops are not ended in their jobs here.  The
+// polling task aborts the jobs after a reset, which drops their line caches.
+void flowcontrol_reset(void) {
+    while (!context.empty()) {
+        context.pop();
+    }
+}
+
 // Public functions
 
 Error flowcontrol(uint32_t o_label, const char* line, size_t& pos, bool& skip) {
@@ -172,8 +214,7 @@ Error flowcontrol(uint32_t o_label, const char* line, size_t& pos, bool& skip) {
             if (Job::active()) {
                 if (!skipping) {
                     stack_push(o_label, operation, false);
-                    context.top().file_pos    = context.top().file->position();
-                    context.top().line_number = context.top().file->lineNumber();
+                    start_loop();
                 }
             } else {
                 status = Error::FlowControlNotExecutingMacro;
@@ -182,12 +223,14 @@ Error flowcontrol(uint32_t o_label, const char* line, size_t& pos, bool& skip) {
 
         case Op_While:
             if (Job::active()) {
-                const char* expr = line + pos;
+                const char* expr    = line + pos;
+                bool        do_loop = last_op == Op_Do && o_label == context.top().o_label;
                 if (!context.empty() && context.top().brk) {
                     if (last_op == Op_Do && o_label == context.top().o_label) {
                         stack_pull();
                     }
-                } else if (!skipping && (status = expression(line, pos, value)) == Error::Ok) {
+                } else if (!skipping && (status = do_loop ? loop_condition(context.top(), line, pos, value)
+                                                          : expression(line, pos, value)) == Error::Ok) {
                     if (last_op == Op_Do) {
                         if (o_label == context.top().o_label) {
                             if (value) {
@@ -202,8 +245,7 @@ Error flowcontrol(uint32_t o_label, const char* line, size_t& pos, bool& skip) {
                         context.top().expr = expr;
                         context.top().file = Job::source();
                         if (value) {
-                            context.top().file_pos    = context.top().file->position();
-                            context.top().line_number = context.top().file->lineNumber();
+                            start_loop();
                         }
                     }
                 }
@@ -217,7 +259,8 @@ Error flowcontrol(uint32_t o_label, const char* line, size_t& pos, bool& skip) {
                 if (last_op == Op_While) {
                     if (!skipping && o_label == context.top().o_label) {
                         size_t pos = 0;
-                        if (!context.top().skip && (status = expression(context.top().expr.c_str(), pos, value)) == Error::Ok) {
+                        if (!context.top().skip &&
+                            (status = loop_condition(context.top(), context.top().expr.c_str(), pos, value)) == Error::Ok) {
                             if (!(context.top().skip = value == 0)) {
                                 context.top().file->set_position(context.top().file_pos);
                             }
@@ -241,10 +284,9 @@ Error flowcontrol(uint32_t o_label, const char* line, size_t& pos, bool& skip) {
                 if (!skipping && (status = expression(line, pos, value)) == Error::Ok) {
                     stack_push(o_label, operation, !value);
                     if (value) {
-                        context.top().file        = Job::source();
-                        context.top().file_pos    = context.top().file->position();
-                        context.top().line_number = context.top().file->lineNumber();
-                        context.top().repeats     = (uint32_t)value;
+                        context.top().file    = Job::source();
+                        context.top().repeats = (uint32_t)value;
+                        start_loop();
                     }
                 }
             } else {
@@ -314,7 +356,8 @@ Error flowcontrol(uint32_t o_label, const char* line, size_t& pos, bool& skip) {
 
                             case Op_While: {
                                 size_t pos = 0;
-                                if (!context.top().skip && (status = expression(context.top().expr.c_str(), pos, value)) == Error::Ok) {
+                                if (!context.top().skip &&
+                                    (status = loop_condition(context.top(), context.top().expr.c_str(), pos, value)) == Error::Ok) {
                                     if (!(context.top().skip = value == 0)) {
                                         context.top().file->set_position(context.top().file_pos);
                                         context.top().file->setLineNumber(context.top().line_number);
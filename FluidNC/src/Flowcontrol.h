@@ -1,4 +1,5 @@
 #pragma once
 
 void  flowcontrol_init(void);
+void  flowcontrol_reset(void);
 Error flowcontrol(uint32_t o_label, const char* line, size_t& pos, bool& skip);
@@ -50,6 +50,7 @@ gc_modal_t modal_defaults = {
     // CutterCompensation::Disable,
     ToolLengthOffset::Cancel,
     CoordIndex::G54,
+    ControlMode::ExactPath,  // G61
     ProgramFlow::Running,
     {}, // 0, // CoolantState::M7,
     SpindleState::Disable,
@@ -70,7 +71,7 @@ void gc_init() {
     gc_state.modal.override = config->_start->_deactivateParking ? Override::Disabled : Override::ParkingMotion;
     gc_state.current_tool   = -1;
     coords[gc_state.modal.coord_select]->get(gc_state.coord_system);
-    flowcontrol_init();
+    flowcontrol_reset();
 }
 
 // Sets g-code parser position in mm. Input in steps. Called by the system abort and hard
@@ -237,6 +238,13 @@ void gc_wco_changed() {
     allChannels.notifyWco();
 }
 
+static Error gc_execute_block(const char*            line,
+                              const CompiledWord*    words,
+                              size_t                 n_words,
+                              size_t                 start,
+                              const CompiledOperand* operands   = nullptr,
+                              size_t                 n_operands = 0);
+
 // Executes one line of NUL-terminated G-Code.
 // The line may contain whitespace and comments, which are first removed,
 // and lower case characters, which are converted to upper case.
@@ -244,6 +252,18 @@ void gc_wco_changed() {
 // exported to internal functions in terms of (mm, mm/min) and absolute machine
 // coordinates, respectively.
 Error gc_execute_line(const char* input_line) {
+    // Binary lines are already tokenized
+    if (GCodeBinary::is_binary(input_line)) {
+        CompiledWord words[GCodeBinary::max_words];
+        size_t       n_words;
+        const char*  rest;
+        Error        err = GCodeBinary::decode(input_line, words, n_words, rest);
+        if (err != Error::Ok) {
+            return err;
+        }
+        return gc_execute_block(rest, words, n_words, 0);
+    }
+
     char line[128];
     if (strlen(input_line) > 127) {
         return Error::LineLengthExceeded;
@@ -253,6 +273,91 @@ Error gc_execute_line(const char* input_line) {
     // Step 0 - remove whitespace and comments and convert to upper case
     collapseGCode(line);
 
+    return gc_execute_block(line, nullptr, 0, 0);
+}
+
+// Does step 0 of gc_execute_line() ahead of time, and also converts the
+// leading words whose values are plain numbers, so a line that is executed
+// many times - like the body of a flow control loop - does not have to be
+// parsed again each time.  Words after the first one whose value is a
+// parameter or an expression are left as text, since their values can change
+// from one execution to the next.  Returns false if the line cannot be
+// compiled because preprocessing it has side effects.
+bool gc_compile_line(const char* input_line, CompiledLine& compiled) {
+    compiled.words.clear();
+    compiled.text.clear();
+    compiled.rest = 0;
+    compiled.operands.clear();
+
+    if (GCodeBinary::is_binary(input_line)) {
+        CompiledWord words[GCodeBinary::max_words];
+        size_t       n_words;
+        const char*  rest;
+        if (GCodeBinary::decode(input_line, words, n_words, rest) != Error::Ok) {
+            return false;
+        }
+        compiled.words.assign(words, words + n_words);
+        compiled.text = rest;
+        return true;
+    }
+
+    // Comments can print messages and % can end the job, so those lines
+    // must go through gc_execute_line() every time.  O words are excluded
+    // because flow control can release the cache that holds a compiled line.
+    // $ and [ lines are not GCode.
+    if (strlen(input_line) > 127 || strpbrk(input_line, "(%Oo")) {
+        return false;
+    }
+    const char* first = input_line + strspn(input_line, " \t");
+    if (*first == '$' || *first == '[') {
+        return false;
+    }
+    char line[128];
+    strcpy(line, input_line);
+    collapseGCode(line);
+
+    size_t pos = 0;
+    char   letter;
+    while ((letter = line[pos]) >= 'A' && letter <= 'Z') {
+        size_t next = pos + 1;
+        float  value;
+        if (!read_float(line, next, value)) {
+            break;
+        }
+        compiled.words.push_back({ letter, value });
+        pos = next;
+    }
+    compiled.text = line;
+    compiled.rest = pos;
+
+    // Compile the values of the words that follow, which have expressions or
+    // parameter references, up to the first one that cannot be compiled
+    while ((letter = line[pos]) >= 'A' && letter <= 'Z') {
+        CompiledOperand operand { pos + 1, pos + 1, {} };
+        if (!operand.value.compile_number(line, operand.end)) {
+            break;
+        }
+        pos = operand.end;
+        compiled.operands.push_back(std::move(operand));
+    }
+    return true;
+}
+
+Error gc_execute_compiled(const CompiledLine& compiled) {
+    return gc_execute_block(compiled.text.c_str(),
+                            compiled.words.data(),
+                            compiled.words.size(),
+                            compiled.rest,
+                            compiled.operands.data(),
+                            compiled.operands.size());
+}
+
+// Executes a block that has been through step 0.  The first n_words words
+// have already been converted, and the rest of the block is text starting
+// at line[start].  Word values in the text that have been compiled are
+// evaluated from operands instead of being parsed.
+static Error gc_execute_block(
+    const char* line, const CompiledWord* words, size_t n_words, size_t start, const CompiledOperand* operands, size_t n_operands) {
     /* -------------------------------------------------------------------------------------
        STEP 1: Initialize parser block struct and copy current g-code state modes. The parser
        updates these modes and commands as the block line is parser and will only be used and
@@ -281,6 +386,7 @@ Error gc_execute_line(const char* input_line) {
     bool laserIsMotion        = false;
     bool nonmodalG38          = false;  // Used for G38.6-9
     bool isWaitOnInputDigital = false;
+    bool hasPathTolerance     = false;
 
     auto    n_axis = Axes::_numberAxis;
     float   coord_data[MAX_N_AXIS];  // Used by WCO-related commands
@@ -309,34 +415,55 @@ Error gc_execute_line(const char* input_line) {
     float      value;
     int32_t    int_value = 0;
     int32_t    mantissa  = 0;
-    pos                  = jogMotion ? 3 : 0;  // Start parsing after `$J=` if jogging
-    while ((letter = line[pos]) != '\0') {     // Loop until no more g-code words in line.
-        if (letter == '#') {
+    size_t     word_index = 0;
+    pos                   = jogMotion ? 3 : start;  // Start parsing after `$J=` if jogging
+    while (true) {
+        if (word_index < n_words) {
+            // Compiled lines never have O words
+            letter = words[word_index].letter;
+            value  = words[word_index].value;
+            ++word_index;
             if (gc_state.skip_blocks) {
                 return Error::Ok;
             }
-            pos++;
-            if (!assign_param(line, pos)) {
-                return Error::BadNumberFormat;
+        } else {
+            if ((letter = line[pos]) == '\0') {  // Loop until no more g-code words in line.
+                break;
+            }
+            if (letter == '#') {
+                if (gc_state.skip_blocks) {
+                    return Error::Ok;
+                }
+                pos++;
+                if (!assign_param(line, pos)) {
+                    return Error::BadNumberFormat;
+                }
+                continue;
             }
-            continue;
-        }
 
-        // XXX Should check that no other words are also present
-        if (bitnum_is_true(value_words, GCodeWord::O)) {
-            return flowcontrol(gc_block.values.o, line, pos, gc_state.skip_blocks);
-        }
+            // XXX Should check that no other words are also present
+            if (bitnum_is_true(value_words, GCodeWord::O)) {
+                return flowcontrol(gc_block.values.o, line, pos, gc_state.skip_blocks);
+            }
 
-        // Import the next g-code word, expecting a letter followed by a value. Otherwise, error out.
-        if ((letter < 'A') || (letter > 'Z')) {
-            return Error::ExpectedCommandLetter;  // [Expected word letter]
-        }
-        pos++;
-        if (!read_number(line, pos, value)) {
-            return Error::BadNumberFormat;  // [Expected word value]
-        }
-        if (gc_state.skip_blocks && letter != 'O') {
-            return Error::Ok;
+            // Import the next g-code word, expecting a letter followed by a value. Otherwise, error out.
+            if ((letter < 'A') || (letter > 'Z')) {
+                return Error::ExpectedCommandLetter;  // [Expected word letter]
+            }
+            pos++;
+            if (n_operands && operands->start == pos) {
+                if (operands->value.evaluate(value) != Error::Ok) {
+                    return Error::BadNumberFormat;  // [Expected word value]
+                }
+                pos = operands->end;
+                ++operands;
+                --n_operands;
+            } else if (!read_number(line, pos, value)) {
+                return Error::BadNumberFormat;  // [Expected word value]
+            }
+            if (gc_state.skip_blocks && letter != 'O') {
+                return Error::Ok;
+            }
         }
 
         // Convert values to smaller uint8 significand and mantissa values for parsing this word.
@@ -602,12 +729,23 @@ Error gc_execute_line(const char* input_line) {
                         break;
                         // NOTE: G59.x are not supported.
                     case 61:
-                        if (mantissa != 0) {
-                            return Error::GcodeUnsupportedCommand;  // [G61.1 not supported]
+                        switch (mantissa) {
+                            case 0:
+                                gc_block.modal.control = ControlMode::ExactPath;  // G61
+                                break;
+                            case 10:
+                                gc_block.modal.control = ControlMode::ExactStop;  // G61.1
+                                break;
+                            default:
+                                return Error::GcodeUnsupportedCommand;
                         }
-                        // gc_block.modal.control = ControlMode::ExactPath; // G61
+                        mantissa    = 0;  // Set to zero to indicate valid non-integer G command.
                         mg_word_bit = ModalGroup::MG13;
                         break;
+                    case 64:
+                        gc_block.modal.control = ControlMode::Continuous;
+                        mg_word_bit            = ModalGroup::MG13;
+                        break;
                     default:
                         return Error::GcodeUnsupportedCommand;  // [Unsupported G command]
                 }
@@ -1174,7 +1312,16 @@ Error gc_execute_line(const char* input_line) {
             coords[gc_block.modal.coord_select]->get(block_coord_system);
         }
     }
-    // [16. Set path control mode ]: N/A. Only G61. G61.1 and G64 NOT SUPPORTED.
+    // [16. Set path control mode ]: G64 P is the path tolerance, unless G10 in the same block claims P.
+    // P cannot be negative.
+    if (bitnum_is_true(command_words, ModalGroup::MG13) && gc_block.modal.control == ControlMode::Continuous &&
+        gc_block.non_modal_command != NonModal::SetCoordinateData && bitnum_is_true(value_words, GCodeWord::P)) {
+        if (gc_block.values.p < 0.0f) {
+            return Error::NegativeValue;
+        }
+        hasPathTolerance = true;
+        clear_bitnum(value_words, GCodeWord::P);
+    }
     // [17. Set distance mode ]: N/A. Only G91.1. G90.1 NOT SUPPORTED.
     // [18. Set retract mode ]: NOT SUPPORTED.
     // [19. Remaining non-modal actions ]: Check go to predefined position, set G10, or set axis offsets.
@@ -1837,8 +1984,19 @@ Error gc_execute_line(const char* input_line) {
         copyAxes(gc_state.coord_system, block_coord_system);
         gc_wco_changed();
     }
-    // [16. Set path control mode ]: G61.1/G64 NOT SUPPORTED
-    // gc_state.modal.control = gc_block.modal.control; // NOTE: Always default.
+    // [16. Set path control mode ]:
+    if (bitnum_is_true(command_words, ModalGroup::MG13)) {
+        gc_state.modal.control = gc_block.modal.control;
+        if (gc_state.modal.control == ControlMode::Continuous) {
+            gc_state.path_tolerance = hasPathTolerance ? gc_block.values.p : 0.0f;
+            if (gc_block.modal.units == Units::Inches) {
+                gc_state.path_tolerance *= MM_PER_INCH;
+            }
+        }
+    }
+    // G64 is planned like G61, since corner blending is not implemented.  The
+    // tolerance is only kept for the $G report.
+    pl_data->motion.exactStop = gc_state.modal.control == ControlMode::ExactStop;
     // [17. Set distance mode ]:
     gc_state.modal.distance = gc_block.modal.distance;
     // [18. Set retract mode ]: NOT SUPPORTED
@@ -2013,7 +2171,6 @@ Error gc_execute_line(const char* input_line) {
    group 8 = {G43} tool length offset (G43.1/G49 are supported)
    group 9 = {M48, M49} enable/disable feed and speed override switches
    group 10 = {G98, G99} return mode canned cycles
-   group 13 = {G61.1, G64} path control mode (G61 is supported)
 */
 
 static std::optional<WaitOnInputMode> validate_wait_on_input_mode_value(objnum_t value) {
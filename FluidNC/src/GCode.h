@@ -8,9 +8,13 @@
 #include "Config.h"
 #include "Error.h"
 #include "SpindleDatatypes.h"
+#include "GCodeBinary.h"  // CompiledWord
+#include "Expression.h"   // CompiledExpression
 
 #include <cstdint>
 #include <optional>
+#include <string>
+#include <vector>
 
 typedef uint16_t gcodenum_t;
 
@@ -133,7 +137,9 @@ enum class CutterCompensation : gcodenum_t {
 
 // Modal Group G13: Control mode
 enum class ControlMode : gcodenum_t {
-    ExactPath = 610,  // G61
+    ExactPath  = 610,  // G61 Default
+    ExactStop  = 611,  // G61.1
+    Continuous = 640,  // G64
 };
 
 // GCodeCoolant is used by the parser, where at most one of
@@ -270,7 +276,7 @@ struct gc_modal_t {
     // CutterCompensation cutter_comp;  // {G40} NOTE: Don't track. Only default supported.
     ToolLengthOffset tool_length;   // {G43.1,G49}
     CoordIndex       coord_select;  // {G54,G55,G56,G57,G58,G59}
-    // uint8_t control;      // {G61} NOTE: Don't track. Only default supported.
+    ControlMode      control;       // {G61,G61.1,G64}
     ProgramFlow   program_flow;  // {M0,M1,M2,M30}
     CoolantState  coolant;       // {M7,M8,M9}
     SpindleState  spindle;       // {M3,M4,M5}
@@ -303,6 +309,7 @@ struct parser_state_t {
     uint32_t selected_tool;  // tool from T value
     int32_t  current_tool;   // the tool in use. default is -1
     int32_t  line_number;    // Last line number sent
+    float    path_tolerance;  // G64 P tolerance in mm, for the $G report; 0 if none was given
 
     float position[MAX_N_AXIS];  // Where the interpreter considers the tool to be at this point in the code
 
@@ -336,6 +343,30 @@ void gc_init();
 // Execute one block of rs275/ngc/g-code
 Error gc_execute_line(const char* line);
 
+// The value of a word after the leading constant words, compiled from
+// text[start] up to text[end] so that its expression and parameter
+// references need not be parsed again.
+struct CompiledOperand {
+    size_t             start;
+    size_t             end;
+    CompiledExpression value;
+};
+
+// A line that has been preprocessed by gc_compile_line() so that it can be
+// executed repeatedly without repeating the text parsing.  text is the line
+// with whitespace and comments removed; words holds the leading words that
+// have constant values, and parsing resumes at text[rest].  operands holds
+// the compiled values of the words that follow, keyed by their positions.
+struct CompiledLine {
+    std::string                  text;
+    std::vector<CompiledWord>    words;
+    size_t                       rest = 0;
+    std::vector<CompiledOperand> operands;
+};
+
+bool  gc_compile_line(const char* line, CompiledLine& compiled);
+Error gc_execute_compiled(const CompiledLine& compiled);
+
 // Set g-code parser position. Input in steps.
 void gc_sync_position();
 
@@ -0,0 +1,249 @@
+// Copyright (c) 2026 - FluidNC Contributors
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#include "GCodeBinary.h"
+#include "Parameters.h"  // uint_to_float
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+namespace GCodeBinary {
+    namespace {
+        // Reads the bytes of a binary line, undoing the escapes
+        class Reader {
+            const uint8_t* _p;
+
+        public:
+            explicit Reader(const char* p) : _p(reinterpret_cast<const uint8_t*>(p)) {}
+
+            const char* position() const { return reinterpret_cast<const char*>(_p); }
+
+            bool get(uint8_t& c) {
+                c = *_p;
+                if (!c) {
+                    return false;
+                }
+                ++_p;
+                if (c == escape) {
+                    if (!*_p) {
+                        return false;
+                    }
+                    c = *_p++ ^ 0x40;
+                }
+                return true;
+            }
+
+            bool get_varint(uint32_t& value) {
+                value = 0;
+                for (int shift = 0; shift < 36; shift += 6) {
+                    uint8_t c;
+                    if (!get(c) || c >= 0x80) {
+                        return false;
+                    }
+                    c ^= varint_xor;
+                    value |= uint32_t(c & 0x3f) << shift;
+                    if (!(c & 0x40)) {
+                        return true;
+                    }
+                }
+                return false;
+            }
+        };
+
+        // Writes the bytes of a binary line, escaping those that cannot appear in it
+        class Writer {
+            char*  _out;
+            size_t _size;
+            size_t _length   = 0;
+            bool   _overflow = false;
+
+        public:
+            Writer(char* out, size_t size) : _out(out), _size(size) {}
+
+            void raw(uint8_t c) {
+                if (_length + 1 < _size) {
+                    _out[_length++] = char(c);
+                } else {
+                    _overflow = true;
+                }
+            }
+            void put(uint8_t c) {
+                if (must_escape(c)) {
+                    raw(escape);
+                    raw(c ^ 0x40);
+                } else {
+                    raw(c);
+                }
+            }
+            void put_varint(uint32_t value) {
+                while (value >= 0x40) {
+                    put((uint8_t(value & 0x3f) | 0x40) ^ varint_xor);
+                    value >>= 6;
+                }
+                put(uint8_t(value) ^ varint_xor);
+            }
+            size_t finish() {
+                if (_overflow || !_size) {
+                    return 0;
+                }
+                _out[_length] = '\0';
+                return _length;
+            }
+        };
+
+        const int MAX_INT_DIGITS = 8;  // As in read_float()
+
+        // Reads a number the way that read_float() does, but returns the digits
+        // and the decimal exponent instead of converting them to a float.
+        bool read_digits(const char* line, size_t& pos, bool& negative, uint32_t& intval, int8_t& exp) {
+            const char* ptr = line + pos;
+
+            negative = false;
+            if (*ptr == '-') {
+                ++ptr;
+                negative = true;
+            } else if (*ptr == '+') {
+                ++ptr;
+            }
+
+            intval         = 0;
+            exp            = 0;
+            size_t ndigit  = 0;
+            bool   decimal = false;
+            while (true) {
+                char c = *ptr;
+                if (isdigit(c)) {
+                    ++ptr;
+                    ndigit++;
+                    if (ndigit <= MAX_INT_DIGITS) {
+                        if (decimal) {
+                            exp--;
+                        }
+                        intval = intval * 10 + c - '0';
+                    } else if (!decimal) {
+                        exp++;
+                    }
+                } else if (c == '.' && !decimal) {
+                    ++ptr;
+                    decimal = true;
+                } else {
+                    break;
+                }
+            }
+            if (!ndigit) {
+                return false;
+            }
+            pos = ptr - line;
+            return true;
+        }
+
+        bool is_letter(char c) { return c >= 'A' && c <= 'Z'; }
+    }
+
+    Error decode(const char* line, CompiledWord* words, size_t& n_words, const char*& rest) {
+        Reader in(line + 1);
+        n_words = 0;
+        rest    = "";
+
+        uint8_t code;
+        while (in.get(code)) {
+            if (code == text_code) {
+                rest = in.position();
+                if (*rest == '$') {
+                    // Not GCode; a jog would be misparsed
+                    return Error::ExpectedCommandLetter;
+                }
+                break;
+            }
+            if (!is_letter(code)) {
+                return Error::ExpectedCommandLetter;
+            }
+            uint32_t number;
+            if (!in.get_varint(number)) {
+                return Error::BadNumberFormat;
+            }
+            uint8_t places = (number >> 1) & 7;
+            int8_t  exp    = -int8_t(places);
+            if (places == exp_places) {
+                uint32_t e;
+                if (!in.get_varint(e) || (e >> 1) > 127) {
+                    return Error::BadNumberFormat;
+                }
+                exp = (e & 1) ? -int8_t(e >> 1) : int8_t(e >> 1);
+            }
+            if (n_words == max_words) {
+                return Error::Overflow;
+            }
+            float value      = uint_to_float(number >> 4, exp);
+            words[n_words++] = { char(code), (number & 1) ? -value : value };
+        }
+        return Error::Ok;
+    }
+
+    size_t encode(const char* input_line, char* out, size_t size) {
+        // Collapse the line as collapseGCode() would.  Comments can print
+        // messages and % can end a job, so lines with them stay as text.
+        char   line[max_line + 1];
+        size_t len = 0;
+        for (const char* p = input_line; *p && *p != ';'; ++p) {
+            uint8_t c = *p;  // Bytes that are not ASCII are neither space nor letters
+            if (isspace(c) || c == ')') {
+                continue;
+            }
+            if (c == '(' || c == '%' || len == sizeof(line) - 1) {
+                return 0;
+            }
+            line[len++] = toupper(c);
+        }
+        line[len] = '\0';
+
+        // $ and [ lines are not GCode, and O words are flow control, which
+        // must see the line as text.
+        if (!is_letter(line[0]) || strchr(line, 'O')) {
+            return 0;
+        }
+
+        Writer w(out, std::min(size, max_line + 1));
+        w.raw(marker);
+
+        size_t pos     = 0;
+        size_t n_words = 0;
+        while (is_letter(line[pos]) && n_words < max_words) {
+            size_t   next = pos + 1;
+            bool     negative;
+            uint32_t digits;
+            int8_t   exp;
+            if (!read_digits(line, next, negative, digits, exp)) {
+                break;
+            }
+            // A literal followed by anything but another word or an assignment
+            // is left for the text parser, so it reports the same error
+            if (line[next] && !is_letter(line[next]) && line[next] != '#') {
+                break;
+            }
+            bool     has_places = exp <= 0 && exp > -exp_places;
+            uint32_t places     = has_places ? -exp : exp_places;
+            w.raw(line[pos]);
+            w.put_varint(digits << 4 | places << 1 | negative);
+            if (!has_places) {
+                w.put_varint(exp < 0 ? uint32_t(-exp) << 1 | 1 : uint32_t(exp) << 1);
+            }
+            pos = next;
+            ++n_words;
+        }
+        if (!n_words) {
+            return 0;
+        }
+        if (line[pos]) {
+            w.raw(text_code);
+            for (const char* p = line + pos; *p; ++p) {
+                if (must_escape(*p)) {
+                    return 0;
+                }
+                w.raw(*p);
+            }
+        }
+        return w.finish();
+    }
+}
@@ -0,0 +1,81 @@
+// Copyright (c) 2026 - FluidNC Contributors
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#pragma once
+
+// Binary GCode lines carry words that have already been tokenized, so the
+// parser can take them without collapsing the text or converting numbers.
+// A binary line travels like a text line, ending with a newline, so it can
+// appear in a job file (by convention with the .gcb extension) or be sent to
+// a channel that has been switched to binary GCode mode with $GB=ON, mixed
+// freely with text lines.
+//
+// A binary line starts with the byte 0x02, which never starts a GCode text
+// line, followed by a sequence of words.  Each word is the upper case word
+// letter followed by an unsigned varint (six bits per byte, least significant
+// first, bit 6 set on all but the last byte, and each byte sent XOR 0x32 so
+// that common values like 0 need no escapes) of
+//
+//   (digits << 4) | (places << 1) | sign
+//
+// places is the number of decimal places in the value, 0 to 6, or 7 if a
+// second varint follows with the decimal exponent, as (-exponent << 1) | 1
+// if it is negative or exponent << 1 if not.  digits is the number written
+// without its decimal point, as read_float() would read it: at most 8
+// significant digits, with any further integer digits counted in the
+// exponent.  The value is digits * 10^-places or digits * 10^exponent,
+// computed exactly as read_float() computes it, so a binary word has the
+// same float value as the text that it was encoded from.
+//
+// A space ends the words.  The rest of the line is GCode text that has
+// already been through collapseGCode() - upper case, without spaces or
+// comments - holding the words that are not literal numbers, like X#1 or
+// Y[#2*2], and parameter assignments.
+//
+// Every byte of a binary line is below 0x80, and the bytes 0x00, 0x08, 0x0A,
+// 0x0D, 0x18, 0x1B, '!', '?' and '~', which would end or edit the line or be
+// taken as realtime commands, do not appear in it.  Each one is sent instead
+// as 0x1B followed by the byte XOR 0x40.  A channel can therefore handle
+// realtime commands in the middle of a binary line, as it does in text.
+
+#include "Error.h"
+
+#include <cstddef>
+#include <cstdint>
+
+// A GCode word whose value was a literal number when the line was compiled
+struct CompiledWord {
+    char  letter;
+    float value;
+};
+
+namespace GCodeBinary {
+    const uint8_t marker     = 0x02;  // Starts a binary line
+    const uint8_t escape     = 0x1B;  // Precedes an escaped byte
+    const uint8_t text_code  = ' ';   // Ends the words
+    const uint8_t exp_places = 7;     // Places value meaning that an exponent follows
+    const uint8_t varint_xor = 0x32;  // Applied to each byte of a varint
+
+    const size_t max_words = 32;
+    const size_t max_line  = 127;  // Longest line, text or binary, that encode() makes
+
+    inline bool is_binary(const char* line) { return uint8_t(line[0]) == marker; }
+
+    // Whether a byte must be escaped in a binary line.  Besides the line
+    // endings and editing keys, these are the realtime commands of RealtimeCmd.h.
+    inline bool must_escape(uint8_t c) {
+        return c == 0x00 || c == 0x08 || c == 0x0A || c == 0x0D || c == 0x18 || c == escape || c == '!' || c == '?' || c == '~' || c >= 0x80;
+    }
+
+    // Decodes a binary line into at most max_words words, and points rest at
+    // the text that follows them, or at an empty string if there is none.
+    Error decode(const char* line, CompiledWord* words, size_t& n_words, const char*& rest);
+
+    // Encodes a line of GCode text into out, which holds size bytes including
+    // a terminating NUL, and returns the length.  Returns 0 if the line should
+    // stay as text: if it has no literal words, if it is not GCode, if parsing
+    // it has side effects like messages from comments, or if it or its binary
+    // form is longer than max_line or than size allows.  tools/gcode_to_gcb.py
+    // must produce the same bytes.
+    size_t encode(const char* line, char* out, size_t size);
+}
@@ -2,8 +2,15 @@
 #include "FileStream.h"
 #include "SHA256.h"
 #include "Driver/watchdog.h"
+#include "NutsBolts.h"  // get_ms
 
-std::map<std::string, std::string> HashFS::localFsHashes;
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+std::map<std::string, HashFS::Entry> HashFS::localFsHashes;
 
 static char hexNibble(uint8_t i) {
     return "0123456789ABCDEF"[i & 0xf];
@@ -45,8 +52,116 @@ void HashFS::report_change() {
     log_msg("Files changed");
 }
 
+// The index is a hidden file at the top of LocalFS.  After a version line,
+// each line holds the size, modification time, hash and name of a file that
+// has been hashed, with the name last because it can contain spaces.
+static const char* indexName    = ".hashes";
+static const char* indexVersion = "HashFS 1";
+
+// WebUI looks up hashes in the network task while the protocol task changes
+// them, so localFsHashes and the index state are used under hash_mutex.
+// Files are read without holding it.  Changes mark the index, and poll()
+// writes it once they stop for index_delay_ms, so that a batch of uploads or
+// deletions writes it once.
+static SemaphoreHandle_t hash_mutex     = xSemaphoreCreateMutex();
+static bool              index_changed  = false;
+static uint32_t          last_change_ms = 0;
+static const uint32_t    index_delay_ms = 1000;
+
+// Must be called with hash_mutex held
+static void mark_changed() {
+    index_changed  = true;
+    last_change_ms = get_ms();
+}
+
+// Gets the size and modification time of a file, returning false if it does not exist
+static bool stamp(const std::filesystem::path& path, HashFS::Entry& entry) {
+    std::error_code ec;
+    auto            size = stdfs::file_size(path, ec);
+    if (ec) {
+        return false;
+    }
+    entry.size  = uint32_t(size);
+    auto mtime  = stdfs::last_write_time(path, ec);
+    entry.mtime = ec ? 0 : int64_t(mtime.time_since_epoch().count());
+    return true;
+}
+
+// Gets the size, modification time and hash of a file, returning false if it cannot be read
+static bool hash_entry(const std::filesystem::path& path, HashFS::Entry& entry) {
+    return stamp(path, entry) && hashFile(path, entry.hash) == Error::Ok;
+}
+
+// A saved hash can be trusted only if the filesystem records times and neither changed
+static bool unchanged(const HashFS::Entry& saved, const HashFS::Entry& current) {
+    return current.mtime && saved.mtime == current.mtime && saved.size == current.size && saved.hash.length();
+}
+
+void HashFS::load_index(std::map<std::string, Entry>& saved) {
+    std::string text;
+    try {
+        FileStream inFile { indexName, "r" };
+        text.resize(inFile.size());
+        text.resize(std::max(inFile.read(&text[0], text.size()), 0));
+    } catch (...) {
+        return;
+    }
+
+    size_t pos = 0;
+    size_t end = text.find('\n');
+    if (end == std::string::npos || text.compare(0, end, indexVersion) != 0) {
+        return;
+    }
+    // A line that was cut short by a reset while the index was being
+    // written fails to parse and is ignored, so that file is hashed again.
+    while ((pos = end + 1) < text.length() && (end = text.find('\n', pos)) != std::string::npos) {
+        std::string        line     = text.substr(pos, end - pos);
+        char               hash[68];
+        int                name_pos = 0;
+        unsigned long long size;
+        long long          mtime;
+        if (sscanf(line.c_str(), "%llu %lld %67s %n", &size, &mtime, hash, &name_pos) != 3 || size_t(name_pos) >= line.length() ||
+            strlen(hash) != 66) {
+            continue;
+        }
+        saved[line.substr(name_pos)] = { uint32_t(size), mtime, hash };
+    }
+}
+
+void HashFS::save_index() {
+    std::string text = indexVersion;
+    text += '\n';
+    xSemaphoreTake(hash_mutex, portMAX_DELAY);
+    for (const auto& [name, entry] : localFsHashes) {
+        text += std::to_string(entry.size) + ' ' + std::to_string(entry.mtime) + ' ' + entry.hash + ' ' + name + '\n';
+    }
+    index_changed = false;
+    xSemaphoreGive(hash_mutex);
+    try {
+        FileStream outFile { indexName, "w" };
+        outFile.write(reinterpret_cast<const uint8_t*>(text.c_str()), text.length());
+    } catch (...) {
+        log_debug("HashFS: cannot save the hash index");
+    }
+}
+
+void HashFS::poll() {
+    xSemaphoreTake(hash_mutex, portMAX_DELAY);
+    bool due = index_changed && get_ms() - last_change_ms >= index_delay_ms;
+    xSemaphoreGive(hash_mutex);
+    if (due) {
+        save_index();
+    }
+}
+
 void HashFS::delete_file(const std::filesystem::path& path, bool report) {
-    localFsHashes.erase(path.filename().string());
+    if (file_is_hashable(path)) {
+        xSemaphoreTake(hash_mutex, portMAX_DELAY);
+        if (localFsHashes.erase(path.filename().string())) {
+            mark_changed();
+        }
+        xSemaphoreGive(hash_mutex);
+    }
     if (report) {
         report_change();
     }
@@ -64,29 +179,59 @@ bool HashFS::file_is_hashable(const std::filesystem::path& path) {
         return false;
     }
     auto fsname = *++path.begin();
-    return fsname == "littlefs" || fsname == "spiffs" || fsname == "localfs";
+    return (fsname == "littlefs" || fsname == "spiffs" || fsname == "localfs") && path.filename() != indexName;
 }
 
 void HashFS::rehash_file(const std::filesystem::path& path, bool report) {
     if (file_is_hashable(path)) {
-        std::string hash;
-        if (hashFile(path, hash) != Error::Ok) {
-            delete_file(path, false);
+        auto  name = path.filename().string();
+        Entry entry;
+        bool  hashed = hash_entry(path, entry);
+        xSemaphoreTake(hash_mutex, portMAX_DELAY);
+        if (hashed) {
+            localFsHashes[name] = entry;
         } else {
-            localFsHashes[path.filename().string()] = hash;
+            localFsHashes.erase(name);
         }
+        mark_changed();
+        xSemaphoreGive(hash_mutex);
     }
     if (report) {
         report_change();
     }
 }
 void HashFS::rename_file(const std::filesystem::path& ipath, const std::filesystem::path& opath, bool report) {
+    // Renaming does not change the contents, so the hash moves with the file
+    if (file_is_hashable(ipath) && file_is_hashable(opath)) {
+        Entry entry;
+        bool  moved = false;
+        if (stamp(opath, entry)) {
+            xSemaphoreTake(hash_mutex, portMAX_DELAY);
+            auto it = localFsHashes.find(ipath.filename().string());
+            if (it != localFsHashes.end() && entry.size == it->second.size) {
+                entry.hash = it->second.hash;
+                localFsHashes.erase(it);
+                localFsHashes[opath.filename().string()] = entry;
+                mark_changed();
+                moved = true;
+            }
+            xSemaphoreGive(hash_mutex);
+        }
+        if (moved) {
+            if (report) {
+                report_change();
+            }
+            return;
+        }
+    }
     delete_file(ipath, false);
     rehash_file(opath, report);
 }
 
 void HashFS::hash_all() {
+    xSemaphoreTake(hash_mutex, portMAX_DELAY);
     localFsHashes.clear();
+    xSemaphoreGive(hash_mutex);
 
     std::error_code ec;
     FluidPath       lfspath { "", LocalFS, ec };
@@ -103,23 +248,64 @@ void HashFS::hash_all() {
         }
         return;
     }
+
+    std::map<std::string, Entry> saved;
+    load_index(saved);
+
+    // Only files whose saved hash is stale are read.  The index is rewritten
+    // if any were, or if files were removed.
+    std::map<std::string, Entry> hashes;
+    size_t                       reused = 0;
     for (auto const& dir_entry : iter) {
-        if (!dir_entry.is_directory()) {
-            rehash_file(dir_entry, false);
+        const auto& path = dir_entry.path();
+        Entry       entry;
+        if (dir_entry.is_directory() || !file_is_hashable(path) || !stamp(path, entry)) {
+            continue;
+        }
+        auto name = path.filename().string();
+        auto it   = saved.find(name);
+        if (it != saved.end() && unchanged(it->second, entry)) {
+            entry.hash = it->second.hash;
+            ++reused;
+        } else if (hashFile(path, entry.hash) != Error::Ok) {
+            continue;
         }
+        hashes[name] = entry;
+    }
+    bool stale = reused != saved.size() || reused != hashes.size();
+
+    xSemaphoreTake(hash_mutex, portMAX_DELAY);
+    localFsHashes.swap(hashes);
+    xSemaphoreGive(hash_mutex);
+    if (stale) {
+        save_index();
     }
 }
 std::string HashFS::hash(const std::filesystem::path& path, bool useCacheOnly /*= false*/) {
     if (file_is_hashable(path)) {
-        std::map<std::string, std::string>::const_iterator it;
-        it = localFsHashes.find(path.filename().string());
+        std::string hash;
+        xSemaphoreTake(hash_mutex, portMAX_DELAY);
+        auto it = localFsHashes.find(path.filename().string());
         if (it != localFsHashes.end()) {
-            return it->second;
+            hash = it->second.hash;
         }
-    } else if (!useCacheOnly) {
+        xSemaphoreGive(hash_mutex);
+        return hash;
+    }
+    if (!useCacheOnly) {
         std::string theHash;
         hashFile(path, theHash);
         return theHash;
     }
     return std::string();
 }
+
+std::map<std::string, std::string> HashFS::hashes() {
+    std::map<std::string, std::string> hashes;
+    xSemaphoreTake(hash_mutex, portMAX_DELAY);
+    for (const auto& [name, entry] : localFsHashes) {
+        hashes[name] = entry.hash;
+    }
+    xSemaphoreGive(hash_mutex);
+    return hashes;
+}
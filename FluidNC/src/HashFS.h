@@ -2,10 +2,20 @@
 #include <string>
 #include <map>
 #include <filesystem>
+#include <cstdint>
 
+// HashFS keeps the SHA-256 hashes of the files at the top of LocalFS, which
+// WebUI uses as ETags so browsers can cache them.  The files are hashed at
+// startup and whenever they change.  The hashes are saved in an index file on
+// LocalFS along with the size and modification time of each file, so after a
+// restart only files that have changed need to be read again.
 class HashFS {
 public:
-    static std::map<std::string, std::string> localFsHashes;
+    struct Entry {
+        uint32_t    size;
+        int64_t     mtime;  // 0 if the filesystem does not record times
+        std::string hash;
+    };
 
     static bool file_is_hashable(const std::filesystem::path& path);
     static void delete_file(const std::filesystem::path& path, bool report = true);
@@ -14,7 +24,21 @@ public:
     static void hash_all();
     static void report_change();
 
+    // Writes the index once changes to the hashes have stopped for a while.
+    // Called from the poller task.
+    static void poll();
+
+    // With useCacheOnly, returns an empty string instead of reading a file
+    // that is not on LocalFS, for use while the machine is moving.
     static std::string hash(const std::filesystem::path& path, bool useCacheOnly = false);
 
+    // A copy of the hashes, by file name
+    static std::map<std::string, std::string> hashes();
+
 private:
+    static std::map<std::string, Entry> localFsHashes;
+
+
+    static void load_index(std::map<std::string, Entry>& saved);
+    static void save_index();
 };
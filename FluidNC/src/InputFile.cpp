@@ -5,6 +5,8 @@
 
 #include "Report.h"
 
+#include <cstring>
+
 InputFile::InputFile(const Volume& defaultFs, const char* path) : FileStream(path, "r", defaultFs) {}
 /*
   Read a line from the file
@@ -13,35 +15,50 @@ InputFile::InputFile(const Volume& defaultFs, const char* path) : FileStream(pat
   Returns other Error code on error, after displaying a message.
 */
 Error InputFile::readLine(char* line, size_t maxlen) {
-    size_t len = 0;
-    int    c;
-    while ((c = read()) >= 0) {
-        if (len >= maxlen) {
-            return Error::LineLengthExceeded;
-        }
-        if (c == '\r') {
-            continue;
+    size_t      len = 0;
+    const char* data;
+    size_t      avail;
+    // Scan the read-ahead buffer for the newline, instead of reading one
+    // character at a time.  A line can span several buffer refills.
+    while (read_ahead(data, avail)) {
+        auto   newline = static_cast<const char*>(memchr(data, '\n', avail));
+        size_t n       = newline ? newline - data : avail;
+        for (size_t i = 0; i < n; i++) {
+            char c = data[i];
+            if (c == '\r') {
+                continue;
+            }
+            // Leave room for the null terminator
+            if (len + 1 >= maxlen) {
+                consume(i);
+                line[len] = '\0';
+                return Error::LineLengthExceeded;
+            }
+            line[len++] = c;
         }
-        if (c == '\n') {
+        if (newline) {
+            consume(n + 1);
             ++_line_number;
             if (len == 0) {
                 ++_blank_lines;
             }
-            break;
+            line[len] = '\0';
+            return Error::Ok;
         }
-        line[len++] = c;
+        consume(n);
     }
+    // A last line without a newline is still a line
     line[len] = '\0';
-    return len || c >= 0 ? Error::Ok : Error::Eof;
+    return len ? Error::Ok : Error::Eof;
 }
 
 void InputFile::ack(Error status) {
     if (status != Error::Ok) {
-        log_error(static_cast<int>(status) << " (" << errorString(status) << ") in " << name() << " at line " << lineNumber());
+        log_error(static_cast<int>(status) << " (" << errorString(status) << ") in " << name() << " at line " << execLineNumber());
         if (status != Error::GcodeUnsupportedCommand) {
             // Do not stop on unsupported commands because most senders do not stop.
             // Stop the file job on other errors
-            notifyf("File job error", "Error:%d in %s at line: %d", status, name().c_str(), lineNumber());
+            notifyf("File job error", "Error:%d in %s at line: %d", status, name().c_str(), execLineNumber());
             _pending_error = status;
         }
     }
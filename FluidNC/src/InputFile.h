@@ -51,6 +51,7 @@ public:
     size_t write(uint8_t c) override { return 0; }
     void   ack(Error status) override;
     Error  pollLine(char* line) override;
+    Error  pendingError() override { return _pending_error; }
 
     ~InputFile();
 };
@@ -2,11 +2,89 @@
 // Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
 
 #include "Job.h"
+#include "Parameters.h"  // param_symbols
+#include "Protocol.h"    // lines_queued_behind
+#include "Assertion.h"
+#include <cstring>
 #include <map>
 #include <vector>
 
 std::vector<JobSource*> job;
 
+void JobSource::sync_position() {
+    if (_replaying) {
+        _replaying = false;
+        _channel->set_position(_replay_position);
+    }
+}
+
+void JobSource::set_position(size_t pos) {
+    Assert(!lines_queued_behind(), "Job position moved with lines read ahead");
+    if (_cached_loops) {
+        // Defer the channel seek, since the next lines are probably cached
+        _replaying       = true;
+        _replay_position = pos;
+    } else {
+        _channel->set_position(pos);
+    }
+}
+
+const CompiledLine* CachedLine::compile() {
+    if (!compile_tried) {
+        compile_tried = true;
+        compiled      = gc_compile_line(text.c_str(), gcode);
+    }
+    return compiled ? &gcode : nullptr;
+}
+
+Error JobSource::pollLine(char* line, CachedLine*& cached) {
+    cached = nullptr;
+    if (!_cached_loops) {
+        return _channel->pollLine(line);
+    }
+
+    size_t start = position();
+    auto   it    = _line_cache.find(start);
+    if (it != _line_cache.end() && _channel->canReplay()) {
+        cached = &it->second;
+        strcpy(line, cached->text.c_str());
+        _replaying       = true;
+        _replay_position = cached->next_position;
+        _channel->setLineNumber(cached->line_number);
+        return Error::Ok;
+    }
+
+    sync_position();
+    Error err = _channel->pollLine(line);
+    if (err != Error::Ok) {
+        return err;
+    }
+    // Channels that cannot seek, like macros, always report the same position
+    size_t next = _channel->position();
+    if (next > start && _line_cache.size() < size_t(LOOP_CACHE_LINES)) {
+        // Inserting into the map does not move existing entries, so lines that
+        // were handed to the protocol task earlier are not disturbed.
+        cached                = &_line_cache[start];
+        cached->next_position = next;
+        cached->line_number   = _channel->lineNumber();
+        cached->text          = line;
+    }
+    return Error::Ok;
+}
+
+void JobSource::begin_loop() {
+    Assert(!lines_queued_behind(), "Loop started with lines read ahead");
+    ++_cached_loops;
+}
+
+void JobSource::end_loop() {
+    Assert(!lines_queued_behind(), "Loop ended with lines read ahead");
+    if (_cached_loops && --_cached_loops == 0) {
+        sync_position();
+        _line_cache.clear();
+    }
+}
+
 Channel* Job::leader = nullptr;
 
 bool Job::active() {
@@ -43,6 +121,7 @@ void Job::pop() {
     delete source;
     if (!active()) {
         leader = nullptr;
+        reclaim_param_symbols();
     }
 }
 void Job::unnest() {
@@ -59,14 +138,14 @@ void Job::abort() {
     }
 }
 
-bool Job::get_param(const std::string& name, float& value) {
-    return job.back()->get_param(name, value);
+bool Job::get_param(param_symbol_t symbol, float& value) {
+    return job.back()->get_param(symbol, value);
 }
-bool Job::set_param(const std::string& name, float value) {
-    return job.back()->set_param(name, value);
+bool Job::set_param(param_symbol_t symbol, float value) {
+    return job.back()->set_param(symbol, value);
 }
-bool Job::param_exists(const std::string& name) {
-    return job.back()->param_exists(name);
+bool Job::param_exists(param_symbol_t symbol) {
+    return job.back()->param_exists(symbol);
 }
 Channel* Job::channel() {
     return job.back()->channel();
@@ -90,9 +169,11 @@ void list_local_params(Channel& out) {
             log_info_to(out, "Job depth " << depth << " - No local parameters");
         } else {
             log_info_to(out, "Job depth " << depth << " - Local Parameters");
-            for (const auto& param : local_params) {
+            for (auto symbol : local_params.sorted(param_symbols)) {
+                float value;
+                local_params.get(symbol, value);
                 // Format: parameter_name = value
-                log_info_to(out, param.first << " = " << param.second);
+                log_info_to(out, param_symbols.name(symbol) << " = " << value);
             }
         }
         depth++;
@@ -2,41 +2,84 @@
 // Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
 
 #include "Channel.h"
+#include "GCode.h"  // CompiledLine
+#include "NamedParams.h"
+#include <map>
 #include <vector>
 
+// A line from the body of a flow control loop, kept so that later iterations
+// of the loop do not have to read it from the channel and parse it again.
+// The polling task sets the position, line number and text when it caches the
+// line.  The protocol task compiles the line when it first executes it, since
+// compiling interns parameter names, and param_symbols belongs to that task.
+struct CachedLine {
+    size_t       next_position;  // The channel position after the line
+    size_t       line_number;
+    std::string  text;  // The line as read, for echo and error messages
+    bool         compile_tried = false;
+    bool         compiled      = false;
+    CompiledLine gcode;
+
+    // Returns the compiled line, or nullptr if it cannot be compiled
+    const CompiledLine* compile();
+};
+
 class JobSource {
 private:
-    Channel*                     _channel;
-    std::map<std::string, float> _local_params;
+    Channel*        _channel;
+    NamedParamStore _local_params;
+
+    // The line cache is keyed by the channel position where each line starts.
+    // It is active while at least one flow control loop in this job is running.
+    // While lines are replayed from the cache, the channel itself is not moved
+    // until a line that is not cached must be read.
+    //
+    // The polling task reads through the cache while the protocol task starts
+    // and ends loops and moves the position.  That is safe only because the
+    // O-word lines that do so block read-ahead, so no lines are queued behind
+    // them and the polling task is not reading while they execute.
+    // begin_loop(), end_loop() and set_position() assert that.
+    std::map<size_t, CachedLine> _line_cache;
+    uint32_t                     _cached_loops    = 0;
+    bool                         _replaying       = false;
+    size_t                       _replay_position = 0;
+
+    void sync_position();
 
 public:
     JobSource(Channel* channel) : _channel(channel) {}
-    bool get_param(const std::string& name, float& value) {
-        auto it = _local_params.find(name);
-        if (it == _local_params.end()) {
-            return false;
-        }
-        value = it->second;
+    bool get_param(param_symbol_t symbol, float& value) { return _local_params.get(symbol, value); }
+    bool set_param(param_symbol_t symbol, float value) {
+        _local_params.set(symbol, value);
         return true;
     }
-    bool set_param(const std::string& name, float value) {
-        _local_params[name] = value;
-        return true;
-    }
-    bool param_exists(const std::string& name) { return _local_params.count(name) != 0; }
+    bool param_exists(param_symbol_t symbol) { return _local_params.exists(symbol); }
 
     // Expose local parameters for enumeration
-    const std::map<std::string, float>& local_params() const { return _local_params; }
+    const NamedParamStore& local_params() const { return _local_params; }
 
-    void   save() { _channel->save(); }
+    void save() {
+        sync_position();
+        _channel->save();
+    }
     void   restore() { _channel->restore(); }
-    size_t position() { return _channel->position(); }
-    void   set_position(size_t pos) { _channel->set_position(pos); }
+    size_t position() { return _replaying ? _replay_position : _channel->position(); }
+    void   set_position(size_t pos);
     size_t lineNumber() { return _channel->lineNumber(); }
     void   setLineNumber(size_t line_number) { _channel->setLineNumber(line_number); }
 
     Channel* channel() { return _channel; }
 
+    // pollLine() gets the next line from the channel, or from the line cache
+    // if the line has already been read by an earlier pass through a loop.
+    // cached is set if the line is in the cache.
+    Error pollLine(char* line, CachedLine*& cached);
+
+    // Flow control calls begin_loop() when a loop starts and end_loop() when
+    // it finishes.  The cache is released when the outermost loop finishes.
+    void begin_loop();
+    void end_loop();
+
     ~JobSource() { delete _channel; }
 };
 
@@ -56,9 +99,9 @@ public:
     static void       abort();
     static JobSource* source();
 
-    static bool     get_param(const std::string& name, float& value);
-    static bool     set_param(const std::string& name, float value);
-    static bool     param_exists(const std::string& name);
+    static bool     get_param(param_symbol_t symbol, float& value);
+    static bool     set_param(param_symbol_t symbol, float value);
+    static bool     param_exists(param_symbol_t symbol);
     static Channel* channel();
 
     // Expose access to jobs stack for listing local parameters
@@ -0,0 +1,14 @@
+// Copyright (c) 2026 - FluidNC Contributors
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#include "Junction.h"
+
+#include <cmath>
+
+namespace Junction {
+    float radius(float cos_theta, float junction_deviation) {
+        // Computed without any expensive trig, sin() or acos(), by trig half angle identities of cos(theta)
+        float sin_theta_d2 = sqrtf(0.5f * (1.0f - cos_theta));
+        return junction_deviation * sin_theta_d2 / (1.0f - sin_theta_d2);
+    }
+}
@@ -0,0 +1,21 @@
+// Copyright (c) 2026 - FluidNC Contributors
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#pragma once
+
+// Cornering geometry for the planner's junction speeds.
+//
+// The planner limits the speed through a junction with the centripetal
+// acceleration about a circle that is tangent to both line segments.  The
+// circle is defined by the deviation, the distance from the junction to the
+// closest point of the circle.  The motion does not follow the circle; it
+// still passes through the junction, so the circle only sets how large a
+// change in velocity the machine takes at the corner.
+
+namespace Junction {
+    // Radius of the circle for a junction with -cos_theta between the unit
+    // vectors of the two segments, so theta is the angle at the corner.  The
+    // configured junction deviation gives the exact path (G61) radius, which
+    // is also used in continuous mode (G64).
+    float radius(float cos_theta, float junction_deviation);
+}
@@ -0,0 +1,112 @@
+// Copyright (c) 2026 - FluidNC Contributors
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#include "DeltaIK.h"
+
+#include "Logging.h"
+
+#include <cmath>
+
+#ifndef M_PI
+#    define M_PI 3.14159265358979323846
+#endif
+
+namespace Kinematics {
+    const float sqrt3  = 1.732050807;
+    const float sin120 = sqrt3 / 2.0;
+    const float cos120 = -0.5;
+    const float tan30  = 1.0 / sqrt3;
+
+    // Rotations of the cartesian coordinates into the YZ plane of each arm: 0, +120 and -120 degrees
+    const float arm_cos[3] = { 1.0, cos120, cos120 };
+    const float arm_sin[3] = { 0.0, sin120, -sin120 };
+
+    void DeltaIK::set_geometry(float rf, float f, float re, float e, float up_degrees) {
+        _rf        = rf;
+        _y1        = -0.5 * tan30 * f;  // f/2 * tg 30
+        _e_shift   = 0.5 * tan30 * e;
+        _ik_const  = rf * rf - re * re - _y1 * _y1;
+        _theta_min = up_degrees - 1;  // A little extra for roundoff errors
+    }
+
+    // helper function, calculates angle theta1 (for YZ-plane) for n effector positions
+    // that have been rotated into the plane of an arm.  The loop does not stop at an
+    // unreachable position, so that it can be vectorized.  Returns the number of
+    // leading positions that the arm can reach.
+    size_t DeltaIK::calc_angles(const float* x0, const float* y0, const float* z0, float* theta, size_t n) const {
+        float d[SegmentBatch::max_size];
+
+        for (size_t i = 0; i < n; i++) {
+            float y = y0[i] - _e_shift;  // shift center to edge
+            // z = a + b*y
+            float a = (x0[i] * x0[i] + y * y + z0[i] * z0[i] + _ik_const) / (2 * z0[i]);
+            float b = (_y1 - y) / z0[i];
+
+            // discriminant
+            d[i] = -(a + b * _y1) * (a + b * _y1) + _rf * (b * b * _rf + _rf);
+
+            float yj = (_y1 - a * b - sqrtf(d[i])) / (b * b + 1);  // choosing outer point
+            float zj = a + b * yj;
+
+            theta[i] = atan2f(-zj, _y1 - yj) * (180.0 / M_PI);  // Result is in -180..180 degrees
+        }
+
+        for (size_t i = 0; i < n; i++) {
+            if (d[i] < 0) {
+                log_debug("Kinematics: negative discriminant " << d[i]);
+                return i;
+                // non-existing point
+            }
+            if (!(theta[i] > _theta_min)) {
+                return i;
+            }
+        }
+        return n;
+    }
+
+    bool DeltaIK::arm_angles(float* angles, const float* cartesian, const float* offset) const {
+        float x0 = cartesian[X_AXIS] - offset[X_AXIS];
+        float y0 = cartesian[Y_AXIS] - offset[Y_AXIS];
+        float z0 = cartesian[Z_AXIS] - offset[Z_AXIS];
+
+        for (size_t arm = 0; arm < 3; arm++) {
+            // rotate coords into the plane of the arm
+            float x = x0 * arm_cos[arm] + y0 * arm_sin[arm];
+            float y = y0 * arm_cos[arm] - x0 * arm_sin[arm];
+            if (!calc_angles(&x, &y, &z0, &angles[arm], 1)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    size_t DeltaIK::arm_angles(SegmentBatch& segments, const float* offset) const {
+        const size_t n = segments.size();
+
+        float x[SegmentBatch::max_size];
+        float y[SegmentBatch::max_size];
+        float z[SegmentBatch::max_size];
+        for (size_t i = 0; i < n; i++) {
+            auto cartesian = segments.cartesian(i);
+            x[i]           = cartesian[X_AXIS] - offset[X_AXIS];
+            y[i]           = cartesian[Y_AXIS] - offset[Y_AXIS];
+            z[i]           = cartesian[Z_AXIS] - offset[Z_AXIS];
+        }
+
+        size_t reachable = n;
+        for (size_t arm = 0; arm < 3; arm++) {
+            float arm_x[SegmentBatch::max_size];
+            float arm_y[SegmentBatch::max_size];
+            float theta[SegmentBatch::max_size];
+            for (size_t i = 0; i < reachable; i++) {
+                arm_x[i] = x[i] * arm_cos[arm] + y[i] * arm_sin[arm];
+                arm_y[i] = y[i] * arm_cos[arm] - x[i] * arm_sin[arm];
+            }
+            reachable = calc_angles(arm_x, arm_y, z, theta, reachable);
+            for (size_t i = 0; i < reachable; i++) {
+                segments.motors(i)[arm] = theta[i];
+            }
+        }
+        return reachable;
+    }
+}
@@ -0,0 +1,41 @@
+// Copyright (c) 2026 - FluidNC Contributors
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#pragma once
+
+// The inverse kinematics of ParallelDelta, which turns effector positions into
+// arm angles in degrees.  The geometry uses the names from the published delta
+// kinematics, as ParallelDelta's configuration does.
+//
+// This file does not depend on the configuration tree, so the transform of a
+// batch of segments can be tested against the transform of a single position
+// on the host.
+
+#include "SegmentBatch.h"
+
+#include <cstddef>
+
+namespace Kinematics {
+    class DeltaIK {
+        // Constants of the inverse kinematics, computed from the geometry
+        float _rf        = 0;  // The length of the crank arm on the motor
+        float _y1        = 0;  // Y of the crank joints, f/2 * tan 30
+        float _e_shift   = 0;  // Shifts the effector center to its edge
+        float _ik_const  = 0;  // rf^2 - re^2 - y1^2
+        float _theta_min = 0;  // The lowest reachable arm angle, with a little extra for roundoff
+
+        size_t calc_angles(const float* x0, const float* y0, const float* z0, float* theta, size_t n) const;
+
+    public:
+        void set_geometry(float rf, float f, float re, float e, float up_degrees);
+
+        // Computes the angles of the three arms for the X, Y and Z of cartesian
+        // less offset.  Returns false if the position cannot be reached.
+        bool arm_angles(float* angles, const float* cartesian, const float* offset) const;
+
+        // The same for every segment of the batch, into the first three motors of
+        // each segment, but done one arm at a time over arrays of positions.
+        // Returns the number of leading segments that can be reached.
+        size_t arm_angles(SegmentBatch& segments, const float* offset) const;
+    };
+}
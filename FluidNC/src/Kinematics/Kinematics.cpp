@@ -6,6 +6,7 @@
 
 #include "Config.h"
 #include "Cartesian.h"
+#include "Machine/MachineConfig.h"  // copyAxes
 
 namespace Kinematics {
     const char* no_system = "No kinematic system";
@@ -92,6 +93,56 @@ namespace Kinematics {
         return _system->rearmLimits(axisMask, motorMask);
     }
 
+    size_t KinematicSystem::transform_segments(SegmentBatch& segments) {
+        for (size_t i = 0; i < segments.size(); i++) {
+            if (!transform_cartesian_to_motors(segments.motors(i), segments.cartesian(i))) {
+                return i;
+            }
+        }
+        return segments.size();
+    }
+
+    bool KinematicSystem::plan_segments(SegmentBatch& segments, plan_line_data_t* pl_data, float* last_motors) {
+        auto  n_axis       = segments.n_axis();
+        float feed_rate    = pl_data->feed_rate;  // save original feed rate
+        float segment_dist = segments.segment_length();
+
+        while (segments.next()) {
+            size_t reachable = transform_segments(segments);
+
+            for (size_t i = 0; i < segments.size(); i++) {
+                if (sys.abort()) {
+                    return true;
+                }
+                if (i == reachable) {
+                    auto cartesian = segments.cartesian(i);
+                    log_error("Segment unreachable (" << cartesian[0] << "," << cartesian[1] << "," << cartesian[2] << ")");
+                    return false;
+                }
+
+                float* motors = segments.motors(i);
+
+                // The planner sets the feed_rate for rapids,
+                if (!pl_data->motion.rapidMotion) {
+                    float delta_distance = vector_distance(motors, last_motors, n_axis);
+                    pl_data->feed_rate   = (feed_rate * delta_distance / segment_dist);
+                }
+
+                // mc_move_motors() returns false if a jog is cancelled.
+                // In that case we stop sending segments to the planner.
+                if (!mc_move_motors(motors, pl_data)) {
+                    return false;
+                }
+
+                // save motor position for next distance calc
+                // This is after mc_move_motors() so that we do not update
+                // last_motors if the segment was discarded.
+                copyAxes(last_motors, motors, n_axis);
+            }
+        }
+        return true;
+    }
+
     void Kinematics::group(Configuration::HandlerBase& handler) {
         ::Kinematics::KinematicsFactory::factory(handler, _system);
     }
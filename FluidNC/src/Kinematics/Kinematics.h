@@ -8,6 +8,7 @@
 #include "Planner.h"
 #include "Types.h"
 #include "Machine/Homing.h"
+#include "SegmentBatch.h"
 
 /*
 Special types
@@ -101,6 +102,12 @@ namespace Kinematics {
 
         virtual bool transform_cartesian_to_motors(float* motors, float* cartesian) = 0;
 
+        // Transforms the cartesian targets of a batch of segments into motor positions,
+        // returning the number of leading segments that are reachable.  The default
+        // transforms one segment at a time; systems with a costly transform override
+        // it to do the whole batch in one pass.
+        virtual size_t transform_segments(SegmentBatch& segments);
+
         virtual bool canHome(AxisMask axisMask) { return false; }
         virtual void releaseMotors(AxisMask axisMask, MotorMask motors) {}
         virtual bool limitReached(AxisMask& axisMask, MotorMask& motors, MotorMask limited) { return false; }
@@ -126,6 +133,14 @@ namespace Kinematics {
 
         float _min_motor_pos[MAX_N_AXIS];
         float _max_motor_pos[MAX_N_AXIS];
+
+    protected:
+        // Plans the segments of a move, transforming them a batch at a time
+        // ahead of the planner.  The feed rate of each segment is scaled by
+        // the ratio of its motor and cartesian lengths.  last_motors holds
+        // the motor position at the start of the move, and is updated as
+        // each segment is planned.
+        bool plan_segments(SegmentBatch& segments, plan_line_data_t* pl_data, float* last_motors);
     };
 
     using KinematicsFactory = Configuration::GenericFactory<KinematicSystem>;
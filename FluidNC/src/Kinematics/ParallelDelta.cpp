@@ -47,12 +47,10 @@ kinematics:
 namespace Kinematics {
 
     // trigonometric constants to speed up calculations
-    const float sqrt3  = 1.732050807;
-    const float sin120 = sqrt3 / 2.0;
-    const float cos120 = -0.5;
-    const float tan60  = sqrt3;
-    const float sin30  = 0.5;
-    const float tan30  = 1.0 / sqrt3;
+    const float sqrt3 = 1.732050807;
+    const float tan60 = sqrt3;
+    const float sin30 = 0.5;
+    const float tan30 = 1.0 / sqrt3;
 
     void ParallelDelta::group(Configuration::HandlerBase& handler) {
         // Field names here follow the published delta-kinematics geometry terms (rf, f,
@@ -108,6 +106,11 @@ namespace Kinematics {
         handler.item("up_degrees", _up_degrees, -90, 0);
     }
 
+    void ParallelDelta::afterParse() {
+        // Everything in the inverse kinematics that depends only on the geometry
+        _ik.set_geometry(rf, f, re, e, _up_degrees);
+    }
+
     void ParallelDelta::init() {
         log_info("Kinematic system:" << name());
 
@@ -190,9 +193,6 @@ namespace Kinematics {
     bool ParallelDelta::cartesian_to_motors(float* target, plan_line_data_t* pl_data, float* position) {
         axis_t n_axis = Axes::_numberAxis;
 
-        float seg_target[MAX_N_AXIS];          // The target of the current segment
-        float feed_rate = pl_data->feed_rate;  // save original feed rate
-
         // Check the destination to see if it is in work area
         float motors[MAX_N_AXIS];
         if (!transform_cartesian_to_motors(motors, target)) {
@@ -214,48 +214,9 @@ namespace Kinematics {
             segment_count = 1;
         }
 
-        // The all-axis segment distance is used for feedrate conversion
-        float segment_dist = vector_length(d, n_axis) / segment_count;
-
-        copyAxes(seg_target, position, n_axis);
-        float delta_d[MAX_N_AXIS];
-        copyArray(delta_d, d, n_axis);
-        multiplyArray(delta_d, 1.0f / segment_count, n_axis);
-
-        for (uint32_t segment = 1; segment <= segment_count; segment++) {
-            if (sys.abort()) {
-                return true;
-            }
-
-            addAxes(seg_target, delta_d, n_axis);
-
-            // calculate the delta motor angles
-            if (!transform_cartesian_to_motors(motors, seg_target)) {
-                //                if (show_error) {
-                log_error("Kinematic error motors (" << motors[0] << "," << motors[1] << "," << motors[2] << ")");
-                //                    show_error = false;
-                //                }
-                return false;
-            }
-
-            // The planner sets the feed_rate for rapids,
-            if (!pl_data->motion.rapidMotion) {
-                float delta_distance = vector_distance(motors, _last_motor_pos, n_axis);
-                pl_data->feed_rate   = (feed_rate * delta_distance / segment_dist);
-            }
-
-            // mc_line() returns false if a jog is cancelled.
-            // In that case we stop sending segments to the planner.
-            if (!mc_move_motors(motors, pl_data)) {
-                return false;
-            }
-
-            // save motor position for next distance calc
-            // This is after mc_move_motors() so that we do not update
-            // last_angle if the segment was discarded.
-            copyAxes(_last_motor_pos, motors, n_axis);
-        }
-        return true;
+        // The arm angles are computed a batch of segments at a time, ahead of the planner
+        SegmentBatch segments(position, target, segment_count, n_axis);
+        return plan_segments(segments, pl_data, _last_motor_pos);
     }
 
     bool ParallelDelta::canHome(AxisMask axisMask) {
@@ -460,60 +421,26 @@ namespace Kinematics {
         return true;  // signal main code that this handled all homing
     }
 
-    // helper functions, calculates angle theta1 (for YZ-plane)
-    bool ParallelDelta::delta_calcAngleYZ(float x0, float y0, float z0, float& theta) {
-        float y1 = -0.5 * tan30 * f;  // f/2 * tg 30
-        y0 -= 0.5 * tan30 * e;        // shift center to edge
-        // z = a + b*y
-        float a = (x0 * x0 + y0 * y0 + z0 * z0 + rf * rf - re * re - y1 * y1) / (2 * z0);
-        float b = (y1 - y0) / z0;
-
-        // discriminant
-        float d = -(a + b * y1) * (a + b * y1) + rf * (b * b * rf + rf);
-        if (d < 0) {
-            log_debug("Kinematics: negative discriminant " << d);
-            return false;
-            // non-existing point
-        }
-        float yj = (y1 - a * b - sqrtf(d)) / (b * b + 1);  // choosing outer point
-        float zj = a + b * yj;
-
-        theta = radians_to_pos(atan2f(-zj, y1 - yj));  // Result is in -180..180 in steps
-
-        return theta > (_up_degrees - 1);  // A little extra for roundoff errors
-    }
-
     bool ParallelDelta::transform_cartesian_to_motors(float* motors, float* cartesian) {
-        float xyz[3];
-        copyArray(xyz, cartesian, 3);
-        subtractArray(xyz, _mpos_offset, 3);
-
         // Copy non-transformed axes
         for (axis_t axis = A_AXIS; axis < Axes::_numberAxis; axis++) {
             motors[axis] = cartesian[axis];
         }
+        return _ik.arm_angles(motors, cartesian, _mpos_offset);
+    }
 
-        if (!delta_calcAngleYZ(xyz[X_AXIS], xyz[Y_AXIS], xyz[Z_AXIS], motors[0])) {
-            return false;
-        }
-
-        // Pre-calculate factors for speed
-        float x_cos120 = xyz[X_AXIS] * cos120;
-        float x_sin120 = xyz[X_AXIS] * sin120;
-        float y_cos120 = xyz[Y_AXIS] * cos120;
-        float y_sin120 = xyz[Y_AXIS] * sin120;
+    // The same as transform_cartesian_to_motors() for every segment of the batch
+    size_t ParallelDelta::transform_segments(SegmentBatch& segments) {
+        size_t reachable = _ik.arm_angles(segments, _mpos_offset);
 
-        // rotate coords to +120 deg
-        if (!delta_calcAngleYZ(x_cos120 + y_sin120, y_cos120 - x_sin120, xyz[Z_AXIS], motors[1])) {
-            return false;
-        }
-
-        // rotate coords to -120 deg
-        if (!delta_calcAngleYZ(x_cos120 - y_sin120, y_cos120 + x_sin120, xyz[Z_AXIS], motors[2])) {
-            return false;
+        // Copy non-transformed axes
+        auto n_axis = segments.n_axis();
+        for (size_t i = 0; i < reachable; i++) {
+            for (axis_t axis = A_AXIS; axis < n_axis; axis++) {
+                segments.motors(i)[axis] = segments.cartesian(i)[axis];
+            }
         }
-
-        return true;
+        return reachable;
     }
 
     void ParallelDelta::set_homed_mpos(float* mpos) {
@@ -11,6 +11,7 @@
 
 #include "Kinematics.h"
 #include "Cartesian.h"
+#include "DeltaIK.h"
 
 // M_PI is not defined in standard C/C++ but some compilers
 // support it anyway.  The following suppresses Intellisense
@@ -34,9 +35,10 @@ namespace Kinematics {
         virtual void init() override;
         virtual void init_position() override;
         //bool canHome(AxisMask& axisMask) override;
-        bool cartesian_to_motors(float* target, plan_line_data_t* pl_data, float* position) override;
-        void motors_to_cartesian(float* cartesian, float* motors, axis_t n_axis) override;
-        bool transform_cartesian_to_motors(float* motors, float* cartesian) override;
+        bool   cartesian_to_motors(float* target, plan_line_data_t* pl_data, float* position) override;
+        void   motors_to_cartesian(float* cartesian, float* motors, axis_t n_axis) override;
+        bool   transform_cartesian_to_motors(float* motors, float* cartesian) override;
+        size_t transform_segments(SegmentBatch& segments) override;
         //bool soft_limit_error_exists(float* cartesian) override;
         bool         kinematics_homing(AxisMask& axisMask) override;
         virtual void constrain_jog(float* cartesian, plan_line_data_t* pl_data, float* position) override;
@@ -58,7 +60,7 @@ namespace Kinematics {
         // Configuration handlers:
         //void         validate() const override {}
         virtual void group(Configuration::HandlerBase& handler) override;
-        void         afterParse() override {}
+        void         afterParse() override;
 
         ~ParallelDelta() {}
 
@@ -78,7 +80,7 @@ namespace Kinematics {
         float _last_motor_pos[MAX_N_AXIS] = { 0 };
         float _mpos_offset[3]             = { 0 };
 
-        bool delta_calcAngleYZ(float x0, float y0, float z0, float& theta);
+        DeltaIK _ik;  // The inverse kinematics, set up from the geometry by afterParse()
 
         void motorVector(AxisMask axisMask, MotorMask motors, Machine::Homing::Phase phase, float* target, float& rate, uint32_t& settle_ms);
         void homing_move(AxisMask axisMask, MotorMask motors, Machine::Homing::Phase phase, uint32_t& settling_ms) override;
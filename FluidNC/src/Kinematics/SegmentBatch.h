@@ -0,0 +1,81 @@
+// Copyright (c) 2026 - FluidNC Contributors
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#pragma once
+
+// SegmentBatch divides a move into equal segments for kinematic systems whose
+// transform is nonlinear, and hands out the cartesian targets of the segments
+// a batch at a time.  The kinematics transforms a whole batch into motor
+// positions in one pass, before any segment of the batch is given to the
+// planner, so a system like ParallelDelta can run its inverse kinematics
+// over arrays with its geometry constants loaded once, instead of once per
+// segment between planner calls.
+//
+// The target of each segment is computed from the start of the move rather
+// than by adding up segment vectors, so rounding errors do not accumulate
+// and the last segment ends exactly at the target.
+
+#include "Types.h"  // axis_t, MAX_N_AXIS
+
+#include <cmath>
+#include <cstddef>
+
+namespace Kinematics {
+    class SegmentBatch {
+    public:
+        static constexpr size_t max_size = 8;
+
+        SegmentBatch(const float* position, const float* target, uint32_t segment_count, axis_t n_axis) :
+            _count(segment_count ? segment_count : 1), _n_axis(n_axis) {
+            float length2 = 0;
+            for (axis_t axis = X_AXIS; axis < n_axis; axis++) {
+                float d       = target[axis] - position[axis];
+                _start[axis]  = position[axis];
+                _target[axis] = target[axis];
+                _step[axis]   = d / _count;
+
+                length2 += d * d;
+            }
+            _segment_length = sqrtf(length2) / _count;
+        }
+
+        // Loads the cartesian targets of the next batch of segments.
+        // Returns false when every segment has been handed out.
+        bool next() {
+            _size = 0;
+            while (_size < max_size && _done < _count) {
+                ++_done;
+                float* cartesian = _cartesian[_size++];
+                for (axis_t axis = X_AXIS; axis < _n_axis; axis++) {
+                    cartesian[axis] = _done == _count ? _target[axis] : _start[axis] + _step[axis] * _done;
+                }
+            }
+            return _size != 0;
+        }
+
+        size_t   size() const { return _size; }
+        axis_t   n_axis() const { return _n_axis; }
+        uint32_t segment_count() const { return _count; }
+
+        // The length of each segment in cartesian space, over all axes
+        float segment_length() const { return _segment_length; }
+
+        // The targets of segment i of the current batch, and the motor
+        // positions that the kinematics computes for them
+        float* cartesian(size_t i) { return _cartesian[i]; }
+        float* motors(size_t i) { return _motors[i]; }
+
+    private:
+        float    _start[MAX_N_AXIS];
+        float    _target[MAX_N_AXIS];
+        float    _step[MAX_N_AXIS];
+        float    _segment_length;
+        uint32_t _count;
+        uint32_t _done = 0;
+        axis_t   _n_axis;
+
+        size_t _size = 0;
+        float  _cartesian[max_size][MAX_N_AXIS];
+        float  _motors[max_size][MAX_N_AXIS];
+    };
+}
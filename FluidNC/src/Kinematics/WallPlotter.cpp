@@ -65,12 +65,8 @@ namespace Kinematics {
         // The motors assume they start from (0, 0, 0).
         // So we need to derive the zero lengths to satisfy the kinematic equations.
         xy_to_lengths(0, 0, zero_left, zero_right);
-        last_motor_segment_end[0] = zero_left;
-        last_motor_segment_end[1] = zero_right;
-        auto n_axis               = Axes::_numberAxis;
-        for (axis_t axis = Z_AXIS; axis < n_axis; axis++) {
-            last_motor_segment_end[axis] = 0.0;
-        }
+        float origin[MAX_N_AXIS] = { 0.0 };
+        transform_cartesian_to_motors(last_motor_segment_end, origin);
 
         init_position();
     }
@@ -139,8 +135,6 @@ namespace Kinematics {
             return true;
         }
 
-        float cartesian_feed_rate = pl_data->feed_rate;
-
         // calculate the total X,Y axis move distance
         // Z axis is the same in both coord systems, so it does not undergo conversion
         float xydist = vector_distance(target, position, 2);  // Only compute distance for both axes. X and Y
@@ -151,74 +145,15 @@ namespace Kinematics {
             // the planner even if there is no movement??
             segment_count = 1;
         }
-        float cartesian_segment_length = total_cartesian_distance / segment_count;
 
-        // Calc length of each cartesian segment - the same for all segments
-        float cartesian_segment_components[MAX_N_AXIS];
-        for (axis_t axis = X_AXIS; axis < n_axis; axis++) {
-            cartesian_segment_components[axis] = (target[axis] - position[axis]) / segment_count;
-        }
+        // TODO: G93 pl_data->motion.inverseTime logic?? Does this even make sense for wallplotter?
 
-        float cartesian_segment_end[MAX_N_AXIS];
-        copyAxes(cartesian_segment_end, position);
-
-        // Calculate desired cartesian feedrate distance ratio. Same for each seg.
-        for (uint32_t segment = 1; segment <= segment_count; segment++) {
-            if (sys.abort()) {
-                return true;
-            }
-            // calculate the cartesian end point of the next segment
-            for (axis_t axis = X_AXIS; axis < n_axis; axis++) {
-                cartesian_segment_end[axis] += cartesian_segment_components[axis];
-            }
-
-            // Convert cartesian space coords to motor space
-            float motor_segment_end[MAX_N_AXIS];
-            xy_to_lengths(cartesian_segment_end[X_AXIS], cartesian_segment_end[Y_AXIS], motor_segment_end[0], motor_segment_end[1]);
-            for (axis_t axis = Z_AXIS; axis < n_axis; axis++) {
-                motor_segment_end[axis] = cartesian_segment_end[axis];
-            }
-
-#ifdef USE_CHECKED_KINEMATICS
-            // Check the inverse computation.
-            float cx, cy;
-            lengths_to_xy(motor_segment_end[0], motor_segment_end[1], cx, cy);
-
-            if (abs(cartesian_segment_end[X_AXIS] - cx) > 0.1 || abs(cartesian_segment_end[Y_AXIS] - cy) > 0.1) {
-                // FIX: Produce an alarm state?
-            }
-#endif
-            // Adjust feedrate by the ratio of the segment lengths in motor and cartesian spaces,
-            // accounting for all axes
-            if (!pl_data->motion.rapidMotion) {  // Rapid motions ignore feedrate. Don't convert.
-                                                 // T=D/V, Tcart=Tmotor, Dcart/Vcart=Dmotor/Vmotor
-                                                 // Vmotor = Dmotor*(Vcart/Dcart)
-                float motor_segment_length = vector_distance(last_motor_segment_end, motor_segment_end, n_axis);
-                pl_data->feed_rate         = cartesian_feed_rate * motor_segment_length / cartesian_segment_length;
-            }
-
-            // TODO: G93 pl_data->motion.inverseTime logic?? Does this even make sense for wallplotter?
-
-            // Remember the last motor position so the length can be computed the next time
-            copyAxes(last_motor_segment_end, motor_segment_end);
-
-            // Initiate motor movement with converted feedrate and converted position
-            // mc_move_motors() returns false if a jog is cancelled.
-            // In that case we stop sending segments to the planner.
-            // Note that the left motor runs backward.
-            // TODO: It might be better to adjust motor direction in .yaml file by inverting direction pin??
-            float cables[MAX_N_AXIS];
-            cables[0] = 0 - (motor_segment_end[0] - zero_left);
-            cables[1] = 0 + (motor_segment_end[1] - zero_right);
-            for (axis_t axis = Z_AXIS; axis < n_axis; axis++) {
-                cables[axis] = cartesian_segment_end[axis];
-            }
-            if (!mc_move_motors(cables, pl_data)) {
-                // TODO fixup last_left last_right?? What is position state when jog is cancelled?
-                return false;
-            }
-        }
-        return true;
+        // The cord lengths are computed a batch of segments at a time, ahead of the planner.
+        // Their feed rates are adjusted by the ratio of the segment lengths in motor and
+        // cartesian spaces, accounting for all axes.
+        // TODO fixup last_motor_segment_end?? What is position state when jog is cancelled?
+        SegmentBatch segments(position, target, segment_count, n_axis);
+        return plan_segments(segments, pl_data, last_motor_segment_end);
     }
 
     /*
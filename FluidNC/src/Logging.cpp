@@ -6,6 +6,9 @@
 #include "Serial.h"
 #include "SettingsDefinitions.h"
 #include "Channel.h"
+#include "BufferPool.h"
+
+#include <cstring>
 
 const EnumItem messageLevels2[] = { { MsgLevelNone, "None" }, { MsgLevelError, "Error" }, { MsgLevelWarning, "Warn" },
                                     { MsgLevelInfo, "Info" }, { MsgLevelDebug, "Debug" }, { MsgLevelVerbose, "Verbose" },
@@ -15,8 +18,36 @@ bool atMsgLevel(MsgLevel level) {
     return message_level == nullptr || message_level->get() >= level;
 }
 
-LogStream::LogStream(Channel& channel, MsgLevel level) : _channel(channel), _level(level) {
-    _line = new std::string();
+static BufferPool<MESSAGE_POOL_BUFFERS, MESSAGE_BUFFER_SIZE> messagePool;
+
+static std::atomic<uint32_t> messages_spilled { 0 };
+
+char* message_buffer_acquire() {
+    return messagePool.acquire();
+}
+void message_buffer_release(const char* buffer) {
+    messagePool.release(buffer);
+}
+size_t message_buffer_size() {
+    return messagePool.buffer_size();
+}
+
+void report_message_pool(Channel& out) {
+    log_stream(out,
+               "Message pool: " << messagePool.in_use() << "/" << messagePool.count() << " High water: " << messagePool.high_water()
+                                << " Exhausted: " << messagePool.exhausted() << " Too long: " << messages_spilled.load());
+}
+
+void reset_message_pool_stats() {
+    messagePool.reset_stats();
+    messages_spilled = 0;
+}
+
+LogStream::LogStream(Channel& channel, MsgLevel level) : _channel(channel), _length(0), _line(nullptr), _level(level) {
+    _buffer = messagePool.acquire();
+    if (!_buffer) {
+        _line = new std::string();
+    }
 }
 
 LogStream::LogStream(Channel& channel, MsgLevel level, const char* name) : LogStream(channel, level) {
@@ -26,12 +57,52 @@ LogStream::LogStream(Channel& channel, MsgLevel level, const char* name) : LogSt
 LogStream::LogStream(Channel& channel, const char* name) : LogStream(channel, MsgLevelNone, name) {}
 LogStream::LogStream(MsgLevel level, const char* name) : LogStream(allChannels, level, name) {}
 
+// Room is kept in the buffer for the closing ']', the newline that the output
+// task appends, and the terminating null
+static constexpr size_t message_capacity = MESSAGE_BUFFER_SIZE - 3;
+
+// Moves a message that has outgrown its pooled buffer to the heap
+void LogStream::spill() {
+    ++messages_spilled;
+    _line = new std::string(_buffer, _length);
+    messagePool.release(_buffer);
+    _buffer = nullptr;
+}
+
 size_t LogStream::write(uint8_t c) {
+    if (_buffer) {
+        if (_length < message_capacity) {
+            _buffer[_length++] = c;
+            return 1;
+        }
+        spill();
+    }
     *_line += (char)c;
     return 1;
 }
 
+size_t LogStream::write(const uint8_t* buffer, size_t size) {
+    if (_buffer) {
+        if (_length + size <= message_capacity) {
+            memcpy(_buffer + _length, buffer, size);
+            _length += size;
+            return size;
+        }
+        spill();
+    }
+    _line->append(reinterpret_cast<const char*>(buffer), size);
+    return size;
+}
+
 LogStream::~LogStream() {
+    if (_buffer) {
+        if (_length && _buffer[0] == '[') {
+            _buffer[_length++] = ']';
+        }
+        _buffer[_length] = '\0';
+        _channel.sendPooledLine(_level, _buffer);
+        return;
+    }
     if ((*_line).length() && (*_line)[0] == '[') {
         *_line += ']';
     }
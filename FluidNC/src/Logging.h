@@ -24,11 +24,19 @@ enum MsgLevel {
     MsgLevelVerbose = 5,
 };
 
+// Where the text of a queued message lives, and thus how to reclaim it
+enum class LineStorage : uint8_t {
+    Static,  // A fixed string
+    Heap,    // A std::string to be deleted
+    Pooled,  // A message pool buffer to be released
+    Frame,   // A binary telemetry frame in a message pool buffer
+};
+
 struct LogMessage {
-    Channel* channel;
-    void*    line;
-    MsgLevel level;
-    bool     isString;
+    Channel*    channel;
+    void*       line;
+    MsgLevel    level;
+    LineStorage storage;
 };
 
 extern TaskHandle_t outputTask;
@@ -59,14 +67,27 @@ public:
     LogStream(Channel& channel, MsgLevel level, const char* name);
     LogStream(MsgLevel level, const char* name);
     size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
     ~LogStream();
 
 private:
+    void spill();
+
     Channel&     _channel;
+    char*        _buffer;  // Pooled buffer holding the message, or nullptr if it is in _line
+    size_t       _length;
     std::string* _line;
     MsgLevel     _level;
 };
 
+// Buffers for outgoing messages; see MESSAGE_POOL_BUFFERS in Config.h.
+// A message in a pooled buffer always leaves room to append a newline.
+char*  message_buffer_acquire();
+void   message_buffer_release(const char* buffer);
+size_t message_buffer_size();
+void   report_message_pool(Channel& out);
+void   reset_message_pool_stats();
+
 extern bool atMsgLevel(MsgLevel level);
 
 // clang-format off
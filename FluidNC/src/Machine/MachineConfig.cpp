@@ -19,6 +19,7 @@
 #include "Configuration/Parser.h"
 #include "Configuration/ParserHandler.h"
 #include "Configuration/Validator.h"
+#include "Configuration/ItemIndex.h"
 #include "Configuration/AfterParse.h"
 #include "Config.h"  // ENABLE_*
 
@@ -159,8 +160,24 @@ namespace Machine {
         // @default 16
         // @tuning typical
         // Number of motion blocks held in the look-ahead planner buffer. Leave at the
-        // default unless tuning for a special application.
-        handler.item("planner_blocks", _planner_blocks, 10, 120);
+        // default unless tuning for a special application. More blocks let high feed
+        // rates be sustained through programs made of many tiny segments. Each block
+        // takes about 100 bytes; buffers of more than 128 blocks are put in PSRAM on
+        // boards that have it.
+        handler.item("planner_blocks", _planner_blocks, 10, 4000);
+
+        // @config jerk_mm_per_sec3
+        // @default 0
+        // @tuning typical
+        // When nonzero, the acceleration and deceleration ramps of each move are shaped
+        // into S-curves so the acceleration changes gradually, at no more than this many
+        // mm/sec^3, instead of switching on and off abruptly. This reduces ringing on
+        // heavy machines. Each ramp has the duration and length that a trapezoidal
+        // ramp would have at 2/3 of the axis acceleration setting, so moves take somewhat
+        // longer, but the peak acceleration in the middle of a ramp stays within the
+        // setting. Ramps that are too short to meet the jerk limit within that peak get
+        // the least jerk that the peak allows. 0 gives the classic trapezoidal profiles.
+        handler.item("jerk_mm_per_sec3", _jerk, 0.0, 1e9);
     }
 
     void MachineConfig::afterParse() {
@@ -251,6 +268,10 @@ namespace Machine {
 
     const char defaultConfig[] = "name: Default (Test Drive)\nboard: None\n";
 
+    static std::string cache_filename(std::string_view filename) {
+        return std::string { filename } + ".cache";
+    }
+
     void MachineConfig::load() {
         // If the system crashes we skip the config file and use the default
         // builtin config.  This helps prevent reset loops on bad config files.
@@ -269,6 +290,11 @@ namespace Machine {
                 }
                 log_error(btLine.c_str());
             }
+            // The crash might have come from the cached configuration, so
+            // make the next boot parse the file
+            std::error_code ec;
+            stdfs::remove(FluidPath { cache_filename(config_filename->get()), LocalFS, ec }, ec);
+
             log_info("Using default configuration");
             load_yaml(defaultConfig);
             set_state(State::ConfigAlarm);
@@ -277,7 +303,21 @@ namespace Machine {
         }
     }
 
+    // Reports how long loading took, how much heap the configuration uses, and
+    // the most heap that loading used at once.  The peak comes from the heap's
+    // low-water mark.  If loading did not lower the mark, the peak is no more
+    // than the distance to the mark from where loading started.
+    static void log_load_stats(const char* how, uint32_t start_ms, uint32_t start_heap, uint32_t start_low_water) {
+        uint32_t    low_water = xPortGetMinimumEverFreeHeapSize();
+        const char* peak      = low_water < start_low_water ? ", peak " : ", peak at most ";
+        log_info("Configuration " << how << " in " << (get_ms() - start_ms) << " ms, heap used "
+                                  << int32_t(start_heap - xPortGetFreeHeapSize()) << peak << (start_heap - low_water));
+    }
+
     void MachineConfig::load_file(const std::string_view filename) {
+        uint32_t start_ms        = get_ms();
+        uint32_t start_heap      = xPortGetFreeHeapSize();
+        uint32_t start_low_water = xPortGetMinimumEverFreeHeapSize();
         try {
             FileStream file(std::string { filename }, "rb", LocalFS);
 
@@ -287,6 +327,28 @@ namespace Machine {
                 load_yaml("");
                 return;
             }
+            log_info("Configuration file:" << filename);
+
+            bool        use_cache  = config_cache->get();
+            std::string cache_name = cache_filename(filename);
+            uint64_t    hash       = Configuration::fnv_basis;
+            if (use_cache) {
+                // Hash the file in pieces so that a cache hit does not need
+                // the whole file in memory
+                char chunk[256];
+                int  len;
+                while ((len = file.read(chunk, sizeof(chunk))) > 0) {
+                    hash = Configuration::fnv1a(chunk, len, hash);
+                }
+                file.set_position(0);
+
+                std::string records;
+                if (Configuration::read_cache(cache_name, hash, records) && load_cache(records)) {
+                    records = std::string();
+                    log_load_stats("loaded from cache", start_ms, start_heap, start_low_water);
+                    return;
+                }
+            }
 
             auto buffer      = std::make_unique<char[]>(filesize + 1);
             buffer[filesize] = '\0';
@@ -295,8 +357,16 @@ namespace Machine {
                 log_config_error("Configuration file:" << filename << " read error - expected " << filesize << " got " << actual);
                 return;
             }
-            log_info("Configuration file:" << filename);
-            load_yaml(std::string_view { buffer.get(), filesize });
+
+            Configuration::CacheWriter cache;
+            load_yaml(std::string_view { buffer.get(), filesize }, use_cache ? &cache : nullptr);
+            buffer.reset();
+            log_load_stats("parsed", start_ms, start_heap, start_low_water);
+
+            // Only a clean parse is cached, so errors are reported on every boot
+            if (use_cache && cache.ok() && !state_is(State::ConfigAlarm)) {
+                Configuration::write_cache(cache_name, hash, cache.records());
+            }
         } catch (...) {
             log_config_error("Cannot open configuration file:" << filename);
             log_info("Using default configuration");
@@ -305,53 +375,82 @@ namespace Machine {
         }
     }
 
-    void MachineConfig::load_yaml(std::string_view input) {
+    // Replaces the configuration with an empty one, ready to be filled in
+    static void new_instance() {
+        // instance() is by reference, so we can just get rid of an old instance and
+        // create a new one here:
+        auto& machineConfig = MachineConfig::instance();
+        if (machineConfig != nullptr) {
+            delete machineConfig;
+        }
+        machineConfig = new MachineConfig();
+        config        = machineConfig;
+        Configuration::ItemIndex::invalidate();
+    }
+
+    // Runs the after-parse and validation steps on a new configuration
+    static void finish_load() {
         try {
-            try {
-                Configuration::Parser        parser(input);
-                Configuration::ParserHandler handler(parser);
-
-                // instance() is by reference, so we can just get rid of an old instance and
-                // create a new one here:
-                {
-                    auto& machineConfig = instance();
-                    if (machineConfig != nullptr) {
-                        delete machineConfig;
-                    }
-                    machineConfig = new MachineConfig();
-                }
-                config = instance();
+            Configuration::AfterParse afterParse;
+            config->afterParse();
+            config->group(afterParse);
+        } catch (std::exception& ex) {
+            // Log exception:
+            log_config_error("Configuration after-parse error: " << ex.what());
+        }
 
-                handler.enterSection("machine", config);
+        try {
+            log_debug("Checking configuration");
 
-                log_debug("Running after-parse tasks");
-            } catch (std::exception& ex) {
-                // Log exception:
-                log_config_error("Configuration parse error: " << ex.what());
-            }
+            Configuration::Validator validator;
+            config->validate();
+            config->group(validator);
 
-            try {
-                Configuration::AfterParse afterParse;
-                config->afterParse();
-                config->group(afterParse);
-            } catch (std::exception& ex) {
-                // Log exception:
-                log_config_error("Configuration after-parse error: " << ex.what());
-            }
+            // log_info("Heap size after configuration load is " << uint32_t(xPortGetFreeHeapSize()));
+        } catch (std::exception& ex) {
+            // Log exception:
+            log_config_error("Configuration validation error: " << ex.what());
+        }
+    }
+
+    bool MachineConfig::load_cache(const std::string& records) {
+        try {
+            Configuration::CacheReader reader(records);
+            new_instance();
+            reader.replay("machine", config);
+        } catch (Configuration::CacheError& ex) {
+            log_info("Configuration cache not used: " << ex.what());
+            return false;
+        }
 
+        try {
+            log_debug("Running after-parse tasks");
+            finish_load();
+        } catch (...) {
+            log_config_error("Unknown error while processing config cache");
+        }
+
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return true;
+    }
+
+    void MachineConfig::load_yaml(std::string_view input, Configuration::CacheWriter* cache) {
+        try {
             try {
-                log_debug("Checking configuration");
+                Configuration::Parser        parser(input);
+                Configuration::ParserHandler handler(parser, cache);
+
+                new_instance();
 
-                Configuration::Validator validator;
-                config->validate();
-                config->group(validator);
+                handler.enterSection("machine", config);
 
-                // log_info("Heap size after configuration load is " << uint32_t(xPortGetFreeHeapSize()));
+                log_debug("Running after-parse tasks");
             } catch (std::exception& ex) {
                 // Log exception:
-                log_config_error("Configuration validation error: " << ex.what());
+                log_config_error("Configuration parse error: " << ex.what());
             }
 
+            finish_load();
         } catch (...) {
             // Get rid of buffer and return
             log_config_error("Unknown error while processing config file");
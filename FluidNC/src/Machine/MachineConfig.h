@@ -9,6 +9,7 @@
 #include "Configuration/GenericFactory.h"
 #include "Configuration/HandlerBase.h"
 #include "Configuration/Configurable.h"
+#include "Configuration/ConfigCache.h"
 #include "CoolantControl.h"
 #include "Kinematics/Kinematics.h"
 #if SUPPORT_PIN_EXTENDERS
@@ -129,6 +130,7 @@ namespace Machine {
         bool  _reportInches      = false;
 
         int32_t _planner_blocks = 16;
+        float   _jerk           = 0.0f;  // mm/sec^3; 0 for trapezoidal velocity profiles
 
         // Enables a special set of M-code commands that enables and disables the parking motion.
         // These are controlled by `M56`, `M56 P1`, or `M56 Px` to enable and `M56 P0` to disable.
@@ -154,7 +156,8 @@ namespace Machine {
 
         static void load();
         static void load_file(std::string_view file);
-        static void load_yaml(std::string_view yaml_string);
+        static void load_yaml(std::string_view yaml_string, Configuration::CacheWriter* cache = nullptr);
+        static bool load_cache(const std::string& records);
 
         ~MachineConfig();
     };
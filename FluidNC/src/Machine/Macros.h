@@ -76,6 +76,7 @@ namespace Machine {
         // Channel methods
         size_t write(uint8_t c) override { return 0; }
         void   ack(Error status) override;
+        Error  pendingError() override { return _pending_error; }
 
         ~MacroChannel();
     };
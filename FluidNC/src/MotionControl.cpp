@@ -312,17 +312,20 @@ GCUpdatePos mc_probe_cycle(float* target, plan_line_data_t* pl_data, bool away,
     // Setup and queue probing motion. Auto cycle-start should not start the cycle.
     mc_linear(target, pl_data, gc_state.position);
     // Activate the probing state monitor in the stepper module.
+    config->_probe->arm_latch();
     probing = true;
     // Perform probing cycle. Wait here until probe is triggered or motion completes.
     protocol_send_event(&cycleStartEvent);
     do {
         protocol_execute_realtime();
         if (sys.abort()) {
+            config->_probe->disarm_latch();
             Stepping::endLowLatency();
             return GCUpdatePos::None;  // Check for system abort
         }
     } while (!state_is(State::Idle));
 
+    config->_probe->disarm_latch();
     Stepping::endLowLatency();
 
     // Probing cycle complete!
@@ -0,0 +1,147 @@
+// Copyright (c) 2026 - FluidNC Contributors
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#include "NamedParams.h"
+
+#include <algorithm>
+#include <cctype>
+
+// Walks a name in canonical form, skipping whitespace and folding case
+class CanonicalChars {
+    std::string_view::const_iterator _next;
+    std::string_view::const_iterator _end;
+
+public:
+    explicit CanonicalChars(std::string_view name) : _next(name.begin()), _end(name.end()) {}
+
+    // Returns the next character, or '\0' at the end
+    char next() {
+        while (_next != _end) {
+            char c = *_next++;
+            if (!isspace(uint8_t(c))) {
+                return toupper(uint8_t(c));
+            }
+        }
+        return '\0';
+    }
+};
+
+uint32_t ParamSymbols::hash(std::string_view name) {
+    // FNV-1a
+    uint32_t       hash = 2166136261u;
+    CanonicalChars chars(name);
+    while (char c = chars.next()) {
+        hash = (hash ^ uint8_t(c)) * 16777619u;
+    }
+    return hash;
+}
+
+bool ParamSymbols::equal(std::string_view name, const std::string& canonical) {
+    CanonicalChars chars(name);
+    for (char c : canonical) {
+        if (chars.next() != c) {
+            return false;
+        }
+    }
+    return chars.next() == '\0';
+}
+
+// Returns the index of the table slot that holds the name, or of the empty
+// slot where it would go
+size_t ParamSymbols::slot(std::string_view name, uint32_t hash) const {
+    size_t mask = _table.size() - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+        param_symbol_t symbol = _table[i];
+        if (symbol == no_symbol || (_hashes[symbol] == hash && equal(name, _names[symbol]))) {
+            return i;
+        }
+    }
+}
+
+void ParamSymbols::rehash(size_t table_size) {
+    _table.assign(table_size, no_symbol);
+    size_t mask = _table.size() - 1;
+    for (size_t symbol = 0; symbol < _names.size(); symbol++) {
+        if (_names[symbol].empty()) {
+            continue;  // Reclaimed
+        }
+        size_t i = _hashes[symbol] & mask;
+        while (_table[i] != no_symbol) {
+            i = (i + 1) & mask;
+        }
+        _table[i] = param_symbol_t(symbol);
+    }
+}
+
+param_symbol_t ParamSymbols::find(std::string_view name) const {
+    if (_table.empty()) {
+        return no_symbol;
+    }
+    return _table[slot(name, hash(name))];
+}
+
+param_symbol_t ParamSymbols::intern(std::string_view name) {
+    // Keep the table at most half full so that probe sequences are short
+    if ((size() + 1) * 2 > _table.size()) {
+        rehash(_table.empty() ? 64 : _table.size() * 2);
+    }
+    uint32_t h = hash(name);
+    size_t   i = slot(name, h);
+    if (_table[i] != no_symbol) {
+        return _table[i];
+    }
+    if (full()) {
+        return no_symbol;
+    }
+
+    std::string    canonical;
+    CanonicalChars chars(name);
+    while (char c = chars.next()) {
+        canonical += c;
+    }
+    if (canonical.empty()) {
+        return no_symbol;
+    }
+
+    param_symbol_t symbol;
+    if (_free.empty()) {
+        symbol = param_symbol_t(_names.size());
+        _names.emplace_back(std::move(canonical));
+        _hashes.push_back(h);
+    } else {
+        symbol = _free.back();
+        _free.pop_back();
+        _names[symbol]  = std::move(canonical);
+        _hashes[symbol] = h;
+    }
+    _table[i] = symbol;
+    return symbol;
+}
+
+void NamedParamStore::set(param_symbol_t symbol, float value) {
+    if (symbol >= _values.size()) {
+        _values.resize(symbol + 1, Value { 0.0f, false });
+    }
+    auto& slot = _values[symbol];
+    if (!slot.defined) {
+        slot.defined = true;
+        ++_count;
+    }
+    slot.value = value;
+}
+
+void NamedParamStore::clear() {
+    _values.clear();
+    _count = 0;
+}
+
+std::vector<param_symbol_t> NamedParamStore::sorted(const ParamSymbols& symbols) const {
+    std::vector<param_symbol_t> result;
+    for (size_t symbol = 0; symbol < _values.size(); symbol++) {
+        if (_values[symbol].defined) {
+            result.push_back(param_symbol_t(symbol));
+        }
+    }
+    std::sort(result.begin(), result.end(), [&symbols](param_symbol_t a, param_symbol_t b) { return symbols.name(a) < symbols.name(b); });
+    return result;
+}
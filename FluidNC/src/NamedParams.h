@@ -0,0 +1,101 @@
+// Copyright (c) 2026 - FluidNC Contributors
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#pragma once
+
+// Named NGC parameters, like #<_x> and #<depth>, are referred to by symbol.
+// Each distinct name is interned once, when a line that uses it is parsed,
+// and gets a small integer that indexes flat arrays of parameter values, so
+// that reading or writing a parameter neither copies nor compares strings.
+// Names are case-insensitive and whitespace in them is ignored, so the
+// canonical form of a name is uppercase with no spaces.
+//
+// A ParamSymbols table is not locked, so it belongs to a single task.  The
+// one in Parameters.cpp is used by the protocol task, which parses and
+// compiles the lines that name parameters.
+//
+// Symbols that nothing refers to any more can be reclaimed between jobs,
+// when no compiled line or local parameter store holds one, so that a long
+// session of programs with different names does not fill the table.
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <vector>
+
+typedef uint16_t param_symbol_t;
+
+const param_symbol_t no_symbol = UINT16_MAX;
+
+class ParamSymbols {
+    std::deque<std::string>     _names;   // Canonical names, by symbol; a deque never moves them
+    std::vector<uint32_t>       _hashes;  // Name hashes, by symbol
+    std::vector<param_symbol_t> _table;   // Open-addressed hash table of symbols
+    std::vector<param_symbol_t> _free;    // Reclaimed symbols, whose names are empty
+
+    size_t slot(std::string_view name, uint32_t hash) const;
+    void   rehash(size_t table_size);
+
+public:
+    static uint32_t hash(std::string_view name);
+    static bool     equal(std::string_view name, const std::string& canonical);
+
+    // Returns no_symbol if the name has not been interned
+    param_symbol_t find(std::string_view name) const;
+
+    // Returns no_symbol if the name is empty or the table is full
+    param_symbol_t intern(std::string_view name);
+
+    const std::string& name(param_symbol_t symbol) const { return _names[symbol]; }
+    size_t             size() const { return _names.size() - _free.size(); }
+    bool               full() const { return _names.size() >= no_symbol && _free.empty(); }
+
+    // Frees the symbols for which keep(symbol) is false, for intern() to
+    // reuse, and returns how many were freed.  Nothing may refer to them.
+    template <typename Keep>
+    size_t reclaim(Keep&& keep) {
+        size_t freed = 0;
+        for (size_t symbol = 0; symbol < _names.size(); symbol++) {
+            if (!_names[symbol].empty() && !keep(param_symbol_t(symbol))) {
+                _names[symbol].clear();
+                _free.push_back(param_symbol_t(symbol));
+                ++freed;
+            }
+        }
+        if (freed) {
+            rehash(_table.size());
+        }
+        return freed;
+    }
+};
+
+// Parameter values indexed by symbol.  Setting a parameter whose symbol is
+// beyond the end of the array grows it; otherwise no access allocates.
+class NamedParamStore {
+    struct Value {
+        float value;
+        bool  defined;
+    };
+    std::vector<Value> _values;
+    size_t             _count = 0;
+
+public:
+    bool get(param_symbol_t symbol, float& value) const {
+        if (symbol >= _values.size() || !_values[symbol].defined) {
+            return false;
+        }
+        value = _values[symbol].value;
+        return true;
+    }
+    bool exists(param_symbol_t symbol) const { return symbol < _values.size() && _values[symbol].defined; }
+    void set(param_symbol_t symbol, float value);
+
+    bool   empty() const { return _count == 0; }
+    size_t count() const { return _count; }
+    void   clear();
+
+    // The symbols of the defined parameters, sorted by name, for listing
+    std::vector<param_symbol_t> sorted(const ParamSymbols& symbols) const;
+};
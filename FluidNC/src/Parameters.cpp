@@ -7,7 +7,7 @@
 #    include "Settings.h"
 #    include "Report.h"
 #    include "System.h"
-#    include "Configuration/GCodeParam.h"
+#    include "Configuration/ItemIndex.h"
 #    include "Machine/MachineConfig.h"
 #    include "MotionControl.h"
 #    include "GCode.h"
@@ -89,42 +89,11 @@ const std::map<const ngc_param_id_t, CoordIndex> axis_params = {
     { 5401, CoordIndex::TLO },
 };
 
-const std::map<const std::string, axis_t> work_positions = {
-    { "_x", X_AXIS },
-    { "_y", Y_AXIS },
-    { "_z", Z_AXIS },
-    { "_a", A_AXIS },
-    { "_b", B_AXIS },
-    { "_c", C_AXIS },
-    { "_u", U_AXIS },
-    { "_v", V_AXIS },
-    { "_w", W_AXIS },
-};
-const std::map<const std::string, axis_t> machine_positions = {
-    { "_abs_x", X_AXIS },
-    { "_abs_y", Y_AXIS },
-    { "_abs_z", Z_AXIS },
-    { "_abs_a", A_AXIS },
-    { "_abs_b", B_AXIS },
-    { "_abs_c", C_AXIS },
-    { "_abs_u", U_AXIS },
-    { "_abs_v", V_AXIS },
-    { "_abs_w", W_AXIS },
-};
-
-const std::array<const std::string, 6> unsupported_sys = {
-    "_spindle_rpm_mode",
-    "_spindle_css_mode",
-    "_ijk_absolute_mode",
-    "_lathe_diameter_mode",
-    "_lathe_radius_mode",
-    "_adaptive_feed",
-};
 #endif
 
 // clang-format on
 
-std::map<std::string, float> global_named_params;
+NamedParamStore global_named_params;
 
 bool ngc_param_is_rw(ngc_param_id_t id) {
     return true;
@@ -213,202 +182,157 @@ bool get_numbered_param(ngc_param_id_t id, float& result) {
     return false;
 }
 
-// TODO - make this a variant?
-struct param_ref_t {
-    std::string    name;  // If non-empty, the parameter is named
-    ngc_param_id_t id;    // Valid if name is empty
-};
 std::vector<std::tuple<param_ref_t, float>> assignments;
 
 uint32_t coord_values[] = { 540, 550, 560, 570, 580, 590, 591, 592, 593 };
 
 #ifndef UNIT_TEST
 bool set_config_item(const std::string& name, float result) {
-    try {
-        Configuration::GCodeParam gci(name.c_str(), result, false);
-        config->group(gci);
-        if (gci.isHandled_) {
-            return true;
-        }
-    } catch (std::exception& ex) {
-        log_debug(ex.what());
-        return false;
+    if (Configuration::ItemIndex::set(name, result)) {
+        return true;
     }
     log_debug("Failed to set " << name);
     return false;
 }
 
 bool get_config_item(const std::string& name, float& result) {
-    try {
-        Configuration::GCodeParam gci(name.c_str(), result, true);
-        config->group(gci);
-        if (gci.isHandled_) {
-            return true;
-        }
-    } catch (std::exception& ex) {
-        log_debug(ex.what());
-        return false;
-    }
-    return false;
+    return Configuration::ItemIndex::get(name, result);
 }
 
-bool get_system_param(const std::string& name, float& result) {
-    std::string sysn;
-    for (auto const& c : name) {
-        sysn += ::tolower(c);
-    }
-    if (auto search = work_positions.find(sysn); search != work_positions.end()) {
-        auto axis = search->second;
-        result    = to_inches(axis, get_mpos()[axis] - get_wco()[axis]);
-        return true;
-    }
-    if (auto search = machine_positions.find(sysn); search != machine_positions.end()) {
-        auto axis = search->second;
-        result    = to_inches(axis, get_mpos()[axis]);
-        return true;
-    }
-    if (std::find(unsupported_sys.begin(), unsupported_sys.end(), sysn) != unsupported_sys.end()) {
-        result = 0.0;
-        return true;
-    }
-    if (sysn == "_spindle_on") {
-        result = gc_state.modal.spindle != SpindleState::Disable;
-        return true;
-    }
-    if (sysn == "_spindle_cw") {
-        result = gc_state.modal.spindle == SpindleState::Cw;
-        return true;
-    }
-    if (sysn == "_spindle_m") {
-        result = static_cast<int>(gc_state.modal.spindle);
-        return true;
-    }
-
-    if (sysn == "_mist") {
-        result = gc_state.modal.coolant.Mist;
-        return true;
-    }
-    if (sysn == "_flood") {
-        result = gc_state.modal.coolant.Flood;
-        return true;
-    }
-    if (sysn == "_speed_override") {
-        result = sys.spindle_speed_ovr() != 100;
-        return true;
-    }
-    if (sysn == "_feed_override") {
-        result = sys.f_override() != 100;
-        return true;
-    }
-    if (sysn == "_feed_hold") {
-        result = state_is(State::Hold);
-        return true;
-    }
-    if (sysn == "_feed") {
-        result = to_inches(X_AXIS, gc_state.feed_rate);
-        return true;
-    }
-    if (sysn == "_rpm") {
-        result = gc_state.spindle_speed;
-        return true;
-    }
-    if (sysn == "_selected_tool") {
-        result = gc_state.selected_tool;
-        return true;
-    }
-
-    if (sysn == "_current_tool") {
-        result = gc_state.current_tool;
-        return true;
-    }
+static float work_position(axis_t axis) {
+    return to_inches(axis, get_mpos()[axis] - get_wco()[axis]);
+}
+static float machine_position(axis_t axis) {
+    return to_inches(axis, get_mpos()[axis]);
+}
+static float version_part(bool minor) {
+    // atoi() stops at the '.' between the parts
+    auto dot = std::string_view(grbl_version).find('.');
+    return atoi(minor ? grbl_version + dot + 1 : grbl_version);
+}
 
-    if (sysn == "_vmajor") {
-        std::string version(grbl_version);
-        auto        major = version.substr(0, version.find('.'));
-        result            = atoi(major.c_str());
-        return true;
-    }
-    if (sysn == "_vminor") {
-        std::string version(grbl_version);
-        auto        minor = version.substr(version.find('.') + 1);
+struct system_param_t {
+    const char* name;
+    float (*get)();
+};
 
-        result = atoi(minor.c_str());
-        return true;
-    }
-    if (sysn == "_line") {
-        //XXX Implement me
-        return true;
-    }
-    if (sysn == "_motion_mode") {
-        result = static_cast<gcodenum_t>(gc_state.modal.motion);
-        return true;
-    }
-    if (sysn == "_plane") {
-        result = static_cast<gcodenum_t>(gc_state.modal.plane_select);
-        return true;
-    }
+// System parameters are interned before any other name, so the symbol of a
+// system parameter is its index in this table.
+// clang-format off
+static const system_param_t system_params[] = {
+    { "_x", [] { return work_position(X_AXIS); } },
+    { "_y", [] { return work_position(Y_AXIS); } },
+    { "_z", [] { return work_position(Z_AXIS); } },
+    { "_a", [] { return work_position(A_AXIS); } },
+    { "_b", [] { return work_position(B_AXIS); } },
+    { "_c", [] { return work_position(C_AXIS); } },
+    { "_u", [] { return work_position(U_AXIS); } },
+    { "_v", [] { return work_position(V_AXIS); } },
+    { "_w", [] { return work_position(W_AXIS); } },
+    { "_abs_x", [] { return machine_position(X_AXIS); } },
+    { "_abs_y", [] { return machine_position(Y_AXIS); } },
+    { "_abs_z", [] { return machine_position(Z_AXIS); } },
+    { "_abs_a", [] { return machine_position(A_AXIS); } },
+    { "_abs_b", [] { return machine_position(B_AXIS); } },
+    { "_abs_c", [] { return machine_position(C_AXIS); } },
+    { "_abs_u", [] { return machine_position(U_AXIS); } },
+    { "_abs_v", [] { return machine_position(V_AXIS); } },
+    { "_abs_w", [] { return machine_position(W_AXIS); } },
+
+    // Unsupported
+    { "_spindle_rpm_mode", [] { return 0.0f; } },
+    { "_spindle_css_mode", [] { return 0.0f; } },
+    { "_ijk_absolute_mode", [] { return 0.0f; } },
+    { "_lathe_diameter_mode", [] { return 0.0f; } },
+    { "_lathe_radius_mode", [] { return 0.0f; } },
+    { "_adaptive_feed", [] { return 0.0f; } },
+
+    { "_spindle_on", [] { return float(gc_state.modal.spindle != SpindleState::Disable); } },
+    { "_spindle_cw", [] { return float(gc_state.modal.spindle == SpindleState::Cw); } },
+    { "_spindle_m", [] { return float(static_cast<int>(gc_state.modal.spindle)); } },
+    { "_mist", [] { return float(gc_state.modal.coolant.Mist); } },
+    { "_flood", [] { return float(gc_state.modal.coolant.Flood); } },
+    { "_speed_override", [] { return float(sys.spindle_speed_ovr() != 100); } },
+    { "_feed_override", [] { return float(sys.f_override() != 100); } },
+    { "_feed_hold", [] { return float(state_is(State::Hold)); } },
+    { "_feed", [] { return to_inches(X_AXIS, gc_state.feed_rate); } },
+    { "_rpm", [] { return float(gc_state.spindle_speed); } },
+    { "_selected_tool", [] { return float(gc_state.selected_tool); } },
+    { "_current_tool", [] { return float(gc_state.current_tool); } },
+    { "_vmajor", [] { return version_part(false); } },
+    { "_vminor", [] { return version_part(true); } },
+    { "_line", [] { return 0.0f; } },  //XXX Implement me
+    { "_motion_mode", [] { return float(static_cast<gcodenum_t>(gc_state.modal.motion)); } },
+    { "_plane", [] { return float(static_cast<gcodenum_t>(gc_state.modal.plane_select)); } },
 #    if 0
-    if (sysn == "_ccomp") {
-        result = static_cast<gcodenum_t>(gc_state.modal.cutter_comp);
-        return true;
-    }
+    { "_ccomp", [] { return float(static_cast<gcodenum_t>(gc_state.modal.cutter_comp)); } },
 #    endif
-    if (sysn == "_coord_system") {
-        result = coord_values[gc_state.modal.coord_select];
-        return true;
-    }
+    { "_coord_system", [] { return float(coord_values[gc_state.modal.coord_select]); } },
+    { "_metric", [] { return float(gc_state.modal.units == Units::Mm); } },
+    { "_imperial", [] { return float(gc_state.modal.units == Units::Inches); } },
+    { "_absolute", [] { return float(gc_state.modal.distance == Distance::Absolute); } },
+    { "_incremental", [] { return float(gc_state.modal.distance == Distance::Incremental); } },
+    { "_inverse_time", [] { return float(gc_state.modal.feed_rate == FeedRate::InverseTime); } },
+    { "_units_per_minute", [] { return float(gc_state.modal.feed_rate == FeedRate::UnitsPerMin); } },
+    // result = gc_state.modal.feed_rate == FeedRate::UnitsPerRev;
+    { "_units_per_rev", [] { return 0.0f; } },
+};
+// clang-format on
 
-    if (sysn == "_metric") {
-        result = gc_state.modal.units == Units::Mm;
-        return true;
-    }
-    if (sysn == "_imperial") {
-        result = gc_state.modal.units == Units::Inches;
-        return true;
-    }
-    if (sysn == "_absolute") {
-        result = gc_state.modal.distance == Distance::Absolute;
-        return true;
-    }
-    if (sysn == "_incremental") {
-        result = gc_state.modal.distance == Distance::Incremental;
-        return true;
-    }
-    if (sysn == "_inverse_time") {
-        result = gc_state.modal.feed_rate == FeedRate::InverseTime;
-        return true;
-    }
-    if (sysn == "_units_per_minute") {
-        result = gc_state.modal.feed_rate == FeedRate::UnitsPerMin;
-        return true;
-    }
-    if (sysn == "_units_per_rev") {
-        // result = gc_state.modal.feed_rate == FeedRate::UnitsPerRev;
-        result = 0.0;
-        return true;
-    }
+const param_symbol_t n_system_params = sizeof(system_params) / sizeof(system_params[0]);
 
-    return false;
+bool get_system_param(param_symbol_t symbol, float& result) {
+    if (symbol >= n_system_params) {
+        return false;
+    }
+    result = system_params[symbol].get();
+    return true;
 }
+#else
+const param_symbol_t n_system_params = 0;
 #endif
 
-bool system_param_exists(const std::string& name) {
-    float dummy;
+static ParamSymbols make_param_symbols() {
+    ParamSymbols symbols;
 #ifndef UNIT_TEST
-    return get_system_param(name, dummy);
-#else
-    return false;
+    for (auto const& param : system_params) {
+        symbols.intern(param.name);
+    }
 #endif
+    return symbols;
+}
+
+ParamSymbols param_symbols = make_param_symbols();
+
+static bool is_system_param(param_symbol_t symbol) {
+    return symbol < n_system_params;
+}
+
+static bool reported_full = false;
+
+// Interns a parameter name, logging once if the table is full
+static param_symbol_t intern_param(std::string_view name) {
+    param_symbol_t symbol = param_symbols.intern(name);
+    if (symbol == no_symbol && param_symbols.full() && !reported_full) {
+        log_error("Too many parameter names");
+        reported_full = true;
+    }
+    return symbol;
+}
+
+void reclaim_param_symbols() {
+    auto in_use = [](param_symbol_t symbol) { return is_system_param(symbol) || global_named_params.exists(symbol); };
+    if (param_symbols.reclaim(in_use)) {
+        reported_full = false;
+    }
 }
 
 // The LinuxCNC doc says that the EXISTS syntax is like EXISTS[#<_foo>]
 // For convenience, we also allow EXISTS[_foo]
 bool named_param_exists(std::string& name) {
-    std::string search;
-    if (name.length() > 3 && name[0] == '#' && name[1] == '<' && name.back() == '>') {
-        search = name.substr(2, name.length() - 3);
-    } else {
-        search = name;
+    std::string_view search(name);
+    if (search.length() > 3 && search[0] == '#' && search[1] == '<' && search.back() == '>') {
+        search = search.substr(2, search.length() - 3);
     }
     if (search.length() == 0) {
         return false;
@@ -416,64 +340,61 @@ bool named_param_exists(std::string& name) {
 #ifndef UNIT_TEST
     if (search[0] == '/') {
         float dummy;
-        return get_config_item(search, dummy);
+        return get_config_item(std::string(search), dummy);
+    }
+#endif
+    // A name that has never been interned cannot have a value
+    param_symbol_t symbol = param_symbols.find(search);
+    if (symbol == no_symbol) {
+        return false;
     }
     if (search[0] == '_') {
-        float dummy;
-        bool  got = get_system_param(search, dummy);
-        if (got) {
-            return true;
-        }
-        // Convert to uppercase for global named param lookup
-        std::string canonical_name(search);
-        std::transform(canonical_name.begin(), canonical_name.end(), canonical_name.begin(), ::toupper);
-        return global_named_params.count(canonical_name) != 0;
+        return is_system_param(symbol) || global_named_params.exists(symbol);
     }
+#ifndef UNIT_TEST
     // If the name does not start with _ it is local so we look for a job-local parameter
     // If no job is active, we treat the interpretive context like a local context
     if (Job::active()) {
-        return Job::param_exists(search);
+        return Job::param_exists(symbol);
     }
 #endif
-    // Convert to uppercase for global named param lookup
-    std::string canonical_name(search);
-    std::transform(canonical_name.begin(), canonical_name.end(), canonical_name.begin(), ::toupper);
-    return global_named_params.count(canonical_name) != 0;
-}
-
-bool get_global_named_param(const std::string& name, float& value) {
-    // Convert parameter name to uppercase for canonical form lookup
-    std::string canonical_name(name);
-    std::transform(canonical_name.begin(), canonical_name.end(), canonical_name.begin(), ::toupper);
-    auto it = global_named_params.find(canonical_name);
-    if (it == global_named_params.end()) {
-        return false;
-    }
-    value = it->second;
-    return true;
+    return global_named_params.exists(symbol);
 }
 
 bool get_param(const param_ref_t& param_ref, float& value) {
-    auto name = param_ref.name;
-    if (name.length()) {
+    auto symbol = param_ref.symbol;
+    if (symbol != no_symbol) {
 #ifndef UNIT_TEST
+        auto& name = param_symbols.name(symbol);
         if (name[0] == '/') {
             return get_config_item(name, value);
         }
         if (name[0] == '_') {
-            if (get_system_param(name, value)) {
+            if (get_system_param(symbol, value)) {
                 return true;
             }
-            return get_global_named_param(name, value);
+            return global_named_params.get(symbol, value);
         }
-        return Job::active() ? Job::get_param(name, value) : get_global_named_param(name, value);
+        return Job::active() ? Job::get_param(symbol, value) : global_named_params.get(symbol, value);
 #else
-        return get_global_named_param(name, value);
+        return global_named_params.get(symbol, value);
 #endif
     }
     return get_numbered_param(param_ref.id, value);
 }
 
+bool read_param(const param_ref_t& param_ref, float& value) {
+    if (get_param(param_ref, value)) {
+        return true;
+    }
+    if (param_ref.symbol != no_symbol) {
+        log_debug("Undefined parameter " << param_symbols.name(param_ref.symbol));
+    } else {
+        log_debug("Undefined parameter " << param_ref.id);
+    }
+    return false;
+}
+
 // Extracts a floating point value from a string. The following code is based loosely on
 // the avr-libc strtod() function by Michael Stumpf and Dmitry Xmelkov and many freely
 // available conversion method examples, but has been highly optimized for Grbl. For known
@@ -483,7 +404,7 @@ bool get_param(const param_ref_t& param_ref, float& value) {
 // NOTE: Thanks to Radu-Eosif Mihailescu for identifying the issues with using strtod().
 const int MAX_INT_DIGITS = 8;  // Maximum number of digits in int32 (and float)
 
-static float uint_to_float(uint32_t intval, int8_t exp) {
+float uint_to_float(uint32_t intval, int8_t exp) {
     float fval = (float)intval;
     // Apply decimal. Should perform no more than two floating point multiplications for the
     // expected range of E0 to E-4.
@@ -578,21 +499,25 @@ bool get_param_ref(const char* line, size_t& pos, param_ref_t& param_ref) {
         }
             param_ref.id = result;
             return true;
-        case '<':
+        case '<': {
             // Named parameter
-            ++pos;
+            auto start = ++pos;
             while ((c = line[pos]) && c != '>') {
                 ++pos;
-                if (!isspace(c)) {
-                    param_ref.name += toupper(c);
-                }
             }
             if (!c) {
                 log_debug("Missing >");
                 return false;
             }
+            std::string_view name(line + start, pos - start);
             ++pos;
+            param_ref.symbol = intern_param(name);
+            if (param_ref.symbol == no_symbol) {
+                log_debug("Invalid parameter name " << name);
+                return false;
+            }
             return true;
+        }
         case '[': {
             // Expression evaluating to param number
             Error status = expression(line, pos, result);
@@ -614,10 +539,11 @@ bool get_param_ref(const char* line, size_t& pos, param_ref_t& param_ref) {
 }
 
 bool set_named_param(const char* name, float value) {
-    // Convert parameter name to uppercase for canonical form
-    std::string canonical_name(name);
-    std::transform(canonical_name.begin(), canonical_name.end(), canonical_name.begin(), ::toupper);
-    global_named_params[canonical_name] = value;
+    param_symbol_t symbol = intern_param(name);
+    if (symbol == no_symbol) {
+        return false;
+    }
+    global_named_params.set(symbol, value);
     return true;
 }
 
@@ -657,22 +583,24 @@ bool set_numbered_param(ngc_param_id_t id, float value) {
 }
 
 bool set_param(const param_ref_t& param_ref, float value) {
+    auto symbol = param_ref.symbol;
+    if (symbol != no_symbol) {  // Named parameter
 #ifndef UNIT_TEST
-    if (param_ref.name.length()) {  // Named parameter
-        auto name = param_ref.name;
+        auto& name = param_symbols.name(symbol);
         if (name[0] == '/') {
-            return set_config_item(param_ref.name, value);
+            return set_config_item(name, value);
         }
         if (name[0] != '_' && Job::active()) {
-            return Job::set_param(name, value);
+            return Job::set_param(symbol, value);
         }
-        if (name[0] == '_' && system_param_exists(name)) {
+        if (is_system_param(symbol)) {
             log_debug("Attempt to set read-only parameter " << name);
             return false;
         }
-        return set_named_param(name.c_str(), value);
-    }
 #endif
+        global_named_params.set(symbol, value);
+        return true;
+    }
 
     if (ngc_param_is_rw(param_ref.id)) {  // Numbered parameter
         return set_numbered_param(param_ref.id, value);
@@ -704,11 +632,7 @@ bool read_number(const char* line, size_t& pos, float& result /*, bool in_expres
         if (!get_param_ref(line, pos, param_ref)) {
             return false;
         }
-        if (get_param(param_ref, result)) {
-            return true;
-        }
-        log_debug("Undefined parameter " << param_ref.name);
-        return false;
+        return read_param(param_ref, result);
     }
 
     // Handle bracketed expression [...]
@@ -786,8 +710,10 @@ void list_global_params(Channel& out) {
         return;
     }
     log_string(out, "Named Parameters");
-    for (const auto& param : global_named_params) {
+    for (auto symbol : global_named_params.sorted(param_symbols)) {
+        float value;
+        global_named_params.get(symbol, value);
         // Format: parameter_name = value
-        log_info_to(out, param.first << " = " << param.second);
+        log_info_to(out, param_symbols.name(symbol) << " = " << value);
     }
 }
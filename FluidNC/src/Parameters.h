@@ -6,14 +6,30 @@
 #include <stddef.h>
 #include <string>
 
+#include "NamedParams.h"
+
 #include <cstdint>
 // TODO - make ngc_param_id_t an enum, give names to numbered parameters where
 // possible
 typedef uint32_t ngc_param_id_t;
 
+struct param_ref_t {
+    param_symbol_t symbol = no_symbol;  // If valid, the parameter is named
+    ngc_param_id_t id     = 0;          // Valid if the parameter is not named
+};
+
+// Reads the parameter reference after a #.  Indirect references, like ##1
+// and #[expr], are resolved to a parameter number as they are read.
+bool get_param_ref(const char* line, size_t& pos, param_ref_t& param_ref);
+// Gets the value of a parameter, logging a message if it is undefined
+bool read_param(const param_ref_t& param_ref, float& value);
+
 bool assign_param(const char* line, size_t& pos);
 bool read_number(const char* line, size_t& pos, float& value /*, bool in_expression = false*/);
 bool read_number(const std::string_view sv, float& value /*, bool in_expression = false*/);
+bool read_float(const char* line, size_t& pos, float& value);
+// The conversion that read_float() applies to the digits that it has read
+float uint_to_float(uint32_t intval, int8_t exp);
 bool perform_assignments();
 bool named_param_exists(std::string& name);
 bool set_named_param(const char* name, float value);
@@ -25,6 +41,11 @@ class Channel;
 // List global parameters
 void list_global_params(Channel& out);
 
-// Forward declaration for list_named_parameters
-#include <map>
-extern std::map<std::string, float> global_named_params;
+// The symbols of all parameter names, and the values of global named parameters.
+// Both belong to the protocol task.
+extern ParamSymbols    param_symbols;
+extern NamedParamStore global_named_params;
+
+// Frees the symbols that only finished jobs used.  Called when the last job
+// finishes, so no compiled line or local parameter refers to them.
+void reclaim_param_symbols();
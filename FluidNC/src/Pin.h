@@ -125,7 +125,7 @@ public:
     inline void     setDuty(uint32_t duty) const { _detail->setDuty(duty); }
     inline uint32_t maxDuty() const { return _detail->maxDuty(); }
 
-    inline bool read() const { return _detail->read() != 0; }
+    inline bool IRAM_ATTR read() const { return _detail->read() != 0; }
 
     inline void setAttr(Attr attributes, uint32_t frequency = 0) const { _detail->setAttr(attributes, frequency); }
 
@@ -18,7 +18,7 @@ namespace Pins {
     // cppcheck-suppress unusedFunction
     void IRAM_ATTR VoidPinDetail::write(bool high) {}
     // cppcheck-suppress unusedFunction
-    bool VoidPinDetail::read() {
+    bool IRAM_ATTR VoidPinDetail::read() {
         return 0;
     }
     // cppcheck-suppress unusedFunction
@@ -9,22 +9,45 @@
 */
 
 #include "Planner.h"
+#include "Junction.h"
+#include "SCurve.h"
 #include "Machine/MachineConfig.h"
+#include "PlatformCompat.h"  // HAS_EXTERNAL_RAM
 
 #include <cstdlib>  // PSoc Required for labs
 #include <cmath>
 
+#if HAS_EXTERNAL_RAM
+#    include <esp_heap_caps.h>
+#endif
+
 static plan_block_t* block_buffer = nullptr;  // A ring buffer for motion instructions
-static uint8_t       block_buffer_tail;       // Index of the block to process now
-static uint8_t       block_buffer_head;       // Index of the next block to be pushed
-static uint8_t       next_buffer_head;        // Index of the next buffer head
-static uint8_t       block_buffer_planned;    // Index of the optimally planned block
+static plan_index_t  block_buffer_tail;       // Index of the block to process now
+static plan_index_t  block_buffer_head;       // Index of the next block to be pushed
+static plan_index_t  next_buffer_head;        // Index of the next buffer head
+static plan_index_t  block_buffer_planned;    // Index of the optimally planned block
+
+static plan_block_t* plan_alloc_blocks(size_t n_blocks) {
+#if HAS_EXTERNAL_RAM
+    // Deep look-ahead buffers go to PSRAM, leaving internal RAM for everything else
+    if (n_blocks > PLANNER_INTERNAL_RAM_BLOCKS) {
+        void* blocks = heap_caps_calloc(n_blocks, sizeof(plan_block_t), MALLOC_CAP_SPIRAM);
+        if (blocks) {
+            return static_cast<plan_block_t*>(blocks);
+        }
+    }
+#endif
+    return static_cast<plan_block_t*>(calloc(n_blocks, sizeof(plan_block_t)));
+}
 
 void plan_init() {
-    if (block_buffer) {
-        delete[] block_buffer;
+    free(block_buffer);
+    block_buffer = plan_alloc_blocks(config->_planner_blocks);
+    if (!block_buffer) {
+        log_error("Not enough memory for " << config->_planner_blocks << " planner blocks");
+        config->_planner_blocks = PLANNER_FALLBACK_BLOCKS;
+        block_buffer            = plan_alloc_blocks(config->_planner_blocks);
     }
-    block_buffer = new plan_block_t[config->_planner_blocks];
 }
 
 // Define planner variables
@@ -38,7 +61,7 @@ typedef struct {
 static planner_t pl;
 
 // Returns the index of the next block in the ring buffer. Also called by stepper segment buffer.
-static uint8_t plan_next_block_index(uint8_t block_index) {
+static plan_index_t plan_next_block_index(plan_index_t block_index) {
     block_index++;
     if (block_index == config->_planner_blocks) {
         block_index = 0;
@@ -47,7 +70,7 @@ static uint8_t plan_next_block_index(uint8_t block_index) {
 }
 
 // Returns the index of the previous block in the ring buffer
-static uint8_t plan_prev_block_index(uint8_t block_index) {
+static plan_index_t plan_prev_block_index(plan_index_t block_index) {
     if (block_index == 0) {
         block_index = config->_planner_blocks;
     }
@@ -115,9 +138,11 @@ static uint8_t plan_prev_block_index(uint8_t block_index) {
   will be able to compute higher velocity profiles within the same combined distance. (2) Maximize line
   motion(s) distance per block to a desired tolerance. The more combined distance the planner has to use,
   the faster it can go. (3) Maximize the planner buffer size. This also will increase the combined distance
-  for the planner to compute over. It also increases the number of computations the planner has to perform
-  to compute an optimal plan, so select carefully. The Arduino 328p memory is already maxed out, but future
-  ARM versions should have enough memory and speed for look-ahead blocks numbering up to a hundred or more.
+  for the planner to compute over. Thanks to the planned pointer, the cost of adding a block does not grow
+  with the buffer size once the buffer holds more than the stopping distance: only the blocks after the
+  planned pointer, which are those still decelerating toward the end of the buffer, are recomputed. So a
+  deep buffer costs memory, but little time. With PSRAM, or on the posix build, thousands of blocks are
+  practical.
 
 */
 static void planner_recalculate() {
@@ -126,7 +151,7 @@ static void planner_recalculate() {
         return;
     }
     // Initialize block index to the last block in the planner buffer.
-    uint8_t block_index = plan_prev_block_index(block_buffer_head);
+    plan_index_t block_index = plan_prev_block_index(block_buffer_head);
     // Bail. Can't do anything with one only one plan-able block.
     if (block_index == block_buffer_planned) {
         return;
@@ -209,7 +234,7 @@ void plan_reset_buffer() {
 // Called from stepper pulse function when the block is complete
 void plan_discard_current_block() {
     if (block_buffer_head != block_buffer_tail) {  // Discard non-empty buffer.
-        uint8_t block_index = plan_next_block_index(block_buffer_tail);
+        plan_index_t block_index = plan_next_block_index(block_buffer_tail);
         // Push block_buffer_planned pointer, if encountered.
         if (block_buffer_tail == block_buffer_planned) {
             block_buffer_planned = block_index;
@@ -232,7 +257,7 @@ plan_block_t* plan_get_current_block() {
 }
 
 float plan_get_exec_block_exit_speed_sqr() {
-    uint8_t block_index = plan_next_block_index(block_buffer_tail);
+    plan_index_t block_index = plan_next_block_index(block_buffer_tail);
     if (block_index == block_buffer_head) {
         return 0.0f;
     }
@@ -281,7 +306,7 @@ static void plan_compute_profile_parameters(plan_block_t* block, float nominal_s
 
 // Re-calculates buffered motions profile parameters upon a motion-based override change.
 void plan_update_velocity_profile_parameters() {
-    uint8_t       block_index = block_buffer_tail;
+    plan_index_t  block_index = block_buffer_tail;
     plan_block_t* block;
     float         nominal_speed;
     float         prev_nominal_speed = SOME_LARGE_VALUE;  // Set high for first block nominal speed calculation.
@@ -351,6 +376,10 @@ bool plan_buffer_line(float* target, plan_line_data_t* pl_data) {
     block->millimeters  = convert_delta_vector_to_unit_vector(unit_vec);
     block->acceleration = limit_acceleration_by_axis_maximum(unit_vec);
     block->rapid_rate   = limit_rate_by_axis_maximum(unit_vec);
+    if (config->_jerk > 0) {
+        // S-curve ramps peak above their average acceleration, see SCurve.h
+        block->acceleration *= SCurve::accel_fraction;
+    }
     // Store programmed rate.
     if (block->motion.rapidMotion) {
         block->programmed_rate = block->rapid_rate;
@@ -377,12 +406,10 @@ bool plan_buffer_line(float* target, plan_line_data_t* pl_data) {
         // from path, but used as a robust way to compute cornering speeds, as it takes into account the
         // nonlinearities of both the junction angle and junction velocity.
         //
-        // NOTE: If the junction deviation value is finite, the motions are executed in exact path
-        // mode (G61). If the junction deviation value is zero, the motions are executed in exact
-        // stop mode (G61.1) manner. In the future, if continuous mode (G64) is desired, the math here
-        // is exactly the same. Instead of motioning all the way to junction point, the machine will
-        // just follow the arc circle defined here. The Arduino doesn't have the CPU cycles to perform
-        // a continuous mode path, but ARM-based microcontrollers most certainly do.
+        // NOTE: With the configured junction deviation, the motions are executed in exact path
+        // mode (G61). In exact stop mode (G61.1), every junction speed is zero. Continuous mode (G64)
+        // is planned exactly like G61. Blending would replace the corner with an arc within the
+        // G64 P tolerance, which means rewriting the path, and that is not implemented.
         //
         // NOTE: The max junction speed is a fixed value, since machine acceleration limits cannot be
         // changed dynamically during operation nor can the line move geometry. This must be kept in
@@ -395,7 +422,9 @@ bool plan_buffer_line(float* target, plan_line_data_t* pl_data) {
             junction_unit_vec[axis] = unit_vec[axis] - pl.previous_unit_vec[axis];
         }
         // NOTE: Computed without any expensive trig, sin() or acos(), by trig half angle identity of cos(theta).
-        if (junction_cos_theta > 0.999999) {
+        if (block->motion.exactStop) {
+            block->max_junction_speed_sqr = 0.0;
+        } else if (junction_cos_theta > 0.999999) {
             //  For a 0 degree acute junction, just set minimum junction speed.
             block->max_junction_speed_sqr = MINIMUM_JUNCTION_SPEED * MINIMUM_JUNCTION_SPEED;
         } else {
@@ -405,10 +434,9 @@ bool plan_buffer_line(float* target, plan_line_data_t* pl_data) {
             } else {
                 convert_delta_vector_to_unit_vector(junction_unit_vec);
                 float junction_acceleration = limit_acceleration_by_axis_maximum(junction_unit_vec);
-                float sin_theta_d2          = sqrtf(0.5f * (1.0f - junction_cos_theta));  // Trig half angle identity. Always positive.
+                float junction_radius       = Junction::radius(junction_cos_theta, config->_junctionDeviation);
                 block->max_junction_speed_sqr =
-                    MAX(MINIMUM_JUNCTION_SPEED * MINIMUM_JUNCTION_SPEED,
-                        (junction_acceleration * config->_junctionDeviation * sin_theta_d2) / (1.0f - sin_theta_d2));
+                    MAX(MINIMUM_JUNCTION_SPEED * MINIMUM_JUNCTION_SPEED, junction_acceleration * junction_radius);
             }
         }
     }
@@ -440,7 +468,7 @@ void plan_sync_position() {
 
 // Returns the number of available blocks are in the planner buffer.
 // Called from report_realtime_status
-uint8_t plan_get_block_buffer_available() {
+plan_index_t plan_get_block_buffer_available() {
     if (block_buffer_head >= block_buffer_tail) {
         return (config->_planner_blocks - 1) - (block_buffer_head - block_buffer_tail);
     } else {
@@ -15,12 +15,16 @@
 
 #include <cstdint>
 
+// Index into the planner ring buffer, which can hold thousands of blocks
+typedef uint16_t plan_index_t;
+
 // Define planner data condition flags. Used to denote running conditions of a block.
 struct PlMotion {
     uint8_t rapidMotion : 1;
     uint8_t systemMotion : 1;    // Single motion. Circumvents planner state. Used by home/park.
     uint8_t noFeedOverride : 1;  // Motion does not honor feed override.
     uint8_t inverseTime : 1;     // Interprets feed rate value as inverse time when set.
+    uint8_t exactStop : 1;       // Comes to a stop at the start of the motion (G61.1).
 };
 
 // This struct stores a linear movement of a g-code block motion with its critical "nominal" values
@@ -109,7 +113,7 @@ void plan_sync_position();
 void plan_cycle_reinitialize();
 
 // Returns the number of available blocks are in the planner buffer.
-uint8_t plan_get_block_buffer_available();
+plan_index_t plan_get_block_buffer_available();
 
 // Returns the status of the block ring buffer. True, if buffer is full.
 uint8_t plan_check_full_buffer();
@@ -5,15 +5,23 @@
 #include "Probe.h"
 #include "Machine/EventPin.h"
 #include "Machine/MachineConfig.h"
+#include "Stepping.h"
+#include "string_util.h"
+#include "Driver/delay_usecs.h"  // getCpuTicks(), ticks_per_us
 
 extern void    protocol_do_probe(void* arg);
 const ArgEvent probeEvent { protocol_do_probe };
 
 Probe::ProbeEventPin::ProbeEventPin(const char* legend) : EventPin(&probeEvent, ExecAlarm::None, legend) {}
 
+static bool is_gpio(Pin& pin) {
+    return pin.undefined() || string_util::starts_with_ignore_case(pin.name(), "gpio.");
+}
+
 void Probe::init() {
     _probePin.init();
     _toolsetterPin.init();
+    _latchable = exists() && is_gpio(_probePin) && is_gpio(_toolsetterPin);
 }
 
 void Probe::set_direction(bool away) {
@@ -30,6 +38,34 @@ bool Probe::tripped() {
     return get_state() ^ _away;
 }
 
+// Undefined pins are skipped, so that a probe without a toolsetter does not
+// depend on the void pin being in IRAM
+bool IRAM_ATTR Probe::tripped_now() {
+    bool tripped = (_probePin.defined() && _probePin.read()) || (_toolsetterPin.defined() && _toolsetterPin.read());
+    return tripped ^ _away;
+}
+
+void Probe::arm_latch() {
+    if (_latchable) {
+        _latch.arm();
+    }
+}
+
+void IRAM_ATTR Probe::sample_latch() {
+    if (_latch.armed()) {
+        _latch.sample(tripped_now(), Stepping::allSteps(), Axes::_numberAxis, getCpuTicks());
+    }
+}
+
+bool Probe::take_latched_steps(int32_t* steps) {
+    uint32_t ticks;
+    if (!_latch.take(steps, Axes::_numberAxis, ticks)) {
+        return false;
+    }
+    log_debug("Probe position latched " << uint32_t(getCpuTicks() - ticks) / ticks_per_us << " us before the probe event");
+    return true;
+}
+
 void Probe::validate() {}
 
 void Probe::group(Configuration::HandlerBase& handler) {
@@ -79,7 +115,9 @@ void protocol_do_probe(void* arg) {
     Probe* p = config->_probe;
     if (p->tripped() && probing) {
         probing = false;
-        get_steps(probe_steps);
+        if (!p->take_latched_steps(probe_steps)) {
+            get_steps(probe_steps);
+        }
         if (p->_hard_stop) {
             Stepper::reset();
             plan_reset();
@@ -6,6 +6,8 @@
 
 #include "Configuration/HandlerBase.h"
 #include "Configuration/Configurable.h"
+#include "ProbeLatch.h"
+#include "Config.h"  // MAX_N_AXIS
 
 #include <cstdint>
 
@@ -27,6 +29,15 @@ class Probe : public Configuration::Configurable {
     ProbeEventPin _probePin;
     ProbeEventPin _toolsetterPin;
 
+    // The stepper ISR can latch the trip position only if it can read the
+    // probe pins directly, which it can for GPIOs but not for pins on an
+    // expander or a UART channel.
+    bool                   _latchable = false;
+    ProbeLatch<MAX_N_AXIS> _latch;
+
+    // Reads the probe pins instead of using the state from the last event
+    bool tripped_now();
+
 public:
     bool _hard_stop        = false;
     bool _probe_hard_limit = false;
@@ -52,6 +63,17 @@ public:
     // Returns true if the probe pin is tripped, depending on the direction (away or not)
     bool tripped();
 
+    // Starts and stops latching the trip position for a probing cycle
+    void arm_latch();
+    void disarm_latch() { _latch.disarm(); }
+
+    // Called from the stepper ISR after each step pulse
+    void sample_latch();
+
+    // Copies the position latched when the probe tripped into steps, and
+    // returns false if no position was latched.
+    bool take_latched_steps(int32_t* steps);
+
     ProbeEventPin& probePin() { return _probePin; }
     ProbeEventPin& toolsetterPin() { return _toolsetterPin; }
 
@@ -0,0 +1,97 @@
+// Copyright (c) 2026 - FluidNC Contributors
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#pragma once
+
+// ProbeLatch records the motor positions at the step where a probe trips.
+// The stepper ISR samples the probe after each step pulse, while the probe
+// event that stops the motion runs later on the protocol task, after the
+// pin has been polled and the event queued.  At probing feed rates the
+// machine moves a measurable distance in that time, so the event takes
+// the position from the latch instead of the current position.
+//
+// The latch follows the probe: if the probe releases before the event
+// takes the position, as it does for a glitch, the latch clears and the
+// next trip latches again.  The ISR writes the position under a sequence
+// count, odd while it is writing, so that the reader on the other core
+// never takes a position that is half updated.  What the ISR calls is in
+// IRAM, since the ISR runs while the flash cache is disabled for writes.
+
+#include "Platform.h"  // IRAM_ATTR
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+template <size_t N>
+class ProbeLatch {
+    std::atomic<bool>     _armed { false };
+    std::atomic<bool>     _latched { false };
+    std::atomic<uint32_t> _sequence { 0 };
+
+    int32_t  _steps[N] = {};
+    uint32_t _ticks    = 0;
+
+public:
+    // Starts watching for a trip, discarding any earlier one
+    void arm() {
+        _latched.store(false);
+        _armed.store(true);
+    }
+    void disarm() { _armed.store(false); }
+    bool IRAM_ATTR armed() const { return _armed.load(std::memory_order_relaxed); }
+
+    // Called from the stepper ISR after the steps of a pulse have been
+    // counted, with the probe state and a timestamp.  Returns true if
+    // this sample latched the position.
+    bool IRAM_ATTR sample(bool tripped, const int32_t* steps, size_t n_axis, uint32_t ticks) {
+        if (!_armed.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        if (!tripped) {
+            _latched.store(false, std::memory_order_relaxed);
+            return false;
+        }
+        if (_latched.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        _sequence.fetch_add(1);
+        for (size_t axis = 0; axis < n_axis && axis < N; axis++) {
+            _steps[axis] = steps[axis];
+        }
+        _ticks = ticks;
+        _sequence.fetch_add(1);
+        _latched.store(true);
+        return true;
+    }
+
+    // Copies the latched position and its timestamp and disarms the latch.
+    // Returns false, leaving steps alone, if nothing is latched.
+    bool take(int32_t* steps, size_t n_axis, uint32_t& ticks) {
+        _armed.store(false);
+        int32_t  copy[N];
+        uint32_t copy_ticks;
+        while (true) {
+            if (!_latched.load()) {
+                return false;
+            }
+            uint32_t sequence = _sequence.load();
+            if (sequence & 1) {
+                continue;  // The ISR is writing a new position
+            }
+            for (size_t axis = 0; axis < N; axis++) {
+                copy[axis] = _steps[axis];
+            }
+            copy_ticks = _ticks;
+            if (_sequence.load() == sequence) {
+                break;
+            }
+        }
+        _latched.store(false);
+        for (size_t axis = 0; axis < n_axis && axis < N; axis++) {
+            steps[axis] = copy[axis];
+        }
+        ticks = copy_ticks;
+        return true;
+    }
+};
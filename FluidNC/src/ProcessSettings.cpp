@@ -10,6 +10,7 @@
 #include "Configuration/RuntimeSetting.h"
 #include "Configuration/AfterParse.h"
 #include "Configuration/Validator.h"
+#include "Configuration/ItemIndex.h"
 #include "Machine/Axes.h"
 #include "Regexpr.h"
 #include "WebUI/Authentication.h"
@@ -26,6 +27,7 @@
 #include "Driver/backtrace.h"     // backtrace_get(), etc.
 #include "FileCommands.h"         // make_file_commands()
 #include "Job.h"                  // Job::active()
+#include "Stepper.h"              // Stepper::report_stats()
 
 #include "FluidPath.h"
 #include "HashFS.h"
@@ -991,6 +993,52 @@ static Error setReportInterval(const char* value, AuthenticationLevel auth_level
     return Error::Ok;
 }
 
+// $RB=<ms> is like $RI but sends binary telemetry frames instead of
+// text status reports.  $RB=0 turns them off, as does any $RI=<ms>.
+static Error setBinaryReportInterval(const char* value, AuthenticationLevel auth_level, Channel& out) {
+    if (!out.binaryReportsOkay()) {
+        log_error_to(out, out.name() << " cannot send binary reports");
+        return Error::InvalidStatement;
+    }
+    if (value && *value) {
+        uint32_t intValue;
+
+        if (!string_util::from_decimal(value, intValue)) {
+            return Error::BadNumberFormat;
+        }
+
+        uint32_t actual = out.setReportInterval(intValue, true);
+        if (actual) {
+            log_info(out.name() << " binary report interval set to " << actual << " ms");
+        } else {
+            log_info(out.name() << " auto reporting turned off");
+        }
+        return Error::Ok;
+    }
+    uint32_t actual = out.getBinaryReports() ? out.getReportInterval() : 0;
+    if (actual) {
+        log_info_to(out, out.name() << " binary report interval is " << actual << " ms");
+    } else {
+        log_info_to(out, out.name() << " binary reporting is off");
+    }
+    return Error::Ok;
+}
+
+// $GB=ON lets the channel accept binary GCode lines; see GCodeBinary.h
+static Error setBinaryGCode(const char* value, AuthenticationLevel auth_level, Channel& out) {
+    if (value && *value) {
+        if (string_util::equal_ignore_case(value, "on") || strcmp(value, "1") == 0) {
+            out.setBinaryGCode(true);
+        } else if (string_util::equal_ignore_case(value, "off") || strcmp(value, "0") == 0) {
+            out.setBinaryGCode(false);
+        } else {
+            return Error::InvalidValue;
+        }
+    }
+    log_info_to(out, out.name() << " binary GCode is " << (out.getBinaryGCode() ? "on" : "off"));
+    return Error::Ok;
+}
+
 static Error sendAlarm(const char* value, AuthenticationLevel auth_level, Channel& out) {
     int32_t   intValue = value ? atoi(value) : 0;
     ExecAlarm alarm    = static_cast<ExecAlarm>(intValue);
@@ -1004,6 +1052,30 @@ static Error showHeap(const char* value, AuthenticationLevel auth_level, Channel
     return Error::Ok;
 }
 
+static Error showLineQueue(const char* value, AuthenticationLevel auth_level, Channel& out) {
+    if (value && strcasecmp(value, "reset") == 0) {
+        reset_line_queue_stats();
+    }
+    report_line_queue(out);
+    return Error::Ok;
+}
+
+static Error showOutputStats(const char* value, AuthenticationLevel auth_level, Channel& out) {
+    if (value && strcasecmp(value, "reset") == 0) {
+        reset_message_pool_stats();
+    }
+    report_message_pool(out);
+    return Error::Ok;
+}
+
+static Error showMotionStats(const char* value, AuthenticationLevel auth_level, Channel& out) {
+    if (value && strcasecmp(value, "reset") == 0) {
+        Stepper::reset_stats();
+    }
+    Stepper::report_stats(out);
+    return Error::Ok;
+}
+
 static Error list_parameters(const char* value, AuthenticationLevel auth_level, Channel& out) {
     list_global_params(out);
     list_local_params(out);
@@ -1037,6 +1109,7 @@ void make_user_commands() {
     new UserCommand("A", "Alarms/List", listAlarms, anyState);
     new UserCommand("E", "Errors/List", listErrors, anyState);
     new UserCommand("C", "GCode/Check", toggle_check_mode, anyState);
+    new UserCommand("GB", "GCode/Binary", setBinaryGCode, anyState);
     new UserCommand("X", "Alarm/Disable", disable_alarm_lock, anyState);
     new UserCommand("NVX", "Settings/Erase", Setting::eraseNVS, notIdleOrAlarm, WA);
     new UserCommand("V", "Settings/Stats", Setting::report_nvs_stats, notIdleOrAlarm);
@@ -1075,6 +1148,9 @@ void make_user_commands() {
 
     new UserCommand("SA", "Alarm/Send", sendAlarm, anyState);
     new UserCommand("Heap", "Heap/Show", showHeap, anyState);
+    new UserCommand("LQ", "LineQueue/Show", showLineQueue, anyState);
+    new UserCommand("SM", "Stats/Motion", showMotionStats, anyState);
+    new UserCommand("SO", "Stats/Output", showOutputStats, anyState);
     new UserCommand("SS", "Startup/Show", showStartupLog, anyState);
     new UserCommand("BS", "Backtrace/Show", showBacktrace, anyState);
 #ifdef CRASH_TEST
@@ -1083,6 +1159,7 @@ void make_user_commands() {
     new UserCommand("UP", "Uart/Passthrough", uartPassthrough, notIdleOrAlarm);
 
     new UserCommand("RI", "Report/Interval", setReportInterval, anyState);
+    new UserCommand("RB", "Report/Binary", setBinaryReportInterval, anyState);
 
     new UserCommand("13", "Report/Inches", switchInchMM, notIdleOrAlarm);
 
@@ -1128,6 +1205,9 @@ Error do_command_or_setting(std::string_view key, std::string_view value, Authen
 
         if (rts.isHandled_) {
             if (!value.empty()) {
+                // The change can create or delete sections
+                Configuration::ItemIndex::invalidate();
+
                 // Validate only if something changed, not for display
                 try {
                     Configuration::Validator validator;
@@ -1228,7 +1308,7 @@ Error settings_execute_line(const char* line, Channel& out, AuthenticationLevel
     return do_command_or_setting(key, value, auth_level, out);
 }
 
-Error execute_line(const char* line, Channel& channel, AuthenticationLevel auth_level) {
+Error execute_line(const char* line, Channel& channel, AuthenticationLevel auth_level, const CompiledLine* compiled) {
     // Empty or comment line. For syncing purposes.
     if (line[0] == 0) {
         return Error::Ok;
@@ -1249,9 +1329,13 @@ Error execute_line(const char* line, Channel& channel, AuthenticationLevel auth_
     if (state_is(State::Alarm) || state_is(State::ConfigAlarm) || state_is(State::Jog)) {
         return Error::SystemGcLock;
     }
-    Error result = gc_execute_line(line);
+    Error result = compiled ? gc_execute_compiled(*compiled) : gc_execute_line(line);
     if (result != Error::Ok && result != Error::Reset) {
-        log_error_to(channel, "Bad GCode: " << line);
+        if (GCodeBinary::is_binary(line)) {
+            log_error_to(channel, "Bad binary GCode line");
+        } else {
+            log_error_to(channel, "Bad GCode: " << line);
+        }
         if (Job::active()) {
             send_alarm(ExecAlarm::GCodeError);
         }
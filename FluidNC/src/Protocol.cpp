@@ -22,6 +22,10 @@
 #include "Job.h"
 #include "Driver/restart.h"
 #include "Driver/watchdog.h"
+#include "SPSCQueue.h"
+#include "GCodeBinary.h"
+
+#include <atomic>
 
 volatile ExecAlarm lastAlarm;  // The most recent alarm code
 
@@ -100,6 +104,26 @@ void drain_messages() {
     }
 }
 
+// Sends a message with its newline in a single write.  Pooled buffers have
+// room to append the newline in place; other messages are short enough to
+// copy, or are sent in two pieces as before.
+static void send_message(Channel* channel, MsgLevel level, char* line, bool appendable) {
+    size_t length = strlen(line);
+    if (appendable) {
+        line[length] = '\n';
+        channel->print_line(level, line, length + 1);
+        return;
+    }
+    char copy[100];
+    if (length < sizeof(copy)) {
+        memcpy(copy, line, length);
+        copy[length] = '\n';
+        channel->print_line(level, copy, length + 1);
+        return;
+    }
+    channel->print_msg(level, line);
+}
+
 void output_loop(void* unused) {
     while (true) {
         if (should_exit()) {
@@ -108,32 +132,159 @@ void output_loop(void* unused) {
         // Block until a message is received
         LogMessage message;
         if (xQueueReceive(message_queue, &message, 100)) {  // Use timeout to check exit flag
-            if (!message.channel->is_closing()) {
-                if (message.isString) {
+            bool send = !message.channel->is_closing();
+            switch (message.storage) {
+                case LineStorage::Static:
+                    if (send) {
+                        send_message(message.channel, message.level, static_cast<char*>(message.line), false);
+                    }
+                    break;
+                case LineStorage::Heap: {
                     std::string* s = static_cast<std::string*>(message.line);
-                    message.channel->print_msg(message.level, s->c_str());
+                    if (send) {
+                        *s += '\n';
+                        message.channel->print_line(message.level, s->c_str(), s->length());
+                    }
                     delete s;
-                } else {
-                    const char* cp = static_cast<const char*>(message.line);
-                    message.channel->print_msg(message.level, cp);
-                }
-            } else if (message.isString) {
-                delete static_cast<std::string*>(message.line);
+                } break;
+                case LineStorage::Pooled: {
+                    char* cp = static_cast<char*>(message.line);
+                    if (send) {
+                        send_message(message.channel, message.level, cp, true);
+                    }
+                    message_buffer_release(cp);
+                } break;
+                case LineStorage::Frame: {
+                    auto frame = static_cast<uint8_t*>(message.line);
+                    if (send) {
+                        message.channel->print_frame(frame, Telemetry::frame_length(frame));
+                    }
+                    message_buffer_release(reinterpret_cast<char*>(frame));
+                } break;
             }
             message.channel->release_log_ref();
         }
     }
 }
 
-Channel* activeChannel = nullptr;  // Channel associated with the input line
+// Input lines travel from the polling task to the protocol task through
+// lineQueue.  The polling task can read several lines ahead, so the protocol
+// loop can execute a burst of short motion lines without waiting for a
+// scheduler tick between them.  Each line is tagged with the channel it came
+// from and the authentication level under which it is to be executed.
+struct QueuedLine {
+    Channel*            channel;
+    AuthenticationLevel auth_level;
+    bool                from_job;     // The line came from the job channel atop the job stack
+    size_t              line_number;  // The channel's line number after reading the line
+    CachedLine*         cached;       // Set if the line is in a job's loop cache
+    char                line[Channel::maxLine];
+};
 
-TaskHandle_t pollingTask = nullptr;
+static SPSCQueue<QueuedLine, LINE_QUEUE_DEPTH> lineQueue;
+
+static char activeLine[Channel::maxLine];  // The line that the protocol task is executing
+
+// lineExecuting is true while the protocol task is executing a line that it
+// has already removed from lineQueue.  Together with lineQueue.empty(), it
+// tells the polling task that every line it has handed over has been finished.
+static std::atomic<bool> lineExecuting { false };
+
+static bool lines_drained() {
+    return lineQueue.empty() && !lineExecuting.load(std::memory_order_acquire);
+}
+
+bool lines_queued_behind() {
+    return !lineQueue.empty();
+}
 
-char activeLine[Channel::maxLine];
+// Some lines can change where the next line must come from, or whether it
+// should be read at all - flow control, job and macro nesting via $ and M
+// commands, % file delimiters, and [ESP] commands.  The polling task must not
+// read past such a line until it has been executed.  The test errs on the side
+// of caution, since a false positive only costs a little read-ahead.
+static bool blocks_read_ahead(const char* line) {
+    if (GCodeBinary::is_binary(line)) {
+        // The words of a binary line are codes, not letters, so they must be
+        // decoded to find M and O words.  The text that follows them is checked
+        // below like any other line.
+        CompiledWord words[GCodeBinary::max_words];
+        size_t       n_words;
+        if (GCodeBinary::decode(line, words, n_words, line) != Error::Ok) {
+            return true;  // The error is reported when the line is executed
+        }
+        for (size_t i = 0; i < n_words; i++) {
+            if (words[i].letter == 'M' || words[i].letter == 'O') {
+                return true;
+            }
+        }
+    }
+    while (*line == ' ' || *line == '\t') {
+        ++line;
+    }
+    if (*line == '$' || *line == '[' || *line == '%') {
+        return true;
+    }
+    bool in_comment = false;
+    for (char c; (c = *line) != '\0'; ++line) {
+        if (in_comment) {
+            in_comment = c != ')';
+            continue;
+        }
+        switch (c) {
+            case '(':
+                in_comment = true;
+                break;
+            case ';':
+                return false;
+            case 'M':
+            case 'm':
+            case 'O':
+            case 'o':
+                return true;
+        }
+    }
+    return false;
+}
+
+// Discards lines that have been read but not yet executed, as after a reset
+// when nothing that was already sent should be processed.  This runs on the
+// protocol task, which is the consumer side of lineQueue.
+static void discard_queued_lines() {
+    QueuedLine* queued;
+    while ((queued = lineQueue.front()) != nullptr) {
+        if (!queued->from_job) {
+            queued->channel->release_processing_ref();
+        }
+        lineQueue.pop();
+    }
+}
+
+void report_line_queue(Channel& out) {
+    log_stream(out,
+               "Line queue: " << lineQueue.size() << "/" << lineQueue.capacity() << " High water: " << lineQueue.high_water()
+                              << " Full: " << lineQueue.full_count());
+}
+
+void reset_line_queue_stats() {
+    lineQueue.reset_stats();
+}
+
+TaskHandle_t pollingTask = nullptr;
 
 bool pollingPaused = false;
 void polling_loop(void* unused) {
     add_watchdog_to_task();
+
+    // If readAheadBlocked is true, the most recently queued line must
+    // be executed before another line is read.
+    bool readAheadBlocked = false;
+
+    // A job end or job error that was seen while lines from the job were still
+    // queued.  The job cannot be unnested until those lines have been executed.
+    Error    deferredJobStatus  = Error::Ok;
+    Channel* deferredJobChannel = nullptr;
+
     for (;;) {
         if (should_exit()) {
             break;
@@ -157,55 +308,80 @@ void polling_loop(void* unused) {
             feed_watchdog();
         }
 
-        // If activeChannel is non-null, it means that we have received a line
-        // but the task running protocol_main_loop() has not yet picked it up.
-        // activeChannel is thus a form of flow control between the protocol
-        // task that processes GCode lines and other events and this task that
-        // handles IO from channels.
-        if (!activeChannel) {
+        if (readAheadBlocked || deferredJobChannel) {
+            if (!lines_drained()) {
+                continue;
+            }
+            readAheadBlocked = false;
+        }
+
+        if (deferredJobChannel) {
+            if (deferredJobStatus == Error::Eof) {
+                notifyf("Job done", "%s job sent", deferredJobChannel->name());
+                log_debug(deferredJobChannel->name() << " job sent");
+                Job::unnest();
+            } else {
+                if (Job::leader) {
+                    log_error_to(*Job::leader,
+                                 static_cast<int>(deferredJobStatus) << " (" << errorString(deferredJobStatus) << ") in "
+                                                                     << deferredJobChannel->name() << " at line "
+                                                                     << deferredJobChannel->execLineNumber());
+                }
+                Job::abort();
+            }
+            deferredJobChannel = nullptr;
+            continue;
+        }
+
+        // Fill the queue with as many lines as are ready.  The queue is thus a
+        // form of flow control between the protocol task that processes GCode
+        // lines and other events and this task that handles IO from channels.
+        QueuedLine* slot;
+        while (!readAheadBlocked && (slot = lineQueue.slot()) != nullptr) {
+            Channel* channel = nullptr;
             // Job channels have priority
             if (!Job::active()) {
                 unwind_cause = nullptr;
                 // No job channel is active, so poll all of the serial-style
                 // channels to see if one has a line ready.
-                activeChannel = pollChannels(activeLine);
-            } else {
-                if (state_is(State::Alarm) || state_is(State::ConfigAlarm) || state_is(State::Critical)) {
-                    log_debug("Unwinding from Alarm");
-                    Job::abort();
-                    unwind_cause = nullptr;
-                    continue;
+                channel = pollChannels(slot->line);
+                if (!channel) {
+                    break;
                 }
-                if (unwind_cause) {
-                    Job::abort();
-                    unwind_cause = nullptr;
-                    continue;
+                slot->from_job = false;
+                slot->cached   = nullptr;
+            } else {
+                if (state_is(State::Alarm) || state_is(State::ConfigAlarm) || state_is(State::Critical) || unwind_cause) {
+                    // The protocol task discards any queued job lines in these
+                    // states, so the job can be aborted once they are gone.
+                    if (lines_drained()) {
+                        if (!unwind_cause) {
+                            log_debug("Unwinding from Alarm");
+                        }
+                        Job::abort();
+                        unwind_cause = nullptr;
+                    }
+                    break;
                 }
                 // A job channel is active, so accept line-oriented input only
                 // from the job channel on top of the job stack.
-                auto channel = Job::channel();
-                auto status  = channel->pollLine(activeLine);
-                switch (status) {
-                    case Error::Ok:
-                        activeChannel = channel;
-                        break;
-                    case Error::NoData:
-                        break;
-                    case Error::Eof:
-                        notifyf("Job done", "%s job sent", channel->name());
-                        log_debug(channel->name() << " job sent");
-                        Job::unnest();
-                        break;
-                    default:
-                        if (Job::leader) {
-                            log_error_to(*Job::leader,
-                                         static_cast<int>(status) << " (" << errorString(status) << ") in " << channel->name()
-                                                                  << " at line " << channel->lineNumber());
-                        }
-                        Job::abort();
-                        break;
+                channel     = Job::channel();
+                auto status = Job::source()->pollLine(slot->line, slot->cached);
+                if (status == Error::NoData) {
+                    break;
                 }
+                if (status != Error::Ok) {
+                    deferredJobStatus  = status;
+                    deferredJobChannel = channel;
+                    break;
+                }
+                slot->from_job = true;
             }
+            slot->channel     = channel;
+            slot->auth_level  = AuthenticationLevel::LEVEL_GUEST;
+            slot->line_number = channel->lineNumber();
+            readAheadBlocked  = blocks_read_ahead(slot->line);
+            lineQueue.commit();
         }
     }
 }
@@ -264,32 +440,57 @@ void protocol_main_loop() {
         if (should_exit()) {
             break;
         }
-        if (activeChannel) {
-            if (activeChannel->is_closing()) {
-                activeChannel->release_processing_ref();
-                activeChannel = nullptr;
+        // Execute all of the lines that the input polling task has collected
+        QueuedLine* queued;
+        while ((queued = lineQueue.front()) != nullptr) {
+            // Copy the line out so its slot can be refilled while it executes, and
+            // so that a reset that discards the queue cannot pull it out from under us
+            lineExecuting.store(true, std::memory_order_release);
+            Channel*            channel    = queued->channel;
+            AuthenticationLevel auth_level = queued->auth_level;
+            bool                from_job   = queued->from_job;
+            CachedLine*         cached     = queued->cached;
+            channel->_exec_line_number     = queued->line_number;
+            strcpy(activeLine, queued->line);
+            lineQueue.pop();
+
+            if (from_job) {
+                // Lines that were read ahead from a job that has since failed,
+                // or that must be unwound, are dropped without being executed.
+                if (state_is(State::Alarm) || state_is(State::ConfigAlarm) || state_is(State::Critical) || unwind_cause ||
+                    channel->pendingError() != Error::Ok) {
+                    lineExecuting.store(false, std::memory_order_release);
+                    continue;
+                }
+            } else if (channel->is_closing()) {
+                channel->release_processing_ref();
+                lineExecuting.store(false, std::memory_order_release);
                 continue;
             }
 
-            // The input polling task has collected a line of input
             if (gcode_echo->get()) {
                 report_echo_line_received(activeLine, allChannels);
             }
 
-            Channel* out_channel = Job::leader ? Job::leader : activeChannel;
+            Channel* out_channel = Job::leader ? Job::leader : channel;
 
-            Error status_code = execute_line(activeLine, *out_channel, AuthenticationLevel::LEVEL_GUEST);
+            Error status_code = execute_line(activeLine, *out_channel, auth_level, cached ? cached->compile() : nullptr);
 
             // Tell the channel that the line has been processed.
             // If the line was aborted, the channel could be invalid
             if (!sys.abort()) {
-                activeChannel->ack(status_code);
+                channel->ack(status_code);
             }
 
             // Tell the input polling task that the line has been processed,
             // so it can give us another one when available
-            activeChannel->release_processing_ref();
-            activeChannel = nullptr;
+            channel->release_processing_ref();
+            lineExecuting.store(false, std::memory_order_release);
+
+            if (sys.abort()) {
+                break;
+            }
+            protocol_execute_realtime();
         }
 
         // Auto-cycle start any queued moves.
@@ -401,7 +602,8 @@ static void protocol_do_soft_restart() {
     // Reset primary systems.
     system_reset();
     protocol_reset();
-    gc_init();  // Set g-code parser to default state
+    discard_queued_lines();  // Before gc_init(), so no line refers to a loop that it forgets
+    gc_init();               // Set g-code parser to default state
     // Spindle should be set either by the configuration
     // or by the post-configuration fixup, but we test
     // it anyway just for safety.  We want to avoid any
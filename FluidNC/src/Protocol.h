@@ -115,4 +115,14 @@ void protocol_send_event_from_ISR(const Event* evt, void* arg = 0);
 
 void drain_messages();
 
+// True if the polling task has queued lines behind the one that the protocol
+// task is executing, which cannot happen while a line that blocks read-ahead,
+// like an O-word line, is executing
+bool lines_queued_behind();
+
+// Reports the occupancy of the queue of input lines awaiting execution
+class Channel;
+void report_line_queue(Channel& out);
+void reset_line_queue_stats();
+
 extern uint32_t heapLowWater;
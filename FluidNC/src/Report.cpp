@@ -29,9 +29,12 @@
 
 #include <map>
 #include <freertos/task.h>
+#include <freertos/semphr.h>
 #include <cstring>
 #include <cstdio>
 #include <cstdarg>
+#include <cmath>
+#include <algorithm>
 
 volatile bool protocol_pin_changed = false;
 
@@ -302,6 +305,25 @@ void report_gcode_modes(Channel& channel) {
             break;
     }
 
+    // G61 is the default, and is not reported, for compatibility with senders that expect the Grbl modes.
+    switch (gc_state.modal.control) {
+        case ControlMode::ExactPath:
+            break;
+        case ControlMode::ExactStop:
+            msg += " G61.1";
+            break;
+        case ControlMode::Continuous:
+            msg += " G64";
+            if (gc_state.path_tolerance > 0.0f) {
+                if (config->_reportInches) {
+                    msg += " P" + formatFloat(gc_state.path_tolerance / MM_PER_INCH, 4);
+                } else {
+                    msg += " P" + formatFloat(gc_state.path_tolerance, 3);
+                }
+            }
+            break;
+    }
+
     //report_util_gcode_modes_M();
     switch (gc_state.modal.program_flow) {
         case ProgramFlow::Running:
@@ -488,30 +510,226 @@ void report_recompute_pin_string() {
 // Define this to do something if a debug request comes in over serial
 void report_realtime_debug() {}
 
-// Prints real-time data. This function grabs a real-time snapshot of the stepper subprogram
-// and the actual location of the CNC machine. Users may change the following function to their
-// specific needs, but the desired real-time data report must be as short as possible. This is
-// requires as it minimizes the computational overhead to keep running smoothly,
-// especially during g-code programs with fast, short line segments and high frequency reports (5-20Hz).
-void report_realtime_status(Channel& channel) {
-    LogStream msg(channel, "<");
-    msg << state_name();
+// The realtime status report is formatted into a fixed buffer without heap
+// allocation or stream formatting, since senders request it 5-20 times a second
+// and automatic reports go to every channel.
+class ReportBuffer {
+    char* _p;
+    char* _end;
+
+public:
+    ReportBuffer(char* buffer, size_t size) : _p(buffer), _end(buffer + size) {}
+
+    char* position() const { return _p; }
+
+    void put(char c) {
+        if (_p < _end) {
+            *_p++ = c;
+        }
+    }
+    void put(const char* s, size_t length) {
+        length = std::min(length, size_t(_end - _p));
+        memcpy(_p, s, length);
+        _p += length;
+    }
+    void put(const char* s) { put(s, strlen(s)); }
+    void put(const std::string& s) { put(s.c_str(), s.length()); }
+
+    void put(uint64_t value) {
+        char digits[20];
+        int  n = 0;
+        do {
+            digits[n++] = '0' + value % 10;
+            value /= 10;
+        } while (value);
+        while (n) {
+            put(digits[--n]);
+        }
+    }
+
+    // Same as printf("%.*f"), including rounding exact ties to even and the
+    // sign of negative values that round to zero.  Scaling a float by a power
+    // of ten up to 10^4 is exact in a double, so the tie test is exact too.
+    void put_fixed(float value, int decimals) {
+        static const uint32_t scale[] = { 1, 10, 100, 1000, 10000 };
+        if (!std::isfinite(value) || fabsf(value) >= 1e9f || decimals < 0 || decimals > 4) {
+            char text[32];
+            put(text, std::min(size_t(snprintf(text, sizeof(text), "%.*f", decimals, value)), sizeof(text) - 1));
+            return;
+        }
+        if (std::signbit(value)) {
+            put('-');
+        }
+        double   scaled = fabs(double(value)) * scale[decimals];
+        uint64_t fixed  = uint64_t(scaled);
+        double   rest   = scaled - double(fixed);
+        if (rest > 0.5 || (rest == 0.5 && (fixed & 1))) {
+            ++fixed;
+        }
+        put(fixed / scale[decimals]);
+        if (decimals) {
+            put('.');
+            uint32_t fraction = fixed % scale[decimals];
+            for (uint32_t digit = scale[decimals] / 10; digit; digit /= 10) {
+                put(char('0' + (fraction / digit) % 10));
+            }
+        }
+    }
+
+    // Same as Print::print(value, 0), which rounds halves up
+    void put_rounded(float value) {
+        if (!std::isfinite(value) || fabsf(value) > 4294967040.0f) {
+            put(std::isnan(value) ? "nan" : std::isinf(value) ? "inf" : "ovf");
+            return;
+        }
+        if (value < 0.0f) {
+            put('-');
+            value = -value;
+        }
+        put(uint64_t(uint32_t(double(value) + 0.5)));
+    }
+
+    void put_axis_values(const float* axis_value) {
+        auto n_axis = Axes::_numberAxis;
+        for (axis_t axis = X_AXIS; axis < n_axis; axis++) {
+            float value = axis_value[axis];
+            int   decimals;
+            if (is_linear(axis) && config->_reportInches) {
+                value /= MM_PER_INCH;
+                decimals = 4;
+            } else {
+                decimals = 3;  // As in report_util_axis_values()
+            }
+            put_fixed(value, decimals);
+            if (axis < (n_axis - 1)) {
+                put(',');
+            }
+        }
+    }
+};
+
+// The text of the WCO and Ov fields changes rarely, so it is kept from one
+// report to the next and only formatted again when its inputs change.
+// Status reports are formatted in whichever task polls a channel, so the
+// caches are shared under report_cache_mutex.
+static SemaphoreHandle_t report_cache_mutex = xSemaphoreCreateMutex();
+
+struct WcoCache {
+    float  wco[MAX_N_AXIS];
+    axis_t n_axis;
+    bool   inches;
+    char   text[MAX_N_AXIS * 16];
+    size_t length;
+};
+static WcoCache wco_cache = {};
+
+struct OvCache {
+    Percent      feed, rapid, spindle;
+    SpindleState sp_state;
+    CoolantState coolant;
+    bool         valid;
+    char         text[32];
+    size_t       length;
+};
+static OvCache ov_cache = {};
+
+static void put_wco(ReportBuffer& msg, const float* wco) {
+    auto n_axis = Axes::_numberAxis;
+    bool inches = config->_reportInches;
+    xSemaphoreTake(report_cache_mutex, portMAX_DELAY);
+    if (wco_cache.length == 0 || wco_cache.n_axis != n_axis || wco_cache.inches != inches ||
+        memcmp(wco_cache.wco, wco, n_axis * sizeof(float))) {
+        ReportBuffer text(wco_cache.text, sizeof(wco_cache.text));
+        text.put_axis_values(wco);
+        wco_cache.length = text.position() - wco_cache.text;
+        memcpy(wco_cache.wco, wco, n_axis * sizeof(float));
+        wco_cache.n_axis = n_axis;
+        wco_cache.inches = inches;
+    }
+    msg.put(wco_cache.text, wco_cache.length);
+    xSemaphoreGive(report_cache_mutex);
+}
+
+static void put_overrides(ReportBuffer& msg) {
+    Percent      feed = sys.f_override(), rapid = sys.r_override(), spindle_ovr = sys.spindle_speed_ovr();
+    SpindleState sp_state      = spindle->get_state();
+    CoolantState coolant_state = config->_coolant->get_state();
+    xSemaphoreTake(report_cache_mutex, portMAX_DELAY);
+    if (!ov_cache.valid || ov_cache.feed != feed || ov_cache.rapid != rapid || ov_cache.spindle != spindle_ovr ||
+        ov_cache.sp_state != sp_state || ov_cache.coolant.Mist != coolant_state.Mist || ov_cache.coolant.Flood != coolant_state.Flood) {
+        ReportBuffer text(ov_cache.text, sizeof(ov_cache.text));
+        text.put("|Ov:");
+        text.put(uint64_t(feed));
+        text.put(',');
+        text.put(uint64_t(rapid));
+        text.put(',');
+        text.put(uint64_t(spindle_ovr));
+        if (sp_state != SpindleState::Disable || coolant_state.Mist || coolant_state.Flood) {
+            text.put("|A:");
+            switch (sp_state) {
+                case SpindleState::Disable:
+                    break;
+                case SpindleState::Cw:
+                    text.put('S');
+                    break;
+                case SpindleState::Ccw:
+                    text.put('C');
+                    break;
+                case SpindleState::Unknown:
+                    break;
+            }
+            if (coolant_state.Flood) {
+                text.put('F');
+            }
+            if (coolant_state.Mist) {
+                text.put('M');
+            }
+        }
+        ov_cache.length   = text.position() - ov_cache.text;
+        ov_cache.feed     = feed;
+        ov_cache.rapid    = rapid;
+        ov_cache.spindle  = spindle_ovr;
+        ov_cache.sp_state = sp_state;
+        ov_cache.coolant  = coolant_state;
+        ov_cache.valid    = true;
+    }
+    msg.put(ov_cache.text, ov_cache.length);
+    xSemaphoreGive(report_cache_mutex);
+}
+
+size_t format_realtime_status(Channel& channel, char* buffer, size_t size) {
+    ReportBuffer msg(buffer, size);
+    msg.put('<');
+    msg.put(state_name());
 
     // Report position
 
     float* print_position = state_is(State::Homing) ? get_motor_pos() : get_mpos();
+    float* wco            = nullptr;
     if (bits_are_true(status_mask->get(), RtStatus::Position)) {
-        msg << "|MPos:";
+        msg.put("|MPos:");
     } else {
-        msg << "|WPos:";
-        mpos_to_wpos(print_position);
+        msg.put("|WPos:");
+        wco         = get_wco();
+        auto n_axis = Axes::_numberAxis;
+        for (axis_t axis = X_AXIS; axis < n_axis; axis++) {
+            print_position[axis] -= wco[axis];
+        }
     }
-    msg << report_util_axis_values(print_position).c_str();
+    msg.put_axis_values(print_position);
 
     // Returns planner and serial read buffer states.
 
     if (bits_are_true(status_mask->get(), RtStatus::Buffer)) {
-        msg << "|Bf:" << plan_get_block_buffer_available() << "," << channel.rx_buffer_available();
+        msg.put("|Bf:");
+        msg.put(uint64_t(plan_get_block_buffer_available()));
+        msg.put(',');
+        int available = channel.rx_buffer_available();
+        if (available < 0) {
+            msg.put('-');
+            available = -available;
+        }
+        msg.put(uint64_t(available));
     }
 
     if (config->_useLineNumbers) {
@@ -520,7 +738,8 @@ void report_realtime_status(Channel& channel) {
         if (cur_block != NULL) {
             uint32_t ln = cur_block->line_number;
             if (ln > 0) {
-                msg << "|Ln:" << ln;
+                msg.put("|Ln:");
+                msg.put(uint64_t(ln));
             }
         }
     }
@@ -530,10 +749,14 @@ void report_realtime_status(Channel& channel) {
     if (config->_reportInches) {
         rate /= MM_PER_INCH;
     }
-    msg << "|FS:" << setprecision(0) << rate << "," << sys.spindle_speed();
+    msg.put("|FS:");
+    msg.put_rounded(rate);
+    msg.put(',');
+    msg.put(uint64_t(sys.spindle_speed()));
 
     if (report_pin_string.length()) {
-        msg << "|Pn:" << report_pin_string;
+        msg.put("|Pn:");
+        msg.put(report_pin_string);
     }
 
     if (report_wco_counter > 0) {
@@ -554,7 +777,8 @@ void report_realtime_status(Channel& channel) {
         if (report_ovr_counter == 0) {
             report_ovr_counter = 1;  // Set override on next report.
         }
-        msg << "|WCO:" << report_util_axis_values(get_wco()).c_str();
+        msg.put("|WCO:");
+        put_wco(msg, wco ? wco : get_wco());
     }
 
     if (report_ovr_counter > 0) {
@@ -572,45 +796,63 @@ void report_realtime_status(Channel& channel) {
                 report_ovr_counter = (REPORT_OVR_REFRESH_IDLE_COUNT - 1);
                 break;
         }
-
-        msg << "|Ov:" << int(sys.f_override()) << "," << int(sys.r_override()) << "," << int(sys.spindle_speed_ovr());
-        SpindleState sp_state      = spindle->get_state();
-        CoolantState coolant_state = config->_coolant->get_state();
-        if (sp_state != SpindleState::Disable || coolant_state.Mist || coolant_state.Flood) {
-            msg << "|A:";
-            switch (sp_state) {
-                case SpindleState::Disable:
-                    break;
-                case SpindleState::Cw:
-                    msg << "S";
-                    break;
-                case SpindleState::Ccw:
-                    msg << "C";
-                    break;
-                case SpindleState::Unknown:
-                    break;
-            }
-
-            auto coolant = coolant_state;
-            if (coolant.Flood) {
-                msg << "F";
-            }
-            if (coolant.Mist) {
-                msg << "M";
-            }
-        }
+        put_overrides(msg);
     }
     if (Job::active()) {
-        msg << "|" << Job::channel()->_progress;
+        msg.put('|');
+        msg.put(Job::channel()->_progress);
     }
 #ifdef DEBUG_STEPPER_ISR
-    msg << "|ISRs:" << Stepper::isr_count;
+    msg.put("|ISRs:");
+    msg.put(uint64_t(Stepper::isr_count));
 #endif
 #ifdef DEBUG_REPORT_HEAP
-    msg << "|Heap:" << xPortGetFreeHeapSize();
+    msg.put("|Heap:");
+    msg.put(uint64_t(xPortGetFreeHeapSize()));
 #endif
-    msg << ">";
-    // The destructor sends the line when msg goes out of scope
+    msg.put('>');
+    return msg.position() - buffer;
+}
+
+// Prints real-time data. This function grabs a real-time snapshot of the stepper subprogram
+// and the actual location of the CNC machine. Users may change format_realtime_status() to their
+// specific needs, but the desired real-time data report must be as short as possible. This is
+// requires as it minimizes the computational overhead to keep running smoothly,
+// especially during g-code programs with fast, short line segments and high frequency reports (5-20Hz).
+void report_realtime_status(Channel& channel) {
+    char report[400];
+    channel.sendLine(MsgLevelNone, report, format_realtime_status(channel, report, sizeof(report)));
+}
+
+// Telemetry carries the same data as the text status report, in fixed units:
+// positions in micrometers, feed rate in mm/min, and counts instead of the
+// available space.  Unlike the text report, the offsets are sampled every time.
+static int32_t micrometers(float mm) {
+    return int32_t(std::lround(mm * 1000.0f));
+}
+
+void sample_telemetry(Telemetry::Sample& sample) {
+    auto& v = sample.value;
+
+    plan_block_t* cur_block = plan_get_current_block();
+
+    v[Telemetry::StateField]      = int32_t(sys.state());
+    v[Telemetry::LineNumber]      = cur_block ? int32_t(cur_block->line_number) : 0;
+    v[Telemetry::FeedRate]        = int32_t(std::lround(Stepper::get_realtime_rate()));
+    v[Telemetry::SpindleSpeed]    = int32_t(sys.spindle_speed());
+    v[Telemetry::FeedOverride]    = sys.f_override();
+    v[Telemetry::RapidOverride]   = sys.r_override();
+    v[Telemetry::SpindleOverride] = sys.spindle_speed_ovr();
+    v[Telemetry::PlannerBlocks]   = int32_t(config->_planner_blocks - 1) - int32_t(plan_get_block_buffer_available());
+    v[Telemetry::Segments]        = int32_t(Stepper::segments_queued());
+
+    float* mpos   = state_is(State::Homing) ? get_motor_pos() : get_mpos();
+    float* wco    = get_wco();
+    auto   n_axis = Axes::_numberAxis;
+    for (axis_t axis = X_AXIS; axis < n_axis && axis < 6; axis++) {
+        v[Telemetry::MachinePosition + axis] = micrometers(mpos[axis]);
+        v[Telemetry::WorkOffset + axis]      = micrometers(wco[axis]);
+    }
 }
 
 void hex_msg(uint8_t* buf, const char* prefix, size_t len) {
@@ -11,6 +11,7 @@
 #include "Error.h"
 #include "Config.h"
 #include "Serial.h"  // CLIENT_xxx
+#include "Telemetry.h"
 #include "PlatformCompat.h"  // FreeRTOS compatibility (xPortGetFreeHeapSize, etc.)
 
 #include <cstdint>
@@ -64,6 +65,13 @@ void report_echo_line_received(const char* line, Channel& channel);
 // Prints realtime status report
 void report_realtime_status(Channel& channel);
 
+// Formats the realtime status report into buffer and returns its length.
+// Longer reports are truncated.
+size_t format_realtime_status(Channel& channel, char* buffer, size_t size);
+
+// Collects the values for a binary telemetry frame
+void sample_telemetry(Telemetry::Sample& sample);
+
 // Prints recorded probe position
 void report_probe_parameters(Channel& channel);
 
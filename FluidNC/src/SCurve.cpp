@@ -0,0 +1,98 @@
+// Copyright (c) 2026 - FluidNC Contributors
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#include "SCurve.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace SCurve {
+    void plan(Ramp& ramp, float v0, float v1, float length, float max_accel, float max_jerk) {
+        ramp.v0       = v0;
+        ramp.v1       = v1;
+        ramp.length   = length;
+        ramp.tj       = 0.0f;
+        ramp.jerk     = 0.0f;
+        ramp.accel    = 0.0f;
+        ramp.duration = (v0 + v1) > 0.0f ? 2.0f * length / (v0 + v1) : 0.0f;
+
+        float T  = ramp.duration;
+        float dv = v1 - v0;
+        if (T <= 0.0f || dv == 0.0f) {
+            return;
+        }
+        ramp.accel = dv / T;  // Linear ramp, unless the S-curve is possible
+
+        if (max_jerk <= 0.0f) {
+            return;
+        }
+        // With jerk phases of duration tj at each end, the constant-acceleration
+        // phase reaches |dv| / (T - tj), so longer jerk phases need a higher
+        // peak.  Keeping the peak within max_accel limits tj to T - |dv| / max_accel.
+        float adv    = fabsf(dv);
+        float max_tj = std::min(T - adv / max_accel, T / 3.0f);
+        if (max_tj <= 0.0f) {
+            return;
+        }
+        // The jerk is the peak divided by tj.  Setting it to the limit gives
+        // tj * (T - tj) = |dv| / max_jerk, whose smaller solution is the least
+        // tj that keeps the jerk within the limit.  If there is no solution,
+        // even the longest jerk phases would exceed the limit.
+        float disc = T * T - 4.0f * adv / max_jerk;
+        float tj   = disc < 0.0f ? max_tj : std::min(0.5f * (T - sqrtf(disc)), max_tj);
+        if (tj <= 0.0f) {
+            return;
+        }
+        float peak = adv / (T - tj);
+        ramp.tj    = tj;
+        ramp.accel = dv > 0.0f ? peak : -peak;
+        ramp.jerk  = ramp.accel / tj;
+    }
+
+    float speed(const Ramp& ramp, float t) {
+        if (t <= 0.0f) {
+            return ramp.v0;
+        }
+        if (t >= ramp.duration) {
+            return ramp.v1;
+        }
+        float tj = ramp.tj;
+        if (tj == 0.0f) {
+            return ramp.v0 + ramp.accel * t;
+        }
+        if (t < tj) {
+            return ramp.v0 + 0.5f * ramp.jerk * t * t;
+        }
+        float u = ramp.duration - t;
+        if (u < tj) {
+            // The last jerk phase mirrors the first one
+            return ramp.v1 - 0.5f * ramp.jerk * u * u;
+        }
+        return ramp.v0 + 0.5f * ramp.jerk * tj * tj + ramp.accel * (t - tj);
+    }
+
+    float distance(const Ramp& ramp, float t) {
+        if (t <= 0.0f) {
+            return 0.0f;
+        }
+        if (t >= ramp.duration) {
+            return ramp.length;
+        }
+        float tj = ramp.tj;
+        if (tj == 0.0f) {
+            return t * (ramp.v0 + 0.5f * ramp.accel * t);
+        }
+        if (t < tj) {
+            return t * (ramp.v0 + ramp.jerk * t * t / 6.0f);
+        }
+        float u = ramp.duration - t;
+        if (u < tj) {
+            // Measure back from the end, where the profile mirrors the start
+            return ramp.length - u * (ramp.v1 - ramp.jerk * u * u / 6.0f);
+        }
+        float d1  = tj * (ramp.v0 + ramp.jerk * tj * tj / 6.0f);
+        float vj  = ramp.v0 + 0.5f * ramp.jerk * tj * tj;
+        float tau = t - tj;
+        return d1 + tau * (vj + 0.5f * ramp.accel * tau);
+    }
+}
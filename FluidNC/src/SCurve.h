@@ -0,0 +1,55 @@
+// Copyright (c) 2026 - FluidNC Contributors
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#pragma once
+
+// Jerk-limited velocity ramps for the segment generator.
+//
+// The planner computes a trapezoidal profile for each block, with ramps of
+// constant acceleration between the entry, cruise and exit speeds.  An S-curve
+// ramp replaces one of those linear ramps with three phases - jerk up, constant
+// acceleration, jerk down - so that the acceleration changes gradually.  With
+// the cruise phase, a full profile thus has seven phases.
+//
+// The ramp has the same duration as the linear ramp that it replaces, and its
+// velocity is symmetric about the middle of the ramp, so its average speed, and
+// hence its length, is also the same.  The planner's junction speeds and ramp
+// breakpoints therefore remain valid, and a block always ends at exactly the
+// position that the trapezoid would reach.
+//
+// The acceleration in the middle of an S-curve is higher than the average, so
+// the planner plans with accel_fraction of the acceleration limit when jerk
+// limiting is on.  The jerk phases then take at most a third of the ramp each,
+// which keeps the peak within the limit.  The jerk is within its limit unless
+// the ramp is too short for that, in which case the jerk phases take a third
+// of the ramp each, for the least jerk that the acceleration limit allows.
+//
+// Units are whatever the caller uses consistently; the segment generator uses
+// mm and minutes.
+
+namespace SCurve {
+    // The planner's ramps have this fraction of the acceleration limit as
+    // their average acceleration when jerk limiting is on
+    const float accel_fraction = 2.0f / 3.0f;
+
+    struct Ramp {
+        float v0;        // Speed at the start of the ramp
+        float v1;        // Speed at the end of the ramp
+        float length;    // Distance covered by the ramp
+        float duration;  // Time to traverse the ramp
+        float tj;        // Duration of each jerk phase; 0 for a linear ramp
+        float jerk;      // Signed rate of change of acceleration during the first jerk phase
+        float accel;     // Signed acceleration during the constant-acceleration phase
+    };
+
+    // Sets up a ramp that goes from v0 to v1 over length, keeping the
+    // acceleration within max_accel and limiting the jerk to max_jerk if
+    // possible.  max_jerk <= 0 gives a linear ramp, as does a ramp whose
+    // average acceleration is already max_accel.
+    void plan(Ramp& ramp, float v0, float v1, float length, float max_accel, float max_jerk);
+
+    // Speed and distance traveled at time t after the start of the ramp.
+    // t is clamped to the ramp duration.
+    float speed(const Ramp& ramp, float t);
+    float distance(const Ramp& ramp, float t);
+}
@@ -0,0 +1,161 @@
+// Copyright (c) 2026 - FluidNC Contributors
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#pragma once
+
+// SPSCQueue is a fixed-capacity ring buffer that is safe without locks
+// when exactly one task pushes and exactly one other task pops.
+//
+// The head and tail are free-running counters; only the producer writes
+// _head and only the consumer writes _tail, so each side needs only an
+// acquire load of the other side's counter to know how much it can use.
+// The capacity must be a power of two so the counters can wrap freely.
+//
+// The producer can fill a slot in place with slot() and commit(), and the
+// consumer can use an item in place with front() and pop(), which avoids
+// copying large items like input lines.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+template <typename T, size_t N>
+class SPSCQueue {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SPSCQueue capacity must be a power of two");
+
+    static constexpr size_t _mask = N - 1;
+
+    T                   _items[N];
+    std::atomic<size_t> _head { 0 };  // Written only by the producer
+    std::atomic<size_t> _tail { 0 };  // Written only by the consumer
+
+    // Statistics, maintained by the producer
+    size_t   _high_water = 0;
+    uint32_t _full_count = 0;
+    bool     _full       = false;  // The producer found no room and has not pushed since
+
+    void found_full() {
+        if (!_full) {
+            _full = true;
+            ++_full_count;
+        }
+    }
+
+    void committed(size_t head) {
+        size_t used = head - _tail.load(std::memory_order_acquire);
+        if (used > _high_water) {
+            _high_water = used;
+        }
+    }
+
+public:
+    static constexpr size_t capacity() { return N; }
+
+    // These can be called from either side, but the answer can be stale
+    // by the time the caller uses it if the other side is active.
+    size_t size() const { return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire); }
+    bool   empty() const { return size() == 0; }
+    size_t free_space() const { return N - size(); }
+
+    // Producer side
+
+    // slot() returns the next free slot, or nullptr if the queue is full.
+    // The slot does not become visible to the consumer until commit().
+    T* slot() {
+        size_t head = _head.load(std::memory_order_relaxed);
+        if (head - _tail.load(std::memory_order_acquire) == N) {
+            found_full();
+            return nullptr;
+        }
+        _full = false;
+        return &_items[head & _mask];
+    }
+
+    void commit() {
+        size_t head = _head.load(std::memory_order_relaxed) + 1;
+        _head.store(head, std::memory_order_release);
+        committed(head);
+    }
+
+    bool push(const T& item) {
+        T* p = slot();
+        if (!p) {
+            return false;
+        }
+        *p = item;
+        commit();
+        return true;
+    }
+
+    // Bulk push; returns the number of items that fit
+    size_t push(const T* items, size_t count) {
+        size_t head  = _head.load(std::memory_order_relaxed);
+        size_t space = N - (head - _tail.load(std::memory_order_acquire));
+        if (count > space) {
+            found_full();
+            count = space;
+        } else {
+            _full = false;
+        }
+        for (size_t i = 0; i < count; i++) {
+            _items[(head + i) & _mask] = items[i];
+        }
+        if (count) {
+            head += count;
+            _head.store(head, std::memory_order_release);
+            committed(head);
+        }
+        return count;
+    }
+
+    // Consumer side
+
+    // front() returns the oldest item, or nullptr if the queue is empty.
+    // The slot is not released to the producer until pop().
+    T* front() {
+        size_t tail = _tail.load(std::memory_order_relaxed);
+        if (_head.load(std::memory_order_acquire) == tail) {
+            return nullptr;
+        }
+        return &_items[tail & _mask];
+    }
+
+    void pop() { _tail.store(_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    bool pop(T& item) {
+        T* p = front();
+        if (!p) {
+            return false;
+        }
+        item = *p;
+        pop();
+        return true;
+    }
+
+    // Bulk pop; returns the number of items copied
+    size_t pop(T* items, size_t count) {
+        size_t tail      = _tail.load(std::memory_order_relaxed);
+        size_t available = _head.load(std::memory_order_acquire) - tail;
+        if (count > available) {
+            count = available;
+        }
+        for (size_t i = 0; i < count; i++) {
+            items[i] = _items[(tail + i) & _mask];
+        }
+        _tail.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    // clear() discards everything that is queued.  It is a consumer-side operation.
+    void clear() { _tail.store(_head.load(std::memory_order_acquire), std::memory_order_release); }
+
+    // high_water() is the largest number of items that have been queued at once,
+    // and full_count() is the number of times that the queue filled up so that
+    // the producer found no room.  Retrying while it stays full is not counted.
+    size_t   high_water() const { return _high_water; }
+    uint32_t full_count() const { return _full_count; }
+    void     reset_stats() {
+        _high_water = size();
+        _full_count = 0;
+    }
+};
@@ -59,6 +59,7 @@
 
 SemaphoreHandle_t AllChannels::_mutex_general = xSemaphoreCreateMutex();
 SemaphoreHandle_t AllChannels::_mutex_pollLine = xSemaphoreCreateMutex();
+SemaphoreHandle_t AllChannels::_mutex_write    = xSemaphoreCreateMutex();
 
 std::vector<Channel*> AllChannels::snapshot_channels() {
     std::vector<Channel*> channels;
@@ -158,12 +159,7 @@ void AllChannels::flushRx() {
 }
 
 size_t AllChannels::write(uint8_t data) {
-    auto channels = snapshot_channels();
-    for (auto channel : channels) {
-        channel->write(data);
-        channel->release_processing_ref();
-    }
-    return 1;
+    return write(&data, 1);
 }
 void AllChannels::notifyState(void) {
     auto channels = snapshot_channels();
@@ -196,14 +192,59 @@ void AllChannels::notifyNgc(CoordIndex coord) {
     }
 }
 
-size_t AllChannels::write(const uint8_t* buffer, size_t length) {
+void AllChannels::broadcast(const uint8_t* line, size_t length) {
     auto channels = snapshot_channels();
     for (auto channel : channels) {
-        channel->write(buffer, length);
+        channel->write(line, length);
         channel->release_processing_ref();
     }
-    return length;
 }
+
+// Direct writes are broadcast a line at a time, so the channel list is
+// captured once per line instead of once per character, and each channel
+// gets the whole line in one write.
+size_t AllChannels::write(const uint8_t* buffer, size_t length) {
+    size_t written = length;
+    xSemaphoreTake(_mutex_write, portMAX_DELAY);
+    while (length) {
+        auto newline = static_cast<const uint8_t*>(memchr(buffer, '\n', length));
+        if (!newline) {
+            if (_partial.empty()) {
+                _partial_ms = get_ms();
+            }
+            _partial.append(reinterpret_cast<const char*>(buffer), length);
+            break;
+        }
+        size_t len = newline - buffer + 1;
+        if (_partial.empty()) {
+            broadcast(buffer, len);
+        } else {
+            _partial.append(reinterpret_cast<const char*>(buffer), len);
+            broadcast(reinterpret_cast<const uint8_t*>(_partial.c_str()), _partial.length());
+            _partial.clear();
+        }
+        buffer += len;
+        length -= len;
+    }
+    xSemaphoreGive(_mutex_write);
+    return written;
+}
+
+// Text that is written without a newline, like a prompt, is broadcast once it
+// has waited partial_timeout_ms for the rest of its line.
+static const uint32_t partial_timeout_ms = 50;
+
+void AllChannels::flush_partial() {
+    xSemaphoreTake(_mutex_write, portMAX_DELAY);
+    if (!_partial.empty() && get_ms() - _partial_ms >= partial_timeout_ms) {
+        broadcast(reinterpret_cast<const uint8_t*>(_partial.c_str()), _partial.length());
+        _partial.clear();
+    }
+    xSemaphoreGive(_mutex_write);
+}
+
+// The output task delivers a broadcast message to every channel from the one
+// buffer, so the message is neither formatted nor copied per channel.
 void AllChannels::print_msg(MsgLevel level, const char* msg) {
     auto channels = snapshot_channels();
     for (auto channel : channels) {
@@ -212,6 +253,14 @@ void AllChannels::print_msg(MsgLevel level, const char* msg) {
     }
 }
 
+void AllChannels::print_line(MsgLevel level, const char* line, size_t length) {
+    auto channels = snapshot_channels();
+    for (auto channel : channels) {
+        channel->print_line(level, line, length);
+        channel->release_processing_ref();
+    }
+}
+
 Channel* AllChannels::find(const std::string_view name) {
     xSemaphoreTake(_mutex_general, portMAX_DELAY);
     for (auto channel : _channelq) {
@@ -225,6 +274,7 @@ Channel* AllChannels::find(const std::string_view name) {
 }
 Channel* AllChannels::poll(char* line) {
     reap_channels();
+    flush_partial();
 
     Channel* deadChannel;
     while (xQueueReceive(_killQueue, &deadChannel, 0)) {
@@ -29,9 +29,17 @@ class AllChannels : public Channel {
 
     static SemaphoreHandle_t _mutex_general;
     static SemaphoreHandle_t _mutex_pollLine;
+    static SemaphoreHandle_t _mutex_write;
+
+    // Characters written directly to allChannels, collected until a newline,
+    // or until poll() finds that they have waited too long for one
+    std::string _partial;
+    uint32_t    _partial_ms = 0;  // When the first character of _partial was written
 
     void                  reap_channels();
     std::vector<Channel*> snapshot_channels();
+    void                  broadcast(const uint8_t* line, size_t length);
+    void                  flush_partial();
 
 public:
     AllChannels() : Channel("all") { _killQueue = xQueueCreate(16, sizeof(Channel*)); }
@@ -47,6 +55,7 @@ public:
     size_t write(const uint8_t* buffer, size_t length) override;
 
     void print_msg(MsgLevel level, const char* msg) override;
+    void print_line(MsgLevel level, const char* line, size_t length) override;
 
     void flushRx() override;
 
@@ -404,6 +404,6 @@ public:
 // Execute the startup script lines stored in non-volatile storage upon initialization
 Error settings_execute_line(const char* line, Channel& out, AuthenticationLevel);
 Error do_command_or_setting(std::string_view key, std::string_view value, AuthenticationLevel auth_level, Channel&);
-Error execute_line(const char* line, Channel& channel, AuthenticationLevel auth_level);
+Error execute_line(const char* line, Channel& channel, AuthenticationLevel auth_level, const CompiledLine* compiled = nullptr);
 
 extern const enum_opt_t onoffOptions;
@@ -10,6 +10,8 @@
 
 StringSetting* config_filename;
 
+EnumSetting* config_cache;
+
 StringSetting* build_info;
 
 StringSetting* start_message;
@@ -97,6 +99,8 @@ void make_settings() {
 
     config_filename = new StringSetting("Name of Configuration File", EXTENDED, WG, NULL, "Config/Filename", "config.yaml", 1, 50);
 
+    config_cache = new EnumSetting("Boot from cached configuration", EXTENDED, WG, NULL, "Config/Cache", 1, &onoffOptions);
+
     // GRBL Numbered Settings
     status_mask = new IntSetting("What to include in status report", GRBL, WG, "10", "Report/Status", 1, 0, 3);
 
@@ -4,6 +4,8 @@
 
 extern StringSetting* config_filename;
 
+extern EnumSetting* config_cache;
+
 extern StringSetting* build_info;
 
 extern StringSetting* start_message;
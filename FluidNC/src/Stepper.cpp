@@ -15,6 +15,9 @@
 #include "StepperPrivate.h"
 #include "Planner.h"
 #include "Protocol.h"
+#include "VelocityProfile.h"
+#include "JSONEncoder.h"
+#include "Driver/delay_usecs.h"  // getCpuTicks(), ticks_per_us
 #include <cmath>
 
 using namespace Stepper;
@@ -49,7 +52,23 @@ struct segment_t {
 };
 static segment_t* segment_buffer = nullptr;
 
+Stats Stepper::stats;
+
+// CPU ticks per step timer tick, times 16, for detecting ISR overruns without
+// floating point or 64-bit arithmetic in the ISR.
+static uint32_t cpu_ticks_per_timer_tick_x16;
+
+void Stepper::reset_stats() {
+    memset(&stats, 0, sizeof(stats));
+    stats.isr_min_ticks     = UINT32_MAX;
+    stats.segment_low_water = UINT32_MAX;
+    stats.planner_low_water = UINT32_MAX;
+}
+
 void Stepper::init() {
+    cpu_ticks_per_timer_tick_x16 = uint32_t(uint64_t(ticks_per_us) * 1000000 * 16 / Machine::Stepping::fStepperTimer);
+    reset_stats();
+
     if (st_block_buffer) {
         delete[] st_block_buffer;
     }
@@ -89,7 +108,7 @@ static volatile st_block_t* st_prep_block;  // Pointer to the stepper block data
 
 // Segment preparation data struct. Contains all the necessary information to compute new segments
 // based on the current executing planner block.
-typedef struct {
+struct st_prep_t : VelocityProfile {
     uint8_t  st_block_index;  // Index of stepper common data block being prepped
     PrepFlag recalculate_flag;
 
@@ -103,19 +122,9 @@ typedef struct {
     float   last_step_per_mm;
     float   last_dt_remainder;
 
-    uint8_t ramp_type;    // Current segment ramp state
-    float   mm_complete;  // End of velocity profile from end of current planner block in (mm).
-    // NOTE: This value must coincide with a step(no mantissa) when converted.
-    float current_speed;     // Current speed at the end of the segment buffer (mm/min)
-    float maximum_speed;     // Maximum speed of executing block. Not always nominal speed. (mm/min)
-    float exit_speed;        // Exit speed of executing block (mm/min)
-    float accelerate_until;  // Acceleration ramp end measured from end of block (mm)
-    float decelerate_after;  // Deceleration ramp start measured from end of block (mm)
-
     float        inv_rate;  // Used by PWM laser mode to speed up segment calculations.
     SpindleSpeed current_spindle_speed;
-
-} st_prep_t;
+};
 static st_prep_t prep;
 
 /* "The Stepper Driver Interrupt" - This timer interrupt is the workhorse, employing
@@ -190,10 +199,34 @@ uint32_t Stepper::isr_count;  // for debugging only
  * is to keep pulse timing as regular as possible.
  * Returns true if step interrupts should continue
  */
+static bool IRAM_ATTR pulse_step();
+
 bool IRAM_ATTR Stepper::pulse_func() {
 #ifdef DEBUG_STEPPER_ISR
     isr_count++;
 #endif
+    // Reading the cycle counter takes constant time, so it does not add jitter
+    int32_t start   = getCpuTicks();
+    bool    more    = pulse_step();
+    auto    elapsed = uint32_t(getCpuTicks() - start);
+
+    ++stats.isr_count;
+    if (elapsed < stats.isr_min_ticks) {
+        stats.isr_min_ticks = elapsed;
+    }
+    if (elapsed > stats.isr_max_ticks) {
+        stats.isr_max_ticks = elapsed;
+    }
+    uint32_t us     = elapsed / ticks_per_us;
+    int      bucket = us ? 32 - __builtin_clz(us) : 0;
+    ++stats.isr_histogram[bucket < isr_histogram_size ? bucket : isr_histogram_size - 1];
+    if (more && st.exec_segment && elapsed * 16 > st.exec_segment->isrPeriod * cpu_ticks_per_timer_tick_x16) {
+        ++stats.isr_overruns;
+    }
+    return more;
+}
+
+static bool IRAM_ATTR pulse_step() {
     // This is a precaution in case we get a spurious interrupt
     if (!awake) {
         return false;
@@ -203,10 +236,17 @@ bool IRAM_ATTR Stepper::pulse_func() {
     Stepping::step(st.step_outbits, st.dir_outbits);
     st.step_outbits = 0;
 
+    // During a probing cycle, latch the position if the probe has tripped
+    config->_probe->sample_latch();
+
     // If there is no step segment, attempt to pop one from the stepper buffer
     if (st.exec_segment == NULL) {
         // Anything in the buffer? If so, load and initialize next step segment.
         if (segment_buffer_head != segment_buffer_tail) {
+            uint32_t queued = segments_queued();
+            if (queued < stats.segment_low_water) {
+                stats.segment_low_water = queued;
+            }
             // Initialize new step segment and load number of steps to execute
             st.exec_segment = &segment_buffer[segment_buffer_tail];
             // Initialize step segment timing per step and load number of steps to execute.
@@ -232,6 +272,9 @@ bool IRAM_ATTR Stepper::pulse_func() {
             spindle->setSpeedfromISR(st.exec_segment->spindle_dev_speed);
         } else {
             // Segment buffer empty. Shutdown.
+            if (pl_block != NULL && !sys.step_control.endMotion) {
+                ++stats.underruns;  // The block is not finished, so segment prep fell behind
+            }
             stop_stepping();
             if (!state_is(State::Jog)) {  // added to prevent ... jog after probing crash
                 // Ensure pwm is set properly upon completion of rate-controlled motion.
@@ -373,12 +416,29 @@ static uint8_t next_block_index(uint8_t block_index) {
    Currently, the segment buffer conservatively holds roughly up to 40-50 msec of steps.
    NOTE: Computation units are in steps, millimeters, and minutes.
 */
+static void fill_segment_buffer();
+
 void Stepper::prep_buffer() {
     // Block step prep buffer, while in a suspend state and there is no suspend motion to execute.
     if (sys.step_control.endMotion) {
         return;
     }
 
+    int32_t  start = getCpuTicks();
+    uint32_t head  = segment_next_head;
+    fill_segment_buffer();
+    if (segment_next_head != head) {
+        auto elapsed = uint32_t(getCpuTicks() - start);
+        ++stats.prep_calls;
+        stats.prep_segments += segment_next_head > head ? segment_next_head - head : segment_next_head + Stepping::_segments - head;
+        stats.prep_ticks += elapsed;
+        if (elapsed > stats.prep_max_ticks) {
+            stats.prep_max_ticks = elapsed;
+        }
+    }
+}
+
+static void fill_segment_buffer() {
     while (segment_buffer_tail != segment_next_head) {  // Check if we need to fill the buffer.
         // Determine if we need to load a new planner block or if the block needs to be recomputed.
         if (pl_block == NULL) {
@@ -387,6 +447,12 @@ void Stepper::prep_buffer() {
                 pl_block = plan_get_system_motion_block();
             } else {
                 pl_block = plan_get_current_block();
+                if (pl_block != NULL && state_is(State::Cycle)) {
+                    uint32_t queued = config->_planner_blocks - 1 - plan_get_block_buffer_available();
+                    if (queued < stats.planner_low_water) {
+                        stats.planner_low_water = queued;
+                    }
+                }
             }
 
             if (pl_block == NULL) {
@@ -449,82 +515,19 @@ void Stepper::prep_buffer() {
              planner has updated it. For a commanded forced-deceleration, such as from a feed
              hold, override the planner velocities and decelerate to the target exit speed.
             */
-            prep.mm_complete  = 0.0;  // Default velocity profile complete at 0.0mm from end of block.
-            float inv_2_accel = 0.5f / pl_block->acceleration;
+            // The jerk limit is in mm/sec^3 and the segment generator works in mm/min
+            prep.max_jerk = config->_jerk * 216000.0f;
             if (sys.step_control.executeHold) {  // [Forced Deceleration to Zero Velocity]
-                // Compute velocity profile parameters for a feed hold in-progress. This profile overrides
-                // the planner block profile, enforcing a deceleration to zero speed.
-                prep.ramp_type = RAMP_DECEL;
-                // Compute decelerate distance relative to end of block.
-                float decel_dist = pl_block->millimeters - inv_2_accel * pl_block->entry_speed_sqr;
-                if (decel_dist < 0.0) {
-                    // Deceleration through entire planner block. End of feed hold is not in this block.
-                    prep.exit_speed = sqrtf(pl_block->entry_speed_sqr - 2 * pl_block->acceleration * pl_block->millimeters);
-                } else {
-                    prep.mm_complete = decel_dist;  // End of feed hold.
-                    prep.exit_speed  = 0.0;
-                }
+                prep.plan_hold(pl_block->millimeters, pl_block->acceleration, pl_block->entry_speed_sqr);
             } else {  // [Normal Operation]
-                // Compute or recompute velocity profile parameters of the prepped planner block.
-                prep.ramp_type        = RAMP_ACCEL;  // Initialize as acceleration ramp.
-                prep.accelerate_until = pl_block->millimeters;
-                float exit_speed_sqr;
-                float nominal_speed;
-                if (sys.step_control.executeSysMotion) {
-                    prep.exit_speed = exit_speed_sqr = 0.0;  // Enforce stop at end of system motion.
-                } else {
-                    exit_speed_sqr  = plan_get_exec_block_exit_speed_sqr();
-                    prep.exit_speed = sqrtf(exit_speed_sqr);
-                }
-
-                nominal_speed            = plan_compute_profile_nominal_speed(pl_block);
-                float nominal_speed_sqr  = nominal_speed * nominal_speed;
-                float intersect_distance = 0.5f * (pl_block->millimeters + inv_2_accel * (pl_block->entry_speed_sqr - exit_speed_sqr));
-                if (pl_block->entry_speed_sqr > nominal_speed_sqr) {  // Only occurs during override reductions.
-                    prep.accelerate_until = pl_block->millimeters - inv_2_accel * (pl_block->entry_speed_sqr - nominal_speed_sqr);
-                    if (prep.accelerate_until <= 0.0) {  // Deceleration-only.
-                        prep.ramp_type = RAMP_DECEL;
-                        // prep.decelerate_after = pl_block->millimeters;
-                        // prep.maximum_speed = prep.current_speed;
-                        // Compute override block exit speed since it doesn't match the planner exit speed.
-                        prep.exit_speed = sqrtf(pl_block->entry_speed_sqr - 2 * pl_block->acceleration * pl_block->millimeters);
-                        prep.recalculate_flag.decelOverride = 1;  // Flag to load next block as deceleration override.
-                        // TODO: Determine correct handling of parameters in deceleration-only.
-                        // Can be tricky since entry speed will be current speed, as in feed holds.
-                        // Also, look into near-zero speed handling issues with this.
-                    } else {
-                        // Decelerate to cruise or cruise-decelerate types. Guaranteed to intersect updated plan.
-                        prep.decelerate_after = inv_2_accel * (nominal_speed_sqr - exit_speed_sqr);
-                        prep.maximum_speed    = nominal_speed;
-                        prep.ramp_type        = RAMP_DECEL_OVERRIDE;
-                    }
-                } else if (intersect_distance > 0.0) {
-                    if (intersect_distance < pl_block->millimeters) {  // Either trapezoid or triangle types
-                        // NOTE: For acceleration-cruise and cruise-only types, following calculation will be 0.0.
-                        prep.decelerate_after = inv_2_accel * (nominal_speed_sqr - exit_speed_sqr);
-                        if (prep.decelerate_after < intersect_distance) {  // Trapezoid type
-                            prep.maximum_speed = nominal_speed;
-                            if (pl_block->entry_speed_sqr == nominal_speed_sqr) {
-                                // Cruise-deceleration or cruise-only type.
-                                prep.ramp_type = RAMP_CRUISE;
-                            } else {
-                                // Full-trapezoid or acceleration-cruise types
-                                prep.accelerate_until -= inv_2_accel * (nominal_speed_sqr - pl_block->entry_speed_sqr);
-                            }
-                        } else {  // Triangle type
-                            prep.accelerate_until = intersect_distance;
-                            prep.decelerate_after = intersect_distance;
-                            prep.maximum_speed    = sqrtf(2.0f * pl_block->acceleration * intersect_distance + exit_speed_sqr);
-                        }
-                    } else {  // Deceleration-only type
-                        prep.ramp_type = RAMP_DECEL;
-                        // prep.decelerate_after = pl_block->millimeters;
-                        // prep.maximum_speed = prep.current_speed;
-                    }
-                } else {  // Acceleration-only type
-                    prep.accelerate_until = 0.0;
-                    // prep.decelerate_after = 0.0;
-                    prep.maximum_speed = prep.exit_speed;
+                // Enforce stop at end of system motion.
+                float exit_speed_sqr = sys.step_control.executeSysMotion ? 0.0f : plan_get_exec_block_exit_speed_sqr();
+                if (prep.plan(pl_block->millimeters,
+                              pl_block->acceleration,
+                              pl_block->entry_speed_sqr,
+                              exit_speed_sqr,
+                              plan_compute_profile_nominal_speed(pl_block))) {
+                    prep.recalculate_flag.decelOverride = 1;  // Flag to load next block as deceleration override.
                 }
             }
 
@@ -537,112 +540,9 @@ void Stepper::prep_buffer() {
         // Set new segment to point to the current segment data block.
         prep_segment->st_block_index = prep.st_block_index;
 
-        /*------------------------------------------------------------------------------------
-            Compute the average velocity of this new segment by determining the total distance
-          traveled over the segment time DT_SEGMENT. The following code first attempts to create
-          a full segment based on the current ramp conditions. If the segment time is incomplete
-          when terminating at a ramp state change, the code will continue to loop through the
-          progressing ramp states to fill the remaining segment execution time. However, if
-          an incomplete segment terminates at the end of the velocity profile, the segment is
-          considered completed despite having a truncated execution time less than DT_SEGMENT.
-            The velocity profile is always assumed to progress through the ramp sequence:
-          acceleration ramp, cruising state, and deceleration ramp. Each ramp's travel distance
-          may range from zero to the length of the block. Velocity profiles can end either at
-          the end of planner block (typical) or mid-block at the end of a forced deceleration,
-          such as from a feed hold.
-        */
-        float dt_max   = DT_SEGMENT;                                // Maximum segment time
-        float dt       = 0.0;                                       // Initialize segment time
-        float time_var = dt_max;                                    // Time worker variable
-        float mm_var;                                               // mm-Distance worker variable
-        float speed_var;                                            // Speed worker variable
-        float mm_remaining = pl_block->millimeters;                 // New segment distance from end of block.
-        float minimum_mm   = mm_remaining - prep.req_mm_increment;  // Guarantee at least one step.
-
-        if (minimum_mm < 0.0) {
-            minimum_mm = 0.0;
-        }
-
-        do {
-            switch (prep.ramp_type) {
-                case RAMP_DECEL_OVERRIDE:
-                    speed_var = pl_block->acceleration * time_var;
-                    mm_var    = time_var * (prep.current_speed - 0.5f * speed_var);
-                    mm_remaining -= mm_var;
-                    if ((mm_remaining < prep.accelerate_until) || (mm_var <= 0)) {
-                        // Cruise or cruise-deceleration types only for deceleration override.
-                        mm_remaining       = prep.accelerate_until;  // NOTE: 0.0 at EOB
-                        time_var           = 2.0f * (pl_block->millimeters - mm_remaining) / (prep.current_speed + prep.maximum_speed);
-                        prep.ramp_type     = RAMP_CRUISE;
-                        prep.current_speed = prep.maximum_speed;
-                    } else {  // Mid-deceleration override ramp.
-                        prep.current_speed -= speed_var;
-                    }
-                    break;
-                case RAMP_ACCEL:
-                    // NOTE: Acceleration ramp only computes during first do-while loop.
-                    speed_var = pl_block->acceleration * time_var;
-                    mm_remaining -= time_var * (prep.current_speed + 0.5f * speed_var);
-                    if (mm_remaining < prep.accelerate_until) {  // End of acceleration ramp.
-                        // Acceleration-cruise, acceleration-deceleration ramp junction, or end of block.
-                        mm_remaining = prep.accelerate_until;  // NOTE: 0.0 at EOB
-                        time_var     = 2.0f * (pl_block->millimeters - mm_remaining) / (prep.current_speed + prep.maximum_speed);
-                        if (mm_remaining == prep.decelerate_after) {
-                            prep.ramp_type = RAMP_DECEL;
-                        } else {
-                            prep.ramp_type = RAMP_CRUISE;
-                        }
-                        prep.current_speed = prep.maximum_speed;
-                    } else {  // Acceleration only.
-                        prep.current_speed += speed_var;
-                    }
-                    break;
-                case RAMP_CRUISE:
-                    // NOTE: mm_var used to retain the last mm_remaining for incomplete segment time_var calculations.
-                    // NOTE: If maximum_speed*time_var value is too low, round-off can cause mm_var to not change. To
-                    //   prevent this, simply enforce a minimum speed threshold in the planner.
-                    mm_var = mm_remaining - prep.maximum_speed * time_var;
-                    if (mm_var < prep.decelerate_after) {  // End of cruise.
-                        // Cruise-deceleration junction or end of block.
-                        time_var       = (mm_remaining - prep.decelerate_after) / prep.maximum_speed;
-                        mm_remaining   = prep.decelerate_after;  // NOTE: 0.0 at EOB
-                        prep.ramp_type = RAMP_DECEL;
-                    } else {  // Cruising only.
-                        mm_remaining = mm_var;
-                    }
-                    break;
-                default:  // case RAMP_DECEL:
-                    // NOTE: mm_var used as a misc worker variable to prevent errors when near zero speed.
-                    speed_var = pl_block->acceleration * time_var;  // Used as delta speed (mm/min)
-                    if (prep.current_speed > speed_var) {           // Check if at or below zero speed.
-                        // Compute distance from end of segment to end of block.
-                        mm_var = mm_remaining - time_var * (prep.current_speed - 0.5f * speed_var);  // (mm)
-                        if (mm_var > prep.mm_complete) {                                             // Typical case. In deceleration ramp.
-                            mm_remaining = mm_var;
-                            prep.current_speed -= speed_var;
-                            break;  // Segment complete. Exit switch-case statement. Continue do-while loop.
-                        }
-                    }
-                    // Otherwise, at end of block or end of forced-deceleration.
-                    time_var           = 2.0f * (mm_remaining - prep.mm_complete) / (prep.current_speed + prep.exit_speed);
-                    mm_remaining       = prep.mm_complete;
-                    prep.current_speed = prep.exit_speed;
-            }
-
-            dt += time_var;  // Add computed ramp time to total segment time.
-            if (dt < dt_max) {
-                time_var = dt_max - dt;  // **Incomplete** At ramp junction.
-            } else {
-                if (mm_remaining > minimum_mm) {  // Check for very slow segments with zero steps.
-                    // Increase segment time to ensure at least one step in segment. Override and loop
-                    // through distance calculations until minimum_mm or mm_complete.
-                    dt_max += DT_SEGMENT;
-                    time_var = dt_max - dt;
-                } else {
-                    break;  // **Complete** Exit loop. Segment execution time maxed.
-                }
-            }
-        } while (mm_remaining > prep.mm_complete);  // **Complete** Exit loop. Profile complete.
+        // Compute the distance and time of this new segment along the velocity profile.
+        float mm_remaining;
+        float dt = prep.next_segment(pl_block->millimeters, pl_block->acceleration, prep.req_mm_increment, DT_SEGMENT, mm_remaining);
 
         /* -----------------------------------------------------------------------------------
           Compute spindle speed PWM output for step segment
@@ -763,6 +663,13 @@ void Stepper::prep_buffer() {
     }
 }
 
+// Number of step segments waiting for the step interrupt
+uint32_t IRAM_ATTR Stepper::segments_queued() {
+    uint32_t head = segment_buffer_head;
+    uint32_t tail = segment_buffer_tail;
+    return head >= tail ? head - tail : head + Stepping::_segments - tail;
+}
+
 // Called by realtime status reporting to fetch the current speed being executed. This value
 // however is not exactly the current speed, but the speed computed in the last step segment
 // in the segment buffer. It will always be behind by up to the number of segment blocks (-1)
@@ -779,3 +686,59 @@ float Stepper::get_realtime_rate() {
             return 0.0f;
     }
 }
+
+static float ticks_to_us(uint64_t ticks) {
+    return float(ticks) / ticks_per_us;
+}
+
+void Stepper::report_stats(Channel& out) {
+    if (stats.isr_count) {
+        log_stream(out,
+                   "Step ISR: " << stats.isr_count << " runs, min " << ticks_to_us(stats.isr_min_ticks) << " us, max "
+                                << ticks_to_us(stats.isr_max_ticks) << " us, overruns " << stats.isr_overruns);
+        std::string histogram("Step ISR us:");
+        for (int i = 0; i < isr_histogram_size; i++) {
+            histogram += i == isr_histogram_size - 1 ? " >=" : " <";
+            histogram += std::to_string(1 << (i == isr_histogram_size - 1 ? i - 1 : i));
+            histogram += ":" + std::to_string(stats.isr_histogram[i]);
+        }
+        log_string(out, histogram);
+    } else {
+        log_string(out, "Step ISR: 0 runs");
+    }
+
+    std::string low_water = stats.segment_low_water == UINT32_MAX ? "-" : std::to_string(stats.segment_low_water);
+    log_stream(out, "Segment buffer: low water " << low_water << "/" << Stepping::_segments << ", underruns " << stats.underruns);
+
+    low_water = stats.planner_low_water == UINT32_MAX ? "-" : std::to_string(stats.planner_low_water);
+    log_stream(out, "Planner: low water " << low_water << "/" << (config->_planner_blocks - 1));
+
+    if (stats.prep_calls) {
+        log_stream(out,
+                   "Segment prep: " << stats.prep_calls << " calls, " << stats.prep_segments << " segments, avg "
+                                    << ticks_to_us(stats.prep_ticks / stats.prep_calls) << " us, max "
+                                    << ticks_to_us(stats.prep_max_ticks) << " us");
+    } else {
+        log_string(out, "Segment prep: 0 calls");
+    }
+}
+
+void Stepper::report_stats(JSONencoder& j) {
+    j.id_value_object("Step ISR runs", int32_t(stats.isr_count));
+    if (stats.isr_count) {
+        j.id_value_object("Step ISR min", formatFloat(ticks_to_us(stats.isr_min_ticks), 2) + "us");
+        j.id_value_object("Step ISR max", formatFloat(ticks_to_us(stats.isr_max_ticks), 2) + "us");
+    }
+    j.id_value_object("Step ISR overruns", int32_t(stats.isr_overruns));
+    if (stats.segment_low_water != UINT32_MAX) {
+        j.id_value_object("Segment buffer low water", int32_t(stats.segment_low_water));
+    }
+    j.id_value_object("Segment buffer underruns", int32_t(stats.underruns));
+    if (stats.planner_low_water != UINT32_MAX) {
+        j.id_value_object("Planner low water", int32_t(stats.planner_low_water));
+    }
+    if (stats.prep_calls) {
+        j.id_value_object("Segment prep avg", formatFloat(ticks_to_us(stats.prep_ticks / stats.prep_calls), 2) + "us");
+        j.id_value_object("Segment prep max", formatFloat(ticks_to_us(stats.prep_max_ticks), 2) + "us");
+    }
+}
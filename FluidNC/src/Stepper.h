@@ -13,7 +13,33 @@
 
 #include <cstdint>
 
+class Channel;
+class JSONencoder;
+
 namespace Stepper {
+    // Always-on counters for diagnosing motion stutters.  They show whether the step
+    // interrupt ran too long, the segment buffer ran dry, or the planner ran low.
+    const int isr_histogram_size = 8;  // Buckets of <1, <2, <4 ... <64 and >= 64 us
+    struct Stats {
+        uint32_t isr_count;                          // Step interrupts
+        uint32_t isr_min_ticks;                      // Shortest pulse_func() execution in CPU ticks
+        uint32_t isr_max_ticks;                      // Longest pulse_func() execution in CPU ticks
+        uint32_t isr_overruns;                       // Executions that took longer than the step period
+        uint32_t isr_histogram[isr_histogram_size];  // Executions by duration
+        uint32_t segment_low_water;                  // Fewest segments queued when the ISR loaded one
+        uint32_t underruns;                          // Times the segment buffer ran dry in the middle of a block
+        uint32_t planner_low_water;                  // Fewest planner blocks queued when a block was loaded in a cycle
+        uint32_t prep_calls;                         // prep_buffer() calls that generated segments
+        uint32_t prep_segments;                      // Segments generated by those calls
+        uint64_t prep_ticks;                         // Total CPU ticks spent in those calls
+        uint32_t prep_max_ticks;                     // Longest of those calls in CPU ticks
+    };
+    extern Stats stats;
+
+    void reset_stats();
+    void report_stats(Channel& out);
+    void report_stats(JSONencoder& j);
+
     void init();
 
     bool pulse_func();
@@ -45,5 +71,8 @@ namespace Stepper {
     // Called by realtime status reporting if realtime rate reporting is enabled in config.h.
     float get_realtime_rate();
 
+    // Number of step segments waiting for the step interrupt
+    uint32_t segments_queued();
+
     extern uint32_t isr_count;
 }
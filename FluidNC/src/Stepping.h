@@ -70,8 +70,9 @@ namespace Machine {
         // Interfaces to stepping engine
         static void init();
 
-        static steps_t getSteps(axis_t axis) { return axis_steps[axis]; }
-        static void    setSteps(axis_t axis, steps_t steps) { axis_steps[axis] = steps; }
+        static steps_t        getSteps(axis_t axis) { return axis_steps[axis]; }
+        static void           setSteps(axis_t axis, steps_t steps) { axis_steps[axis] = steps; }
+        static const steps_t* IRAM_ATTR allSteps() { return axis_steps; }  // For the stepper ISR, which owns the counts
 
         static void assignMotor(axis_t axis, motor_t motor, pinnum_t step_pin, bool step_invert, pinnum_t dir_pin, bool dir_invert);
 
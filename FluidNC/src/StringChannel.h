@@ -2,6 +2,7 @@
 
 #include "Channel.h"
 #include "Serial.h"
+#include <string>
 #include <string_view>
 #include <cstdio>
 
@@ -13,19 +14,21 @@
  * If the string doesn't end with a newline, one is automatically appended.
  */
 class StringChannel : public Channel {
+    std::string _input;
+    size_t      _next = 0;
+
 public:
     /*
      * Constructor: Takes the input string to be consumed.
      * If string is empty or all whitespace, the channel will immediately return EOF.
      */
-    StringChannel(const std::string_view input) : Channel("StringChannel", false) {
-        push(input);
-        if (!input.empty() && input.back() != '\n') {
-            push((uint8_t)'\n');
+    StringChannel(const std::string_view input) : Channel("StringChannel", false), _input(input) {
+        if (!_input.empty() && _input.back() != '\n') {
+            _input += '\n';
         }
     }
 
-    // This is a no-op so the initial call to it does not clear the queue
+    // This is a no-op so the initial call to it does not discard the string
     void flushRx() override {}
 
     void init() override { allChannels.registration(this); }
@@ -44,7 +47,7 @@ public:
         return fputc(c, stderr) != EOF ? 1 : 0;
     }
 
-    int read() override { return -1; }
+    int read() override { return _next < _input.length() ? uint8_t(_input[_next++]) : -1; }
 
     // Channel methods
     int rx_buffer_available() override { return 0; }
@@ -0,0 +1,96 @@
+// Copyright (c) 2026 - FluidNC Contributors
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#include "Telemetry.h"
+
+namespace Telemetry {
+    static uint8_t* put_varint(uint8_t* p, uint32_t value) {
+        while (value >= 0x80) {
+            *p++ = uint8_t(value) | 0x80;
+            value >>= 7;
+        }
+        *p++ = uint8_t(value);
+        return p;
+    }
+
+    static bool get_varint(const uint8_t*& p, const uint8_t* end, uint32_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 35 && p < end; shift += 7) {
+            uint8_t byte = *p++;
+            value |= uint32_t(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Zigzag encoding maps small differences of either sign to small numbers
+    static uint32_t zigzag(int32_t n) { return (uint32_t(n) << 1) ^ uint32_t(n >> 31); }
+    static int32_t  unzigzag(uint32_t n) { return int32_t(n >> 1) ^ -int32_t(n & 1); }
+
+    size_t Encoder::encode(const Sample& sample, uint8_t* frame, bool keyframe) {
+        keyframe = keyframe || !_valid;
+
+        uint32_t mask = 0;
+        uint8_t* p    = frame + header_size;
+        for (size_t i = 0; i < FieldCount; i++) {
+            int32_t previous = keyframe ? 0 : _last.value[i];
+            if (keyframe || sample.value[i] != previous) {
+                mask |= uint32_t(1) << i;
+                p = put_varint(p, zigzag(int32_t(uint32_t(sample.value[i]) - uint32_t(previous))));
+            }
+        }
+        if (!mask && !keyframe) {
+            return 0;
+        }
+
+        size_t length = p - frame;
+        frame[0]      = magic;
+        frame[1]      = uint8_t(length - 2);
+        frame[2]      = version;
+        frame[3]      = _sequence++;
+        frame[4]      = keyframe ? keyframe_flag : 0;
+        for (int i = 0; i < 4; i++) {
+            frame[5 + i] = uint8_t(mask >> (8 * i));
+        }
+
+        _last  = sample;
+        _valid = true;
+        return length;
+    }
+
+    bool Decoder::decode(const uint8_t* frame, size_t length) {
+        if (length < header_size || frame_length(frame) != length || frame[2] != version) {
+            return false;
+        }
+        bool keyframe = frame[4] & keyframe_flag;
+        if (!keyframe && (!_valid || frame[3] != uint8_t(_sequence + 1))) {
+            _valid = false;
+            return false;
+        }
+
+        uint32_t mask = 0;
+        for (int i = 0; i < 4; i++) {
+            mask |= uint32_t(frame[5 + i]) << (8 * i);
+        }
+
+        Sample         next = keyframe ? Sample() : _current;
+        const uint8_t* p    = frame + header_size;
+        const uint8_t* end  = frame + length;
+        for (size_t i = 0; i < FieldCount; i++) {
+            if (mask & (uint32_t(1) << i)) {
+                uint32_t delta;
+                if (!get_varint(p, end, delta)) {
+                    return false;
+                }
+                next.value[i] = int32_t(uint32_t(next.value[i]) + uint32_t(unzigzag(delta)));
+            }
+        }
+
+        _current  = next;
+        _sequence = frame[3];
+        _valid    = true;
+        return true;
+    }
+}
@@ -0,0 +1,119 @@
+// Copyright (c) 2026 - FluidNC Contributors
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#pragma once
+
+// Binary telemetry frames are a compact alternative to the text <...> status
+// report, for displays and plotters that want positions at 50-100 Hz.  A
+// channel switches to them with $RB=<ms>; the frames then take the place of
+// the automatic status reports.  Other output, including $G state reports
+// and replies to commands, is still sent as text lines.
+//
+// Frame layout, version 1:
+//
+//   offset  size  contents
+//   0       1     0xFE, which never appears in UTF-8 text
+//   1       1     Number of bytes that follow this one
+//   2       1     Version, 1
+//   3       1     Sequence number, incremented for each frame and wrapping at 255
+//   4       1     Flags: bit 0 is set in a keyframe
+//   5       4     Field mask, little-endian; bit n is set if field n is present
+//   9       ...   The present fields, in order of field number
+//
+// Each present field is the difference between its value and the value that
+// it had in the previous frame, zigzag-encoded ((d << 1) ^ (d >> 31)) and
+// then written as an unsigned LEB128 varint: seven bits per byte, least
+// significant first, with bit 7 set on every byte except the last.  Fields
+// that did not change since the previous frame are omitted, and a frame in
+// which nothing changed is not sent.
+//
+// A keyframe contains every field, and its differences are from zero, so it
+// carries absolute values.  Keyframes are sent when reporting starts and then
+// at least once a second.  A client that sees a gap in the sequence numbers
+// has missed a frame and must ignore frames until the next keyframe.
+//
+// Fields, all signed 32-bit integers:
+//
+//   0        State, numbered as in enum class State (Idle = 0, Alarm, CheckMode, Homing, Cycle,
+//            Hold, Held, Jog, SafetyDoor, Sleep, ConfigAlarm, Critical, Starting)
+//   1        Line number of the executing block, 0 if none
+//   2        Feed rate in mm/min
+//   3        Spindle speed in RPM
+//   4        Feed override in percent
+//   5        Rapid override in percent
+//   6        Spindle override in percent
+//   7        Planner blocks queued
+//   8        Step segments queued
+//   9-14     Machine position of axes X, Y, Z, A, B, C in micrometers
+//   15-20    Work coordinate offset of axes X, Y, Z, A, B, C in micrometers;
+//            the work position is the machine position minus this offset
+//
+// Fields for axes that the machine does not have are always zero.  New fields
+// may be added after the last one without changing the version, so a client
+// should ignore mask bits that it does not know; the version changes only if
+// the meaning of an existing field does.
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Telemetry {
+    const uint8_t magic   = 0xFE;
+    const uint8_t version = 1;
+
+    enum Field : uint8_t {
+        StateField = 0,
+        LineNumber,
+        FeedRate,
+        SpindleSpeed,
+        FeedOverride,
+        RapidOverride,
+        SpindleOverride,
+        PlannerBlocks,
+        Segments,
+        MachinePosition,                   // One per axis
+        WorkOffset = MachinePosition + 6,  // One per axis
+        FieldCount = WorkOffset + 6,
+    };
+
+    const uint8_t keyframe_flag = 0x01;
+
+    const size_t header_size    = 9;
+    const size_t max_frame_size = header_size + FieldCount * 5;  // 5 bytes holds any 32-bit varint
+
+    struct Sample {
+        int32_t value[FieldCount] = {};
+    };
+
+    // Encoder remembers the previous sample so that each frame carries only
+    // what changed since the last one.
+    class Encoder {
+        Sample  _last;
+        uint8_t _sequence = 0;
+        bool    _valid    = false;
+
+    public:
+        // Writes a frame for sample into frame, which must hold max_frame_size
+        // bytes, and returns its length.  Returns 0, leaving the encoder as it
+        // was, if this is not a keyframe and nothing changed.
+        size_t encode(const Sample& sample, uint8_t* frame, bool keyframe);
+
+        // Makes the next frame a keyframe, for instance after a frame was lost.
+        void reset() { _valid = false; }
+    };
+
+    // Decoder is the inverse of Encoder.  It returns false if the frame is
+    // malformed, is not a keyframe and follows a gap in the sequence, or has
+    // a version that it does not know.
+    class Decoder {
+        Sample  _current;
+        uint8_t _sequence = 0;
+        bool    _valid    = false;
+
+    public:
+        bool          decode(const uint8_t* frame, size_t length);
+        const Sample& sample() const { return _current; }
+    };
+
+    // Total length of a frame from its header, or 0 if it is not a frame.
+    inline size_t frame_length(const uint8_t* frame) { return frame[0] == magic ? size_t(frame[1]) + 2 : 0; }
+}
@@ -0,0 +1,74 @@
+// Copyright (c) 2026 - FluidNC Contributors
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#pragma once
+
+// TokenBucket limits the rate of something, like bytes per second, while
+// allowing short bursts.  Tokens accumulate at the rate, up to the burst
+// size, and each use takes the tokens that it needs.  The caller passes in
+// the time in milliseconds, so the bucket does not depend on a clock.
+
+#include <cstddef>
+#include <cstdint>
+
+class TokenBucket {
+    uint32_t _rate     = 0;  // Tokens per second
+    uint32_t _burst    = 0;  // Most tokens that can accumulate
+    uint32_t _tokens   = 0;
+    uint32_t _fraction = 0;  // Thousandths of a token, so slow rates are exact
+    uint32_t _last_ms  = 0;
+
+public:
+    // Starts with a full bucket
+    void set_rate(uint32_t rate, uint32_t burst, uint32_t now_ms) {
+        _rate     = rate;
+        _burst    = burst;
+        _tokens   = burst;
+        _fraction = 0;
+        _last_ms  = now_ms;
+    }
+
+    uint32_t rate() const { return _rate; }
+
+    void refill(uint32_t now_ms) {
+        uint32_t elapsed = now_ms - _last_ms;
+        _last_ms         = now_ms;
+        if (_tokens >= _burst) {
+            _fraction = 0;
+            return;
+        }
+        uint64_t milli = uint64_t(elapsed) * _rate + _fraction;
+        uint64_t added = milli / 1000;
+        _fraction      = uint32_t(milli % 1000);
+        if (added >= _burst - _tokens) {
+            _tokens   = _burst;
+            _fraction = 0;
+        } else {
+            _tokens += uint32_t(added);
+        }
+    }
+
+    // Takes count tokens if they are all available
+    bool take(size_t count, uint32_t now_ms) {
+        refill(now_ms);
+        if (count > _tokens) {
+            return false;
+        }
+        _tokens -= uint32_t(count);
+        return true;
+    }
+
+    // Milliseconds until count tokens will be available, which is never if
+    // count is more than the burst size or the rate is 0
+    uint32_t wait_ms(size_t count, uint32_t now_ms) {
+        refill(now_ms);
+        if (count <= _tokens) {
+            return 0;
+        }
+        if (!_rate || count > _burst) {
+            return UINT32_MAX;
+        }
+        uint64_t milli = uint64_t(count - _tokens) * 1000 - _fraction;
+        return uint32_t((milli + _rate - 1) / _rate);
+    }
+};
@@ -145,11 +145,9 @@ size_t UartChannel::timedReadBytes(char* buffer, size_t length, TickType_t timeo
     // It is likely that _queue will be empty because timedReadBytes() is only
     // used in situations where the UART is not receiving GCode commands
     // and Grbl realtime characters.
-    uint8_t queued = 0;
-    while (remlen && try_pop_queued_byte(queued)) {
-        *buffer++ = queued;
-        --remlen;
-    }
+    size_t queued = pop_queued_bytes(reinterpret_cast<uint8_t*>(buffer), remlen);
+    buffer += queued;
+    remlen -= queued;
 
     auto thislen = _uart->timedReadBytes(buffer, remlen, timeout);
     remlen -= thislen;
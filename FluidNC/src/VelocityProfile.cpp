@@ -0,0 +1,243 @@
+// Copyright (c) 2026 - FluidNC Contributors
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#include "VelocityProfile.h"
+
+#include <cmath>
+
+void VelocityProfile::plan_hold(float millimeters, float acceleration, float entry_speed_sqr) {
+    // Compute velocity profile parameters for a feed hold in-progress. This profile overrides
+    // the planner block profile, enforcing a deceleration to zero speed.
+    mm_complete = 0.0;  // Default velocity profile complete at 0.0mm from end of block.
+    ramp_type   = RAMP_DECEL;
+    // Compute decelerate distance relative to end of block.
+    float decel_dist = millimeters - (0.5f / acceleration) * entry_speed_sqr;
+    if (decel_dist < 0.0) {
+        // Deceleration through entire planner block. End of feed hold is not in this block.
+        exit_speed = sqrtf(entry_speed_sqr - 2 * acceleration * millimeters);
+    } else {
+        mm_complete = decel_dist;  // End of feed hold.
+        exit_speed  = 0.0;
+    }
+    ramp.tj = 0.0f;
+    start_ramp(millimeters, mm_complete, exit_speed, acceleration);
+}
+
+bool VelocityProfile::plan(float millimeters, float acceleration, float entry_speed_sqr, float exit_speed_sqr, float nominal_speed) {
+    bool decel_override = false;
+
+    // Compute or recompute velocity profile parameters of the prepped planner block.
+    mm_complete      = 0.0;         // Default velocity profile complete at 0.0mm from end of block.
+    ramp_type        = RAMP_ACCEL;  // Initialize as acceleration ramp.
+    accelerate_until = millimeters;
+    exit_speed       = sqrtf(exit_speed_sqr);
+
+    float inv_2_accel        = 0.5f / acceleration;
+    float nominal_speed_sqr  = nominal_speed * nominal_speed;
+    float intersect_distance = 0.5f * (millimeters + inv_2_accel * (entry_speed_sqr - exit_speed_sqr));
+    if (entry_speed_sqr > nominal_speed_sqr) {  // Only occurs during override reductions.
+        accelerate_until = millimeters - inv_2_accel * (entry_speed_sqr - nominal_speed_sqr);
+        if (accelerate_until <= 0.0) {  // Deceleration-only.
+            ramp_type = RAMP_DECEL;
+            // decelerate_after = millimeters;
+            // maximum_speed = current_speed;
+            // Compute override block exit speed since it doesn't match the planner exit speed.
+            exit_speed     = sqrtf(entry_speed_sqr - 2 * acceleration * millimeters);
+            decel_override = true;  // Flag to load next block as deceleration override.
+            // TODO: Determine correct handling of parameters in deceleration-only.
+            // Can be tricky since entry speed will be current speed, as in feed holds.
+            // Also, look into near-zero speed handling issues with this.
+        } else {
+            // Decelerate to cruise or cruise-decelerate types. Guaranteed to intersect updated plan.
+            decelerate_after = inv_2_accel * (nominal_speed_sqr - exit_speed_sqr);
+            maximum_speed    = nominal_speed;
+            ramp_type        = RAMP_DECEL_OVERRIDE;
+        }
+    } else if (intersect_distance > 0.0) {
+        if (intersect_distance < millimeters) {  // Either trapezoid or triangle types
+            // NOTE: For acceleration-cruise and cruise-only types, following calculation will be 0.0.
+            decelerate_after = inv_2_accel * (nominal_speed_sqr - exit_speed_sqr);
+            if (decelerate_after < intersect_distance) {  // Trapezoid type
+                maximum_speed = nominal_speed;
+                if (entry_speed_sqr == nominal_speed_sqr) {
+                    // Cruise-deceleration or cruise-only type.
+                    ramp_type = RAMP_CRUISE;
+                } else {
+                    // Full-trapezoid or acceleration-cruise types
+                    accelerate_until -= inv_2_accel * (nominal_speed_sqr - entry_speed_sqr);
+                }
+            } else {  // Triangle type
+                accelerate_until = intersect_distance;
+                decelerate_after = intersect_distance;
+                maximum_speed    = sqrtf(2.0f * acceleration * intersect_distance + exit_speed_sqr);
+            }
+        } else {  // Deceleration-only type
+            ramp_type = RAMP_DECEL;
+            // decelerate_after = millimeters;
+            // maximum_speed = current_speed;
+        }
+    } else {  // Acceleration-only type
+        accelerate_until = 0.0;
+        // decelerate_after = 0.0;
+        maximum_speed = exit_speed;
+    }
+
+    ramp.tj = 0.0f;
+    if (ramp_type == RAMP_ACCEL) {
+        start_ramp(millimeters, accelerate_until, maximum_speed, acceleration);
+    } else if (ramp_type == RAMP_DECEL) {
+        start_ramp(millimeters, mm_complete, exit_speed, acceleration);
+    }
+    return decel_override;
+}
+
+// Shapes the ramp from the current speed to end_speed, between start_mm and end_mm
+// from the end of the block, into an S-curve if there is a jerk limit.  The planner
+// plans with a fraction of the acceleration limit in that case, see SCurve.h.
+void VelocityProfile::start_ramp(float start_mm, float end_mm, float end_speed, float acceleration) {
+    SCurve::plan(ramp, current_speed, end_speed, start_mm - end_mm, acceleration / SCurve::accel_fraction, max_jerk);
+    ramp_time     = 0.0f;
+    ramp_start_mm = start_mm;
+}
+
+// Advances along an S-curve ramp by time_var, updating mm_remaining and the current speed.
+// Returns true at the end of the ramp, with time_var reduced to the time that was left.
+bool VelocityProfile::advance_ramp(float& time_var, float& mm_remaining) {
+    if (ramp_time + time_var >= ramp.duration) {
+        time_var  = ramp.duration - ramp_time;
+        ramp_time = ramp.duration;
+        return true;
+    }
+    ramp_time += time_var;
+    mm_remaining  = ramp_start_mm - SCurve::distance(ramp, ramp_time);
+    current_speed = SCurve::speed(ramp, ramp_time);
+    return false;
+}
+
+float VelocityProfile::next_segment(float millimeters, float acceleration, float req_mm_increment, float dt_segment, float& mm_remaining) {
+    /*------------------------------------------------------------------------------------
+        Compute the average velocity of this new segment by determining the total distance
+      traveled over the segment time dt_segment. The following code first attempts to create
+      a full segment based on the current ramp conditions. If the segment time is incomplete
+      when terminating at a ramp state change, the code will continue to loop through the
+      progressing ramp states to fill the remaining segment execution time. However, if
+      an incomplete segment terminates at the end of the velocity profile, the segment is
+      considered completed despite having a truncated execution time less than dt_segment.
+        The velocity profile is always assumed to progress through the ramp sequence:
+      acceleration ramp, cruising state, and deceleration ramp. Each ramp's travel distance
+      may range from zero to the length of the block. Velocity profiles can end either at
+      the end of planner block (typical) or mid-block at the end of a forced deceleration,
+      such as from a feed hold.
+    */
+    float dt_max     = dt_segment;                       // Maximum segment time
+    float dt         = 0.0;                              // Initialize segment time
+    float time_var   = dt_max;                           // Time worker variable
+    float mm_var;                                        // mm-Distance worker variable
+    float speed_var;                                     // Speed worker variable
+    mm_remaining     = millimeters;                      // New segment distance from end of block.
+    float minimum_mm = mm_remaining - req_mm_increment;  // Guarantee at least one step.
+
+    if (minimum_mm < 0.0) {
+        minimum_mm = 0.0;
+    }
+
+    do {
+        switch (ramp_type) {
+            case RAMP_DECEL_OVERRIDE:
+                speed_var = acceleration * time_var;
+                mm_var    = time_var * (current_speed - 0.5f * speed_var);
+                mm_remaining -= mm_var;
+                if ((mm_remaining < accelerate_until) || (mm_var <= 0)) {
+                    // Cruise or cruise-deceleration types only for deceleration override.
+                    mm_remaining  = accelerate_until;  // NOTE: 0.0 at EOB
+                    time_var      = 2.0f * (millimeters - mm_remaining) / (current_speed + maximum_speed);
+                    ramp_type     = RAMP_CRUISE;
+                    current_speed = maximum_speed;
+                } else {  // Mid-deceleration override ramp.
+                    current_speed -= speed_var;
+                }
+                break;
+            case RAMP_ACCEL:
+                // NOTE: Acceleration ramp only computes during first do-while loop.
+                if (ramp.tj > 0.0f) {
+                    if (!advance_ramp(time_var, mm_remaining)) {
+                        break;  // Mid S-curve acceleration.
+                    }
+                } else {
+                    speed_var = acceleration * time_var;
+                    mm_remaining -= time_var * (current_speed + 0.5f * speed_var);
+                    if (mm_remaining >= accelerate_until) {  // Acceleration only.
+                        current_speed += speed_var;
+                        break;
+                    }
+                    time_var = 2.0f * (millimeters - accelerate_until) / (current_speed + maximum_speed);
+                }
+                // End of acceleration ramp.
+                // Acceleration-cruise, acceleration-deceleration ramp junction, or end of block.
+                mm_remaining  = accelerate_until;  // NOTE: 0.0 at EOB
+                current_speed = maximum_speed;
+                if (mm_remaining == decelerate_after) {
+                    ramp_type = RAMP_DECEL;
+                    start_ramp(decelerate_after, mm_complete, exit_speed, acceleration);
+                } else {
+                    ramp_type = RAMP_CRUISE;
+                }
+                break;
+            case RAMP_CRUISE:
+                // NOTE: mm_var used to retain the last mm_remaining for incomplete segment time_var calculations.
+                // NOTE: If maximum_speed*time_var value is too low, round-off can cause mm_var to not change. To
+                //   prevent this, simply enforce a minimum speed threshold in the planner.
+                mm_var = mm_remaining - maximum_speed * time_var;
+                if (mm_var < decelerate_after) {  // End of cruise.
+                    // Cruise-deceleration junction or end of block.
+                    time_var     = (mm_remaining - decelerate_after) / maximum_speed;
+                    mm_remaining = decelerate_after;  // NOTE: 0.0 at EOB
+                    ramp_type    = RAMP_DECEL;
+                    start_ramp(decelerate_after, mm_complete, exit_speed, acceleration);
+                } else {  // Cruising only.
+                    mm_remaining = mm_var;
+                }
+                break;
+            default:  // case RAMP_DECEL:
+                if (ramp.tj > 0.0f) {
+                    if (!advance_ramp(time_var, mm_remaining)) {
+                        break;  // Mid S-curve deceleration.
+                    }
+                    mm_remaining  = mm_complete;
+                    current_speed = exit_speed;
+                    break;
+                }
+                // NOTE: mm_var used as a misc worker variable to prevent errors when near zero speed.
+                speed_var = acceleration * time_var;  // Used as delta speed (mm/min)
+                if (current_speed > speed_var) {      // Check if at or below zero speed.
+                    // Compute distance from end of segment to end of block.
+                    mm_var = mm_remaining - time_var * (current_speed - 0.5f * speed_var);  // (mm)
+                    if (mm_var > mm_complete) {                                             // Typical case. In deceleration ramp.
+                        mm_remaining = mm_var;
+                        current_speed -= speed_var;
+                        break;  // Segment complete. Exit switch-case statement. Continue do-while loop.
+                    }
+                }
+                // Otherwise, at end of block or end of forced-deceleration.
+                time_var      = 2.0f * (mm_remaining - mm_complete) / (current_speed + exit_speed);
+                mm_remaining  = mm_complete;
+                current_speed = exit_speed;
+        }
+
+        dt += time_var;  // Add computed ramp time to total segment time.
+        if (dt < dt_max) {
+            time_var = dt_max - dt;  // **Incomplete** At ramp junction.
+        } else {
+            if (mm_remaining > minimum_mm) {  // Check for very slow segments with zero steps.
+                // Increase segment time to ensure at least one step in segment. Override and loop
+                // through distance calculations until minimum_mm or mm_complete.
+                dt_max += dt_segment;
+                time_var = dt_max - dt;
+            } else {
+                break;  // **Complete** Exit loop. Segment execution time maxed.
+            }
+        }
+    } while (mm_remaining > mm_complete);  // **Complete** Exit loop. Profile complete.
+
+    return dt;
+}
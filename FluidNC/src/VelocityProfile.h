@@ -0,0 +1,56 @@
+// Copyright (c) 2026 - FluidNC Contributors
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#pragma once
+
+// The velocity profile that the segment generator follows through the planner
+// block that it is prepping, and the tracing of that profile into segments.
+//
+// Distances are measured back from the end of the block, as the planner block's
+// millimeters counts down, and speeds are in mm/min.  This file does not depend
+// on the planner or the stepper, so the profiles can be tested on the host.
+
+#include "SCurve.h"
+
+#include <cstdint>
+
+const int RAMP_ACCEL          = 0;
+const int RAMP_CRUISE         = 1;
+const int RAMP_DECEL          = 2;
+const int RAMP_DECEL_OVERRIDE = 3;
+
+struct VelocityProfile {
+    uint8_t ramp_type;    // Current segment ramp state
+    float   mm_complete;  // End of velocity profile from end of current planner block in (mm).
+    // NOTE: This value must coincide with a step(no mantissa) when converted.
+    float current_speed;     // Current speed at the end of the segment buffer (mm/min)
+    float maximum_speed;     // Maximum speed of executing block. Not always nominal speed. (mm/min)
+    float exit_speed;        // Exit speed of executing block (mm/min)
+    float accelerate_until;  // Acceleration ramp end measured from end of block (mm)
+    float decelerate_after;  // Deceleration ramp start measured from end of block (mm)
+
+    SCurve::Ramp ramp;           // Jerk-limited shape of the current ramp; linear if ramp.tj is 0
+    float        ramp_time;      // Time since the start of the current ramp (min)
+    float        ramp_start_mm;  // Start of the current ramp measured from end of block (mm)
+    float        max_jerk;       // Jerk limit of the ramps (mm/min^3); 0 for linear ramps
+
+    // Computes the profile of a feed hold in progress, which decelerates to zero
+    // speed, from the block's remaining millimeters and entry speed.
+    void plan_hold(float millimeters, float acceleration, float entry_speed_sqr);
+
+    // Computes or recomputes the profile of the block from its remaining millimeters,
+    // entry, exit and nominal speeds.  Returns true if the block can only decelerate
+    // and its exit speed is higher than planned, in which case the next block must
+    // be loaded as a deceleration override.
+    bool plan(float millimeters, float acceleration, float entry_speed_sqr, float exit_speed_sqr, float nominal_speed);
+
+    // Advances along the profile by a segment of dt_segment minutes, longer if that
+    // does not reach req_mm_increment, or shorter at the end of the profile.  Sets
+    // mm_remaining to the distance from the end of the block after the segment and
+    // returns the segment time.
+    float next_segment(float millimeters, float acceleration, float req_mm_increment, float dt_segment, float& mm_remaining);
+
+private:
+    void start_ramp(float start_mm, float end_mm, float end_speed, float acceleration);
+    bool advance_ramp(float& time_var, float& mm_remaining);
+};
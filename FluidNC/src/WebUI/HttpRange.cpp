@@ -0,0 +1,126 @@
+// Copyright (c) 2026 - FluidNC Contributors
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#include "HttpRange.h"
+
+#include <cctype>
+#include <cstdint>
+
+namespace WebUI {
+    static void skip_spaces(std::string_view& s) {
+        while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) {
+            s.remove_prefix(1);
+        }
+    }
+
+    static bool skip_prefix(std::string_view& s, std::string_view prefix) {
+        if (s.length() < prefix.length()) {
+            return false;
+        }
+        for (size_t i = 0; i < prefix.length(); i++) {
+            if (tolower(s[i]) != prefix[i]) {
+                return false;
+            }
+        }
+        s.remove_prefix(prefix.length());
+        return true;
+    }
+
+    // Reads a decimal number, failing if there is none or it overflows
+    static bool read_number(std::string_view& s, size_t& value) {
+        if (s.empty() || s.front() < '0' || s.front() > '9') {
+            return false;
+        }
+        value = 0;
+        while (!s.empty() && s.front() >= '0' && s.front() <= '9') {
+            size_t digit = s.front() - '0';
+            if (value > (SIZE_MAX - digit) / 10) {
+                return false;
+            }
+            value = value * 10 + digit;
+            s.remove_prefix(1);
+        }
+        return true;
+    }
+
+    RangeResult parse_range(std::string_view header, size_t size, size_t& first, size_t& last) {
+        skip_spaces(header);
+        if (!skip_prefix(header, "bytes")) {
+            return RangeResult::None;
+        }
+        skip_spaces(header);
+        if (header.empty() || header.front() != '=') {
+            return RangeResult::None;
+        }
+        header.remove_prefix(1);
+        skip_spaces(header);
+
+        size_t start;
+        size_t end       = SIZE_MAX;
+        bool   has_start = read_number(header, start);
+        if (header.empty() || header.front() != '-') {
+            return RangeResult::None;
+        }
+        header.remove_prefix(1);
+        bool has_end = read_number(header, end);
+        skip_spaces(header);
+        if (!header.empty() || (!has_start && !has_end) || (has_start && has_end && end < start)) {
+            // Several ranges, or not a valid range
+            return RangeResult::None;
+        }
+
+        if (!has_start) {
+            // A suffix range, the last end bytes
+            if (end == 0 || size == 0) {
+                return RangeResult::Unsatisfiable;
+            }
+            first = end < size ? size - end : 0;
+            last  = size - 1;
+            return RangeResult::Partial;
+        }
+        if (start >= size) {
+            return RangeResult::Unsatisfiable;
+        }
+        first = start;
+        last  = end < size ? end : size - 1;
+        return RangeResult::Partial;
+    }
+
+    bool if_range_matches(std::string_view header, std::string_view etag) {
+        skip_spaces(header);
+        while (!header.empty() && header.back() == ' ') {
+            header.remove_suffix(1);
+        }
+        return !etag.empty() && header == etag;
+    }
+
+    bool parse_content_range(std::string_view header, size_t& first, size_t& last, size_t& total) {
+        skip_spaces(header);
+        if (!skip_prefix(header, "bytes") || header.empty() || header.front() != ' ') {
+            return false;
+        }
+        skip_spaces(header);
+        if (!read_number(header, first) || header.empty() || header.front() != '-') {
+            return false;
+        }
+        header.remove_prefix(1);
+        if (!read_number(header, last) || last < first || header.empty() || header.front() != '/') {
+            return false;
+        }
+        header.remove_prefix(1);
+        if (!header.empty() && header.front() == '*') {
+            header.remove_prefix(1);
+            total = SIZE_MAX;
+        } else if (!read_number(header, total) || last >= total) {
+            return false;
+        }
+        skip_spaces(header);
+        return header.empty();
+    }
+
+    std::string content_range(size_t first, size_t last, size_t size) {
+        return "bytes " + std::to_string(first) + "-" + std::to_string(last) + "/" + std::to_string(size);
+    }
+
+    std::string unsatisfied_range(size_t size) { return "bytes */" + std::to_string(size); }
+}
@@ -0,0 +1,42 @@
+// Copyright (c) 2026 - FluidNC Contributors
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#pragma once
+
+// Byte ranges (RFC 7233) let a client fetch part of a file, to resume an
+// interrupted download or to preview the start of a job, and let WebDAV
+// clients resume an interrupted upload with a PUT that has a Content-Range.
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace WebUI {
+    enum class RangeResult {
+        None,           // Send the whole file
+        Partial,        // Send the range first..last with status 206
+        Unsatisfiable,  // Send status 416
+    };
+
+    // Parses the Range header of a GET for a file of the given size.  Only a
+    // single range is supported; as RFC 7233 allows, a header with several
+    // ranges, or one that cannot be parsed, is ignored and the whole file is sent.
+    RangeResult parse_range(std::string_view header, size_t size, size_t& first, size_t& last);
+
+    // True if the If-Range header of a Range request names the current
+    // version of the file, so the range can be sent.  Otherwise the whole
+    // file must be sent.  The file's entity tag must match exactly; a weak
+    // tag never matches, and neither does a date, since no Last-Modified
+    // header is sent.
+    bool if_range_matches(std::string_view header, std::string_view etag);
+
+    // Parses a Content-Range header of the form "bytes first-last/total", where
+    // total can be "*" if it is not known, in which case it is set to SIZE_MAX.
+    bool parse_content_range(std::string_view header, size_t& first, size_t& last, size_t& total);
+
+    // The Content-Range value for a partial response
+    std::string content_range(size_t first, size_t last, size_t size);
+
+    // The Content-Range value for a 416 response
+    std::string unsatisfied_range(size_t size);
+}
@@ -0,0 +1,200 @@
+// Copyright (c) 2026 - FluidNC Contributors
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#include "IoThrottle.h"
+
+#include "WebUIServer.h"  // http_block_during_motion, http_motion_rate
+#include "Config.h"
+#include "FileStream.h"
+#include "Stepper.h"
+#include "Stepping.h"
+#include "System.h"  // inMotionState()
+#include "TokenBucket.h"
+
+#include <AsyncTCP.h>
+#include <algorithm>
+
+namespace WebUI {
+    // Downloads take from the bucket in the network task and kept upload
+    // data is written in the poller task, so both hold io_mutex
+    static SemaphoreHandle_t io_mutex = xSemaphoreCreateMutex();
+
+    static TokenBucket                   bucket;
+    static bool                          throttling = false;  // True while motion continues
+    static uint32_t                      last_underruns;
+    static bool                          waiting = false;  // True from a refused take until the next granted one
+    static uint32_t                      wait_start;
+    static std::vector<ThrottledWriter*> writers;  // Those that have kept data
+
+    // Statistics, since startup
+    static uint32_t throttled_bytes;
+    static uint32_t throttle_wait_ms;
+    static uint32_t io_underruns;
+
+    static bool throttled() { return http_block_during_motion->get() && inMotionState(); }
+
+    bool file_io_allowed() { return !throttled() || http_motion_rate->get(); }
+
+    bool file_io_throttled() { return throttled() && http_motion_rate->get(); }
+
+    // Must be called with io_mutex held
+    static size_t take(size_t want) {
+        if (!file_io_throttled()) {
+            throttling = false;
+            waiting    = false;
+            return want;
+        }
+
+        uint32_t now = get_ms();
+        if (!throttling) {
+            // Each motion starts at the configured rate
+            uint32_t rate = http_motion_rate->get() * 1024;
+            bucket.set_rate(rate, HTTP_MOTION_IO_CHUNK * HTTP_MOTION_IO_BURST, now);
+            last_underruns = Stepper::stats.underruns;
+            throttling     = true;
+        } else if (Stepper::stats.underruns != last_underruns) {
+            io_underruns += Stepper::stats.underruns - last_underruns;
+            last_underruns = Stepper::stats.underruns;
+            bucket.set_rate(std::max(bucket.rate() / 2, uint32_t(HTTP_MOTION_IO_CHUNK)), HTTP_MOTION_IO_CHUNK, now);
+        }
+
+        size_t   chunk     = std::min(want, size_t(HTTP_MOTION_IO_CHUNK));
+        uint32_t low_water = uint32_t(Machine::Stepping::_segments) / 2;
+        if (Stepper::segments_queued() < low_water || !bucket.take(chunk, now)) {
+            if (!waiting) {
+                waiting    = true;
+                wait_start = now;
+            }
+            return 0;
+        }
+        if (waiting) {
+            throttle_wait_ms += now - wait_start;
+            waiting = false;
+        }
+        throttled_bytes += chunk;
+        return chunk;
+    }
+
+    size_t throttle_io(size_t want) {
+        xSemaphoreTake(io_mutex, portMAX_DELAY);
+        size_t allowed = take(want);
+        xSemaphoreGive(io_mutex);
+        return allowed;
+    }
+
+    bool ThrottledWriter::write(AsyncClient* client, FileStream* file, const uint8_t* data, size_t len) {
+        xSemaphoreTake(io_mutex, portMAX_DELAY);
+        _client = client;
+        _file   = file;
+
+        // Nothing can be written ahead of data that is already kept
+        size_t done = 0;
+        while (_kept.empty() && !_failed && done < len) {
+            size_t chunk = take(len - done);
+            if (!chunk) {
+                break;
+            }
+            if (_file->write(data + done, chunk) != chunk) {
+                _failed = true;
+            }
+            done += chunk;
+        }
+        if (!_failed && done < len) {
+            if (_kept.empty()) {
+                writers.push_back(this);
+            }
+            _kept.insert(_kept.end(), data + done, data + len);
+            _client->ackLater();
+            _holding = true;
+        }
+
+        bool ok = !_failed;
+        xSemaphoreGive(io_mutex);
+        return ok;
+    }
+
+    // Writes kept data, as much as the throttle allows or all of it.  Must
+    // be called with io_mutex held.  Returns true when nothing is kept.
+    bool ThrottledWriter::drain(bool all) {
+        size_t done = 0;
+        while (!_failed && done < _kept.size()) {
+            size_t want  = _kept.size() - done;
+            size_t chunk = all ? want : take(want);
+            if (!chunk) {
+                break;
+            }
+            if (_file->write(_kept.data() + done, chunk) != chunk) {
+                _failed = true;
+            }
+            done += chunk;
+        }
+        if (_failed) {
+            _kept.clear();
+        } else {
+            _kept.erase(_kept.begin(), _kept.begin() + done);
+        }
+        if (_kept.empty()) {
+            release();
+        }
+        return _kept.empty();
+    }
+
+    // Lets the client send again.  Must be called with io_mutex held.
+    void ThrottledWriter::release() {
+        if (_holding && _client) {
+            _client->ack(SIZE_MAX);  // Everything that was held back
+        }
+        _holding = false;
+    }
+
+    bool ThrottledWriter::finish() {
+        xSemaphoreTake(io_mutex, portMAX_DELAY);
+        if (!_kept.empty()) {
+            drain(true);
+            writers.erase(std::remove(writers.begin(), writers.end(), this), writers.end());
+        }
+        bool ok = !_failed;
+        _failed = false;
+        _client = nullptr;
+        _file   = nullptr;
+        xSemaphoreGive(io_mutex);
+        return ok;
+    }
+
+    void ThrottledWriter::cancel(AsyncClient* client) {
+        xSemaphoreTake(io_mutex, portMAX_DELAY);
+        if (!client || client == _client) {
+            _kept.clear();
+            writers.erase(std::remove(writers.begin(), writers.end(), this), writers.end());
+            _holding = false;
+            _failed  = false;
+            _client  = nullptr;
+            _file    = nullptr;
+        }
+        xSemaphoreGive(io_mutex);
+    }
+
+    void poll_io() {
+        xSemaphoreTake(io_mutex, portMAX_DELAY);
+        for (auto it = writers.begin(); it != writers.end();) {
+            if ((*it)->drain(false)) {
+                it = writers.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        xSemaphoreGive(io_mutex);
+    }
+
+    void report_io_stats(Channel& out) {
+        log_stream(out,
+                   "HTTP I/O during motion: " << throttled_bytes << " bytes, " << throttle_wait_ms << " ms throttled, underruns "
+                                              << io_underruns);
+    }
+
+    void report_io_stats(JSONencoder& j) {
+        j.id_value_object("HTTP I/O during motion", int32_t(throttled_bytes));
+        j.id_value_object("HTTP I/O throttled ms", int32_t(throttle_wait_ms));
+        j.id_value_object("HTTP I/O underruns", int32_t(io_underruns));
+    }
+}
@@ -0,0 +1,88 @@
+// Copyright (c) 2026 - FluidNC Contributors
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#pragma once
+
+// Reading and writing flash for HTTP requests can take the support core away
+// from step segment preparation for long enough to starve the stepping, so by
+// default files cannot be served during motion.  If HTTP/MotionRate is set,
+// file transfers are allowed during motion instead, but each one goes through
+// throttle_io(), which limits the combined rate of transfers with a token
+// bucket, splits them into small pieces, and holds them back while the step
+// segment buffer is less than half full.  Underruns of the segment buffer
+// that happen while transfers are being throttled are counted and reported
+// with the system stats, and each one halves the rate for the rest of the
+// motion.
+//
+// The transfers run in the network task, which must never wait for the
+// throttle, lest it stop handling the WebSocket realtime commands.  Downloads
+// that get no bytes from throttle_io() ask the web server to try again later,
+// and uploads go through a ThrottledWriter, which keeps what it cannot write
+// now and writes it from poll_io() in the poller task.
+
+#include "Channel.h"
+#include "JSONEncoder.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class AsyncClient;
+class FileStream;
+
+namespace WebUI {
+    // True if file transfers are allowed now, which is when the machine
+    // is not moving or when transfers during motion are throttled
+    bool file_io_allowed();
+
+    // True if file transfers are being throttled now, in which case
+    // needless flash access, like hashing files, should be avoided
+    bool file_io_throttled();
+
+    // Returns how many of the want bytes of a file transfer the caller may
+    // read or write now.  If the machine is not moving, that is all of them.
+    // It never waits; 0 means that the caller must try again later.
+    size_t throttle_io(size_t want);
+
+    // Writes upload data to a file at the rate that throttle_io() allows.
+    // What cannot be written now is kept, and the TCP acknowledgement of
+    // the data from the client is held back so that its receive window
+    // closes and it stops sending until poll_io() has written what was kept.
+    class ThrottledWriter {
+    public:
+        ThrottledWriter() = default;
+        ThrottledWriter(const ThrottledWriter&) = delete;
+        ThrottledWriter& operator=(const ThrottledWriter&) = delete;
+        ~ThrottledWriter() { cancel(); }
+
+        // Returns false if a write to the file has failed
+        bool write(AsyncClient* client, FileStream* file, const uint8_t* data, size_t len);
+
+        // Writes whatever is still kept at once, since the client has sent
+        // everything.  It is at most one TCP window.  Returns false if a
+        // write to the file has failed.
+        bool finish();
+
+        // Drops whatever is kept, which must be done before the file is
+        // closed.  If client is given, only if the data came from it.
+        void cancel(AsyncClient* client = nullptr);
+
+    private:
+        friend void poll_io();
+
+        bool drain(bool all);
+        void release();
+
+        AsyncClient*         _client  = nullptr;
+        FileStream*          _file    = nullptr;
+        std::vector<uint8_t> _kept;
+        bool                 _holding = false;  // True while TCP acknowledgements are held back
+        bool                 _failed  = false;
+    };
+
+    // Writes data kept by ThrottledWriters as the throttle allows
+    void poll_io();
+
+    void report_io_stats(Channel& out);
+    void report_io_stats(JSONencoder& j);
+}
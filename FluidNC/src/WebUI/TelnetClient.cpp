@@ -193,6 +193,16 @@ namespace WebUI {
         return length;
     }
 
+    // Telemetry frames are queued as they are, without the \n to \r\n translation
+    // that write() applies to text.  A frame that does not fit is dropped.
+    void TelnetClient::print_frame(const uint8_t* frame, size_t length) {
+        if (_state == -1 || _disconnected.load()) {
+            return;
+        }
+        queueLine(frame, length, TX_CRITICAL_RESERVE);
+        flushQueue();
+    }
+
     int TelnetClient::peek(void) {
         if (_disconnected.load()) {
             return -1;
@@ -76,6 +76,8 @@ namespace WebUI {
         int    rx_buffer_available() override;
         size_t write(uint8_t data) override;
         size_t write(const uint8_t* buffer, size_t size) override;
+        void   print_frame(const uint8_t* frame, size_t length) override;
+        bool   binaryReportsOkay() override { return true; }
         int    read(void) override;
         int    peek(void) override;
         int    available() override;
@@ -205,6 +205,29 @@ namespace WebUI {
         Channel::autoReport();
     }
 
+    // Each telemetry frame goes out as a WebSocket message of its own.  The
+    // client must be reading frames at the report rate, so if it has fallen
+    // behind the frame is dropped; the sequence number tells it what it missed.
+    void WSChannel::print_frame(const uint8_t* frame, size_t length) {
+        if (!_active) {
+            return;
+        }
+        auto client = get_client(_server, _clientNum);
+        if (!client) {
+            _active = false;
+            return;
+        }
+        if (client->queueIsFull()) {
+            return;
+        }
+        try {
+            _server->binary(_clientNum, frame, length);
+        } catch (...) {
+            client->close();
+            _active = false;
+        }
+    }
+
     WSChannel::~WSChannel() {}
 
     std::vector<WSChannel*> WSChannels::_wsChannels;
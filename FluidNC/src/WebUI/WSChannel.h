@@ -25,7 +25,6 @@ namespace WebUI {
 
         objnum_t id() { return _clientNum; }
 
-        int      rx_buffer_available() override { return std::max(0, 256 - int(queued_bytes())); }
         uint32_t clientNum() { return _clientNum; };
 
         operator bool() const;
@@ -36,6 +35,8 @@ namespace WebUI {
         int available() override { return queued_bytes() + (_rtchar > -1); }
 
         void        autoReport() override;
+        void        print_frame(const uint8_t* frame, size_t length) override;
+        bool        binaryReportsOkay() override { return true; }
         void        active(bool is_active);
         std::string session() { return _session; };
 
@@ -230,6 +230,10 @@ namespace WebUI {
     void WebClient::sendLine(MsgLevel level, const std::string& line) {
         print_msg(level, line.c_str());
     }
+    void WebClient::sendPooledLine(MsgLevel level, char* line) {
+        print_msg(level, line);
+        message_buffer_release(line);
+    }
 
     void WebClient::out(const char* s, const char* tag) {
         write((uint8_t*)s, strlen(s));
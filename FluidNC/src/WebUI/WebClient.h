@@ -34,6 +34,7 @@ namespace WebUI {
         void sendLine(MsgLevel level, const char* line) override;
         void sendLine(MsgLevel level, const std::string* line) override;
         void sendLine(MsgLevel level, const std::string& line) override;
+        void sendPooledLine(MsgLevel level, char* line) override;
 
         void sendError(uint16_t code, const std::string& line);
 
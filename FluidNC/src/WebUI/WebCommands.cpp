@@ -13,6 +13,7 @@
 #include "Configuration/JsonGenerator.h"
 #include "Report.h"  // git_info
 #include "Driver/SysStats.h"
+#include "Stepper.h"
 #include "Module.h"
 
 namespace WebUI {
@@ -72,6 +73,7 @@ namespace WebUI {
             j.begin_array("data");
 
             platform_sys_stats(j);
+            Stepper::report_stats(j);
 
             for (auto const& module : ModuleFactory::objects()) {
                 module->wifi_stats(j);
@@ -101,6 +103,7 @@ namespace WebUI {
             }
 
             platform_sys_stats(out);
+            Stepper::report_stats(out);
 
             for (auto const& module : Modules()) {
                 module->build_info(out);
@@ -15,10 +15,13 @@
 #include "WebDAV.h"
 #include "FileStream.h"
 #include "HashFS.h"
+#include "IoThrottle.h"
+#include "HttpRange.h"
 
 #include "Mime.h"
 
 using namespace asyncsrv;
+using WebUI::RangeResult;
 
 WebDAV::WebDAV(const std::string_view url, const Volume& volume, bool reject_metadata) :
     _url(url), _volume(volume), _reject_metadata(reject_metadata) {}
@@ -346,9 +349,11 @@ void WebDAV::handleRequest(AsyncWebServerRequest* request) {
     if (state) {
         if (state->outFile) {
             // The file was already opened and written in handleBody so
-            // we are done.  We will handle PUT without body data below.
+            // we are done, once the writes that were held back during
+            // motion are finished.  We will handle PUT without body data below.
+            bool written = state->writer.finish();
             delete state->outFile;
-            request->send(201);  // Created
+            request->send(written ? 201 : 500);  // Created, or the write failed
         }
         // If state was non-null but state->outFile was null, handleBody
         // rejected the operation and already sent the response code.
@@ -444,6 +449,18 @@ void WebDAV::handleBody(AsyncWebServerRequest* request, unsigned char* data, siz
         if (index == 0 && state == nullptr) {
             state                = new RequestState { nullptr };
             request->_tempObject = static_cast<void*>(state);
+
+            // If the client goes away during the upload, handleRequest
+            // will not be called, so the file must be closed here
+            request->onDisconnect([request]() {
+                auto state = static_cast<RequestState*>(request->_tempObject);
+                if (state) {
+                    state->writer.cancel();
+                    delete state->outFile;
+                    delete state;
+                    request->_tempObject = nullptr;
+                }
+            });
         }
         if (state->outFile == nullptr) {
             // parse the url to a proper path
@@ -475,20 +492,42 @@ void WebDAV::handleBody(AsyncWebServerRequest* request, unsigned char* data, siz
                 return request->send(403);
             }
 
+            // A PUT with a Content-Range resumes an interrupted upload by
+            // appending to the part that was already received.  It must
+            // start where the file ends; if not, the 416 reply tells the
+            // client the current size so it can resume from there.
+            const char* mode = "w";
+            if (request->hasHeader("Content-Range")) {
+                size_t first, last, whole;
+                if (!WebUI::parse_content_range(request->getHeader("Content-Range")->value().c_str(), first, last, whole)) {
+                    return request->send(400);
+                }
+                if (first) {
+                    auto existing = stdfs::file_size(fpath, ec);
+                    if (ec || existing != first) {
+                        AsyncWebServerResponse* response = request->beginResponse(416);
+                        response->addHeader("Content-Range", WebUI::unsatisfied_range(ec ? 0 : existing).c_str());
+                        return request->send(response);
+                    }
+                    mode = "a";
+                }
+            }
+
             // If we ever handle LOCK properly, we might need
             // to open for appending instead of recreating the
             // file if it already exists.
             try {
-                state->outFile = new FileStream(fpath, "w", LocalFS);
+                state->outFile = new FileStream(fpath, mode, LocalFS);
             } catch (const ErrorException& err) {
                 log_debug(fpath << " cannot be opened");
                 return request->send(500);
             }
         }
         if (state && state->outFile) {
-            auto actual = state->outFile->write(data, len);
-            if (actual != len) {
+            // During motion, what cannot be written now is written later from WebUI::poll_io()
+            if (!state->writer.write(request->client(), state->outFile, data, len)) {
                 log_debug("WebDAV write failed.  Deleting file.");
+                state->writer.cancel();
                 delete state->outFile;  // Closes file
                 state->outFile = nullptr;
 
@@ -614,15 +653,42 @@ void WebDAV::handleGet(const FluidPath& fpath, DavResource resource, AsyncWebSer
         return;
     }
 
+    // A Range request gets only part of the file.  Either way, the file is
+    // read a buffer at a time as the connection can take it, so memory use
+    // does not depend on the file size.  No ETag is sent, so the whole file
+    // is sent if the range is conditional on an If-Range.
+    size_t      size  = file->size();
+    size_t      first = 0;
+    size_t      last  = size - 1;
+    RangeResult range = RangeResult::None;
+    if (request->hasHeader("Range") && !request->hasHeader("If-Range")) {
+        range = WebUI::parse_range(request->getHeader("Range")->value().c_str(), size, first, last);
+    }
+    if (range == RangeResult::Unsatisfiable) {
+        delete file;
+        AsyncWebServerResponse* response = request->beginResponse(416);
+        response->addHeader("Content-Range", WebUI::unsatisfied_range(size).c_str());
+        request->send(response);
+        return;
+    }
+    size_t length = range == RangeResult::Partial ? last - first + 1 : size;
+    if (first) {
+        file->set_position(first);
+    }
+
     AsyncWebServerResponse* response = request->beginResponse(
-        getContentType(fpath.c_str()), file->size(), [file, request](uint8_t* buffer, size_t maxLen, size_t filled) mutable -> size_t {
+        getContentType(fpath.c_str()), length, [file, request, length](uint8_t* buffer, size_t maxLen, size_t filled) mutable -> size_t {
             if (!file) {
                 request->client()->close();
                 return 0;  //RESPONSE_TRY_AGAIN; // This only works for ChunkedResponse
             }
             int actual = 0;
-            if (maxLen) {
-                actual = file->read(buffer, maxLen);  // return 0 even when no bytes were loaded
+            if (maxLen && filled < length) {
+                size_t want = WebUI::throttle_io(std::min(maxLen, length - filled));
+                if (want == 0) {
+                    return RESPONSE_TRY_AGAIN;  // Throttled during motion
+                }
+                actual = file->read(buffer, want);  // return 0 even when no bytes were loaded
             }
             if (actual == 0) {
                 file = nullptr;
@@ -630,6 +696,11 @@ void WebDAV::handleGet(const FluidPath& fpath, DavResource resource, AsyncWebSer
             return actual;
         });
 
+    if (range == RangeResult::Partial) {
+        response->setCode(206);
+        response->addHeader("Content-Range", WebUI::content_range(first, last, size).c_str());
+    }
+    response->addHeader("Accept-Ranges", "bytes");
     if (isGzip) {
         response->addHeader(T_Content_Encoding, T_gzip, false);
     }
@@ -4,9 +4,11 @@
 #include "FluidPath.h"
 #include "JSONEncoder.h"
 #include "FileStream.h"
+#include "IoThrottle.h"
 
 struct RequestState {
-    FileStream* outFile;
+    FileStream*            outFile;
+    WebUI::ThrottledWriter writer;  // Writes to outFile, throttled during motion
 };
 
 class WebDAV : public AsyncWebHandler {
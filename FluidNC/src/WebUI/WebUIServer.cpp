@@ -31,6 +31,8 @@
 #include "JSONEncoder.h"
 
 #include "HashFS.h"
+#include "IoThrottle.h"
+#include "HttpRange.h"
 #include <cstdio>
 #include <list>
 #include <algorithm>
@@ -260,11 +262,13 @@ namespace WebUI {
     uint8_t           WebUI_Server::_nb_ip = 0;
     const int         MAX_AUTH_IP          = 10;
 #endif
-    FileStream* WebUI_Server::_uploadFile = nullptr;
-    std::string WebUI_Server::_uploadPath = "";  // Store upload directory path for listing
+    FileStream*     WebUI_Server::_uploadFile = nullptr;
+    ThrottledWriter WebUI_Server::_upload_writer;
+    std::string     WebUI_Server::_uploadPath = "";  // Store upload directory path for listing
 
     EnumSetting *http_enable, *http_block_during_motion;
     IntSetting*  http_port;
+    IntSetting*  http_motion_rate;
 
     WebUI_Server::~WebUI_Server() {
         deinit();
@@ -280,6 +284,15 @@ namespace WebUI {
                                                    "HTTP/BlockDuringMotion",
                                                    DEFAULT_HTTP_BLOCKED_DURING_MOTION,
                                                    &onoffOptions);
+        // KiB/s for file transfers during motion when they would otherwise be blocked; 0 blocks them
+        http_motion_rate = new IntSetting("HTTP transfer rate during motion",
+                                          WEBSET,
+                                          WA,
+                                          NULL,
+                                          "HTTP/MotionRate",
+                                          DEFAULT_HTTP_MOTION_RATE,
+                                          MIN_HTTP_MOTION_RATE,
+                                          MAX_HTTP_MOTION_RATE);
 
         _setupdone = false;
 
@@ -298,6 +311,9 @@ namespace WebUI {
         _headerFilter->keep("Accept-Encoding");
         _headerFilter->keep("Cookie");
         _headerFilter->keep("If-None-Match");
+        _headerFilter->keep("If-Range");
+        _headerFilter->keep("Range");
+        _headerFilter->keep("Content-Range");
         _headerFilter->keep("User-Agent");
 
         //For websockets we need to keep these headers, otherwise this wouldn't work!
@@ -396,6 +412,16 @@ namespace WebUI {
         _setupdone = true;
     }
 
+    void WebUI_Server::build_info(Channel& out) {
+        if (http_motion_rate->get()) {
+            report_io_stats(out);
+        }
+    }
+
+    void WebUI_Server::wifi_stats(JSONencoder& j) {
+        report_io_stats(j);
+    }
+
     void WebUI_Server::deinit() {
         _setupdone = false;
 
@@ -496,7 +522,9 @@ namespace WebUI {
         // integrity.
         // This can make it hard to debug ISR IRAM problems, because the easiest
         // way to trigger such problems is to refresh WebUI during motion.
-        if (http_block_during_motion->get() && inMotionState()) {
+        // If HTTP/MotionRate is set, files are served during motion instead,
+        // but at a limited rate.
+        if (!file_io_allowed()) {
             // Check to see if we have a cached hash of the file that can be retrieved without accessing FLASH
             hash = HashFS::hash(fpath, true);
             if (!hash.length() && acceptGz) {
@@ -515,12 +543,14 @@ namespace WebUI {
             return true;
         }
 
-        // Check for browser cache match
-        hash = HashFS::hash(fpath);
+        // Check for browser cache match.  During motion, only cached hashes
+        // are used, since computing one reads the whole file at full speed.
+        bool cacheOnly = file_io_throttled();
+        hash           = HashFS::hash(fpath, cacheOnly);
         if (!hash.length() && acceptGz) {
             std::filesystem::path gzpath(fpath);
             gzpath += ".gz";
-            hash = HashFS::hash(gzpath);
+            hash = HashFS::hash(gzpath, cacheOnly);
         }
         if (hash.length() && request->hasHeader("If-None-Match") &&
             std::string(request->getHeader("If-None-Match")->value().c_str()) == hash) {
@@ -554,24 +584,57 @@ namespace WebUI {
             return false;
         }
 
+        // A Range request, for instance to resume a download, gets only part
+        // of the file, unless its If-Range shows that the client has an older
+        // version.  Either way, the file is read a buffer at a time as the
+        // connection can take it, so memory use does not depend on its size.
+        size_t      size  = file->size();
+        size_t      first = 0;
+        size_t      last  = size - 1;
+        RangeResult range = RangeResult::None;
+        if (request->hasHeader("Range") &&
+            (!request->hasHeader("If-Range") || if_range_matches(request->getHeader("If-Range")->value().c_str(), hash))) {
+            range = parse_range(request->getHeader("Range")->value().c_str(), size, first, last);
+        }
+        if (range == RangeResult::Unsatisfiable) {
+            delete file;
+            AsyncWebServerResponse* response = request->beginResponse(416);
+            response->addHeader("Content-Range", unsatisfied_range(size).c_str());
+            request->send(response);
+            return true;
+        }
+        size_t length = range == RangeResult::Partial ? last - first + 1 : size;
+        if (first) {
+            file->set_position(first);
+        }
+
         AsyncWebServerResponse* response = request->beginResponse(
-            getContentType(path), file->size(), [file, request](uint8_t* buffer, size_t maxLen, size_t total) mutable -> size_t {
+            getContentType(path), length, [file, request, length](uint8_t* buffer, size_t maxLen, size_t total) mutable -> size_t {
                 if (!file) {
                     request->client()->close();
                     return 0;  //RESPONSE_TRY_AGAIN; // This only works for ChunkedResponse
                 }
-                if (total >= file->size() || request->method() != HTTP_GET) {
+                if (total >= length || request->method() != HTTP_GET) {
                     file = nullptr;
                     return 0;
                 }
-                size_t bytes  = min(file->size() - total, maxLen);
-                int    actual = file->read(buffer, bytes);  // return 0 even when no bytes were loaded
-                if (actual == 0 || (actual + total) >= file->size()) {
+                size_t bytes = throttle_io(min(length - total, maxLen));
+                if (bytes == 0) {
+                    return RESPONSE_TRY_AGAIN;  // Throttled during motion
+                }
+                int actual = file->read(buffer, bytes);  // return 0 even when no bytes were loaded
+                if (actual == 0 || (actual + total) >= length) {
                     file = nullptr;
                 }
                 return actual;  // Return actual bytes read, not requested bytes
             });
 
+        if (range == RangeResult::Partial) {
+            response->setCode(206);
+            response->addHeader("Content-Range", content_range(first, last, size).c_str());
+        }
+        response->addHeader("Accept-Ranges", "bytes");
+
         request->onDisconnect([request, file]() { delete file; });
 
         if (setSession && getSessionCookie(request) == "") {
@@ -1035,7 +1098,11 @@ namespace WebUI {
             std::string sizeargname(filename.c_str());
             sizeargname += "S";
             size_t filesize = request->hasParam(sizeargname.c_str()) ? request->getParam(sizeargname.c_str())->value().toInt() : 0;
-            uploadStart(request, filename.c_str(), filesize, fs);
+            // An offset resumes an interrupted upload, and the data is the rest of the file from there
+            std::string offsetargname(filename.c_str());
+            offsetargname += "O";
+            size_t offset = request->hasParam(offsetargname.c_str()) ? request->getParam(offsetargname.c_str())->value().toInt() : 0;
+            uploadStart(request, filename.c_str(), filesize, offset, fs);
         }
         if (_upload_status == UploadStatus::ONGOING) {
             uploadWrite(request, data, len);
@@ -1316,7 +1383,7 @@ namespace WebUI {
     }
 
     // File upload
-    void WebUI_Server::uploadStart(AsyncWebServerRequest* request, const char* filename, size_t filesize, const Volume& fs) {
+    void WebUI_Server::uploadStart(AsyncWebServerRequest* request, const char* filename, size_t filesize, size_t offset, const Volume& fs) {
         std::error_code ec;
 
         FluidPath fpath { filename, fs, ec };
@@ -1347,11 +1414,23 @@ namespace WebUI {
             }
         }
 
+        // A resumed upload continues where the file ends
+        if (offset) {
+            auto existing_size = stdfs::file_size(fpath, ec);
+            if (ec || existing_size != offset) {
+                _upload_status = UploadStatus::FAILED;
+                log_info("Upload resume offset " << offset << " does not match the file size");
+                pushError(request, ESP_ERROR_UPLOAD, "Upload rejected, resume offset does not match the file size");
+                return;
+            }
+        }
+
         if (_upload_status != UploadStatus::FAILED) {
             //Create file for writing
             try {
-                _uploadFile    = new FileStream(fpath, "w");
+                _uploadFile    = new FileStream(fpath, offset ? "a" : "w");
                 _upload_status = UploadStatus::ONGOING;
+                request->onDisconnect([request]() { _upload_writer.cancel(request->client()); });
             } catch (const ErrorException& err) {
                 _uploadFile    = nullptr;
                 _upload_status = UploadStatus::FAILED;
@@ -1365,7 +1444,8 @@ namespace WebUI {
         delay_ms(1);
         if (_uploadFile && _upload_status == UploadStatus::ONGOING) {
             //no error write post data
-            if (length != _uploadFile->write(buffer, length)) {
+            // During motion, what cannot be written now is written later from poll()
+            if (!_upload_writer.write(request->client(), _uploadFile, buffer, length)) {
                 _upload_status = UploadStatus::FAILED;
                 log_info("Upload failed - file write failed");
                 pushError(request, ESP_ERROR_FILE_WRITE, "File write failed");
@@ -1383,6 +1463,12 @@ namespace WebUI {
             //            delete _uploadFile;
             // _uploadFile = nullptr;
 
+            if (!_upload_writer.finish()) {
+                _upload_status = UploadStatus::FAILED;
+                log_info("Upload failed - file write failed");
+                pushError(request, ESP_ERROR_FILE_WRITE, "File write failed");
+            }
+
             std::string pathname = _uploadFile->fpath();
             delete _uploadFile;
             _uploadFile = nullptr;
@@ -1422,6 +1508,7 @@ namespace WebUI {
         _uploadPath.clear();  // Clear stored upload path on failure
         if (_uploadFile) {
             log_info("Upload cancelled");
+            _upload_writer.cancel();
             std::filesystem::path filepath = _uploadFile->fpath();
             delete _uploadFile;
             _uploadFile = nullptr;
@@ -1433,6 +1520,7 @@ namespace WebUI {
         if (_upload_status == UploadStatus::FAILED) {
             cancelUpload(request);
             if (_uploadFile) {
+                _upload_writer.cancel();
                 std::filesystem::path filepath = _uploadFile->fpath();
                 delete _uploadFile;
                 _uploadFile = nullptr;
@@ -1462,6 +1550,8 @@ namespace WebUI {
             }
             start_time = millis();
         }
+        poll_io();
+        HashFS::poll();
     }
 
     //check authentication
@@ -4,6 +4,7 @@
 #pragma once
 
 #include "FileStream.h"
+#include "IoThrottle.h"  // ThrottledWriter
 
 #include "Settings.h"
 #include "Module.h"
@@ -24,6 +25,10 @@ namespace WebUI {
     static const int DEFAULT_HTTP_STATE                 = 1;
     static const int DEFAULT_HTTP_BLOCKED_DURING_MOTION = 1;
     static const int DEFAULT_HTTP_PORT                  = 80;
+    static const int DEFAULT_HTTP_MOTION_RATE           = 0;
+
+    static const int MIN_HTTP_MOTION_RATE = 0;
+    static const int MAX_HTTP_MOTION_RATE = 1024;
 
     static const int MIN_HTTP_PORT = 1;
     static const int MAX_HTTP_PORT = 65001;
@@ -32,6 +37,8 @@ namespace WebUI {
 
     extern EnumSetting* http_enable;
     extern IntSetting*  http_port;
+    extern EnumSetting* http_block_during_motion;
+    extern IntSetting*  http_motion_rate;
 
 #ifdef ENABLE_AUTHENTICATION
     struct AuthenticationIP {
@@ -57,6 +64,8 @@ namespace WebUI {
         void init() override;
         void deinit() override;
         void poll() override;
+        void build_info(Channel& out) override;
+        void wifi_stats(JSONencoder& j) override;
 
         static uint16_t port() { return _port; }
         static std::string getWebSocketSession(AsyncWebServerRequest* request, AsyncWebSocketClient* client = nullptr);
@@ -78,6 +87,8 @@ namespace WebUI {
         static bool         _schedule_reboot;
         static uint32_t     _schedule_reboot_time;
 
+        static ThrottledWriter _upload_writer;  // Writes to _uploadFile, throttled during motion
+
         static AuthenticationLevel is_authenticated();
 #ifdef ENABLE_AUTHENTICATION
         static AuthenticationIP*   _head;
@@ -116,7 +127,7 @@ namespace WebUI {
         static void fileUpload(
             AsyncWebServerRequest* request, const Volume& fs, String filename, size_t index, uint8_t* data, size_t len, bool final);
         static void SDFileUpload(AsyncWebServerRequest* request, String filename, size_t index, uint8_t* data, size_t len, bool final);
-        static void uploadStart(AsyncWebServerRequest* request, const char* filename, size_t filesize, const Volume& fs);
+        static void uploadStart(AsyncWebServerRequest* request, const char* filename, size_t filesize, size_t offset, const Volume& fs);
         static void uploadWrite(AsyncWebServerRequest* request, uint8_t* buffer, size_t length);
         static void uploadEnd(AsyncWebServerRequest* request, size_t filesize);
         static void uploadStop();
@@ -33,8 +33,20 @@
  */
 
 #include "xmodem.h"
+#include "Config.h"
+#include "HashFS.h"
 #include "Driver/watchdog.h"
 
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+
 static Channel*     serialPort;
 static FileStream*  file;
 
@@ -117,19 +129,15 @@ static void flushinput(void) {
         ;
 }
 
-// We delay writing each packet until the next one arrives
-// so that we can remove trailing control-Z's in only the
-// last one.  The Xmodem protocol has no good way to denote
-// the actual size of the file in bytes as opposed to packets.
-// Instead it pads the final packet with control-Z.  By removing
-// those trailing control-Z's before writing to the file, it
-// is possible to handle files of any length.  This heuristic
-// fails with binary files that are supposed to have trailing
-// control-Z's.  Doing the control-Z removal only on the final
-// packet avoids removing interior control-Z's that happen to
-// land at the end of a packet.
-static uint8_t held_packet[1024];
-static size_t  held_packet_len;
+static void cancel_transfer() {
+    flushinput();
+    _outbyte(CAN);
+    _outbyte(CAN);
+    _outbyte(CAN);
+}
+
+static TransferStats* stats;
+static uint32_t       startTime;
 
 // Xmodem has no way to announce the total upload size in advance, so we
 // can't check free space once up front. Instead, before every write we
@@ -139,56 +147,171 @@ static size_t  held_packet_len;
 // write that can't succeed. This is what protects against the crash in
 // https://github.com/bdring/FluidNC/issues/1788: uploading a file larger
 // than the free space on the (usually nearly-full) target filesystem.
+// Ymodem sends the size in its header, so the space is checked once then.
+static bool checkSpace;
+
 static bool writeChecked(const uint8_t* buf, size_t count) {
-    std::error_code ec;
-    auto            space = stdfs::space(file->fpath(), ec);
-    if (ec || space.available < count) {
-        return false;
+    if (checkSpace) {
+        std::error_code ec;
+        auto            space = stdfs::space(file->fpath(), ec);
+        if (ec || space.available < count) {
+            return false;
+        }
     }
     return file->write(buf, count) == count;
 }
 
-static bool flush_packet(size_t packet_len, size_t& total_len) {
-    if (held_packet_len > 0) {
-        // Remove trailing ctrl-z's on the final packet
-        size_t count;
-        for (count = held_packet_len; count > 0; --count) {
-            if (held_packet[count - 1] != CTRLZ) {
-                break;
-            }
+// Received packets are written to the file by a separate task, so the link
+// keeps receiving while the filesystem is busy erasing and programming
+// flash.  The receiver takes a buffer from a ring of XMODEM_WRITE_BUFFERS
+// packet buffers, reads a packet into it, and queues it for the writer,
+// which returns it to the ring once it is written.  The receiver waits only
+// when every buffer is waiting to be written.
+const size_t PACKET_BUFFER_SIZE = 1024 + 2;  // Data and CRC
+
+struct WriteRequest {
+    uint8_t* data;  // nullptr asks the writer to signal when it has caught up
+    size_t   len;
+};
+
+static QueueHandle_t     freeBuffers = nullptr;  // Buffers that the receiver can fill
+static QueueHandle_t     writeQueue  = nullptr;  // Buffers waiting to be written
+static SemaphoreHandle_t writerIdle  = nullptr;  // Given when the writer reaches a sync request
+static TaskHandle_t      writerTask  = nullptr;
+static uint8_t*          bufferPool  = nullptr;
+static volatile bool     writeFailed;
+
+static void writer_loop(void* unused) {
+    WriteRequest req;
+    while (true) {
+        if (xQueueReceive(writeQueue, &req, portMAX_DELAY) != pdTRUE) {
+            continue;
         }
-        if (!writeChecked(held_packet, count)) {
-            return false;
+        if (!req.data) {
+            xSemaphoreGive(writerIdle);
+            continue;
+        }
+        // After a failure the rest of the file is discarded, but the buffers
+        // still go back to the ring so the receiver can finish cleanly.
+        if (!writeFailed && !writeChecked(req.data, req.len)) {
+            writeFailed = true;
         }
-        total_len += count;
-        held_packet_len = 0;
+        xQueueSend(freeBuffers, &req.data, portMAX_DELAY);
     }
-    return true;
 }
-static bool write_packet(uint8_t* buf, size_t packet_len, size_t& total_len) {
-    if (held_packet_len > 0) {
-        if (!writeChecked(held_packet, held_packet_len)) {
-            return false;
-        }
-        total_len += held_packet_len;
-        held_packet_len = 0;
+
+static bool start_writer() {
+    if (!writerTask) {
+        freeBuffers = xQueueCreate(XMODEM_WRITE_BUFFERS, sizeof(uint8_t*));
+        writeQueue  = xQueueCreate(XMODEM_WRITE_BUFFERS + 1, sizeof(WriteRequest));  // + 1 for a sync request
+        writerIdle  = xSemaphoreCreateBinary();
+        xTaskCreateAffinitySet(writer_loop,               // task
+                               "xmodem_writer",           // name for task
+                               4096,                      // size of task stack
+                               0,                         // parameters
+                               1,                         // priority
+                               (1 << SUPPORT_TASK_CORE),  // affinity mask
+                               &writerTask                // task handle
+        );
+    }
+    // The buffers are only needed during a transfer
+    bufferPool = static_cast<uint8_t*>(malloc(XMODEM_WRITE_BUFFERS * PACKET_BUFFER_SIZE));
+    if (!bufferPool) {
+        return false;
+    }
+    xQueueReset(freeBuffers);
+    for (size_t i = 0; i < XMODEM_WRITE_BUFFERS; ++i) {
+        uint8_t* buf = bufferPool + i * PACKET_BUFFER_SIZE;
+        xQueueSend(freeBuffers, &buf, 0);
     }
-    memcpy(held_packet, buf, packet_len);
-    held_packet_len = packet_len;
+    writeFailed = false;
     return true;
 }
-int32_t xmodemReceive(Channel* serial, FileStream* out) {
-    serialPort      = serial;
-    file            = out;
-    held_packet_len = 0;
 
-    uint8_t  xbuff[1030]; /* 1024 for XModem 1k + 3 head chars + 2 crc + nul */
-    uint8_t* p;
-    size_t   bufsz    = 0;
-    uint16_t crc      = 0;
-    uint8_t  trychar  = 'C';
-    uint8_t  packetno = 1;
-    int32_t  c = 0;
+// Waits until every queued packet has been written.  Returns false if a write failed.
+static bool wait_for_writes() {
+    WriteRequest sync = { nullptr, 0 };
+    xQueueSend(writeQueue, &sync, portMAX_DELAY);
+    while (xSemaphoreTake(writerIdle, pdMS_TO_TICKS(DLY_1S)) != pdTRUE) {
+        feed_watchdog();
+    }
+    return !writeFailed;
+}
+
+static void stop_writer() {
+    wait_for_writes();
+    free(bufferPool);
+    bufferPool = nullptr;
+}
+
+static uint8_t* get_buffer() {
+    uint8_t* buf;
+    if (xQueueReceive(freeBuffers, &buf, 0) == pdTRUE) {
+        return buf;
+    }
+    uint32_t start = get_ms();
+    while (xQueueReceive(freeBuffers, &buf, pdMS_TO_TICKS(DLY_1S)) != pdTRUE) {
+        feed_watchdog();
+    }
+    stats->write_wait_ms += get_ms() - start;
+    return buf;
+}
+
+// Queues count bytes of buf to be written, or returns buf to the ring if count is 0
+static void queue_write(uint8_t* buf, size_t count) {
+    if (count) {
+        WriteRequest req = { buf, count };
+        xQueueSend(writeQueue, &req, portMAX_DELAY);
+    } else {
+        xQueueSend(freeBuffers, &buf, portMAX_DELAY);
+    }
+}
+
+// Reads the rest of a packet whose start byte has been received, putting
+// the data and its CRC or checksum into buf.  Returns the packet number,
+// or -1 if the packet is incomplete or corrupt.
+static int32_t read_packet(size_t bufsz, bool crc, uint8_t* buf) {
+    if (!startTime) {
+        startTime = get_ms();
+    }
+    uint8_t header[2];
+    if (serialPort->timedReadBytes(header, 2, DLY_1S) != 2) {
+        return -1;
+    }
+    size_t want = bufsz + (crc ? 2 : 1);
+    if (serialPort->timedReadBytes(buf, want, DLY_1S) != want) {
+        return -1;
+    }
+    if (header[0] != (uint8_t)(~header[1]) || !check(crc, buf, bufsz)) {
+        return -1;
+    }
+    return header[0];
+}
+
+const size_t UNKNOWN_SIZE = SIZE_MAX;
+
+// Receives the data packets of one file.  trychar is the byte that asks
+// the sender to start: 'C' for CRC, NAK for checksums, or 'G' for Ymodem-G
+// streaming, in which packets are not acknowledged and any error ends the
+// transfer.  If size is UNKNOWN_SIZE, as with Xmodem, the last packet is
+// held until EOT so we can remove the trailing control-Z's that pad it.
+// The Xmodem protocol has no good way to denote the actual size of the
+// file in bytes as opposed to packets.  This heuristic fails with binary
+// files that are supposed to have trailing control-Z's.  Doing the
+// control-Z removal only on the final packet avoids removing interior
+// control-Z's that happen to land at the end of a packet.
+static int32_t receive_file(uint8_t trychar, size_t size) {
+    uint8_t  request   = trychar;
+    bool     streaming = trychar == 'G';
+    bool     fallback  = trychar == 'C' && size == UNKNOWN_SIZE;  // Xmodem can fall back to checksums
+    uint8_t* buf       = get_buffer();
+    uint8_t* held      = nullptr;
+    size_t   held_len  = 0;
+    size_t   bufsz     = 0;
+    bool     crc       = true;
+    uint8_t  packetno  = 1;
+    int32_t  c         = 0;
+    int32_t  result;
     size_t   retry, retrans = MAXRETRANS;
 
     size_t len = 0;
@@ -207,11 +330,21 @@ int32_t xmodemReceive(Channel* serial, FileStream* out) {
                         bufsz = 1024;
                         goto start_recv;
                     case EOT:
-                        if (!flush_packet(bufsz, len)) {
-                            flushinput();
-                            _outbyte(CAN);
-                            _outbyte(CAN);
-                            _outbyte(CAN);
+                        if (held) {
+                            // Remove trailing ctrl-z's on the final packet
+                            size_t count;
+                            for (count = held_len; count > 0; --count) {
+                                if (held[count - 1] != CTRLZ) {
+                                    break;
+                                }
+                            }
+                            queue_write(held, count);
+                            len += count;
+                            held = nullptr;
+                        }
+                        queue_write(buf, 0);
+                        if (!wait_for_writes()) {
+                            cancel_transfer();
                             return -6; /* not enough free space */
                         }
                         _outbyte(ACK);
@@ -221,7 +354,8 @@ int32_t xmodemReceive(Channel* serial, FileStream* out) {
                         if ((c = _inbyte(DLY_1S)) == CAN) {
                             flushinput();
                             _outbyte(ACK);
-                            return -1; /* canceled by remote */
+                            result = -1; /* canceled by remote */
+                            goto fail;
                         }
                         break;
                     default:
@@ -229,54 +363,234 @@ int32_t xmodemReceive(Channel* serial, FileStream* out) {
                 }
             }
         }
-        if (trychar == 'C') {
+        if (trychar == 'C' && fallback) {
             trychar = NAK;
             continue;
         }
-        flushinput();
-        _outbyte(CAN);
-        _outbyte(CAN);
-        _outbyte(CAN);
-        return -2; /* sync error */
+        cancel_transfer();
+        result = -2; /* sync error */
+        goto fail;
 
     start_recv:
-        if (trychar == 'C')
-            crc = 1;
-        trychar     = 0;
-        p           = xbuff;
-        *p++        = c;
-        size_t want = bufsz + (crc ? 1 : 0) + 3;
-        auto   res  = serialPort->timedReadBytes(p, want, DLY_1S);
-        if (res != want) {
+        if (trychar)
+            crc = trychar != NAK;
+        trychar = 0;
+        c       = read_packet(bufsz, crc, buf);
+        if (c < 0) {
             goto reject;
         }
+        if (c == packetno) {
+            ++stats->packets;
+            if (size == UNKNOWN_SIZE) {
+                if (held) {
+                    queue_write(held, held_len);
+                    len += held_len;
+                }
+                held     = buf;
+                held_len = bufsz;
+            } else {
+                size_t count = std::min(bufsz, size - len);
+                queue_write(buf, count);
+                len += count;
+            }
+            buf = get_buffer();
+            ++packetno;
+            retrans = MAXRETRANS + 1;
+        } else if (c != (uint8_t)(packetno - 1) || streaming) {
+            goto reject;
+        } else if (packetno == 1) {
+            // A Ymodem sender that missed our ACK of its header resends the
+            // header, and then it waits to be asked for the data again.
+            trychar = request;
+        }
+        if (writeFailed) {
+            cancel_transfer();
+            result = -6; /* not enough free space */
+            goto fail;
+        }
+        if (--retrans == 0) {
+            cancel_transfer();
+            result = -3; /* too many retry error */
+            goto fail;
+        }
+        if (!streaming)
+            _outbyte(ACK);
+        continue;
+
+    reject:
+        ++stats->retries;
+        if (streaming) {
+            // The sender does not wait for us, so there is no way to recover
+            cancel_transfer();
+            result = -3;
+            goto fail;
+        }
+        flushinput();
+        _outbyte(NAK);
+    }
+
+fail:
+    queue_write(buf, 0);
+    if (held) {
+        queue_write(held, 0);
+    }
+    wait_for_writes();
+    return result;
+}
+
+static void begin_transfer(Channel* serial, TransferStats& transferStats) {
+    serialPort = serial;
+    stats      = &transferStats;
+    *stats     = {};
+    startTime  = 0;
+}
+
+static void end_transfer() {
+    if (startTime) {
+        stats->ms = get_ms() - startTime;
+    }
+}
+
+int32_t xmodemReceive(Channel* serial, FileStream* out, TransferStats& transferStats) {
+    begin_transfer(serial, transferStats);
+    if (!start_writer()) {
+        cancel_transfer();
+        return -7; /* no memory for the write buffers */
+    }
+    file       = out;
+    checkSpace = true;
+
+    int32_t len = receive_file('C', UNKNOWN_SIZE);
+    stop_writer();
+    end_transfer();
+    if (len >= 0) {
+        stats->files = 1;
+        stats->bytes = len;
+    }
+    return len;
+}
+
+// Ymodem sends each file of a batch as a header packet numbered 0, holding
+// the file name and then its size and other fields separated by spaces,
+// followed by the data packets as for Xmodem.  A header with an empty
+// name ends the batch.
+int32_t ymodemReceive(Channel* serial, const char* dir, bool streaming, TransferStats& transferStats) {
+    begin_transfer(serial, transferStats);
+    if (!start_writer()) {
+        cancel_transfer();
+        return -7; /* no memory for the write buffers */
+    }
+
+    uint8_t  trychar = streaming ? 'G' : 'C';
+    uint8_t* header  = get_buffer();
+    size_t   bufsz;
+    size_t   errors = 0;
+    int32_t  c;
+    int32_t  result = 0;
+    size_t   retry;
 
-        if (xbuff[1] == (uint8_t)(~xbuff[2]) && (xbuff[1] == packetno || xbuff[1] == packetno - 1) && check(crc, &xbuff[3], bufsz)) {
-            if (xbuff[1] == packetno) {
-                if (!write_packet(xbuff + 3, bufsz, len)) {
+    for (;;) {
+        for (retry = 0; retry < 16; ++retry) {
+            feed_watchdog();
+            _outbyte(trychar);
+            if ((c = _inbyte((DLY_1S) << 1)) >= 0) {
+                if (c == SOH || c == STX) {
+                    break;
+                }
+                if (c == CAN && _inbyte(DLY_1S) == CAN) {
                     flushinput();
-                    _outbyte(CAN);
-                    _outbyte(CAN);
-                    _outbyte(CAN);
-                    return -6; /* not enough free space */
+                    _outbyte(ACK);
+                    result = -1; /* canceled by remote */
+                    goto done;
                 }
-                ++packetno;
-                retrans = MAXRETRANS + 1;
             }
-            if (--retrans == 0) {
-                flushinput();
-                _outbyte(CAN);
-                _outbyte(CAN);
-                _outbyte(CAN);
-                return -3; /* too many retry error */
+        }
+        if (retry == 16) {
+            cancel_transfer();
+            result = -2; /* sync error */
+            goto done;
+        }
+        bufsz = c == SOH ? 128 : 1024;
+        if (read_packet(bufsz, true, header) != 0) {
+            ++stats->retries;
+            if (streaming || ++errors == MAXRETRANS) {
+                cancel_transfer();
+                result = -3;
+                goto done;
             }
-            _outbyte(ACK);
+            flushinput();
+            _outbyte(NAK);
             continue;
         }
-    reject:
-        flushinput();
-        _outbyte(NAK);
+        errors        = 0;
+        header[bufsz] = '\0';  // Overwrites the CRC, which has been checked
+
+        const char* name = reinterpret_cast<const char*>(header);
+        if (!*name) {
+            // End of batch
+            if (!streaming)
+                _outbyte(ACK);
+            break;
+        }
+        size_t      size = UNKNOWN_SIZE;
+        const char* p    = name + strlen(name) + 1;
+        if (isdigit(*p)) {
+            size = strtoul(p, nullptr, 10);
+        }
+        // Files go in dir, whatever directory they came from
+        const char* slash = strrchr(name, '/');
+        if (slash) {
+            name = slash + 1;
+        }
+        std::string path(dir);
+        if (!path.empty() && path.back() != '/') {
+            path += '/';
+        }
+        path += name;
+
+        try {
+            file = new FileStream(path, "w");
+        } catch (...) {
+            cancel_transfer();
+            result = -8; /* cannot create the file */
+            goto done;
+        }
+        stdfs::path fname = file->fpath();
+
+        checkSpace = size == UNKNOWN_SIZE;
+        if (!checkSpace) {
+            std::error_code ec;
+            auto            space = stdfs::space(fname, ec);
+            if (ec || space.available < size) {
+                cancel_transfer();
+                result = -6; /* not enough free space */
+            }
+        }
+        if (result == 0) {
+            if (!streaming)
+                _outbyte(ACK);
+            result = receive_file(trychar, size);
+        }
+        delete file;
+        file = nullptr;
+        if (result < 0) {
+            // Don't leave a truncated file behind
+            std::error_code ec;
+            stdfs::remove(fname, ec);
+            HashFS::delete_file(fname);
+            goto done;
+        }
+        HashFS::rehash_file(fname);
+        stats->bytes += result;
+        ++stats->files;
+        result = 0;
     }
+
+done:
+    queue_write(header, 0);
+    stop_writer();
+    end_transfer();
+    return result < 0 ? result : int32_t(stats->bytes);
 }
 
 int32_t xmodemTransmit(Channel* serial, FileStream* infile) {
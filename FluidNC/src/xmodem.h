@@ -5,5 +5,25 @@
 #include "Channel.h"
 #include "FileStream.h"
 
-int32_t xmodemReceive(Channel* serial, FileStream* outfile);
+// Statistics for a completed receive, reported by the upload commands
+struct TransferStats {
+    size_t   bytes;          // Bytes written
+    size_t   files;          // Files written
+    uint32_t packets;        // Packets received
+    uint32_t retries;        // Packets that had to be resent
+    uint32_t ms;             // Time from the first packet to the end
+    uint32_t write_wait_ms;  // Time spent waiting for the filesystem
+};
+
+// The receive functions return the number of bytes received, or a negative
+// error code: -1 canceled by the sender, -2 no sync, -3 too many errors,
+// -6 not enough free space, -7 not enough memory, -8 cannot create a file.
+int32_t xmodemReceive(Channel* serial, FileStream* outfile, TransferStats& stats);
+
+// Receives a Ymodem batch of files into the directory dir.  If streaming is
+// true, asks for Ymodem-G, in which the sender does not wait for each packet
+// to be acknowledged; that is much faster, but only suits links like USB or
+// Telnet that do not lose or corrupt data, because any error ends the transfer.
+int32_t ymodemReceive(Channel* serial, const char* dir, bool streaming, TransferStats& stats);
+
 int32_t xmodemTransmit(Channel* serial, FileStream* infile);
@@ -0,0 +1,93 @@
+// Test suite for the lock-free pool of message buffers
+#include <gtest/gtest.h>
+
+#include "../src/BufferPool.h"
+
+#include <cstring>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace {
+
+TEST(BufferPool, HandsOutDistinctBuffers) {
+    BufferPool<4, 16> pool;
+    std::set<char*>   seen;
+    for (int i = 0; i < 4; i++) {
+        char* p = pool.acquire();
+        ASSERT_NE(p, nullptr);
+        EXPECT_TRUE(pool.owns(p));
+        EXPECT_TRUE(seen.insert(p).second);
+    }
+    EXPECT_EQ(pool.in_use(), 4u);
+    EXPECT_EQ(pool.exhausted(), 0u);
+}
+
+TEST(BufferPool, CountsExhaustion) {
+    BufferPool<2, 16> pool;
+    char*             a = pool.acquire();
+    char*             b = pool.acquire();
+    ASSERT_NE(a, nullptr);
+    ASSERT_NE(b, nullptr);
+    EXPECT_EQ(pool.acquire(), nullptr);
+    EXPECT_EQ(pool.acquire(), nullptr);
+    EXPECT_EQ(pool.exhausted(), 2u);
+
+    pool.release(a);
+    EXPECT_EQ(pool.acquire(), a);
+    EXPECT_EQ(pool.high_water(), 2u);
+
+    pool.release(a);
+    pool.release(b);
+    pool.reset_stats();
+    EXPECT_EQ(pool.exhausted(), 0u);
+    EXPECT_EQ(pool.high_water(), 0u);
+}
+
+TEST(BufferPool, FullSizePool) {
+    BufferPool<32, 8>  pool;
+    std::vector<char*> buffers;
+    while (char* p = pool.acquire()) {
+        buffers.push_back(p);
+    }
+    EXPECT_EQ(buffers.size(), 32u);
+    for (auto p : buffers) {
+        pool.release(p);
+    }
+    EXPECT_EQ(pool.in_use(), 0u);
+}
+
+TEST(BufferPool, DoesNotOwnOtherMemory) {
+    BufferPool<2, 16> pool;
+    char              other[16];
+    EXPECT_FALSE(pool.owns(other));
+}
+
+TEST(BufferPool, ConcurrentUse) {
+    static BufferPool<8, 32> pool;
+    const int                iterations = 20000;
+
+    auto worker = [&](char tag) {
+        for (int i = 0; i < iterations; i++) {
+            char* p = pool.acquire();
+            if (!p) {
+                continue;
+            }
+            memset(p, tag, 32);
+            for (int j = 0; j < 32; j++) {
+                ASSERT_EQ(p[j], tag);  // Nobody else wrote into our buffer
+            }
+            pool.release(p);
+        }
+    };
+    std::thread t1(worker, 'a');
+    std::thread t2(worker, 'b');
+    std::thread t3(worker, 'c');
+    t1.join();
+    t2.join();
+    t3.join();
+    EXPECT_EQ(pool.in_use(), 0u);
+    EXPECT_LE(pool.high_water(), 3u);
+}
+
+}  // namespace
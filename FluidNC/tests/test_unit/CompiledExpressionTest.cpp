@@ -0,0 +1,85 @@
+// Test suite for compiled expressions, which must agree with read_number()
+// and expression() reading the same text.  ExpressionParserTest runs its
+// read_number() tests against compiled expressions too.
+#include <gtest/gtest.h>
+
+#include "../src/Expression.h"
+#include "../src/Parameters.h"
+
+namespace {
+
+TEST(CompiledExpression, FoldsConstants) {
+    CompiledExpression compiled;
+    size_t             pos = 0;
+    float              value;
+
+    ASSERT_TRUE(compiled.compile("[2*3+SQRT[16]-ATAN[1]/[1]]", pos));
+    EXPECT_TRUE(compiled.constant());
+    ASSERT_EQ(compiled.evaluate(value), Error::Ok);
+    EXPECT_FLOAT_EQ(value, 2 * 3 + 4 - 45);
+
+    // Only the part that reads a parameter is left: #1, 6, *
+    pos = 0;
+    ASSERT_TRUE(compiled.compile("[#1*[2*3]]", pos));
+    EXPECT_EQ(compiled.size(), 3u);
+}
+
+TEST(CompiledExpression, ReadsParametersWhenEvaluated) {
+    CompiledExpression compiled;
+    size_t             pos = 0;
+    float              value;
+
+    set_numbered_param(5, 1.0f);
+    set_named_param("depth", 0.5f);
+    ASSERT_TRUE(compiled.compile("[#5+#<Depth>*2]", pos));
+
+    ASSERT_EQ(compiled.evaluate(value), Error::Ok);
+    EXPECT_FLOAT_EQ(value, 2.0f);
+
+    set_numbered_param(5, 3.0f);
+    set_named_param("DEPTH", 1.5f);
+    ASSERT_EQ(compiled.evaluate(value), Error::Ok);
+    EXPECT_FLOAT_EQ(value, 6.0f);
+}
+
+TEST(CompiledExpression, ErrorsMatchExpression) {
+    const char* cases[] = {
+        "[1/0]",                  // Divide by zero, not folded
+        "[1/[2-2]]",              // Divide by zero nested in a subexpression
+        "[SQRT[-1]]",             // Argument out of range in a function
+        "[2+ACOS[2]]",            // Argument out of range deeper in
+        "[#<undefined_name>+1]",  // Undefined parameter
+        "[[-8]**0.5]",            // Negative base, non-integer power
+    };
+    for (auto text : cases) {
+        float  read_value, compiled_value;
+        size_t read_pos = 0, compiled_pos = 0;
+
+        Error read_status = expression(text, read_pos, read_value);
+
+        CompiledExpression compiled;
+        ASSERT_TRUE(compiled.compile(text, compiled_pos)) << text;
+        EXPECT_NE(read_status, Error::Ok) << text;
+        EXPECT_EQ(compiled.evaluate(compiled_value), read_status) << text;
+    }
+}
+
+TEST(CompiledExpression, RejectsWhatItCannotCompile) {
+    const char* cases[] = {
+        "[##1+1]",          // Indirect parameter reference
+        "[#[1+1]]",         // Parameter number from an expression
+        "[EXISTS[#<_x>]]",  // Depends on the parameter table
+        "[1+]",             // Syntax error
+        "[1FOO2]",          // Unknown operator
+        "[ATAN[1]]",        // ATAN without its second argument
+        "",
+    };
+    for (auto text : cases) {
+        CompiledExpression compiled;
+        size_t             pos = 0;
+        EXPECT_FALSE(compiled.compile(text, pos)) << text;
+        EXPECT_TRUE(compiled.empty()) << text;
+    }
+}
+
+}  // namespace
@@ -0,0 +1,249 @@
+// Test suite for recording and replaying the config cache
+#include <gtest/gtest.h>
+
+#include "../src/Configuration/CacheRecords.h"
+
+#include <memory>
+#include <string>
+
+namespace {
+
+using Configuration::CacheError;
+using Configuration::CacheRecord;
+using Configuration::CacheRecords;
+using Configuration::CacheWriter;
+
+// Replays records the way CacheReader does, with the section and factory
+// logic of HandlerBase and GenericFactory when the handler is a parser
+struct Replayer {
+    CacheRecords records;
+
+    explicit Replayer(const std::string& data) : records(data) {}
+
+    void item(const char* name, int32_t& value) {
+        if (records.is(name, CacheRecord::Int)) {
+            records.get(&value, sizeof(value));
+        }
+    }
+    void item(const char* name, float& value) {
+        if (records.is(name, CacheRecord::Float)) {
+            records.get(&value, sizeof(value));
+        }
+    }
+    void item(const char* name, std::string& value) {
+        if (records.is(name, CacheRecord::String)) {
+            value.assign(reinterpret_cast<const char*>(records.value()), records.length());
+        }
+    }
+
+    template <typename T>
+    void enterSection(const char* name, T* section) {
+        records.section(name, [&] { section->group(*this); });
+    }
+
+    // HandlerBase::section()
+    template <typename T>
+    void section(const char* name, std::unique_ptr<T>& value) {
+        if (records.is(name, CacheRecord::Section)) {
+            EXPECT_EQ(value, nullptr);
+            value = std::make_unique<T>();
+            enterSection(name, value.get());
+        }
+    }
+
+    // GenericFactory::factory() for a single instance, which enters an
+    // existing object for every record of the enclosing section
+    template <typename T>
+    void factory(const char* name, std::unique_ptr<T>& value) {
+        if (value == nullptr) {
+            if (records.is(name, CacheRecord::Section)) {
+                value = std::make_unique<T>();
+                enterSection(name, value.get());
+            }
+        } else {
+            value->entered++;
+            enterSection(name, value.get());
+        }
+    }
+
+    template <typename T>
+    void replay(const char* name, T* root) {
+        records.replay([&] { enterSection(name, root); });
+    }
+};
+
+struct Driver {
+    std::string step_pin;
+    int32_t     entered = 0;
+
+    void group(Replayer& handler) { handler.item("step_pin", step_pin); }
+};
+
+struct Motor {
+    float                   pulloff     = 0;
+    int32_t                 hard_limits = 0;
+    std::unique_ptr<Driver> driver;
+
+    void group(Replayer& handler) {
+        handler.item("pulloff", pulloff);
+        handler.item("hard_limits", hard_limits);
+        handler.factory("stepstick", driver);
+    }
+};
+
+struct Axis {
+    int32_t                steps = 0;
+    std::unique_ptr<Motor> motor0;
+
+    void group(Replayer& handler) {
+        handler.item("steps", steps);
+        handler.section("motor0", motor0);
+    }
+};
+
+struct Empty {
+    void group(Replayer& handler) {}
+};
+
+struct Axes {
+    std::unique_ptr<Axis> x;
+    std::unique_ptr<Axis> y;
+
+    void group(Replayer& handler) {
+        handler.section("x", x);
+        handler.section("y", y);
+    }
+};
+
+struct Machine {
+    std::string            name;
+    std::unique_ptr<Axes>  axes;
+    std::unique_ptr<Empty> empty;
+    float                  speed = 0;
+
+    void group(Replayer& handler) {
+        handler.item("name", name);
+        handler.section("axes", axes);
+        handler.section("empty", empty);
+        handler.item("speed", speed);
+    }
+};
+
+// Records what ParserHandler records for
+//
+//   name: test
+//   axes:
+//     x:
+//       steps: 80
+//       motor0:
+//         pulloff: 1.5
+//         stepstick:
+//           step_pin: gpio.2
+//         hard_limits: 1
+//     y:
+//       steps: 100
+//   empty:
+//   speed: 3.5
+//
+// The factory enters the existing stepstick again for hard_limits, which
+// records an empty section after it.
+void record_machine(CacheWriter& cache, const char* extra_key = nullptr) {
+    cache.begin_section("machine");
+    cache.put("name", std::string_view("test"));
+    cache.begin_section("axes");
+    cache.begin_section("x");
+    cache.put("steps", int32_t(80));
+    cache.begin_section("motor0");
+    cache.put("pulloff", 1.5f);
+    cache.begin_section("stepstick");
+    cache.put("step_pin", std::string_view("gpio.2"));
+    cache.end_section();
+    cache.put("hard_limits", int32_t(1));
+    cache.begin_section("stepstick");
+    cache.end_section();
+    if (extra_key) {
+        cache.put(extra_key, int32_t(0));
+    }
+    cache.end_section();
+    cache.end_section();
+    cache.begin_section("y");
+    cache.put("steps", int32_t(100));
+    cache.end_section();
+    cache.end_section();
+    cache.begin_section("empty");
+    cache.end_section();
+    cache.put("speed", 3.5f);
+    cache.end_section();
+}
+
+TEST(ConfigCache, ReplaysNestedAndFactorySections) {
+    CacheWriter cache;
+    record_machine(cache);
+    ASSERT_TRUE(cache.ok());
+
+    Machine  machine;
+    Replayer replayer(cache.records());
+    replayer.replay("machine", &machine);
+
+    EXPECT_EQ(machine.name, "test");
+    EXPECT_EQ(machine.speed, 3.5f);
+    ASSERT_NE(machine.axes, nullptr);
+    ASSERT_NE(machine.axes->x, nullptr);
+    ASSERT_NE(machine.axes->y, nullptr);
+    EXPECT_EQ(machine.axes->x->steps, 80);
+    EXPECT_EQ(machine.axes->y->steps, 100);
+    EXPECT_EQ(machine.axes->y->motor0, nullptr);
+    EXPECT_NE(machine.empty, nullptr);
+
+    auto& motor = machine.axes->x->motor0;
+    ASSERT_NE(motor, nullptr);
+    EXPECT_EQ(motor->pulloff, 1.5f);
+    EXPECT_EQ(motor->hard_limits, 1);
+    ASSERT_NE(motor->driver, nullptr);
+    EXPECT_EQ(motor->driver->step_pin, "gpio.2");
+    // Once for hard_limits, where nothing is entered, and once for the
+    // empty stepstick section
+    EXPECT_EQ(motor->driver->entered, 2);
+}
+
+TEST(ConfigCache, RejectsAnUnknownKey) {
+    CacheWriter cache;
+    record_machine(cache, "no_such_key");
+
+    Machine  machine;
+    Replayer replayer(cache.records());
+    EXPECT_THROW(replayer.replay("machine", &machine), CacheError);
+}
+
+TEST(ConfigCache, RejectsAnotherTopSection) {
+    CacheWriter cache;
+    record_machine(cache);
+
+    Machine  machine;
+    Replayer replayer(cache.records());
+    EXPECT_THROW(replayer.replay("other", &machine), CacheError);
+}
+
+TEST(ConfigCache, RejectsTruncatedAndExtraRecords) {
+    CacheWriter cache;
+    record_machine(cache);
+    auto& records = cache.records();
+
+    for (size_t length = 0; length < records.length(); length++) {
+        Machine  machine;
+        Replayer replayer(records.substr(0, length));
+        EXPECT_THROW(replayer.replay("machine", &machine), CacheError) << "length " << length;
+    }
+
+    Machine  machine;
+    Replayer replayer(records + char(CacheRecord::EndSection));
+    EXPECT_THROW(replayer.replay("machine", &machine), CacheError);
+}
+
+TEST(ConfigCache, RejectsTooLongItems) {
+    CacheWriter cache;
+    cache.put(std::string(300, 'k').c_str(), int32_t(1));
+    EXPECT_FALSE(cache.ok());
+}
+
+}
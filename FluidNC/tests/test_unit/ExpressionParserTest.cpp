@@ -1,11 +1,15 @@
 // Test suite for read_number() function
 // Validates Phase 1 implementation: unary operators on non-numeric values
 // Tests parser syntax without complex system dependencies
+// Each test runs twice, reading the text with read_number() and evaluating
+// it as a CompiledExpression, which must give the same values and positions
 
 #include "gtest/gtest.h"
 #include "LinuxCNCParser.h"
 #include "Parameters.h"
+#include "Expression.h"
 #include <cmath>
+#include <string>
 
 namespace {
 
@@ -13,63 +17,96 @@ static bool approx_equal(float a, float b, float tolerance = 1e-5f) {
     return std::abs(a - b) < tolerance;
 }
 
+enum class Evaluator {
+    Text,      // read_number()
+    Compiled,  // CompiledExpression::compile_number(), then evaluate()
+};
+
+class ReadNumberTest : public ::testing::TestWithParam<Evaluator> {
+protected:
+    bool read(const char* text, size_t& pos, float& result) {
+        if (GetParam() == Evaluator::Text) {
+            return read_number(text, pos, result);
+        }
+        CompiledExpression compiled;
+        return compiled.compile_number(text, pos) && compiled.evaluate(result) == Error::Ok;
+    }
+    bool read(std::string_view sv, float& result) {
+        if (GetParam() == Evaluator::Text) {
+            return read_number(sv, result);
+        }
+        std::string s(sv);
+        size_t      pos = 0;
+        return read(s.c_str(), pos, result);
+    }
+};
+
+class ComparativeTest : public ReadNumberTest {};
+
+std::string evaluator_name(const ::testing::TestParamInfo<Evaluator>& info) {
+    return info.param == Evaluator::Text ? "Text" : "Compiled";
+}
+
+INSTANTIATE_TEST_SUITE_P(Evaluators, ReadNumberTest, ::testing::Values(Evaluator::Text, Evaluator::Compiled), evaluator_name);
+INSTANTIATE_TEST_SUITE_P(Evaluators, ComparativeTest, ::testing::Values(Evaluator::Text, Evaluator::Compiled), evaluator_name);
+
 // ============================================================================
 // Basic Numeric Literals
 // ============================================================================
 
-TEST(ReadNumberTest, PositiveInteger) {
+TEST_P(ReadNumberTest, PositiveInteger) {
     float  result;
     size_t pos = 0;
-    EXPECT_TRUE(read_number("123", pos, result));
+    EXPECT_TRUE(read("123", pos, result));
     EXPECT_TRUE(approx_equal(result, 123.0f));
 }
 
-TEST(ReadNumberTest, NegativeInteger) {
+TEST_P(ReadNumberTest, NegativeInteger) {
     float  result;
     size_t pos = 0;
-    EXPECT_TRUE(read_number("-123", pos, result));
+    EXPECT_TRUE(read("-123", pos, result));
     EXPECT_TRUE(approx_equal(result, -123.0f));
 }
 
-TEST(ReadNumberTest, Float) {
+TEST_P(ReadNumberTest, Float) {
     float  result;
     size_t pos = 0;
-    EXPECT_TRUE(read_number("123.456", pos, result));
+    EXPECT_TRUE(read("123.456", pos, result));
     EXPECT_TRUE(approx_equal(result, 123.456f));
 }
 
-TEST(ReadNumberTest, NegativeFloat) {
+TEST_P(ReadNumberTest, NegativeFloat) {
     float  result;
     size_t pos = 0;
-    EXPECT_TRUE(read_number("-123.456", pos, result));
+    EXPECT_TRUE(read("-123.456", pos, result));
     EXPECT_TRUE(approx_equal(result, -123.456f));
 }
 
-TEST(ReadNumberTest, LeadingDecimal) {
+TEST_P(ReadNumberTest, LeadingDecimal) {
     float  result;
     size_t pos = 0;
-    EXPECT_TRUE(read_number(".5", pos, result));
+    EXPECT_TRUE(read(".5", pos, result));
     EXPECT_TRUE(approx_equal(result, 0.5f));
 }
 
-TEST(ReadNumberTest, NegativeLeadingDecimal) {
+TEST_P(ReadNumberTest, NegativeLeadingDecimal) {
     float  result;
     size_t pos = 0;
-    EXPECT_TRUE(read_number("-.5", pos, result));
+    EXPECT_TRUE(read("-.5", pos, result));
     EXPECT_TRUE(approx_equal(result, -0.5f));
 }
 
-TEST(ReadNumberTest, UnaryPlusNumeric) {
+TEST_P(ReadNumberTest, UnaryPlusNumeric) {
     float  result;
     size_t pos = 0;
-    EXPECT_TRUE(read_number("+123", pos, result));
+    EXPECT_TRUE(read("+123", pos, result));
     EXPECT_TRUE(approx_equal(result, 123.0f));
 }
 
-TEST(ReadNumberTest, Zero) {
+TEST_P(ReadNumberTest, Zero) {
     float  result;
     size_t pos = 0;
-    EXPECT_TRUE(read_number("0", pos, result));
+    EXPECT_TRUE(read("0", pos, result));
     EXPECT_TRUE(approx_equal(result, 0.0f));
 }
 
@@ -77,45 +114,45 @@ TEST(ReadNumberTest, Zero) {
 // Bracketed Expressions
 // ============================================================================
 
-TEST(ReadNumberTest, SimpleExpression) {
+TEST_P(ReadNumberTest, SimpleExpression) {
     float  result;
     size_t pos = 0;
-    EXPECT_TRUE(read_number("[2+3]", pos, result));
+    EXPECT_TRUE(read("[2+3]", pos, result));
     EXPECT_TRUE(approx_equal(result, 5.0f));
 }
 
-TEST(ReadNumberTest, ExpressionWithMultiplication) {
+TEST_P(ReadNumberTest, ExpressionWithMultiplication) {
     float  result;
     size_t pos = 0;
-    EXPECT_TRUE(read_number("[2*3+4]", pos, result));
+    EXPECT_TRUE(read("[2*3+4]", pos, result));
     EXPECT_TRUE(approx_equal(result, 10.0f));
 }
 
-TEST(ReadNumberTest, NegatedExpression) {
+TEST_P(ReadNumberTest, NegatedExpression) {
     float  result;
     size_t pos = 0;
-    EXPECT_TRUE(read_number("-[2+3]", pos, result));
+    EXPECT_TRUE(read("-[2+3]", pos, result));
     EXPECT_TRUE(approx_equal(result, -5.0f));
 }
 
-TEST(ReadNumberTest, UnaryPlusExpression) {
+TEST_P(ReadNumberTest, UnaryPlusExpression) {
     float  result;
     size_t pos = 0;
-    EXPECT_TRUE(read_number("+[2+3]", pos, result));
+    EXPECT_TRUE(read("+[2+3]", pos, result));
     EXPECT_TRUE(approx_equal(result, 5.0f));
 }
 
-TEST(ReadNumberTest, ExpressionWithPower) {
+TEST_P(ReadNumberTest, ExpressionWithPower) {
     float  result;
     size_t pos = 0;
-    EXPECT_TRUE(read_number("[2**3]", pos, result));
+    EXPECT_TRUE(read("[2**3]", pos, result));
     EXPECT_TRUE(approx_equal(result, 8.0f));
 }
 
-TEST(ReadNumberTest, NegatedPowerExpression) {
+TEST_P(ReadNumberTest, NegatedPowerExpression) {
     float  result;
     size_t pos = 0;
-    EXPECT_TRUE(read_number("-[2**3]", pos, result));
+    EXPECT_TRUE(read("-[2**3]", pos, result));
     EXPECT_TRUE(approx_equal(result, -8.0f));
 }
 
@@ -123,31 +160,31 @@ TEST(ReadNumberTest, NegatedPowerExpression) {
 // Unary Functions (in expressions only)
 // ============================================================================
 
-TEST(ReadNumberTest, FunctionAbsoluteValue) {
+TEST_P(ReadNumberTest, FunctionAbsoluteValue) {
     float  result;
     size_t pos = 0;
-    EXPECT_TRUE(read_number("[ABS[-5]]", pos, result));
+    EXPECT_TRUE(read("[ABS[-5]]", pos, result));
     EXPECT_TRUE(approx_equal(result, 5.0f));
 }
 
-TEST(ReadNumberTest, FunctionSquareRoot) {
+TEST_P(ReadNumberTest, FunctionSquareRoot) {
     float  result;
     size_t pos = 0;
-    EXPECT_TRUE(read_number("[SQRT[16]]", pos, result));
+    EXPECT_TRUE(read("[SQRT[16]]", pos, result));
     EXPECT_TRUE(approx_equal(result, 4.0f));
 }
 
-TEST(ReadNumberTest, FunctionRound) {
+TEST_P(ReadNumberTest, FunctionRound) {
     float  result;
     size_t pos = 0;
-    EXPECT_TRUE(read_number("[ROUND[3.7]]", pos, result));
+    EXPECT_TRUE(read("[ROUND[3.7]]", pos, result));
     EXPECT_TRUE(approx_equal(result, 4.0f));
 }
 
-TEST(ReadNumberTest, NegatedFunctionInExpression) {
+TEST_P(ReadNumberTest, NegatedFunctionInExpression) {
     float  result;
     size_t pos = 0;
-    EXPECT_TRUE(read_number("[-ABS[-5]]", pos, result));
+    EXPECT_TRUE(read("[-ABS[-5]]", pos, result));
     EXPECT_TRUE(approx_equal(result, -5.0f));
 }
 
@@ -156,36 +193,36 @@ TEST(ReadNumberTest, NegatedFunctionInExpression) {
 // This is the key Phase 1 feature: unary minus/plus on bracketed expressions
 // ============================================================================
 
-TEST(ReadNumberTest, UnaryMinusOnBracketedExpression) {
+TEST_P(ReadNumberTest, UnaryMinusOnBracketedExpression) {
     float  result;
     size_t pos = 0;
     // -[10+5] should equal -15
     // This is the Phase 1 key feature: unary operator recognized before '['
-    EXPECT_TRUE(read_number("-[10+5]", pos, result));
+    EXPECT_TRUE(read("-[10+5]", pos, result));
     EXPECT_TRUE(approx_equal(result, -15.0f));
 }
 
-TEST(ReadNumberTest, UnaryPlusOnBracketedExpression) {
+TEST_P(ReadNumberTest, UnaryPlusOnBracketedExpression) {
     float  result;
     size_t pos = 0;
     // +[10+5] should equal 15
-    EXPECT_TRUE(read_number("+[10+5]", pos, result));
+    EXPECT_TRUE(read("+[10+5]", pos, result));
     EXPECT_TRUE(approx_equal(result, 15.0f));
 }
 
-TEST(ReadNumberTest, DoublyNegatedBracketedExpression) {
+TEST_P(ReadNumberTest, DoublyNegatedBracketedExpression) {
     float  result;
     size_t pos = 0;
     // --[7] should equal 7
-    EXPECT_TRUE(read_number("--[7]", pos, result));
+    EXPECT_TRUE(read("--[7]", pos, result));
     EXPECT_TRUE(approx_equal(result, 7.0f));
 }
 
-TEST(ReadNumberTest, UnaryMinusThenPlus) {
+TEST_P(ReadNumberTest, UnaryMinusThenPlus) {
     float  result;
     size_t pos = 0;
     // -+[5] should equal -5
-    EXPECT_TRUE(read_number("-+[5]", pos, result));
+    EXPECT_TRUE(read("-+[5]", pos, result));
     EXPECT_TRUE(approx_equal(result, -5.0f));
 }
 
@@ -194,19 +231,19 @@ TEST(ReadNumberTest, UnaryMinusThenPlus) {
 // Key: Unary operators only recognized if next char is NOT digit or '.'
 // ============================================================================
 
-TEST(ReadNumberTest, NegativeDigitParsedAsLiteral) {
+TEST_P(ReadNumberTest, NegativeDigitParsedAsLiteral) {
     float  result;
     size_t pos = 0;
     // -123 should be parsed as negative literal (digit follows operator)
-    EXPECT_TRUE(read_number("-123", pos, result));
+    EXPECT_TRUE(read("-123", pos, result));
     EXPECT_TRUE(approx_equal(result, -123.0f));
 }
 
-TEST(ReadNumberTest, NegativeDecimalParsedAsLiteral) {
+TEST_P(ReadNumberTest, NegativeDecimalParsedAsLiteral) {
     float  result;
     size_t pos = 0;
     // -.456 should be parsed as negative literal (dot follows operator)
-    EXPECT_TRUE(read_number("-.456", pos, result));
+    EXPECT_TRUE(read("-.456", pos, result));
     EXPECT_TRUE(approx_equal(result, -0.456f));
 }
 
@@ -214,19 +251,19 @@ TEST(ReadNumberTest, NegativeDecimalParsedAsLiteral) {
 // Complex Expressions
 // ============================================================================
 
-TEST(ReadNumberTest, ComplexExpressionPrecedence) {
+TEST_P(ReadNumberTest, ComplexExpressionPrecedence) {
     float  result;
     size_t pos = 0;
     // [2+3*4-5] should equal 9 (multiplication has higher precedence)
-    EXPECT_TRUE(read_number("[2+3*4-5]", pos, result));
+    EXPECT_TRUE(read("[2+3*4-5]", pos, result));
     EXPECT_TRUE(approx_equal(result, 9.0f));
 }
 
-TEST(ReadNumberTest, NegatedComplexExpression) {
+TEST_P(ReadNumberTest, NegatedComplexExpression) {
     float  result;
     size_t pos = 0;
     // -[2+3*4] should equal -14
-    EXPECT_TRUE(read_number("-[2+3*4]", pos, result));
+    EXPECT_TRUE(read("-[2+3*4]", pos, result));
     EXPECT_TRUE(approx_equal(result, -14.0f));
 }
 
@@ -234,29 +271,29 @@ TEST(ReadNumberTest, NegatedComplexExpression) {
 // Position Tracking
 // ============================================================================
 
-TEST(ReadNumberTest, PositionAdvancedAfterNumber) {
+TEST_P(ReadNumberTest, PositionAdvancedAfterNumber) {
     float       result;
     const char* input = "123+456";
     size_t      pos   = 0;
-    EXPECT_TRUE(read_number(input, pos, result));
+    EXPECT_TRUE(read(input, pos, result));
     EXPECT_EQ(pos, 3);  // Should be at the '+' character
     EXPECT_TRUE(approx_equal(result, 123.0f));
 }
 
-TEST(ReadNumberTest, PositionAdvancedAfterExpression) {
+TEST_P(ReadNumberTest, PositionAdvancedAfterExpression) {
     float       result;
     const char* input = "[1+2]+3";
     size_t      pos   = 0;
-    EXPECT_TRUE(read_number(input, pos, result));
+    EXPECT_TRUE(read(input, pos, result));
     EXPECT_EQ(pos, 5);  // Should be at the '+' character after ']'
     EXPECT_TRUE(approx_equal(result, 3.0f));
 }
 
-TEST(ReadNumberTest, PositionAdvancedAfterUnaryOperator) {
+TEST_P(ReadNumberTest, PositionAdvancedAfterUnaryOperator) {
     float       result;
     const char* input = "-[5]+2";
     size_t      pos   = 0;
-    EXPECT_TRUE(read_number(input, pos, result));
+    EXPECT_TRUE(read(input, pos, result));
     EXPECT_EQ(pos, 4);  // Should be at the '+' character
     EXPECT_TRUE(approx_equal(result, -5.0f));
 }
@@ -265,37 +302,37 @@ TEST(ReadNumberTest, PositionAdvancedAfterUnaryOperator) {
 // Parameter References
 // ============================================================================
 
-TEST(ReadNumberTest, ParameterReference) {
+TEST_P(ReadNumberTest, ParameterReference) {
     float  result;
     size_t pos = 0;
     set_numbered_param(1, 42.5f);
-    EXPECT_TRUE(read_number("#1", pos, result));
+    EXPECT_TRUE(read("#1", pos, result));
     EXPECT_TRUE(approx_equal(result, 42.5f));
 }
 
-TEST(ReadNumberTest, NegatedParameterReference) {
+TEST_P(ReadNumberTest, NegatedParameterReference) {
     float  result;
     size_t pos = 0;
     set_numbered_param(2, 100.0f);
     // -#2 should equal -100 (Phase 1: unary operator on parameter)
-    EXPECT_TRUE(read_number("-#2", pos, result));
+    EXPECT_TRUE(read("-#2", pos, result));
     EXPECT_TRUE(approx_equal(result, -100.0f));
 }
 
-TEST(ReadNumberTest, UnaryPlusParameterReference) {
+TEST_P(ReadNumberTest, UnaryPlusParameterReference) {
     float  result;
     size_t pos = 0;
     set_numbered_param(3, 50.0f);
-    EXPECT_TRUE(read_number("+#3", pos, result));
+    EXPECT_TRUE(read("+#3", pos, result));
     EXPECT_TRUE(approx_equal(result, 50.0f));
 }
 
-TEST(ReadNumberTest, DoublyNegatedParameter) {
+TEST_P(ReadNumberTest, DoublyNegatedParameter) {
     float  result;
     size_t pos = 0;
     set_numbered_param(4, 25.0f);
     // --#4 should equal 25
-    EXPECT_TRUE(read_number("--#4", pos, result));
+    EXPECT_TRUE(read("--#4", pos, result));
     EXPECT_TRUE(approx_equal(result, 25.0f));
 }
 
@@ -303,25 +340,25 @@ TEST(ReadNumberTest, DoublyNegatedParameter) {
 // String View Overload (Phase 1 bug fix)
 // ============================================================================
 
-TEST(ReadNumberTest, StringViewOverload) {
+TEST_P(ReadNumberTest, StringViewOverload) {
     float            result;
     std::string_view sv("123.45");
-    EXPECT_TRUE(read_number(sv, result));
+    EXPECT_TRUE(read(sv, result));
     EXPECT_TRUE(approx_equal(result, 123.45f));
 }
 
-TEST(ReadNumberTest, StringViewWithUnaryOperator) {
+TEST_P(ReadNumberTest, StringViewWithUnaryOperator) {
     float result;
     set_numbered_param(30, 77.0f);
     std::string_view sv("-#30");
-    EXPECT_TRUE(read_number(sv, result));
+    EXPECT_TRUE(read(sv, result));
     EXPECT_TRUE(approx_equal(result, -77.0f));
 }
 
-TEST(ReadNumberTest, StringViewWithNegatedExpression) {
+TEST_P(ReadNumberTest, StringViewWithNegatedExpression) {
     float            result;
     std::string_view sv("-[10+20]");
-    EXPECT_TRUE(read_number(sv, result));
+    EXPECT_TRUE(read(sv, result));
     EXPECT_TRUE(approx_equal(result, -30.0f));
 }
 
@@ -329,7 +366,7 @@ TEST(ReadNumberTest, StringViewWithNegatedExpression) {
 // Phase 3: Comparative Tests Against LinuxCNC
 // ============================================================================
 
-TEST(ComparativeTest, BasicNumericLiterals) {
+TEST_P(ComparativeTest, BasicNumericLiterals) {
     const char *test_cases[] = {"123", "-456", "78.9", "-12.34"};
     
     for (const char *test : test_cases) {
@@ -338,7 +375,7 @@ TEST(ComparativeTest, BasicNumericLiterals) {
         size_t  fluidnc_pos = 0;
         int     linuxcnc_pos = 0;
         
-        bool fluidnc_ok = read_number(test, fluidnc_pos, fluidnc_result);
+        bool fluidnc_ok = read(test, fluidnc_pos, fluidnc_result);
         int  linuxcnc_ok = linuxcnc_read_value(test, &linuxcnc_pos, &linuxcnc_result);
         
         EXPECT_TRUE(fluidnc_ok);
@@ -348,7 +385,7 @@ TEST(ComparativeTest, BasicNumericLiterals) {
     }
 }
 
-TEST(ComparativeTest, UnaryOperatorsOnExpressions) {
+TEST_P(ComparativeTest, UnaryOperatorsOnExpressions) {
     const char *test_cases[] = {
         "-[10+5]",   // Phase 1: unary minus on bracketed expression
         "+[20*2]",   // Phase 1: unary plus on expression
@@ -363,7 +400,7 @@ TEST(ComparativeTest, UnaryOperatorsOnExpressions) {
         size_t  fluidnc_pos = 0;
         int     linuxcnc_pos = 0;
         
-        bool fluidnc_ok = read_number(test, fluidnc_pos, fluidnc_result);
+        bool fluidnc_ok = read(test, fluidnc_pos, fluidnc_result);
         int  linuxcnc_ok = linuxcnc_read_value(test, &linuxcnc_pos, &linuxcnc_result);
         
         EXPECT_TRUE(fluidnc_ok) << "FluidNC failed on: " << test;
@@ -373,7 +410,7 @@ TEST(ComparativeTest, UnaryOperatorsOnExpressions) {
     }
 }
 
-TEST(ComparativeTest, UnaryFunctions) {
+TEST_P(ComparativeTest, UnaryFunctions) {
     const char *test_cases[] = {
         "[ABS[-5]]",     // Absolute value
         "[SQRT[16]]",    // Square root
@@ -387,7 +424,7 @@ TEST(ComparativeTest, UnaryFunctions) {
         size_t  fluidnc_pos = 0;
         int     linuxcnc_pos = 0;
         
-        bool fluidnc_ok = read_number(test, fluidnc_pos, fluidnc_result);
+        bool fluidnc_ok = read(test, fluidnc_pos, fluidnc_result);
         int  linuxcnc_ok = linuxcnc_read_value(test, &linuxcnc_pos, &linuxcnc_result);
         
         EXPECT_TRUE(fluidnc_ok) << "FluidNC failed on: " << test;
@@ -397,7 +434,7 @@ TEST(ComparativeTest, UnaryFunctions) {
     }
 }
 
-TEST(ComparativeTest, BinaryOperators) {
+TEST_P(ComparativeTest, BinaryOperators) {
     const char *test_cases[] = {
         "[2+3]",       // Addition
         "[10-4]",      // Subtraction
@@ -413,7 +450,7 @@ TEST(ComparativeTest, BinaryOperators) {
         size_t  fluidnc_pos = 0;
         int     linuxcnc_pos = 0;
         
-        bool fluidnc_ok = read_number(test, fluidnc_pos, fluidnc_result);
+        bool fluidnc_ok = read(test, fluidnc_pos, fluidnc_result);
         int  linuxcnc_ok = linuxcnc_read_value(test, &linuxcnc_pos, &linuxcnc_result);
         
         EXPECT_TRUE(fluidnc_ok) << "FluidNC failed on: " << test;
@@ -423,7 +460,7 @@ TEST(ComparativeTest, BinaryOperators) {
     }
 }
 
-TEST(ComparativeTest, OperatorPrecedence) {
+TEST_P(ComparativeTest, OperatorPrecedence) {
     const char *test_cases[] = {
         "[2+3*4]",       // * has higher precedence than +
         "[10-2*3]",      // * has higher precedence than -
@@ -437,7 +474,7 @@ TEST(ComparativeTest, OperatorPrecedence) {
         size_t  fluidnc_pos = 0;
         int     linuxcnc_pos = 0;
         
-        bool fluidnc_ok = read_number(test, fluidnc_pos, fluidnc_result);
+        bool fluidnc_ok = read(test, fluidnc_pos, fluidnc_result);
         int  linuxcnc_ok = linuxcnc_read_value(test, &linuxcnc_pos, &linuxcnc_result);
         
         EXPECT_TRUE(fluidnc_ok) << "FluidNC failed on: " << test;
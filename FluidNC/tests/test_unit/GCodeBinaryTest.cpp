@@ -0,0 +1,161 @@
+// Test suite for the binary GCode line encoding
+#include <gtest/gtest.h>
+
+#include "../src/GCodeBinary.h"
+#include "../src/Parameters.h"
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace {
+
+using namespace GCodeBinary;
+
+std::string encoded(const char* text) {
+    char   out[128];
+    size_t length = encode(text, out, sizeof(out));
+    return std::string(out, length);
+}
+
+// Decodes a line and checks each word against read_float() of the matching text
+void expect_same_words(const char* text, const char* words_text, const char* expected_rest = "") {
+    std::string line = encoded(text);
+    ASSERT_FALSE(line.empty()) << text;
+    ASSERT_TRUE(is_binary(line.c_str()));
+
+    CompiledWord words[max_words];
+    size_t       n_words;
+    const char*  rest;
+    ASSERT_EQ(decode(line.c_str(), words, n_words, rest), Error::Ok);
+    EXPECT_STREQ(rest, expected_rest);
+
+    size_t pos = 0;
+    for (size_t i = 0; i < n_words; i++) {
+        ASSERT_EQ(words[i].letter, words_text[pos]) << text;
+        ++pos;
+        float value;
+        ASSERT_TRUE(read_float(words_text, pos, value));
+        EXPECT_EQ(memcmp(&words[i].value, &value, sizeof(value)), 0) << text << " word " << i << " " << words[i].value << " " << value;
+    }
+    EXPECT_EQ(words_text[pos], '\0') << text;
+}
+
+TEST(GCodeBinary, SimpleWords) {
+    expect_same_words("G1 X12.345 Y-0.5 F3000", "G1X12.345Y-0.5F3000");
+    expect_same_words("g38.2 z-10 f100", "G38.2Z-10F100");
+    expect_same_words("N10 G0 X0 Y0", "N10G0X0Y0");
+}
+
+TEST(GCodeBinary, ExactValues) {
+    expect_same_words("X-0.0 Y+7 Z.25", "X-0.0Y+7Z.25");
+    expect_same_words("X0.0000001 Y123456789.5 Z1.23456789", "X0.0000001Y123456789.5Z1.23456789");
+    expect_same_words("X99999999 Y0.000001 Z-12345.678", "X99999999Y0.000001Z-12345.678");
+}
+
+TEST(GCodeBinary, Smaller) {
+    // Six bits per byte of a value, so that realtime commands need not appear
+    const char* text = "G1X123.456Y-78.901Z-1.5F1500";
+    EXPECT_LT(encoded(text).size(), strlen(text) * 3 / 4);
+}
+
+TEST(GCodeBinary, TextRest) {
+    expect_same_words("G1 X1 Y#1 Z2", "G1X1", "Y#1Z2");
+    expect_same_words("G1 X[1+2]", "G1", "X[1+2]");
+    expect_same_words("G1 X5 #1=2", "G1X5", "#1=2");
+    expect_same_words("G1 X5 ; comment", "G1X5");
+}
+
+TEST(GCodeBinary, StaysText) {
+    EXPECT_TRUE(encoded("").empty());
+    EXPECT_TRUE(encoded("$H").empty());
+    EXPECT_TRUE(encoded("[ESP800]").empty());
+    EXPECT_TRUE(encoded("%").empty());
+    EXPECT_TRUE(encoded("G1 X5 (MSG, hello)").empty());
+    EXPECT_TRUE(encoded("o100 while [#1 lt 5]").empty());
+    EXPECT_TRUE(encoded("#1=5").empty());
+    EXPECT_TRUE(encoded("X#1").empty());
+}
+
+TEST(GCodeBinary, NoLineEndingsOrRealtimeCommands) {
+    // Before escaping, these values hold the bytes for a newline, '?', Ctrl-[,
+    // backspace, a carriage return, '~', '!', Ctrl-X and NUL
+    const char* text = "G1 X2.25 Y5.5 Z16.5 A23.5 B25.5 C30.5 U49.25 V108.25 W128.25";
+    std::string line = encoded(text);
+    ASSERT_FALSE(line.empty());
+    size_t escapes = 0;
+    for (char c : line) {
+        EXPECT_FALSE(c == '\0' || c == '\n' || c == '\r' || c == '\b' || c == 0x18 || c == '?' || c == '!' || c == '~') << int(c);
+        EXPECT_LT(uint8_t(c), 0x80);
+        escapes += c == escape;
+    }
+    EXPECT_EQ(escapes, 9u);
+    expect_same_words(text, "G1X2.25Y5.5Z16.5A23.5B25.5C30.5U49.25V108.25W128.25");
+}
+
+TEST(GCodeBinary, LongLines) {
+    char small[8];
+    EXPECT_EQ(encode("G1X1Y2Z3A4B5C6", small, sizeof(small)), 0u);
+
+    std::string text = "G1";
+    while (text.length() < 130) {
+        text += "X1";
+    }
+    EXPECT_TRUE(encoded(text.c_str()).empty());
+}
+
+TEST(GCodeBinary, RejectsMalformedLines) {
+    CompiledWord words[max_words];
+    size_t       n_words;
+    const char*  rest;
+    EXPECT_EQ(decode("\x02g\x22", words, n_words, rest), Error::ExpectedCommandLetter);  // Lower case
+    EXPECT_EQ(decode("\x02G\x72", words, n_words, rest), Error::BadNumberFormat);        // Unfinished varint
+    EXPECT_EQ(decode("\x02G\xB2", words, n_words, rest), Error::BadNumberFormat);        // Not seven bits
+    EXPECT_EQ(decode("\x02 $J=X1", words, n_words, rest), Error::ExpectedCommandLetter);
+
+    std::string many = "\x02";
+    for (size_t i = 0; i <= max_words; i++) {
+        many += "G\x22";  // G1, 1 << 4 XOR 0x32
+    }
+    EXPECT_EQ(decode(many.c_str(), words, n_words, rest), Error::Overflow);
+}
+
+// A file in the fixtures directory next to this file
+std::string read_fixture(const char* name) {
+    std::string path(__FILE__);
+    path = path.substr(0, path.find_last_of("/\\") + 1) + "fixtures/" + name;
+
+    std::ifstream file(path, std::ios::binary);
+    EXPECT_TRUE(file.good()) << path;
+    std::stringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+// gcode_binary.gcb is what tools/gcode_to_gcb.py makes of gcode_binary.nc.
+// tools/check_gcb_fixture.py checks that the converter still makes it.
+TEST(GCodeBinary, MatchesTheConverterFixture) {
+    std::string source   = read_fixture("gcode_binary.nc");
+    std::string expected = read_fixture("gcode_binary.gcb");
+    ASSERT_FALSE(source.empty());
+
+    std::string converted;
+    std::string long_line;
+    for (size_t start = 0, end; (end = source.find('\n', start)) != std::string::npos; start = end + 1) {
+        std::string line   = source.substr(start, end - start);
+        std::string binary = encoded(line.c_str());
+        converted += (binary.empty() ? line : binary) + '\n';
+        if (line.length() > long_line.length()) {
+            long_line = line;
+        }
+    }
+    EXPECT_EQ(converted, expected);
+
+    // The fixture reaches the limit on the line length
+    ASSERT_GT(long_line.length(), size_t(127));
+    EXPECT_FALSE(encoded(long_line.substr(0, 127).c_str()).empty());
+    EXPECT_TRUE(encoded(long_line.c_str()).empty());
+}
+
+}  // namespace
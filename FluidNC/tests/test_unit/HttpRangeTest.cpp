@@ -0,0 +1,88 @@
+// Test suite for HTTP byte range parsing
+#include <gtest/gtest.h>
+
+#include "../src/WebUI/HttpRange.h"
+
+#include <cstdint>
+
+namespace {
+
+using namespace WebUI;
+
+TEST(HttpRange, SingleRanges) {
+    size_t first, last;
+    ASSERT_EQ(parse_range("bytes=0-499", 1000, first, last), RangeResult::Partial);
+    EXPECT_EQ(first, 0u);
+    EXPECT_EQ(last, 499u);
+
+    ASSERT_EQ(parse_range("bytes=500-", 1000, first, last), RangeResult::Partial);
+    EXPECT_EQ(first, 500u);
+    EXPECT_EQ(last, 999u);
+
+    // The end is clipped to the file
+    ASSERT_EQ(parse_range("Bytes = 900-2000", 1000, first, last), RangeResult::Partial);
+    EXPECT_EQ(first, 900u);
+    EXPECT_EQ(last, 999u);
+}
+
+TEST(HttpRange, SuffixRanges) {
+    size_t first, last;
+    ASSERT_EQ(parse_range("bytes=-100", 1000, first, last), RangeResult::Partial);
+    EXPECT_EQ(first, 900u);
+    EXPECT_EQ(last, 999u);
+
+    ASSERT_EQ(parse_range("bytes=-5000", 1000, first, last), RangeResult::Partial);
+    EXPECT_EQ(first, 0u);
+    EXPECT_EQ(last, 999u);
+
+    EXPECT_EQ(parse_range("bytes=-0", 1000, first, last), RangeResult::Unsatisfiable);
+    EXPECT_EQ(parse_range("bytes=-10", 0, first, last), RangeResult::Unsatisfiable);
+}
+
+TEST(HttpRange, Unsatisfiable) {
+    size_t first, last;
+    EXPECT_EQ(parse_range("bytes=1000-", 1000, first, last), RangeResult::Unsatisfiable);
+    EXPECT_EQ(parse_range("bytes=0-10", 0, first, last), RangeResult::Unsatisfiable);
+    EXPECT_EQ(unsatisfied_range(1000), "bytes */1000");
+}
+
+TEST(HttpRange, Ignored) {
+    size_t first, last;
+    EXPECT_EQ(parse_range("", 1000, first, last), RangeResult::None);
+    EXPECT_EQ(parse_range("items=0-5", 1000, first, last), RangeResult::None);
+    EXPECT_EQ(parse_range("bytes=0-5,10-20", 1000, first, last), RangeResult::None);
+    EXPECT_EQ(parse_range("bytes=20-10", 1000, first, last), RangeResult::None);
+    EXPECT_EQ(parse_range("bytes=-", 1000, first, last), RangeResult::None);
+    EXPECT_EQ(parse_range("bytes=99999999999999999999999-", 1000, first, last), RangeResult::None);
+}
+
+TEST(HttpRange, IfRange) {
+    EXPECT_TRUE(if_range_matches("\"ABC123\"", "\"ABC123\""));
+    EXPECT_TRUE(if_range_matches(" \"ABC123\" ", "\"ABC123\""));
+    EXPECT_FALSE(if_range_matches("\"ABC124\"", "\"ABC123\""));
+    EXPECT_FALSE(if_range_matches("W/\"ABC123\"", "\"ABC123\""));
+    EXPECT_FALSE(if_range_matches("Wed, 21 Oct 2015 07:28:00 GMT", "\"ABC123\""));
+    // A file whose hash is not known cannot be validated
+    EXPECT_FALSE(if_range_matches("\"\"", ""));
+    EXPECT_FALSE(if_range_matches("", ""));
+}
+
+TEST(HttpRange, ContentRange) {
+    size_t first, last, total;
+    ASSERT_TRUE(parse_content_range("bytes 1000-1999/5000", first, last, total));
+    EXPECT_EQ(first, 1000u);
+    EXPECT_EQ(last, 1999u);
+    EXPECT_EQ(total, 5000u);
+
+    ASSERT_TRUE(parse_content_range("bytes 0-99/*", first, last, total));
+    EXPECT_EQ(total, SIZE_MAX);
+
+    EXPECT_FALSE(parse_content_range("bytes 100-99/5000", first, last, total));
+    EXPECT_FALSE(parse_content_range("bytes 0-5000/5000", first, last, total));
+    EXPECT_FALSE(parse_content_range("bytes */5000", first, last, total));
+    EXPECT_FALSE(parse_content_range("bytes=0-99/100", first, last, total));
+
+    EXPECT_EQ(content_range(0, 499, 1000), "bytes 0-499/1000");
+}
+
+}  // namespace
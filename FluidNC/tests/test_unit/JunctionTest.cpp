@@ -0,0 +1,44 @@
+// Test suite for the planner's junction cornering speeds
+#include <gtest/gtest.h>
+
+#include "../src/Junction.h"
+
+#include <cmath>
+
+namespace {
+
+const float deviation = 0.01f;    // The default junction_deviation_mm
+const float accel     = 1000.0f;  // mm/sec^2
+
+// -cos(theta) between the unit vectors of two segments, as the planner computes it
+float cos_theta(float degrees_turned) {
+    return -cosf(degrees_turned * float(M_PI) / 180.0f);
+}
+
+// Corner speed in mm/sec from the centripetal acceleration about the circle
+float corner_speed(float radius) {
+    return sqrtf(accel * radius);
+}
+
+TEST(Junction, ExactPathUsesTheJunctionDeviation) {
+    // A 90 degree turn: sin(45) / (1 - sin(45)) = 2.414
+    float radius = Junction::radius(cos_theta(90), deviation);
+    EXPECT_NEAR(radius, deviation * 2.4142f, 1e-5);
+    EXPECT_NEAR(corner_speed(radius), 4.91f, 0.01f);
+}
+
+TEST(Junction, RadiusScalesWithTheDeviation) {
+    float radius = Junction::radius(cos_theta(60), deviation);
+    EXPECT_NEAR(Junction::radius(cos_theta(60), deviation * 4), radius * 4, 1e-6);
+}
+
+TEST(Junction, SharperCornersAreSlower) {
+    float previous = INFINITY;
+    for (float turned = 5; turned < 180; turned += 5) {
+        float radius = Junction::radius(cos_theta(turned), deviation);
+        EXPECT_LT(radius, previous) << turned << " degrees";
+        previous = radius;
+    }
+}
+
+}
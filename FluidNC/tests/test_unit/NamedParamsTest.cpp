@@ -0,0 +1,161 @@
+// Test suite for interned named parameters
+#include <gtest/gtest.h>
+
+#include "../src/NamedParams.h"
+#include "../src/Parameters.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+TEST(ParamSymbols, InternIsCaseAndSpaceInsensitive) {
+    ParamSymbols symbols;
+
+    auto depth = symbols.intern("depth");
+    EXPECT_NE(depth, no_symbol);
+    EXPECT_EQ(symbols.intern("DEPTH"), depth);
+    EXPECT_EQ(symbols.intern("De pth"), depth);
+    EXPECT_EQ(symbols.find(" dEpTh "), depth);
+    EXPECT_EQ(symbols.name(depth), "DEPTH");
+
+    auto width = symbols.intern("width");
+    EXPECT_NE(width, depth);
+    EXPECT_EQ(symbols.size(), 2u);
+}
+
+TEST(ParamSymbols, FindDoesNotIntern) {
+    ParamSymbols symbols;
+
+    EXPECT_EQ(symbols.find("missing"), no_symbol);
+    symbols.intern("present");
+    EXPECT_EQ(symbols.find("missing"), no_symbol);
+    EXPECT_EQ(symbols.size(), 1u);
+}
+
+TEST(ParamSymbols, EmptyNameIsRejected) {
+    ParamSymbols symbols;
+
+    EXPECT_EQ(symbols.intern(""), no_symbol);
+    EXPECT_EQ(symbols.intern("   "), no_symbol);
+    EXPECT_EQ(symbols.size(), 0u);
+}
+
+TEST(ParamSymbols, SymbolsSurviveGrowth) {
+    ParamSymbols                symbols;
+    std::vector<param_symbol_t> interned;
+
+    for (int i = 0; i < 1000; i++) {
+        interned.push_back(symbols.intern("param" + std::to_string(i)));
+    }
+    for (int i = 0; i < 1000; i++) {
+        auto name = "PARAM" + std::to_string(i);
+        EXPECT_EQ(symbols.find(name), interned[i]);
+        EXPECT_EQ(symbols.name(interned[i]), name);
+    }
+}
+
+TEST(ParamSymbols, ReclaimedSymbolsAreReused) {
+    ParamSymbols    symbols;
+    NamedParamStore global;
+
+    auto kept = symbols.intern("kept");
+    global.set(kept, 1.0f);
+    std::vector<param_symbol_t> job;
+    for (int i = 0; i < 100; i++) {
+        job.push_back(symbols.intern("local" + std::to_string(i)));
+    }
+
+    EXPECT_EQ(symbols.reclaim([&global](param_symbol_t symbol) { return global.exists(symbol); }), 100u);
+    EXPECT_EQ(symbols.size(), 1u);
+    EXPECT_EQ(symbols.find("kept"), kept);
+    EXPECT_EQ(symbols.find("local0"), no_symbol);
+
+    // The next job's names get the freed symbols, and the table does not grow
+    for (int i = 0; i < 100; i++) {
+        auto symbol = symbols.intern("other" + std::to_string(i));
+        EXPECT_NE(std::find(job.begin(), job.end(), symbol), job.end());
+        EXPECT_EQ(symbols.name(symbol), "OTHER" + std::to_string(i));
+    }
+    EXPECT_EQ(symbols.size(), 101u);
+    EXPECT_EQ(symbols.find("kept"), kept);
+    EXPECT_EQ(symbols.find("other50"), symbols.intern("OTHER50"));
+}
+
+TEST(NamedParamStore, GetSetExists) {
+    NamedParamStore store;
+    float           value = -1;
+
+    EXPECT_TRUE(store.empty());
+    EXPECT_FALSE(store.get(3, value));
+    EXPECT_FALSE(store.exists(3));
+    EXPECT_EQ(value, -1);
+
+    store.set(3, 2.5f);
+    EXPECT_TRUE(store.get(3, value));
+    EXPECT_EQ(value, 2.5f);
+    EXPECT_TRUE(store.exists(3));
+    EXPECT_FALSE(store.exists(2));
+
+    store.set(3, 4.0f);
+    EXPECT_EQ(store.count(), 1u);
+
+    store.clear();
+    EXPECT_FALSE(store.exists(3));
+    EXPECT_TRUE(store.empty());
+}
+
+TEST(NamedParamStore, SortedByName) {
+    ParamSymbols    symbols;
+    NamedParamStore store;
+
+    auto c = symbols.intern("c");
+    auto a = symbols.intern("a");
+    auto b = symbols.intern("b");
+    store.set(c, 3);
+    store.set(a, 1);
+
+    auto sorted = store.sorted(symbols);
+    ASSERT_EQ(sorted.size(), 2u);
+    EXPECT_EQ(sorted[0], a);
+    EXPECT_EQ(sorted[1], c);
+    EXPECT_FALSE(store.exists(b));
+}
+
+TEST(NamedParams, ReadAndAssignInGCode) {
+    size_t pos = 0;
+    float  value;
+
+    set_named_param("Feed_Depth", 1.5f);
+    ASSERT_TRUE(read_number("#<feed_depth>", pos, value));
+    EXPECT_EQ(value, 1.5f);
+
+    // Assignments take effect when they are performed
+    const char* line = "<FEED_DEPTH>=2.25";
+    pos              = 0;
+    ASSERT_TRUE(assign_param(line, pos));
+    EXPECT_EQ(pos, strlen(line));
+    ASSERT_TRUE(perform_assignments());
+
+    pos = 0;
+    ASSERT_TRUE(read_number("#<feed_ Depth>", pos, value));
+    EXPECT_EQ(value, 2.25f);
+
+    std::string exists("#<FEED_depth>");
+    EXPECT_TRUE(named_param_exists(exists));
+    std::string missing("#<never_used>");
+    EXPECT_FALSE(named_param_exists(missing));
+}
+
+TEST(NamedParams, UndefinedAndEmptyNamesFail) {
+    size_t pos = 0;
+    float  value;
+
+    EXPECT_FALSE(read_number("#<undefined_param>", pos, value));
+    pos = 0;
+    EXPECT_FALSE(read_number("#<>", pos, value));
+    pos = 0;
+    EXPECT_FALSE(read_number("#<unterminated", pos, value));
+}
+
+}  // namespace
@@ -0,0 +1,92 @@
+// Test suite for the inverse kinematics of ParallelDelta, one position and a batch at a time
+#include <gtest/gtest.h>
+
+#include "../src/Kinematics/DeltaIK.h"
+
+#include <vector>
+
+namespace {
+
+using Kinematics::DeltaIK;
+using Kinematics::SegmentBatch;
+
+// The default geometry of ParallelDelta
+DeltaIK default_delta() {
+    DeltaIK ik;
+    ik.set_geometry(70.0, 179.437, 133.5, 86.603, -30.0);
+    return ik;
+}
+
+const float no_offset[3] = { 0, 0, 0 };
+
+// Transforms every batch of the move and checks each segment against the
+// transform of its position alone.  Returns the number of segments before
+// the first unreachable one, or the segment count if all are reachable.
+size_t check_batches(const DeltaIK& ik, SegmentBatch& segments, const float* offset) {
+    size_t done = 0;
+    while (segments.next()) {
+        size_t reachable = ik.arm_angles(segments, offset);
+        EXPECT_LE(reachable, segments.size());
+        for (size_t i = 0; i < segments.size(); i++) {
+            float angles[3];
+            bool  ok = ik.arm_angles(angles, segments.cartesian(i), offset);
+            EXPECT_EQ(ok, i < reachable) << "segment " << done + i;
+            if (i >= reachable) {
+                return done + reachable;
+            }
+            for (size_t arm = 0; arm < 3; arm++) {
+                EXPECT_FLOAT_EQ(segments.motors(i)[arm], angles[arm]) << "segment " << done + i << " arm " << arm;
+            }
+        }
+        done += segments.size();
+    }
+    return done;
+}
+
+TEST(ParallelDelta, BatchMatchesSingleTransforms) {
+    auto  ik         = default_delta();
+    float position[] = { -40, 30, -180 };
+    float target[]   = { 35, -25, -140 };
+
+    SegmentBatch segments(position, target, 37, axis_t(3));
+    EXPECT_EQ(check_batches(ik, segments, no_offset), 37u);
+}
+
+TEST(ParallelDelta, BatchMatchesSingleTransformsWithOffset) {
+    auto        ik         = default_delta();
+    const float offset[3]  = { 5, -3, 20 };
+    float       position[] = { 0, 0, -160 };
+    float       target[]   = { 20, 40, -150 };
+
+    SegmentBatch segments(position, target, 20, axis_t(3));
+    EXPECT_EQ(check_batches(ik, segments, offset), 20u);
+}
+
+TEST(ParallelDelta, BatchStopsAtAnUnreachableSegment) {
+    // At this height the effector reaches about 67 mm out along X, so the
+    // sixth of these 5 mm segments, in the middle of the first batch, is
+    // the first that cannot be reached
+    auto  ik         = default_delta();
+    float position[] = { 40, 0, -180 };
+    float target[]   = { 120, 0, -180 };
+
+    SegmentBatch segments(position, target, 16, axis_t(3));
+    EXPECT_EQ(check_batches(ik, segments, no_offset), 5u);
+}
+
+TEST(ParallelDelta, BatchStopsInEveryDirection) {
+    // Moves out of the work area in several directions, so that the arms are
+    // rotated into every plane
+    auto ik = default_delta();
+    for (float angle : { 0.0f, 2.0944f, -2.0944f, 1.0472f }) {
+        float position[] = { 0, 0, -170 };
+        float target[]   = { 300 * cosf(angle), 300 * sinf(angle), -170 };
+
+        SegmentBatch segments(position, target, 301, axis_t(3));
+        size_t       reachable = check_batches(ik, segments, no_offset);
+        EXPECT_GT(reachable, 0u) << "angle " << angle;
+        EXPECT_LT(reachable, 301u) << "angle " << angle;
+    }
+}
+
+}
@@ -0,0 +1,143 @@
+// Test suite for latching the probe trip position in the stepper ISR
+#include <gtest/gtest.h>
+
+#include "../src/ProbeLatch.h"
+
+#include <atomic>
+#include <thread>
+
+namespace {
+
+const size_t n_axis = 3;
+
+// Steps the axes the way the stepper ISR would, sampling the latch after each
+// pulse, with the probe tripping while trip_from <= step < trip_to
+void run_move(ProbeLatch<6>& latch, int32_t* steps, int n_steps, int trip_from, int trip_to = 1 << 30) {
+    for (int step = 0; step < n_steps; step++) {
+        steps[0] += 1;
+        steps[1] -= 2;
+        if (step % 4 == 0) {
+            steps[2] += 1;
+        }
+        bool tripped = step >= trip_from && step < trip_to;
+        latch.sample(tripped, steps, n_axis, uint32_t(step * 100));
+    }
+}
+
+TEST(ProbeLatch, LatchesAtTheTrippingStep) {
+    ProbeLatch<6> latch;
+    int32_t       steps[n_axis] = { 1000, 0, -50 };
+
+    latch.arm();
+    run_move(latch, steps, 600, 437);
+
+    int32_t  latched[n_axis] = {};
+    uint32_t ticks;
+    ASSERT_TRUE(latch.take(latched, n_axis, ticks));
+    // The position after the pulse of step 437, which is the 438th step
+    EXPECT_EQ(latched[0], 1000 + 438);
+    EXPECT_EQ(latched[1], -2 * 438);
+    EXPECT_EQ(latched[2], -50 + 110);
+    EXPECT_EQ(ticks, 43700u);
+
+    // The machine kept moving after the trip
+    EXPECT_EQ(steps[0], 1600);
+}
+
+TEST(ProbeLatch, TakesOnlyOnce) {
+    ProbeLatch<6> latch;
+    int32_t       steps[n_axis] = {};
+
+    latch.arm();
+    run_move(latch, steps, 100, 10);
+
+    int32_t  latched[n_axis] = {};
+    uint32_t ticks;
+    EXPECT_TRUE(latch.take(latched, n_axis, ticks));
+    EXPECT_FALSE(latch.armed());
+
+    // A later trip is ignored until the latch is armed again
+    int32_t again[n_axis] = { -1, -1, -1 };
+    run_move(latch, steps, 100, 0);
+    EXPECT_FALSE(latch.take(again, n_axis, ticks));
+    EXPECT_EQ(again[0], -1);
+}
+
+TEST(ProbeLatch, IgnoresTripsWhenDisarmed) {
+    ProbeLatch<6> latch;
+    int32_t       steps[n_axis] = {};
+
+    run_move(latch, steps, 100, 0);
+
+    int32_t  latched[n_axis] = {};
+    uint32_t ticks;
+    EXPECT_FALSE(latch.take(latched, n_axis, ticks));
+}
+
+TEST(ProbeLatch, GlitchIsForgotten) {
+    ProbeLatch<6> latch;
+    int32_t       steps[n_axis] = {};
+
+    // A trip from step 20 to 22 is a glitch; the real trip is at step 300
+    latch.arm();
+    run_move(latch, steps, 250, 20, 23);
+    run_move(latch, steps, 100, 50);
+
+    int32_t  latched[n_axis] = {};
+    uint32_t ticks;
+    ASSERT_TRUE(latch.take(latched, n_axis, ticks));
+    EXPECT_EQ(latched[0], 250 + 51);
+}
+
+TEST(ProbeLatch, ArmingDiscardsAnOldTrip) {
+    ProbeLatch<6> latch;
+    int32_t       steps[n_axis] = {};
+
+    latch.arm();
+    run_move(latch, steps, 10, 5);
+    latch.arm();
+
+    int32_t  latched[n_axis] = {};
+    uint32_t ticks;
+    EXPECT_FALSE(latch.take(latched, n_axis, ticks));
+}
+
+TEST(ProbeLatch, ReaderNeverSeesAHalfWrittenPosition) {
+    // The ISR runs on one core and the probe event on the other.  The writer
+    // keeps latching positions whose axes are all equal, releasing the probe
+    // between latches, while the reader checks that it never sees a mix.
+    ProbeLatch<6>     latch;
+    std::atomic<bool> done { false };
+
+    latch.arm();
+    std::thread isr([&] {
+        int32_t steps[6];
+        for (int32_t i = 0; !done.load(); i++) {
+            for (auto& s : steps) {
+                s = i;
+            }
+            latch.sample((i & 1) == 0, steps, 6, uint32_t(i));
+        }
+    });
+
+    int  takes = 0;
+    bool torn  = false;
+    for (int i = 0; i < 10000000 && takes < 1000; i++) {
+        int32_t  latched[6];
+        uint32_t ticks;
+        if (latch.take(latched, 6, ticks)) {
+            ++takes;
+            for (auto s : latched) {
+                torn |= s != latched[0];
+            }
+            torn |= uint32_t(latched[0]) != ticks;
+        }
+        latch.arm();
+    }
+    done = true;
+    isr.join();
+    EXPECT_FALSE(torn);
+    EXPECT_GT(takes, 0);
+}
+
+}  // namespace
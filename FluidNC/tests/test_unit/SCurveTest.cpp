@@ -0,0 +1,181 @@
+// Test suite for the jerk-limited S-curve ramps used by the segment generator
+#include <gtest/gtest.h>
+
+#include "../src/SCurve.h"
+#include "../src/VelocityProfile.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Units as in the segment generator: mm and minutes
+const float accel   = 200.0f * 3600.0f;    // 200 mm/sec^2, the acceleration limit
+const float jerk    = 5000.0f * 216000.0f;  // 5000 mm/sec^3
+const float segment = 1.0f / 100.0f / 60.0f;
+
+// The acceleration that the planner plans with when jerk limiting is on
+const float planned = accel * SCurve::accel_fraction;
+
+TEST(SCurve, LinearWithoutJerkLimit) {
+    SCurve::Ramp ramp;
+    SCurve::plan(ramp, 0.0f, 6000.0f, 25.0f, accel, 0.0f);
+    EXPECT_EQ(ramp.tj, 0.0f);
+    EXPECT_FLOAT_EQ(ramp.duration, 2.0f * 25.0f / 6000.0f);
+    EXPECT_FLOAT_EQ(SCurve::speed(ramp, ramp.duration / 2), 3000.0f);
+    EXPECT_FLOAT_EQ(SCurve::distance(ramp, ramp.duration / 2), 25.0f / 4);
+}
+
+TEST(SCurve, KeepsDurationAndLength) {
+    float        v1     = 6000.0f;
+    float        length = v1 * v1 / (2 * planned);
+    SCurve::Ramp ramp;
+    SCurve::plan(ramp, 0.0f, v1, length, accel, jerk);
+    ASSERT_GT(ramp.tj, 0.0f);
+    EXPECT_FLOAT_EQ(ramp.duration, v1 / planned);
+    EXPECT_LE(ramp.accel, accel);
+    EXPECT_LE(ramp.jerk, jerk * 1.0001f);
+
+    EXPECT_EQ(SCurve::speed(ramp, 0.0f), 0.0f);
+    EXPECT_EQ(SCurve::speed(ramp, ramp.duration), v1);
+    EXPECT_EQ(SCurve::distance(ramp, ramp.duration), length);
+    EXPECT_NEAR(SCurve::distance(ramp, ramp.duration * 0.999999f), length, 1e-3);
+
+    // Symmetric about the middle, so the midpoint is at the average speed
+    EXPECT_NEAR(SCurve::speed(ramp, ramp.duration / 2), v1 / 2, 1e-2);
+}
+
+TEST(SCurve, ContinuousAndWithinLimits) {
+    SCurve::Ramp ramp;
+    SCurve::plan(ramp, 3000.0f, 500.0f, 10.0f, accel, jerk);
+    ASSERT_GT(ramp.tj, 0.0f);
+    EXPECT_LE(std::fabs(ramp.jerk), jerk * 1.0001f);
+    EXPECT_LE(std::fabs(ramp.accel), accel);
+
+    const int steps     = 10000;
+    float     dt        = ramp.duration / steps;
+    float     lastSpeed = ramp.v0;
+    float     lastDist  = 0.0f;
+    float     maxDelta  = std::fabs(ramp.accel) * dt * 1.01f;
+    for (int i = 1; i <= steps; i++) {
+        float t = i * dt;
+        float v = SCurve::speed(ramp, t);
+        float d = SCurve::distance(ramp, t);
+        EXPECT_LE(std::fabs(v - lastSpeed), maxDelta) << "at step " << i;
+        EXPECT_LE(v, lastSpeed + 1e-3f);  // Decelerating throughout
+        EXPECT_GE(d, lastDist);
+        lastSpeed = v;
+        lastDist  = d;
+    }
+}
+
+TEST(SCurve, ShortRampKeepsAccelerationLimit) {
+    // A ramp planned at the reduced acceleration, but so short in time that the
+    // jerk limit cannot be met without exceeding the acceleration limit
+    float        v0 = 6000.0f, v1 = 6100.0f;
+    float        length = (v1 * v1 - v0 * v0) / (2 * planned);
+    SCurve::Ramp ramp;
+    SCurve::plan(ramp, v0, v1, length, accel, jerk);
+    ASSERT_GT(ramp.tj, 0.0f);
+    EXPECT_FLOAT_EQ(ramp.tj, ramp.duration / 3);
+    EXPECT_LE(ramp.accel, accel * 1.0001f);
+    EXPECT_GT(ramp.jerk, jerk);
+    EXPECT_EQ(SCurve::distance(ramp, ramp.duration), length);
+}
+
+TEST(SCurve, FullAccelerationRampStaysLinear) {
+    // A ramp that already averages the acceleration limit cannot be shaped
+    // without exceeding it
+    SCurve::Ramp ramp;
+    SCurve::plan(ramp, 6000.0f, 0.0f, 6000.0f * 6000.0f / (2 * accel), accel, jerk);
+    EXPECT_EQ(ramp.tj, 0.0f);
+    EXPECT_FLOAT_EQ(ramp.accel, -accel);
+}
+
+struct Trace {
+    int   steps    = 0;     // Total steps
+    int   segments = 0;     // Segment count
+    float time     = 0.0f;  // Total time (min)
+    float mm_left  = 0.0f;  // Distance from the end of the block where the profile ended
+    float accel    = 0.0f;  // Highest magnitude of the average acceleration over a segment
+};
+
+// Follows a block through the segment generator's velocity profile, converting the
+// distances to steps the way Stepper.cpp does
+Trace trace(float length, float entry_speed, float exit_speed, float nominal_speed, float step_per_mm, float max_jerk, bool hold = false) {
+    VelocityProfile profile {};
+    profile.current_speed = entry_speed;
+    profile.max_jerk      = max_jerk;
+    if (hold) {
+        profile.plan_hold(length, planned, entry_speed * entry_speed);
+    } else {
+        profile.plan(length, planned, entry_speed * entry_speed, exit_speed * exit_speed, nominal_speed);
+    }
+
+    Trace result;
+    float millimeters      = length;
+    float steps_remaining  = length * step_per_mm;
+    float req_mm_increment = 1.25f / step_per_mm;
+    do {
+        float last_speed = profile.current_speed;
+        float mm_remaining;
+        float dt = profile.next_segment(millimeters, planned, req_mm_increment, segment, mm_remaining);
+        EXPECT_GT(dt, 0.0f);
+        EXPECT_LE(mm_remaining, millimeters);
+
+        float n_steps_remaining = std::ceil(step_per_mm * mm_remaining);
+        EXPECT_GE(std::ceil(steps_remaining), n_steps_remaining);
+        result.steps += int(std::ceil(steps_remaining) - n_steps_remaining);
+        result.time += dt;
+        result.segments++;
+        result.accel = std::max(result.accel, std::fabs(profile.current_speed - last_speed) / dt);
+
+        millimeters     = mm_remaining;
+        steps_remaining = n_steps_remaining;
+    } while (millimeters != profile.mm_complete);
+    result.mm_left = millimeters;
+    return result;
+}
+
+TEST(SCurve, SameStepsAndPositionAsTrapezoid) {
+    const float spm = 80.0f;
+    struct {
+        float length, entry, exit, nominal;
+    } blocks[] = {
+        { 100.0f, 0.0f, 0.0f, 9000.0f },       // Full trapezoid
+        { 10.0f, 0.0f, 0.0f, 9000.0f },        // Triangle
+        { 50.0f, 3000.0f, 1000.0f, 6000.0f },  // Between junctions
+        { 20.0f, 3000.0f, 0.0f, 3000.0f },     // Cruise-deceleration
+    };
+    for (auto& b : blocks) {
+        auto trapezoid = trace(b.length, b.entry, b.exit, b.nominal, spm, 0.0f);
+        auto scurve    = trace(b.length, b.entry, b.exit, b.nominal, spm, jerk);
+
+        EXPECT_EQ(trapezoid.steps, int(b.length * spm)) << "length " << b.length;
+        EXPECT_EQ(scurve.steps, trapezoid.steps) << "length " << b.length;
+        EXPECT_EQ(scurve.mm_left, 0.0f);
+
+        // Same duration, to within float rounding over the segments
+        EXPECT_NEAR(scurve.time, trapezoid.time, 1e-4f * trapezoid.time) << "length " << b.length;
+
+        // The trapezoid ramps at the planned acceleration, and the S-curves peak
+        // within the acceleration limit
+        EXPECT_NEAR(trapezoid.accel, planned, 1e-3f * planned) << "length " << b.length;
+        EXPECT_GT(scurve.accel, planned) << "length " << b.length;
+        EXPECT_LE(scurve.accel, accel * 1.001f) << "length " << b.length;
+    }
+}
+
+TEST(SCurve, FeedHoldStopsWhereTrapezoidDoes) {
+    const float spm       = 80.0f;
+    auto        trapezoid = trace(100.0f, 6000.0f, 0.0f, 6000.0f, spm, 0.0f, true);
+    auto        scurve    = trace(100.0f, 6000.0f, 0.0f, 6000.0f, spm, jerk, true);
+
+    EXPECT_GT(trapezoid.mm_left, 0.0f);
+    EXPECT_EQ(scurve.mm_left, trapezoid.mm_left);
+    EXPECT_EQ(scurve.steps, trapezoid.steps);
+    EXPECT_NEAR(scurve.time, trapezoid.time, 1e-4f * trapezoid.time);
+    EXPECT_LE(scurve.accel, accel * 1.001f);
+}
+
+}  // namespace
@@ -0,0 +1,153 @@
+// Test suite for the lock-free single-producer/single-consumer queue
+#include <gtest/gtest.h>
+
+#include "../src/SPSCQueue.h"
+
+#include <cstring>
+#include <thread>
+
+namespace {
+
+struct Line {
+    int  tag;
+    char text[16];
+};
+
+TEST(SPSCQueue, StartsEmpty) {
+    SPSCQueue<int, 4> q;
+    EXPECT_TRUE(q.empty());
+    EXPECT_EQ(q.size(), 0u);
+    EXPECT_EQ(q.free_space(), 4u);
+    EXPECT_EQ(q.front(), nullptr);
+}
+
+TEST(SPSCQueue, PushPopInOrder) {
+    SPSCQueue<int, 4> q;
+    EXPECT_TRUE(q.push(1));
+    EXPECT_TRUE(q.push(2));
+    EXPECT_TRUE(q.push(3));
+    EXPECT_EQ(q.size(), 3u);
+
+    int v;
+    EXPECT_TRUE(q.pop(v));
+    EXPECT_EQ(v, 1);
+    EXPECT_TRUE(q.pop(v));
+    EXPECT_EQ(v, 2);
+    EXPECT_TRUE(q.pop(v));
+    EXPECT_EQ(v, 3);
+    EXPECT_FALSE(q.pop(v));
+}
+
+TEST(SPSCQueue, FullQueueRejectsAndCounts) {
+    SPSCQueue<int, 4> q;
+    for (int i = 0; i < 4; i++) {
+        EXPECT_TRUE(q.push(i));
+    }
+    EXPECT_FALSE(q.push(99));
+    EXPECT_EQ(q.slot(), nullptr);
+    EXPECT_EQ(q.full_count(), 1u);  // Retries while full are not counted
+    EXPECT_EQ(q.high_water(), 4u);
+
+    int v;
+    EXPECT_TRUE(q.pop(v));
+    EXPECT_EQ(q.full_count(), 1u);
+    EXPECT_TRUE(q.push(4));
+    EXPECT_FALSE(q.push(5));
+    EXPECT_EQ(q.full_count(), 2u);
+
+    q.reset_stats();
+    EXPECT_EQ(q.full_count(), 0u);
+    EXPECT_EQ(q.high_water(), 4u);  // Reset to the current occupancy
+}
+
+TEST(SPSCQueue, WrapsAround) {
+    SPSCQueue<int, 4> q;
+    int               v;
+    for (int i = 0; i < 100; i++) {
+        EXPECT_TRUE(q.push(i));
+        EXPECT_TRUE(q.push(i + 1000));
+        EXPECT_TRUE(q.pop(v));
+        EXPECT_EQ(v, i);
+        EXPECT_TRUE(q.pop(v));
+        EXPECT_EQ(v, i + 1000);
+    }
+    EXPECT_TRUE(q.empty());
+    EXPECT_EQ(q.high_water(), 2u);
+}
+
+TEST(SPSCQueue, SlotAndFrontInPlace) {
+    SPSCQueue<Line, 2> q;
+    Line*              slot = q.slot();
+    ASSERT_NE(slot, nullptr);
+    slot->tag = 7;
+    strcpy(slot->text, "G1X1");
+    EXPECT_TRUE(q.empty());  // Not visible until committed
+    q.commit();
+    EXPECT_EQ(q.size(), 1u);
+
+    Line* front = q.front();
+    ASSERT_NE(front, nullptr);
+    EXPECT_EQ(front->tag, 7);
+    EXPECT_STREQ(front->text, "G1X1");
+    q.pop();
+    EXPECT_TRUE(q.empty());
+}
+
+TEST(SPSCQueue, BulkPushPop) {
+    SPSCQueue<uint8_t, 8> q;
+    const uint8_t         data[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+    EXPECT_EQ(q.push(data, 5), 5u);
+    EXPECT_EQ(q.push(data + 5, 5), 3u);  // Only 3 fit
+    EXPECT_EQ(q.full_count(), 1u);
+
+    uint8_t out[10] = {};
+    EXPECT_EQ(q.pop(out, 6), 6u);
+    for (int i = 0; i < 6; i++) {
+        EXPECT_EQ(out[i], data[i]);
+    }
+    EXPECT_EQ(q.pop(out, 10), 2u);
+    EXPECT_EQ(out[0], 7);
+    EXPECT_EQ(out[1], 8);
+}
+
+TEST(SPSCQueue, ClearDiscardsEverything) {
+    SPSCQueue<int, 4> q;
+    q.push(1);
+    q.push(2);
+    q.clear();
+    EXPECT_TRUE(q.empty());
+    EXPECT_TRUE(q.push(3));
+    int v;
+    EXPECT_TRUE(q.pop(v));
+    EXPECT_EQ(v, 3);
+}
+
+TEST(SPSCQueue, ConcurrentProducerConsumer) {
+    SPSCQueue<uint32_t, 16> q;
+    const uint32_t          count = 20000;
+
+    std::thread producer([&q, count]() {
+        for (uint32_t i = 0; i < count;) {
+            if (q.push(i)) {
+                ++i;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    uint32_t expected = 0;
+    uint32_t v;
+    while (expected < count) {
+        if (q.pop(v)) {
+            ASSERT_EQ(v, expected);
+            ++expected;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    EXPECT_TRUE(q.empty());
+}
+
+}  // namespace
@@ -0,0 +1,88 @@
+// Test suite for dividing kinematic moves into batches of segments
+#include <gtest/gtest.h>
+
+#include "../src/Kinematics/SegmentBatch.h"
+
+#include <vector>
+
+namespace {
+
+using Kinematics::SegmentBatch;
+
+// Collects the targets of every segment, checking the batch sizes on the way
+std::vector<std::vector<float>> all_targets(SegmentBatch& segments) {
+    std::vector<std::vector<float>> targets;
+    while (segments.next()) {
+        EXPECT_GT(segments.size(), 0u);
+        EXPECT_LE(segments.size(), SegmentBatch::max_size);
+        for (size_t i = 0; i < segments.size(); i++) {
+            auto cartesian = segments.cartesian(i);
+            targets.emplace_back(cartesian, cartesian + segments.n_axis());
+        }
+    }
+    return targets;
+}
+
+TEST(SegmentBatch, DividesTheMoveEvenly) {
+    float position[] = { 0, 10, -5, 1 };
+    float target[]   = { 20, 10, 15, 1 };
+
+    SegmentBatch segments(position, target, 20, axis_t(4));
+    EXPECT_EQ(segments.segment_count(), 20u);
+    EXPECT_FLOAT_EQ(segments.segment_length(), sqrtf(800) / 20);
+
+    auto targets = all_targets(segments);
+    ASSERT_EQ(targets.size(), 20u);
+    for (size_t i = 0; i < targets.size(); i++) {
+        EXPECT_FLOAT_EQ(targets[i][0], float(i + 1));
+        EXPECT_FLOAT_EQ(targets[i][1], 10);
+        EXPECT_FLOAT_EQ(targets[i][2], -5 + float(i + 1));
+        EXPECT_FLOAT_EQ(targets[i][3], 1);
+    }
+}
+
+TEST(SegmentBatch, LastSegmentEndsExactlyAtTheTarget) {
+    // A step of 0.1 is not exact in binary, so adding up the steps would miss
+    float position[] = { 0, 0, 0 };
+    float target[]   = { 100.1f, -33.3f, 7.7f };
+
+    SegmentBatch segments(position, target, 1001, axis_t(3));
+    auto         targets = all_targets(segments);
+    ASSERT_EQ(targets.size(), 1001u);
+    EXPECT_EQ(targets.back()[0], target[0]);
+    EXPECT_EQ(targets.back()[1], target[1]);
+    EXPECT_EQ(targets.back()[2], target[2]);
+}
+
+TEST(SegmentBatch, FillsFullBatchesThenTheRest) {
+    float position[] = { 0, 0, 0 };
+    float target[]   = { 1, 2, 3 };
+
+    const uint32_t count = SegmentBatch::max_size * 2 + 3;
+    SegmentBatch   segments(position, target, count, axis_t(3));
+
+    EXPECT_TRUE(segments.next());
+    EXPECT_EQ(segments.size(), SegmentBatch::max_size);
+    EXPECT_TRUE(segments.next());
+    EXPECT_EQ(segments.size(), SegmentBatch::max_size);
+    EXPECT_TRUE(segments.next());
+    EXPECT_EQ(segments.size(), 3u);
+    EXPECT_FALSE(segments.next());
+    EXPECT_EQ(segments.size(), 0u);
+}
+
+TEST(SegmentBatch, ZeroSegmentsIsOne) {
+    // A move that is entirely in untransformed axes still needs one segment
+    float position[] = { 5, 5, 5 };
+    float target[]   = { 5, 5, 5 };
+
+    SegmentBatch segments(position, target, 0, axis_t(3));
+    EXPECT_EQ(segments.segment_count(), 1u);
+    EXPECT_FLOAT_EQ(segments.segment_length(), 0);
+
+    auto targets = all_targets(segments);
+    ASSERT_EQ(targets.size(), 1u);
+    EXPECT_EQ(targets[0], std::vector<float>({ 5, 5, 5 }));
+}
+
+}  // namespace
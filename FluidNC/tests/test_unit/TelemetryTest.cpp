@@ -0,0 +1,118 @@
+// Test suite for the binary telemetry frame encoder and decoder
+#include <gtest/gtest.h>
+
+#include "../src/Telemetry.h"
+
+#include <vector>
+
+namespace {
+
+using namespace Telemetry;
+
+Sample moving_sample(int i) {
+    Sample s;
+    s.value[StateField]          = 4;  // Cycle
+    s.value[LineNumber]          = 100 + i / 10;
+    s.value[FeedRate]            = 3000;
+    s.value[SpindleSpeed]        = 18000;
+    s.value[FeedOverride]        = 100;
+    s.value[RapidOverride]       = 100;
+    s.value[SpindleOverride]     = 100;
+    s.value[PlannerBlocks]       = 15;
+    s.value[Segments]            = 6;
+    s.value[MachinePosition + 0] = -123456 + i * 500;
+    s.value[MachinePosition + 1] = 20000 - i * 250;
+    s.value[MachinePosition + 2] = -5000;
+    s.value[WorkOffset + 0]      = -200000;
+    s.value[WorkOffset + 2]      = -50000;
+    return s;
+}
+
+TEST(Telemetry, FirstFrameIsKeyframe) {
+    Encoder encoder;
+    uint8_t frame[max_frame_size];
+    size_t  length = encoder.encode(moving_sample(0), frame, false);
+    ASSERT_GE(length, header_size + FieldCount);
+    EXPECT_EQ(frame[0], magic);
+    EXPECT_EQ(frame_length(frame), length);
+    EXPECT_EQ(frame[2], version);
+    EXPECT_EQ(frame[4] & keyframe_flag, keyframe_flag);
+    EXPECT_EQ(frame[5] | frame[6] << 8 | frame[7] << 16 | frame[8] << 24, (1 << FieldCount) - 1);
+}
+
+TEST(Telemetry, SkipsUnchangedSamples) {
+    Encoder encoder;
+    uint8_t frame[max_frame_size];
+    ASSERT_GT(encoder.encode(moving_sample(0), frame, false), 0u);
+    EXPECT_EQ(encoder.encode(moving_sample(0), frame, false), 0u);
+    EXPECT_GT(encoder.encode(moving_sample(0), frame, true), 0u);
+}
+
+TEST(Telemetry, DeltasAreSmall) {
+    Encoder encoder;
+    uint8_t frame[max_frame_size];
+    encoder.encode(moving_sample(0), frame, false);
+    size_t length = encoder.encode(moving_sample(1), frame, false);
+    // Two axes moved by a few hundred micrometers, two bytes each
+    EXPECT_EQ(length, header_size + 4);
+    EXPECT_EQ(frame[4] & keyframe_flag, 0);
+}
+
+TEST(Telemetry, RoundTrip) {
+    Encoder encoder;
+    Decoder decoder;
+    uint8_t frame[max_frame_size];
+    for (int i = 0; i < 200; i++) {
+        Sample s = moving_sample(i);
+        if (i == 50) {
+            s.value[MachinePosition + 3] = INT32_MIN;
+            s.value[MachinePosition + 4] = INT32_MAX;
+        }
+        size_t length = encoder.encode(s, frame, i % 64 == 0);
+        if (!length) {
+            continue;
+        }
+        ASSERT_TRUE(decoder.decode(frame, length)) << "frame " << i;
+        for (size_t f = 0; f < FieldCount; f++) {
+            EXPECT_EQ(decoder.sample().value[f], s.value[f]) << "frame " << i << " field " << f;
+        }
+    }
+}
+
+TEST(Telemetry, ResynchronizesAtKeyframe) {
+    Encoder encoder;
+    Decoder decoder;
+    uint8_t frame[max_frame_size];
+
+    ASSERT_TRUE(decoder.decode(frame, encoder.encode(moving_sample(0), frame, false)));
+    encoder.encode(moving_sample(1), frame, false);  // Lost
+    EXPECT_FALSE(decoder.decode(frame, encoder.encode(moving_sample(2), frame, false)));
+    EXPECT_FALSE(decoder.decode(frame, encoder.encode(moving_sample(3), frame, false)));
+
+    encoder.reset();
+    ASSERT_TRUE(decoder.decode(frame, encoder.encode(moving_sample(4), frame, false)));
+    EXPECT_EQ(decoder.sample().value[MachinePosition], moving_sample(4).value[MachinePosition]);
+    ASSERT_TRUE(decoder.decode(frame, encoder.encode(moving_sample(5), frame, false)));
+    EXPECT_EQ(decoder.sample().value[MachinePosition], moving_sample(5).value[MachinePosition]);
+}
+
+TEST(Telemetry, RejectsMalformedFrames) {
+    Encoder encoder;
+    Decoder decoder;
+    uint8_t frame[max_frame_size];
+    size_t  length = encoder.encode(moving_sample(0), frame, false);
+
+    EXPECT_FALSE(decoder.decode(frame, length - 1));
+
+    std::vector<uint8_t> copy(frame, frame + length);
+    copy[2] = version + 1;
+    EXPECT_FALSE(decoder.decode(copy.data(), copy.size()));
+
+    copy    = std::vector<uint8_t>(frame, frame + length);
+    copy[1] = uint8_t(length - 2 - 1);  // Cuts off the last field
+    EXPECT_FALSE(decoder.decode(copy.data(), copy.size() - 1));
+
+    EXPECT_TRUE(decoder.decode(frame, length));
+}
+
+}  // namespace
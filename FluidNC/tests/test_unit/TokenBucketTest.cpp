@@ -0,0 +1,57 @@
+// Test suite for the TokenBucket rate limiter
+#include <gtest/gtest.h>
+
+#include "../src/TokenBucket.h"
+
+namespace {
+
+TEST(TokenBucket, StartsFull) {
+    TokenBucket bucket;
+    bucket.set_rate(1000, 512, 0);
+    EXPECT_TRUE(bucket.take(512, 0));
+    EXPECT_FALSE(bucket.take(1, 0));
+}
+
+TEST(TokenBucket, RefillsAtRate) {
+    TokenBucket bucket;
+    bucket.set_rate(1000, 512, 100);
+    ASSERT_TRUE(bucket.take(512, 100));
+    EXPECT_FALSE(bucket.take(256, 355));
+    EXPECT_TRUE(bucket.take(256, 356));
+    // No more than the burst size accumulates
+    EXPECT_FALSE(bucket.take(513, 100000));
+    EXPECT_TRUE(bucket.take(512, 100000));
+}
+
+TEST(TokenBucket, SlowRatesKeepFractions) {
+    // 300 tokens a second is 0.3 per millisecond
+    TokenBucket bucket;
+    bucket.set_rate(300, 100, 0);
+    ASSERT_TRUE(bucket.take(100, 0));
+    size_t taken = 0;
+    for (uint32_t ms = 1; ms <= 1000; ms++) {
+        if (bucket.take(1, ms)) {
+            ++taken;
+        }
+    }
+    EXPECT_EQ(taken, 300u);
+}
+
+TEST(TokenBucket, WaitTime) {
+    TokenBucket bucket;
+    bucket.set_rate(2000, 1024, 0);
+    ASSERT_TRUE(bucket.take(1024, 0));
+    EXPECT_EQ(bucket.wait_ms(512, 0), 256u);
+    EXPECT_EQ(bucket.wait_ms(512, 100), 156u);
+    EXPECT_TRUE(bucket.take(512, 356));
+    EXPECT_EQ(bucket.wait_ms(2048, 356), UINT32_MAX);
+}
+
+TEST(TokenBucket, ClockWraps) {
+    TokenBucket bucket;
+    bucket.set_rate(1000, 100, UINT32_MAX - 10);
+    ASSERT_TRUE(bucket.take(100, UINT32_MAX - 10));
+    EXPECT_TRUE(bucket.take(50, 39));
+}
+
+}  // namespace
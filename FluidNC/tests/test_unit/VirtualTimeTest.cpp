@@ -0,0 +1,185 @@
+// Test suite for the virtual clock used by the host build's --virtual-time mode
+#include <gtest/gtest.h>
+
+#include "Capture.h"
+#include "Driver/StepTimer.h"
+
+#include <chrono>
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+void stepTimerShutdown();  // In capture/StepTimer.cpp, like restart.cpp uses it
+
+namespace {
+
+class VirtualTime : public ::testing::Test {
+protected:
+    void SetUp() override { Capture::instance().setVirtualTime(true); }
+    void TearDown() override {
+        Capture::instance().takeClock(false);
+        Capture::instance().setVirtualTime(false);
+    }
+};
+
+TEST_F(VirtualTime, IdleWaitAdvancesClockWithoutSleeping) {
+    auto& capture = Capture::instance();
+    auto  start   = capture.micros();
+    auto  real    = std::chrono::steady_clock::now();
+
+    capture.wait(60 * 1000);  // One virtual minute
+
+    EXPECT_EQ(capture.micros(), start + 60u * 1000 * 1000);
+    EXPECT_LT(std::chrono::steady_clock::now() - real, std::chrono::seconds(1));
+}
+
+TEST_F(VirtualTime, CurrentFollowsMicroseconds) {
+    auto& capture = Capture::instance();
+    capture.advanceTo(capture.micros() + 2500);
+    EXPECT_EQ(capture.current(), uint32_t(capture.micros() / 1000));
+}
+
+TEST_F(VirtualTime, ClockNeverMovesBackwards) {
+    auto& capture = Capture::instance();
+    auto  now     = capture.micros();
+    capture.advanceTo(now - 1);
+    EXPECT_EQ(capture.micros(), now);
+}
+
+TEST_F(VirtualTime, StepperClockReleasesWaiters) {
+    auto& capture = Capture::instance();
+    capture.takeClock(true);
+    auto start = capture.micros();
+
+    std::atomic<bool> woke { false };
+    std::thread       task([&]() {
+        capture.wait(3);
+        woke = true;
+    });
+
+    // The task cannot finish until the step timer drives the clock past its wake time
+    for (uint64_t t = start; t < start + 2000; t += 100) {
+        capture.advanceTo(t);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(woke);
+
+    for (uint64_t t = start + 2000; !woke && t < start + 10000; t += 100) {
+        capture.advanceTo(t);
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    task.join();
+    EXPECT_TRUE(woke);
+    EXPECT_GE(capture.micros(), start + 3000);
+}
+
+// A stand-in for the step interrupt and the protocol task's segment prep.  The
+// interrupt takes one step per tick from a ring of segments that a task refills
+// every millisecond, and records the segment that each tick stepped, or -1 if
+// the ring had run dry.
+namespace StepOutput {
+    const int      ring_size         = 20;  // 40 ms, so real time rarely runs dry
+    const int      ticks_per_segment = 20;
+    const int      total_segments    = 60;
+    const uint32_t tick_us           = 100;  // So each segment lasts 2 ms
+
+    std::atomic<int>  head { 0 };   // Segments prepped
+    std::atomic<int>  tail { 0 };   // Segments stepped
+    std::atomic<int>  ticks { 0 };  // Calls to isr()
+    std::atomic<bool> done { false };
+    int               tick_in_segment;
+    std::vector<int>  output;
+    std::vector<int>  wakes;  // The ticks when the prep task woke up
+
+    // Like the stepper's interrupt, sets the period of the next tick, which
+    // starts out at 1 us
+    bool isr() {
+        stepTimerSetTicks(tick_us);
+        ++ticks;
+        int t = tail.load();
+        if (t == total_segments) {
+            done = true;
+            return false;
+        }
+        if (t == head.load()) {
+            output.push_back(-1);
+            return true;
+        }
+        output.push_back(t);
+        if (++tick_in_segment == ticks_per_segment) {
+            tick_in_segment = 0;
+            tail            = t + 1;
+        }
+        return true;
+    }
+
+    void prep() {
+        while (head < total_segments && head - tail < ring_size) {
+            ++head;
+        }
+    }
+
+    // Runs the segments through the step timer and returns the step output
+    std::vector<int> run() {
+        head            = 0;
+        tail            = 0;
+        ticks           = 0;
+        done            = false;
+        tick_in_segment = 0;
+        output.clear();
+        wakes.clear();
+
+        // The task starts the step timer, as the protocol task does
+        std::thread task([]() {
+            prep();
+            stepTimerStart();
+            while (head < total_segments) {
+                Capture::instance().wait(1);
+                wakes.push_back(ticks);
+                // Prepping takes real time, as planning does
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+                prep();
+            }
+        });
+        while (!done) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        task.join();
+        stepTimerStop();
+        return output;
+    }
+}
+
+TEST(VirtualTimeStepTimer, SameStepOutputAsRealTime) {
+    auto& capture = Capture::instance();
+    stepTimerInit(StepOutput::isr);
+
+    auto real = StepOutput::run();
+
+    capture.setVirtualTime(true);
+    auto start     = capture.micros();
+    auto simulated = StepOutput::run();
+    auto elapsed   = capture.micros() - start;
+    capture.setVirtualTime(false);
+
+    stepTimerShutdown();
+
+    // Every tick stepped, so the prep task kept up with the step timer
+    EXPECT_EQ(real.size(), size_t(StepOutput::total_segments * StepOutput::ticks_per_segment));
+    EXPECT_EQ(std::count(real.begin(), real.end(), -1), 0);
+    EXPECT_EQ(simulated, real);
+
+    // The virtual clock moved by exactly the step periods, up to the last
+    // tick, which found nothing left to step
+    EXPECT_EQ(elapsed, 1 + simulated.size() * StepOutput::tick_us);
+
+    // The step timer waited for the prep task at each of its wake times, so
+    // after the first wait, which started between ticks, each wait lasted
+    // exactly 1 ms of ticks
+    ASSERT_GT(StepOutput::wakes.size(), size_t(2));
+    for (size_t i = 2; i < StepOutput::wakes.size(); i++) {
+        EXPECT_EQ(StepOutput::wakes[i] - StepOutput::wakes[i - 1], int(1000 / StepOutput::tick_us)) << "wake " << i;
+    }
+}
+
+}  // namespace
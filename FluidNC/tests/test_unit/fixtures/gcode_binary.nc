@@ -0,0 +1,25 @@
+G1 X10 Y-2.5 F3000
+g0x1.23456789y0.000001z-.5
+G1 X1234567890 Y0.0000001
+Y5 X10 A0 Z1.3
+G1 X2.25 Y5.5 Z16.5 A23.5 B25.5 C30.5 U49.25 V108.25 W128.25
+G1 X1 Y#1 Z2
+G1 X[1+2]
+G1 X5 #1=2
+G1 X5 ; comment
+G1 X1 #<é>=2
+G1	X1Y2
+M3 S1000
+M6 T2
+o100 while [#1 lt 5]
+G1 X5 (MSG, hello)
+$H
+[ESP800]
+%
+
+#1=5
+X#1
+G1X1Y2Z3A4B5C6
+G1X123456.7X123456.7X123456.7X123456.7X123456.7X123456.7X123456.7X123456.7X123456.7X123456.7X123456.7X123456.7X123456.7X123456.
+G1X123456.7X123456.7X123456.7X123456.7X123456.7X123456.7X123456.7X123456.7X123456.7X123456.7X123456.7X123456.7X123456.7X123456 
+G1X123456.7X123456.7X123456.7X123456.7X123456.7X123456.7X123456.7X123456.7X123456.7X123456.7X123456.7X123456.7X123456.7X123456.7
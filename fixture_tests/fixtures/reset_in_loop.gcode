@@ -0,0 +1,8 @@
+#<n>=0
+o100 while [#<n> LT 1000]
+(print, looping)
+G91 G1 X1 F100
+G1 X-1
+#<n>=[#<n>+1]
+o100 endwhile
+G90
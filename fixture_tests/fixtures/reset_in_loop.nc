@@ -0,0 +1,16 @@
+=> ./reset_in_loop.gcode /littlefs/reset_in_loop.gcode
+-> $X
+<~ [MSG:INFO: Caution: Unlocked]
+<- ok
+-> $LocalFS/Run=/reset_in_loop.gcode
+# Ctrl-X while the body of the cached loop is queued
+<... [MSG:INFO: PRINT, looping]
+<... [MSG:INFO: PRINT, looping]
+^X
+# after the reset the machine must unlock, not sit in ConfigAlarm
+-> $X
+<... * *Unlocked]
+<- ok
+-> (print, after reset)
+<- ok
+<- [MSG:INFO: PRINT, after reset]
@@ -173,7 +173,7 @@ class SendFileOpEntry(OpEntry):
                     )
                 )
 
-            controller.send_line(f"$XModem/Receive={remote_file}")
+            controller.send_line(f"$XModem/Receive={self.remote_file_path}")
             while True:
                 # wait for the 'C' character to start the transfer
                 controller.timeout = 2
@@ -182,7 +182,7 @@ class SendFileOpEntry(OpEntry):
                     break
                 if c == b"":
                     raise TimeoutError(
-                        f"XModem start timeout at line {lineno} in fixture file {fixture_file}"
+                        f"XModem start timeout at line {self.lineno} in fixture file {self.fixture_path}"
                     )
                 controller.timeout = 1
             xmodem = XMODEM(controller.getc, controller.putc)
@@ -196,31 +196,40 @@ class SendFileOpEntry(OpEntry):
             )
             if matcher is None:
                 raise ValueError(
-                    f"Transfer failed (ack line): {rx_ack_line} at line {lineno} in fixture file {fixture_file}"
+                    f"Transfer failed (ack line): {rx_ack_line} at line {self.lineno} in fixture file {self.fixture_path}"
                 )
             num_tx_bytes = int(matcher.group(1))
             name_tx_file = matcher.group(2)
-            if name_tx_file != remote_file:
-                print(f"Expected: {remote_file}")
+            if name_tx_file != self.remote_file_path:
+                print(f"Expected: {self.remote_file_path}")
                 print(f"Actual: {name_tx_file}")
                 raise ValueError(
-                    f"Transfer failed (filename mismatch): {rx_ack_line} at line {lineno} in fixture file {fixture_file}"
+                    f"Transfer failed (filename mismatch): {rx_ack_line} at line {self.lineno} in fixture file {self.fixture_path}"
                 )
             print(
                 self._op_str()
-                + color.green(local_file, bold=True)
+                + color.green(self.local_file_path, bold=True)
                 + color.dark_grey(" => ")
-                + color.green(remote_file, bold=True)
+                + color.green(self.remote_file_path, bold=True)
                 + color.green(f" ({num_tx_bytes} bytes)")
             )
             return True
 
 
+class SoftResetOpEntry(OpEntry):
+    def execute(self, controller):
+        print(self._op_str() + color.sent_line("Ctrl-X"))
+        controller.send_soft_reset()
+        return True
+
+
 OPS_MAP = {
     # send command to controller
     "->": SendLineOpEntry,
     # send file to controller
     "=>": SendFileOpEntry,
+    # send a soft reset (Ctrl-X) and wait for the startup message
+    "^X": SoftResetOpEntry,
     # expect from controller
     "<-": StringMatchOpEntry,
     # expect from controller, but optional
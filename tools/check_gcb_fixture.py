@@ -0,0 +1,74 @@
+#!/usr/bin/env python3
+"""
+check_gcb_fixture.py — check gcode_to_gcb.py against the binary GCode fixture.
+
+Usage:
+    python3 check_gcb_fixture.py             # check
+    python3 check_gcb_fixture.py --update    # rewrite the expected .gcb
+
+GCodeBinaryTest checks GCodeBinary::encode() against the expected bytes in
+FluidNC/tests/test_unit/fixtures/gcode_binary.gcb, which are the conversion
+of gcode_binary.nc in the same directory.  This script checks that
+gcode_to_gcb.py still produces those bytes, so the firmware and the
+converter agree.  After a deliberate change to the encoding, change both,
+run this with --update and check that GCodeBinaryTest passes.
+
+Exit codes:
+    0  the converter matches the fixture
+    1  it does not
+"""
+
+import argparse
+import os
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from gcode_to_gcb import encode  # noqa: E402
+
+FIXTURES = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "FluidNC", "tests", "test_unit", "fixtures")
+
+
+def convert(path):
+    out = b""
+    with open(path, "rb") as src:
+        for text in src:
+            text = text.rstrip(b"\r\n")
+            binary = encode(text)
+            out += (text if binary is None else binary) + b"\n"
+    return out
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Check gcode_to_gcb.py against the binary GCode fixture")
+    parser.add_argument("--update", action="store_true", help="rewrite the expected bytes from the converter")
+    args = parser.parse_args()
+
+    source = os.path.join(FIXTURES, "gcode_binary.nc")
+    expected_path = os.path.join(FIXTURES, "gcode_binary.gcb")
+    converted = convert(source)
+
+    if args.update:
+        with open(expected_path, "wb") as f:
+            f.write(converted)
+        print(f"Wrote {expected_path}")
+        return
+
+    with open(expected_path, "rb") as f:
+        expected = f.read()
+    if converted == expected:
+        print("gcode_to_gcb.py matches the fixture")
+        return
+
+    got_lines = converted.split(b"\n")
+    want_lines = expected.split(b"\n")
+    for number, (got, want) in enumerate(zip(got_lines, want_lines), 1):
+        if got != want:
+            print(f"Line {number}: expected {want.hex(' ')}, converted {got.hex(' ')}")
+            break
+    else:
+        print(f"Expected {len(want_lines)} lines, converted {len(got_lines)}")
+    sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
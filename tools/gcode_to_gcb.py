@@ -0,0 +1,167 @@
+#!/usr/bin/env python3
+"""
+gcode_to_gcb.py — convert a GCode file to FluidNC binary GCode (.gcb).
+
+Usage:
+    python3 gcode_to_gcb.py job.nc                 # writes job.gcb
+    python3 gcode_to_gcb.py job.nc -o out.gcb
+    python3 gcode_to_gcb.py job.nc --stats         # also report the size saving
+
+Each line whose leading words are plain numbers is replaced by a binary
+line that FluidNC executes without parsing the text.  Other lines - $
+commands, comments, % lines, O-word flow control and lines without literal
+words - are copied as text, so the result runs the same as the original.
+The encoding is described in FluidNC/src/GCodeBinary.h; this converter must
+produce the same bytes as GCodeBinary::encode(), which check_gcb_fixture.py
+and GCodeBinaryTest check through a shared fixture.
+Lines are handled as bytes, as the firmware sees them, so text that is not
+ASCII is copied unchanged.
+
+A .gcb file can be run as a job like any other GCode file.  To stream one
+over a serial, Telnet or WebSocket connection, first send $GB=ON so that
+the channel passes binary lines through unchanged, and send each line as
+it is, including its terminating newline.
+"""
+
+import argparse
+import os
+import sys
+
+MARKER = 0x02
+ESCAPE = 0x1B
+TEXT_CODE = ord(" ")
+EXP_PLACES = 7
+VARINT_XOR = 0x32
+MAX_WORDS = 32
+MAX_INT_DIGITS = 8  # As in read_float()
+MAX_LINE = 127  # GCodeBinary::max_line, for both the collapsed text and the binary line
+# Line endings, editing keys and the realtime commands
+MUST_ESCAPE = {0x00, 0x08, 0x0A, 0x0D, 0x18, ESCAPE, ord("!"), ord("?"), ord("~")} | set(range(0x80, 0x100))
+SPACE = b" \t\n\v\f\r"  # As C isspace()
+
+
+def is_letter(c):
+    return ord("A") <= c <= ord("Z")
+
+
+def put(out, byte):
+    if byte in MUST_ESCAPE:
+        out.append(ESCAPE)
+        out.append(byte ^ 0x40)
+    else:
+        out.append(byte)
+
+
+def put_varint(out, value):
+    while value >= 0x40:
+        put(out, ((value & 0x3F) | 0x40) ^ VARINT_XOR)
+        value >>= 6
+    put(out, value ^ VARINT_XOR)
+
+
+def read_digits(line, pos):
+    """Read a number as read_float() does; return (pos, negative, digits, exp) or None."""
+    negative = False
+    if pos < len(line) and line[pos] in b"+-":
+        negative = line[pos] == ord("-")
+        pos += 1
+    digits = 0
+    exp = 0
+    ndigit = 0
+    decimal = False
+    while pos < len(line):
+        c = line[pos]
+        if ord("0") <= c <= ord("9"):
+            pos += 1
+            ndigit += 1
+            if ndigit <= MAX_INT_DIGITS:
+                if decimal:
+                    exp -= 1
+                digits = digits * 10 + c - ord("0")
+            elif not decimal:
+                exp += 1
+        elif c == ord(".") and not decimal:
+            pos += 1
+            decimal = True
+        else:
+            break
+    if not ndigit:
+        return None
+    return pos, negative, digits, exp
+
+
+def encode(text):
+    """Return the binary form of a line of GCode bytes, or None if it should stay as text."""
+    line = bytearray()
+    for c in text.split(b";", 1)[0]:
+        if c in SPACE or c == ord(")"):
+            continue
+        if c in b"(%" or len(line) == MAX_LINE:
+            return None
+        line.append(c - 32 if ord("a") <= c <= ord("z") else c)
+    if not line or not is_letter(line[0]) or ord("O") in line:
+        return None
+
+    out = bytearray([MARKER])
+    pos = 0
+    n_words = 0
+    while pos < len(line) and is_letter(line[pos]) and n_words < MAX_WORDS:
+        number = read_digits(line, pos + 1)
+        if number is None:
+            break
+        next_pos, negative, digits, exp = number
+        if next_pos < len(line) and not is_letter(line[next_pos]) and line[next_pos] != ord("#"):
+            break
+        has_places = -EXP_PLACES < exp <= 0
+        out.append(line[pos])
+        put_varint(out, (digits << 4) | ((-exp if has_places else EXP_PLACES) << 1) | negative)
+        if not has_places:
+            put_varint(out, (-exp << 1) | 1 if exp < 0 else exp << 1)
+        pos = next_pos
+        n_words += 1
+    if not n_words:
+        return None
+    if pos < len(line):
+        rest = line[pos:]
+        if any(b in MUST_ESCAPE for b in rest):
+            return None
+        out.append(TEXT_CODE)
+        out += rest
+    if len(out) > MAX_LINE:
+        return None
+    return bytes(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Convert GCode to FluidNC binary GCode")
+    parser.add_argument("input", help="GCode file to convert")
+    parser.add_argument("-o", "--output", help="output file, by default the input with a .gcb extension")
+    parser.add_argument("--stats", action="store_true", help="report the number of lines and bytes converted")
+    args = parser.parse_args()
+
+    output = args.output or os.path.splitext(args.input)[0] + ".gcb"
+    if os.path.abspath(output) == os.path.abspath(args.input):
+        sys.exit("The output file would overwrite the input")
+
+    in_bytes = out_bytes = lines = converted = 0
+    with open(args.input, "rb") as src, open(output, "wb") as dst:
+        for text in src:
+            text = text.rstrip(b"\r\n")
+            in_bytes += len(text) + 1
+            lines += 1
+            binary = encode(text)
+            if binary is None:
+                data = text
+            else:
+                data = binary
+                converted += 1
+            dst.write(data + b"\n")
+            out_bytes += len(data) + 1
+
+    if args.stats:
+        saving = 100.0 * (in_bytes - out_bytes) / in_bytes if in_bytes else 0.0
+        print(f"{lines} lines, {converted} binary; {in_bytes} bytes -> {out_bytes} bytes ({saving:.1f}% smaller)")
+
+
+if __name__ == "__main__":
+    main()